@@ -26,6 +26,7 @@
 #include <brpc/closure_guard.h>
 #include <brpc/controller.h>
 
+#include <algorithm>
 #include <memory>
 #include <cerrno>
 #include <vector>
@@ -35,6 +36,7 @@
 #include "src/chunkserver/chunkserver_metrics.h"
 #include "src/chunkserver/op_request.h"
 #include "src/chunkserver/chunk_service_closure.h"
+#include "src/chunkserver/dmclock_scheduler.h"
 
 #include "src/common/fast_align.h"
 
@@ -44,7 +46,8 @@ namespace chunkserver {
 ChunkServiceImpl::ChunkServiceImpl(ChunkServiceOptions chunkServiceOptions) :
     chunkServiceOptions_(chunkServiceOptions),
     copysetNodeManager_(chunkServiceOptions.copysetNodeManager),
-    inflightThrottle_(chunkServiceOptions.inflightThrottle) {
+    inflightThrottle_(chunkServiceOptions.inflightThrottle),
+    qosScheduler_(chunkServiceOptions.qosScheduler) {
     maxChunkSize_ = copysetNodeManager_->GetCopysetNodeOptions().maxChunkSize;
 }
 
@@ -142,7 +145,7 @@ void ChunkServiceImpl::WriteChunk(RpcController *controller,
                                                   request,
                                                   response,
                                                   doneGuard.release());
-    req->Process();
+    ProcessRequest(req, closure, controller, request, response);
 }
 
 void ChunkServiceImpl::CreateCloneChunk(RpcController *controller,
@@ -252,7 +255,7 @@ void ChunkServiceImpl::ReadChunk(RpcController *controller,
                                            request,
                                            response,
                                            doneGuard.release());
-    req->Process();
+    ProcessRequest(req, closure, controller, request, response);
 }
 
 void ChunkServiceImpl::RecoverChunk(RpcController *controller,
@@ -403,6 +406,78 @@ void ChunkServiceImpl::DeleteChunkSnapshotOrCorrectSn(
     req->Process();
 }
 
+void ChunkServiceImpl::BatchChunk(RpcController *controller,
+                                  const BatchChunkRequest *request,
+                                  BatchChunkResponse *response,
+                                  Closure *done) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller *cntl = dynamic_cast<brpc::Controller *>(controller);
+
+    // 写请求的数据总长度必须和attachment的长度一致，否则无法切分数据
+    uint64_t writeSize = 0;
+    for (const ChunkRequest &subRequest : request->requests()) {
+        if (subRequest.optype() == CHUNK_OP_TYPE::CHUNK_OP_WRITE) {
+            writeSize += subRequest.size();
+        }
+    }
+    if (writeSize != cntl->request_attachment().size()) {
+        LOG(ERROR) << "BatchChunk: write size " << writeSize
+                   << " mismatch attachment size "
+                   << cntl->request_attachment().size();
+        for (int i = 0; i < request->requests_size(); ++i) {
+            response->add_responses()->set_status(
+                CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST);
+            response->add_datasize(0);
+        }
+        return;
+    }
+
+    if (request->requests_size() == 0) {
+        return;
+    }
+
+    BatchChunkClosure *batchDone =
+        new (std::nothrow) BatchChunkClosure(cntl,
+                                             request,
+                                             response,
+                                             doneGuard.release());
+    CHECK(nullptr != batchDone) << "new batch chunk closure failed";
+
+    // 子请求在分发的过程中就可能返回，所以先准备好所有的response和数据
+    for (int i = 0; i < request->requests_size(); ++i) {
+        response->add_responses();
+        const ChunkRequest &subRequest = request->requests(i);
+        if (subRequest.optype() == CHUNK_OP_TYPE::CHUNK_OP_WRITE) {
+            cntl->request_attachment().cutn(
+                &batchDone->GetSubController(i)->request_attachment(),
+                subRequest.size());
+        }
+    }
+
+    // 最后一个子请求返回后batchDone会被析构，分发完之后不能再访问
+    int count = request->requests_size();
+    for (int i = 0; i < count; ++i) {
+        const ChunkRequest *subRequest = &request->requests(i);
+        ChunkResponse *subResponse = response->mutable_responses(i);
+        brpc::Controller *subCntl = batchDone->GetSubController(i);
+        switch (subRequest->optype()) {
+            case CHUNK_OP_TYPE::CHUNK_OP_READ:
+                ReadChunk(subCntl, subRequest, subResponse, batchDone);
+                break;
+            case CHUNK_OP_TYPE::CHUNK_OP_WRITE:
+                WriteChunk(subCntl, subRequest, subResponse, batchDone);
+                break;
+            default:
+                subResponse->set_status(
+                    CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST);
+                LOG(ERROR) << "BatchChunk: unsupported op type "
+                           << subRequest->optype();
+                batchDone->Run();
+                break;
+        }
+    }
+}
+
 /**
  * 当前GetChunkInfo在rpc service层定义和Chunk Service分离的，
  * 且其并不经过QoS或者raft一致性协议，所以这里没有让其继承
@@ -547,5 +622,35 @@ bool ChunkServiceImpl::CheckRequestOffsetAndLength(uint32_t offset,
            common::is_aligned(len, FLAGS_minIoAlignment);
 }
 
+void ChunkServiceImpl::ProcessRequest(std::shared_ptr<ChunkOpRequest> req,
+                                      ChunkServiceClosure *closure,
+                                      RpcController *controller,
+                                      const ChunkRequest *request,
+                                      ChunkResponse *response) {
+    if (nullptr == qosScheduler_) {
+        req->Process();
+        return;
+    }
+
+    // 老版本的client不带qos参数，这些请求按client的地址分到不同的卷中
+    const QosRequestParas &paras = request->deltarho();
+    brpc::Controller *cntl = dynamic_cast<brpc::Controller *>(controller);
+    QosClientKey clientKey =
+        DmClockScheduler::ClientKey(paras.clientid(), cntl->remote_side());
+    uint32_t delta = std::max(paras.dmclockdelta(), 1);
+    uint32_t rho = std::max(paras.dmclockrho(), 1);
+    // 请求从下发到返回给client一直占用调度器的名额，由closure释放
+    uint64_t copysetId =
+        ToGroupNid(request->logicpoolid(), request->copysetid());
+    closure->SetQosScheduler(qosScheduler_, copysetId);
+    qosScheduler_->Submit(clientKey, copysetId, delta, rho, request->size(),
+        [req, response](QosPhase phase, uint32_t cost) {
+            QosResponseParas *phaseCost = response->mutable_phasecost();
+            phaseCost->set_phase(static_cast<int32_t>(phase));
+            phaseCost->set_cost(cost);
+            req->Process();
+        });
+}
+
 }  // namespace chunkserver
 }  // namespace curve
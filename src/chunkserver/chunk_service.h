@@ -37,6 +37,8 @@ using ::google::protobuf::RpcController;
 using ::google::protobuf::Closure;
 
 class CopysetNodeManager;
+class ChunkOpRequest;
+class ChunkServiceClosure;
 
 class ChunkServiceImpl : public ChunkService {
  public:
@@ -81,6 +83,15 @@ class ChunkServiceImpl : public ChunkService {
                       ChunkResponse *response,
                       Closure *done);
 
+    /**
+     * 批量读写，子请求交给ReadChunk/WriteChunk分别处理，
+     * 所有子请求都返回之后再返回rpc
+     */
+    void BatchChunk(RpcController *controller,
+                    const BatchChunkRequest *request,
+                    BatchChunkResponse *response,
+                    Closure *done);
+
     void GetChunkInfo(RpcController *controller,
                       const GetChunkInfoRequest *request,
                       GetChunkInfoResponse *response,
@@ -100,10 +111,25 @@ class ChunkServiceImpl : public ChunkService {
      */
     bool CheckRequestOffsetAndLength(uint32_t offset, uint32_t len);
 
+    /**
+     * 处理读写请求，开启qos时请求先经过dmClock调度再交给copyset处理
+     * @param req[in]: 读写请求
+     * @param closure[in]: 请求的闭包，请求返回时释放qos调度的名额
+     * @param controller[in]: rpc请求的controller
+     * @param request[in]: rpc请求的request
+     * @param response[in]: rpc请求的response
+     */
+    void ProcessRequest(std::shared_ptr<ChunkOpRequest> req,
+                        ChunkServiceClosure *closure,
+                        RpcController *controller,
+                        const ChunkRequest *request,
+                        ChunkResponse *response);
+
  private:
     ChunkServiceOptions chunkServiceOptions_;
     CopysetNodeManager  *copysetNodeManager_;
     std::shared_ptr<InflightThrottle> inflightThrottle_;
+    std::shared_ptr<DmClockScheduler> qosScheduler_;
     uint32_t            maxChunkSize_;
 };
 
@@ -35,19 +35,37 @@ void ChunkServiceClosure::Run() {
      */
     std::unique_ptr<ChunkServiceClosure> selfGuard(this);
 
+    // 读写请求的延时，用于自适应调整inflight上限，过载被拒绝的请求不统计
+    bool sampleLatency = false;
+    uint64_t latencyUs = 0;
     {
         // 所有brpcDone_调用之前要做的操作都放到这个生命周期内
         brpc::ClosureGuard doneGuard(brpcDone_);
         // 记录请求处理结果，收集到metric中
         OnResonse();
+        if (request_ != nullptr && response_ != nullptr
+            && response_->status()
+               != CHUNK_OP_STATUS::CHUNK_OP_STATUS_OVERLOAD) {
+            sampleLatency = true;
+            latencyUs =
+                common::TimeUtility::GetTimeofDayUs() - receivedTimeUs_;
+        }
     }
 
     // closure调用的时候减1，closure创建的什么加1
     // 这一行必须放在brpcDone_调用之后，ut里需要测试inflightio超过限制时的表现
     // 会在传进来的closure里面加一个sleep来控制inflightio个数
     if (nullptr != inflightThrottle_) {
+        if (sampleLatency) {
+            inflightThrottle_->OnResponse(latencyUs);
+        }
         inflightThrottle_->Decrement();
     }
+
+    // 请求已经返回给client，释放qos调度的名额
+    if (nullptr != qosScheduler_) {
+        qosScheduler_->OnComplete(qosCopysetId_);
+    }
 }
 
 void ChunkServiceClosure::OnRequest() {
@@ -151,5 +169,34 @@ void ChunkServiceClosure::OnResonse() {
     }
 }
 
+BatchChunkClosure::BatchChunkClosure(brpc::Controller *cntl,
+                                     const BatchChunkRequest *request,
+                                     BatchChunkResponse *response,
+                                     google::protobuf::Closure *done)
+    : cntl_(cntl)
+    , response_(response)
+    , brpcDone_(done)
+    , remaining_(request->requests_size()) {
+    subCntls_.reserve(request->requests_size());
+    for (int i = 0; i < request->requests_size(); ++i) {
+        subCntls_.emplace_back(new brpc::Controller());
+    }
+}
+
+void BatchChunkClosure::Run() {
+    if (remaining_.fetch_sub(1) != 1) {
+        return;
+    }
+
+    std::unique_ptr<BatchChunkClosure> selfGuard(this);
+    brpc::ClosureGuard doneGuard(brpcDone_);
+
+    // 读请求的数据按子请求的顺序拼接，IOBuf之间只是引用，不会拷贝数据
+    for (auto &subCntl : subCntls_) {
+        response_->add_datasize(subCntl->response_attachment().size());
+        cntl_->response_attachment().append(subCntl->response_attachment());
+    }
+}
+
 }  // namespace chunkserver
 }  // namespace curve
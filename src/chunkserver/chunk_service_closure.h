@@ -24,11 +24,15 @@
 #define SRC_CHUNKSERVER_CHUNK_SERVICE_CLOSURE_H_
 
 #include <brpc/closure_guard.h>
+#include <brpc/controller.h>
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #include "proto/chunk.pb.h"
 #include "src/chunkserver/op_request.h"
 #include "src/chunkserver/inflight_throttle.h"
+#include "src/chunkserver/dmclock_scheduler.h"
 #include "src/common/timeutility.h"
 
 namespace curve {
@@ -64,6 +68,17 @@ class ChunkServiceClosure : public braft::Closure {
      */
     void Run() override;
 
+    /**
+     * 请求经过qos调度时设置，请求返回时释放其在调度器中占用的名额
+     * @param qosScheduler: qos调度器
+     * @param copysetId: 请求所属的copyset，见ToGroupNid
+     */
+    void SetQosScheduler(std::shared_ptr<DmClockScheduler> qosScheduler,
+                         uint64_t copysetId) {
+        qosScheduler_ = qosScheduler;
+        qosCopysetId_ = copysetId;
+    }
+
  private:
     /**
      * 统计请求数量和速率
@@ -85,6 +100,48 @@ class ChunkServiceClosure : public braft::Closure {
     google::protobuf::Closure *brpcDone_;
     // 接受到请求的时间
     uint64_t receivedTimeUs_;
+    // qos调度器，请求没有经过qos调度时为空
+    std::shared_ptr<DmClockScheduler> qosScheduler_;
+    // 请求所属的copyset，brpcDone_调用之后request_已经失效，这里单独保存
+    uint64_t qosCopysetId_ = 0;
+};
+
+// 批量读写请求的闭包，作为每个子请求的done传入，每个子请求返回时调用一次，
+// 所有子请求都返回之后把读到的数据按顺序拼接到rpc的attachment中再返回rpc
+class BatchChunkClosure : public google::protobuf::Closure {
+ public:
+    BatchChunkClosure(brpc::Controller *cntl,
+                      const BatchChunkRequest *request,
+                      BatchChunkResponse *response,
+                      google::protobuf::Closure *done);
+
+    ~BatchChunkClosure() = default;
+
+    /**
+     * 获取子请求使用的controller，写请求的数据放在其request attachment中，
+     * 读请求的数据由子请求放到其response attachment中
+     * @param index[in]: 子请求的序号
+     */
+    brpc::Controller *GetSubController(int index) {
+        return subCntls_[index].get();
+    }
+
+    /**
+     * 子请求返回时调用，最后一个子请求返回时返回整个rpc并析构自己
+     */
+    void Run() override;
+
+ private:
+    // rpc请求的controller
+    brpc::Controller *cntl_;
+    // rpc请求的response
+    BatchChunkResponse *response_;
+    // rpc请求回调
+    google::protobuf::Closure *brpcDone_;
+    // 每个子请求的controller
+    std::vector<std::unique_ptr<brpc::Controller>> subCntls_;
+    // 还未返回的子请求数量
+    std::atomic<int> remaining_;
 };
 
 }  // namespace chunkserver
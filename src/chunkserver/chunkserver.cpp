@@ -34,6 +34,7 @@
 #include "src/chunkserver/chunkserver_service.h"
 #include "src/chunkserver/copyset_service.h"
 #include "src/chunkserver/chunk_service.h"
+#include "src/chunkserver/dmclock_scheduler.h"
 #include "src/chunkserver/braft_cli_service.h"
 #include "src/chunkserver/braft_cli_service2.h"
 #include "src/chunkserver/chunkserver_helper.h"
@@ -42,6 +43,7 @@
 #include "src/chunkserver/raftsnapshot/curve_file_service.h"
 #include "src/chunkserver/raftsnapshot/curve_snapshot_storage.h"
 #include "src/chunkserver/raftlog/curve_segment_log_storage.h"
+#include "src/chunkserver/raftlog/shared_wal_log_storage.h"
 #include "src/common/curve_version.h"
 
 using ::curve::fs::LocalFileSystem;
@@ -75,6 +77,7 @@ DEFINE_string(walFilePoolMetaPath, "./walfilepool.meta",
                                     "WAL filepool meta path");
 
 const char* kProtocalCurve = "curve";
+const char* kProtocalCurveWal = "curvewal";
 
 namespace curve {
 namespace chunkserver {
@@ -83,6 +86,7 @@ int ChunkServer::Run(int argc, char** argv) {
     gflags::ParseCommandLineFlags(&argc, &argv, true);
 
     RegisterCurveSegmentLogStorageOrDie();
+    RegisterSharedWalLogStorageOrDie();
 
     // ==========================加载配置项===============================//
     LOG(INFO) << "Loading Configuration.";
@@ -127,11 +131,16 @@ int ChunkServer::Run(int argc, char** argv) {
         << "Failed to initialize concurrentapply module!";
 
     // 初始化本地文件系统
-    std::shared_ptr<LocalFileSystem> fs(
-        LocalFsFactory::CreateFs(FileSystemType::EXT4, ""));
+    bool enableIoUring = false;
+    LOG_IF(FATAL, !conf.GetBoolValue("fs.enable_io_uring", &enableIoUring));
+    std::shared_ptr<LocalFileSystem> fs(LocalFsFactory::CreateFs(
+        enableIoUring ? FileSystemType::EXT4_URING : FileSystemType::EXT4,
+        ""));
     LocalFileSystemOption lfsOption;
     LOG_IF(FATAL, !conf.GetBoolValue(
         "fs.enable_renameat2", &lfsOption.enableRenameat2));
+    LOG_IF(FATAL, !conf.GetUInt32Value(
+        "fs.io_uring_queue_depth", &lfsOption.uringQueueDepth));
     LOG_IF(FATAL, 0 != fs->Init(lfsOption))
         << "Failed to initialize local filesystem module!";
 
@@ -165,6 +174,12 @@ int ChunkServer::Run(int argc, char** argv) {
             walFilePool = chunkfilePool;
             LOG(INFO) << "initialize to use chunkfilePool as walpool success.";
         }
+    } else if (raftLogProtocol == kProtocalCurveWal) {
+        SharedWalOptions sharedWalOptions;
+        InitSharedWalOptions(&conf, &sharedWalOptions);
+        LOG_IF(FATAL, SharedWal::GetInstance()->Init(sharedWalOptions) != 0)
+            << "Failed to init shared wal";
+        LOG(INFO) << "initialize shared wal success.";
     }
 
     // 远端拷贝管理模块选项
@@ -225,8 +240,15 @@ int ChunkServer::Run(int argc, char** argv) {
     copysetNodeOptions.concurrentapply = &concurrentapply;
     copysetNodeOptions.chunkFilePool = chunkfilePool;
     copysetNodeOptions.walFilePool = walFilePool;
+    copysetNodeOptions.pageCache = InitPageCache(&conf);
     copysetNodeOptions.localFileSystem = fs;
     copysetNodeOptions.trash = trash_;
+    // lease read依赖braft的leader lease
+    if (copysetNodeOptions.enableLeaseRead) {
+        LOG_IF(FATAL, google::SetCommandLineOption(
+            "raft_enable_leader_lease", "true").empty())
+            << "Failed to enable raft leader lease.";
+    }
     if (nullptr != walFilePool) {
         FilePoolOptions poolOpt = walFilePool->GetFilePoolOpt();
         uint32_t maxWalSegmentSize = poolOpt.fileSize + poolOpt.metaPageSize;
@@ -287,6 +309,16 @@ int ChunkServer::Run(int argc, char** argv) {
     // 监控部分模块的metric指标
     metric->MonitorTrash(trash_.get());
     metric->MonitorChunkFilePool(chunkfilePool.get());
+    // 前台写请求延时过高时，放慢chunk清理
+    IOMetricPtr writeMetric = metric->GetIOMetric(CSIOMetricType::WRITE_CHUNK);
+    if (nullptr != writeMetric) {
+        chunkfilePool->SetLatencyProbe([writeMetric]() -> uint64_t {
+            return writeMetric->latencyRecorder_.latency();
+        });
+    }
+    if (nullptr != copysetNodeOptions.pageCache) {
+        metric->MonitorPageCache(copysetNodeOptions.pageCache.get());
+    }
     if (raftLogProtocol == kProtocalCurve && !useChunkFilePoolAsWalPool) {
         metric->MonitorWalFilePool(walFilePool.get());
     }
@@ -306,19 +338,26 @@ int ChunkServer::Run(int argc, char** argv) {
     CHECK(0 == ret) << "Fail to add CopysetService";
 
     // inflight throttle
-    int maxInflight;
-    LOG_IF(FATAL,
-           !conf.GetIntValue("copyset.max_inflight_requests",
-                             &maxInflight));
+    InflightThrottleOptions inflightThrottleOptions;
+    InitInflightThrottleOptions(&conf, &inflightThrottleOptions);
     std::shared_ptr<InflightThrottle> inflightThrottle
-        = std::make_shared<InflightThrottle>(maxInflight);
+        = std::make_shared<InflightThrottle>(inflightThrottleOptions);
     CHECK(nullptr != inflightThrottle) << "new inflight throttle failed";
+    metric->MonitorInflightThrottle(inflightThrottle.get());
+
+    // qos scheduler
+    std::shared_ptr<DmClockScheduler> qosScheduler = InitQosScheduler(&conf);
+    if (nullptr != qosScheduler) {
+        LOG_IF(FATAL, qosScheduler->Start() != 0)
+            << "Failed to start qos scheduler.";
+    }
 
     // chunk service
     ChunkServiceOptions chunkServiceOptions;
     chunkServiceOptions.copysetNodeManager = copysetNodeManager_;
     chunkServiceOptions.cloneManager = &cloneManager_;
     chunkServiceOptions.inflightThrottle = inflightThrottle;
+    chunkServiceOptions.qosScheduler = qosScheduler;
     ChunkServiceImpl chunkService(chunkServiceOptions);
     ret = server.AddService(&chunkService,
                         brpc::SERVER_DOESNT_OWN_SERVICE);
@@ -414,6 +453,8 @@ int ChunkServer::Run(int argc, char** argv) {
         << "Failed to start scan manager.";
     LOG_IF(FATAL, !chunkfilePool->StartCleaning())
         << "Failed to start file pool clean worker.";
+    LOG_IF(FATAL, !chunkfilePool->StartAllocating())
+        << "Failed to start file pool allocate worker.";
 
     // =======================等待进程退出==================================//
     while (!brpc::IsAskedToQuit()) {
@@ -424,6 +465,10 @@ int ChunkServer::Run(int argc, char** argv) {
         externalServer.Join();
     }
     server.Stop(0);
+    // 排队中的请求要在server.Join之前下发，否则Join会一直等待
+    if (nullptr != qosScheduler) {
+        qosScheduler->Stop();
+    }
     server.Join();
 
     LOG(INFO) << "ChunkServer is going to quit.";
@@ -439,6 +484,9 @@ int ChunkServer::Run(int argc, char** argv) {
         << "Failed to shutdown clone copyer.";
     LOG_IF(ERROR, trash_->Fini() != 0)
         << "Failed to shutdown trash.";
+    SharedWal::GetInstance()->Fini();
+    LOG_IF(ERROR, !chunkfilePool->StopAllocating())
+        << "Failed to shutdown file pool allocate worker.";
     LOG_IF(ERROR, !chunkfilePool->StopCleaning())
         << "Failed to shutdown file pool clean worker.";
     concurrentapply.Stop();
@@ -484,6 +532,16 @@ void ChunkServer::InitChunkFilePoolOptions(
             &chunkFilePoolOptions->bytesPerWrite));
         LOG_IF(FATAL, !conf->GetUInt32Value("chunkfilepool.clean.throttle_iops",
             &chunkFilePoolOptions->iops4clean));
+        LOG_IF(FATAL, !conf->GetBoolValue("chunkfilepool.clean.zeroing_offload",
+            &chunkFilePoolOptions->zeroingOffload));
+        LOG_IF(FATAL, !conf->GetUInt32Value(
+            "chunkfilepool.clean.latency_threshold_us",
+            &chunkFilePoolOptions->cleanLatencyThresholdUs));
+        LOG_IF(FATAL, !conf->GetBoolValue(
+            "chunkfilepool.allocate_in_background",
+            &chunkFilePoolOptions->allocateInBackground));
+        LOG_IF(FATAL, !conf->GetUInt32Value("chunkfilepool.allocate_percent",
+            &chunkFilePoolOptions->allocatePercent));
 
         if (0 == chunkFilePoolOptions->bytesPerWrite
             || chunkFilePoolOptions->bytesPerWrite > 1 * 1024 * 1024
@@ -505,6 +563,14 @@ void ChunkServer::InitConcurrentApplyOptions(common::Configuration *conf,
         "rconcurrentapply.queuedepth", &concurrentApplyOptions->rqueuedepth));
     LOG_IF(FATAL, !conf->GetIntValue(
         "wconcurrentapply.queuedepth", &concurrentApplyOptions->wqueuedepth));
+    LOG_IF(FATAL, !conf->GetBoolValue(
+        "wconcurrentapply.async", &concurrentApplyOptions->wasync));
+    LOG_IF(FATAL, !conf->GetIntValue(
+        "wconcurrentapply.async_threads",
+        &concurrentApplyOptions->wasyncthreads));
+    LOG_IF(FATAL, !conf->GetIntValue(
+        "wconcurrentapply.merge_max_bytes",
+        &concurrentApplyOptions->wmergemaxbytes));
 }
 
 void ChunkServer::InitWalFilePoolOptions(
@@ -535,6 +601,16 @@ void ChunkServer::InitWalFilePoolOptions(
     }
 }
 
+void ChunkServer::InitSharedWalOptions(
+    common::Configuration *conf, SharedWalOptions *sharedWalOptions) {
+    LOG_IF(FATAL, !conf->GetStringValue("walshared.dir",
+        &sharedWalOptions->dir));
+    LOG_IF(FATAL, !conf->GetUInt64Value("walshared.segment_size",
+        &sharedWalOptions->segmentSize));
+    LOG_IF(FATAL, !conf->GetUInt32Value("walshared.reclaim_interval_s",
+        &sharedWalOptions->reclaimIntervalS));
+}
+
 void ChunkServer::InitCopysetNodeOptions(
     common::Configuration *conf, CopysetNodeOptions *copysetNodeOptions) {
     LOG_IF(FATAL, !conf->GetStringValue("global.ip", &copysetNodeOptions->ip));
@@ -565,6 +641,14 @@ void ChunkServer::InitCopysetNodeOptions(
         &copysetNodeOptions->maxChunkSize));
     LOG_IF(FATAL, !conf->GetUInt32Value("global.location_limit",
         &copysetNodeOptions->locationLimit));
+    LOG_IF(FATAL, !conf->GetUInt32Value("copyset.clone_meta_flush_pages",
+        &copysetNodeOptions->cloneMetaFlushPages));
+    LOG_IF(FATAL, !conf->GetBoolValue("copyset.enable_lease_read",
+        &copysetNodeOptions->enableLeaseRead));
+    LOG_IF(FATAL, !conf->GetBoolValue("copyset.enable_chunk_index",
+        &copysetNodeOptions->enableChunkIndex));
+    LOG_IF(FATAL, !conf->GetBoolValue("copyset.enable_page_checksum",
+        &copysetNodeOptions->enablePageChecksum));
     LOG_IF(FATAL, !conf->GetUInt32Value("global.meta_page_size",
         &copysetNodeOptions->pageSize));
     LOG_IF(FATAL, !conf->GetUInt32Value("copyset.load_concurrency",
@@ -577,6 +661,71 @@ void ChunkServer::InitCopysetNodeOptions(
         &copysetNodeOptions->checkLoadMarginIntervalMs));
 }
 
+std::shared_ptr<CSPageCache> ChunkServer::InitPageCache(
+    common::Configuration *conf) {
+    uint32_t capacityMb = 0;
+    PageCacheOptions pageCacheOptions;
+    LOG_IF(FATAL, !conf->GetUInt32Value("pagecache.capacity_mb",
+        &capacityMb));
+    LOG_IF(FATAL, !conf->GetUInt32Value("pagecache.shard_num",
+        &pageCacheOptions.shardNum));
+    LOG_IF(FATAL, !conf->GetUInt32Value("global.meta_page_size",
+        &pageCacheOptions.pageSize));
+    // 容量为0表示不开启页缓存
+    if (capacityMb == 0) {
+        return nullptr;
+    }
+    pageCacheOptions.capacity =
+        static_cast<uint64_t>(capacityMb) * 1024 * 1024;
+    LOG(INFO) << "Chunk page cache enabled, capacity: " << capacityMb
+              << "MB, shard num: " << pageCacheOptions.shardNum;
+    return std::make_shared<CSPageCache>(pageCacheOptions);
+}
+
+void ChunkServer::InitInflightThrottleOptions(
+    common::Configuration *conf, InflightThrottleOptions *options) {
+    int maxInflight;
+    int minInflight;
+    LOG_IF(FATAL, !conf->GetIntValue("copyset.max_inflight_requests",
+        &maxInflight));
+    LOG_IF(FATAL, !conf->GetBoolValue("copyset.enable_adaptive_inflight",
+        &options->enableAdaptive));
+    LOG_IF(FATAL, !conf->GetIntValue("copyset.min_inflight_requests",
+        &minInflight));
+    LOG_IF(FATAL, !conf->GetDoubleValue("copyset.inflight_latency_tolerance",
+        &options->latencyTolerance));
+    options->maxInflight = maxInflight;
+    options->minInflight = minInflight;
+}
+
+std::shared_ptr<DmClockScheduler> ChunkServer::InitQosScheduler(
+    common::Configuration *conf) {
+    bool enable = false;
+    DmClockOptions dmclockOptions;
+    LOG_IF(FATAL, !conf->GetBoolValue("qos.enable", &enable));
+    LOG_IF(FATAL, !conf->GetUInt32Value("qos.reservation_iops",
+        &dmclockOptions.reservation));
+    LOG_IF(FATAL, !conf->GetUInt32Value("qos.weight",
+        &dmclockOptions.weight));
+    LOG_IF(FATAL, !conf->GetUInt32Value("qos.limit_iops",
+        &dmclockOptions.limit));
+    LOG_IF(FATAL, !conf->GetUInt32Value("qos.max_inflight_requests",
+        &dmclockOptions.maxInflight));
+    LOG_IF(FATAL, !conf->GetUInt32Value("qos.max_inflight_per_copyset",
+        &dmclockOptions.maxInflightPerCopyset));
+    if (!enable) {
+        return nullptr;
+    }
+    LOG(INFO) << "Chunk request qos enabled, reservation: "
+              << dmclockOptions.reservation
+              << ", weight: " << dmclockOptions.weight
+              << ", limit: " << dmclockOptions.limit
+              << ", max inflight: " << dmclockOptions.maxInflight
+              << ", max inflight per copyset: "
+              << dmclockOptions.maxInflightPerCopyset;
+    return std::make_shared<DmClockScheduler>(dmclockOptions);
+}
+
 void ChunkServer::InitCopyerOptions(
     common::Configuration *conf, CopyerOptions *copyerOptions) {
     LOG_IF(FATAL, !conf->GetStringValue("curve.root_username",
@@ -35,6 +35,9 @@
 #include "src/chunkserver/chunkserver_metrics.h"
 #include "src/chunkserver/concurrent_apply/concurrent_apply.h"
 #include "src/chunkserver/scan_service.h"
+#include "src/chunkserver/raftlog/shared_wal.h"
+#include "src/chunkserver/datastore/page_cache.h"
+#include "src/chunkserver/dmclock_scheduler.h"
 
 using ::curve::chunkserver::concurrent::ConcurrentApplyOption;
 
@@ -64,12 +67,23 @@ class ChunkServer {
     void InitWalFilePoolOptions(common::Configuration *conf,
         FilePoolOptions *walPoolOption);
 
+    void InitSharedWalOptions(common::Configuration *conf,
+        SharedWalOptions *sharedWalOptions);
+
     void InitConcurrentApplyOptions(common::Configuration *conf,
         ConcurrentApplyOption *concurrentApplyOption);
 
     void InitCopysetNodeOptions(common::Configuration *conf,
         CopysetNodeOptions *copysetNodeOptions);
 
+    std::shared_ptr<CSPageCache> InitPageCache(common::Configuration *conf);
+
+    void InitInflightThrottleOptions(common::Configuration *conf,
+        InflightThrottleOptions *options);
+
+    std::shared_ptr<DmClockScheduler> InitQosScheduler(
+        common::Configuration *conf);
+
     void InitCopyerOptions(common::Configuration *conf,
         CopyerOptions *copyerOptions);
 
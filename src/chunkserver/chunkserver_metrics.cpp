@@ -207,12 +207,15 @@ void CSCopysetMetric::MonitorDataStore(CSDataStore* datastore) {
     std::string chunkCountPrefix = Prefix() + "_chunk_count";
     std::string snapshotCountPrefix = Prefix() + "snapshot_count";
     std::string cloneChunkCountPrefix = Prefix() + "_clonechunk_count";
+    std::string crcErrorCountPrefix = Prefix() + "_crc_error_count";
     chunkCount_ = std::make_shared<bvar::PassiveStatus<uint32_t>>(
         chunkCountPrefix, GetDatastoreChunkCountFunc, datastore);
     snapshotCount_ = std::make_shared<bvar::PassiveStatus<uint32_t>>(
         snapshotCountPrefix, GetDatastoreSnapshotCountFunc, datastore);
     cloneChunkCount_ = std::make_shared<bvar::PassiveStatus<uint32_t>>(
         cloneChunkCountPrefix, GetDatastoreCloneChunkCountFunc, datastore);
+    crcErrorCount_ = std::make_shared<bvar::PassiveStatus<uint32_t>>(
+        crcErrorCountPrefix, GetDatastoreCrcErrorCountFunc, datastore);
 }
 
 void CSCopysetMetric::MonitorCurveSegmentLogStorage(
@@ -225,13 +228,20 @@ void CSCopysetMetric::MonitorCurveSegmentLogStorage(
 ChunkServerMetric::ChunkServerMetric()
     : hasInited_(false)
     , leaderCount_(nullptr)
+    , leaseReadCount_(nullptr)
+    , proposeReadCount_(nullptr)
     , chunkLeft_(nullptr)
     , walSegmentLeft_(nullptr)
     , chunkTrashed_(nullptr)
+    , pageCacheHit_(nullptr)
+    , pageCacheMiss_(nullptr)
+    , pageCacheBytes_(nullptr)
     , chunkCount_(nullptr)
     , snapshotCount_(nullptr)
     , cloneChunkCount_(nullptr)
-    , walSegmentCount_(nullptr) {}
+    , walSegmentCount_(nullptr)
+    , walCopyBytes_(nullptr)
+    , writeCopyBytesPerRequest_(nullptr) {}
 
 ChunkServerMetric* ChunkServerMetric::self_ = nullptr;
 
@@ -268,6 +278,13 @@ int ChunkServerMetric::Init(const ChunkServerMetricOptions& option) {
     std::string leaderCountPrefix = Prefix() + "_leader_count";
     leaderCount_ = std::make_shared<bvar::Adder<uint32_t>>(leaderCountPrefix);
 
+    std::string leaseReadPrefix = Prefix() + "_lease_read_count";
+    leaseReadCount_ = std::make_shared<bvar::Adder<uint64_t>>(leaseReadPrefix);
+
+    std::string proposeReadPrefix = Prefix() + "_propose_read_count";
+    proposeReadCount_ =
+        std::make_shared<bvar::Adder<uint64_t>>(proposeReadPrefix);
+
     std::string chunkCountPrefix = Prefix() + "_chunk_count";
     chunkCount_ = std::make_shared<bvar::PassiveStatus<uint32_t>>(
         chunkCountPrefix, GetTotalChunkCountFunc, this);
@@ -276,6 +293,15 @@ int ChunkServerMetric::Init(const ChunkServerMetricOptions& option) {
     walSegmentCount_ = std::make_shared<bvar::PassiveStatus<uint32_t>>(
         walSegmentCountPrefix, GetTotalWalSegmentCountFunc, this);
 
+    std::string walCopyBytesPrefix = Prefix() + "_wal_memcpy_bytes";
+    walCopyBytes_ = std::make_shared<bvar::PassiveStatus<uint64_t>>(
+        walCopyBytesPrefix, GetWalCopyBytesFunc, nullptr);
+
+    std::string writeCopyBytesPrefix =
+        Prefix() + "_write_memcpy_bytes_per_request";
+    writeCopyBytesPerRequest_ = std::make_shared<bvar::PassiveStatus<double>>(
+        writeCopyBytesPrefix, GetWriteCopyBytesPerRequestFunc, this);
+
     std::string snapshotCountPrefix = Prefix() + "_snapshot_count";
     snapshotCount_ = std::make_shared<bvar::PassiveStatus<uint32_t>>(
         snapshotCountPrefix, GetTotalSnapshotCountFunc, this);
@@ -293,13 +319,20 @@ int ChunkServerMetric::Fini() {
     // 释放资源，从而将暴露的metric从全局的map中移除
     ioMetrics_.Fini();
     leaderCount_ = nullptr;
+    leaseReadCount_ = nullptr;
+    proposeReadCount_ = nullptr;
     chunkLeft_ = nullptr;
     walSegmentLeft_ = nullptr;
     chunkTrashed_ = nullptr;
+    pageCacheHit_ = nullptr;
+    pageCacheMiss_ = nullptr;
+    pageCacheBytes_ = nullptr;
     chunkCount_ = nullptr;
     snapshotCount_ = nullptr;
     cloneChunkCount_ = nullptr;
     walSegmentCount_ = nullptr;
+    walCopyBytes_ = nullptr;
+    writeCopyBytesPerRequest_ = nullptr;
     copysetMetricMap_.Clear();
     hasInited_ = false;
     return 0;
@@ -414,6 +447,36 @@ void ChunkServerMetric::MonitorTrash(Trash* trash) {
         chunkTrashedPrefix, GetChunkTrashedFunc, trash);
 }
 
+void ChunkServerMetric::MonitorPageCache(CSPageCache* pageCache) {
+    if (!option_.collectMetric) {
+        return;
+    }
+
+    std::string pageCacheHitPrefix = Prefix() + "_page_cache_hit";
+    pageCacheHit_ = std::make_shared<bvar::PassiveStatus<uint64_t>>(
+        pageCacheHitPrefix, GetPageCacheHitFunc, pageCache);
+    std::string pageCacheMissPrefix = Prefix() + "_page_cache_miss";
+    pageCacheMiss_ = std::make_shared<bvar::PassiveStatus<uint64_t>>(
+        pageCacheMissPrefix, GetPageCacheMissFunc, pageCache);
+    std::string pageCacheBytesPrefix = Prefix() + "_page_cache_bytes";
+    pageCacheBytes_ = std::make_shared<bvar::PassiveStatus<uint64_t>>(
+        pageCacheBytesPrefix, GetPageCacheBytesFunc, pageCache);
+}
+
+void ChunkServerMetric::MonitorInflightThrottle(
+    InflightThrottle* inflightThrottle) {
+    if (!option_.collectMetric) {
+        return;
+    }
+
+    std::string inflightLimitPrefix = Prefix() + "_inflight_limit";
+    inflightLimit_ = std::make_shared<bvar::PassiveStatus<uint64_t>>(
+        inflightLimitPrefix, GetInflightLimitFunc, inflightThrottle);
+    std::string inflightShedPrefix = Prefix() + "_inflight_shed_count";
+    inflightShedCount_ = std::make_shared<bvar::PassiveStatus<uint64_t>>(
+        inflightShedPrefix, GetInflightShedCountFunc, inflightThrottle);
+}
+
 void ChunkServerMetric::IncreaseLeaderCount() {
     if (!option_.collectMetric) {
         return;
@@ -430,6 +493,22 @@ void ChunkServerMetric::DecreaseLeaderCount() {
     *leaderCount_ << -1;
 }
 
+void ChunkServerMetric::IncreaseLeaseReadCount() {
+    if (!option_.collectMetric) {
+        return;
+    }
+
+    *leaseReadCount_ << 1;
+}
+
+void ChunkServerMetric::IncreaseProposeReadCount() {
+    if (!option_.collectMetric) {
+        return;
+    }
+
+    *proposeReadCount_ << 1;
+}
+
 void ChunkServerMetric::ExposeConfigMetric(common::Configuration* conf) {
     if (!option_.collectMetric) {
         return;
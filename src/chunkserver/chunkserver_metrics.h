@@ -50,6 +50,8 @@ class FilePool;
 class CSDataStore;
 class CurveSegmentLogStorage;
 class Trash;
+class CSPageCache;
+class InflightThrottle;
 
 template <typename Tp>
 using PassiveStatusPtr = std::shared_ptr<bvar::PassiveStatus<Tp>>;
@@ -186,6 +188,7 @@ class CSCopysetMetric {
         , chunkCount_(nullptr)
         , snapshotCount_(nullptr)
         , cloneChunkCount_(nullptr)
+        , crcErrorCount_(nullptr)
         , walSegmentCount_(nullptr) {}
 
     ~CSCopysetMetric() {}
@@ -270,6 +273,13 @@ class CSCopysetMetric {
         return cloneChunkCount_->get_value();
     }
 
+    const uint32_t GetCrcErrorCount() const {
+        if (crcErrorCount_ == nullptr) {
+            return 0;
+        }
+        return crcErrorCount_->get_value();
+    }
+
  private:
     inline std::string Prefix() {
         return "copyset_"
@@ -291,6 +301,8 @@ class CSCopysetMetric {
     PassiveStatusPtr<uint32_t> snapshotCount_;
     // copyset上的 clone chunk 的数量
     PassiveStatusPtr<uint32_t> cloneChunkCount_;
+    // copyset上读数据时 page 校验失败的次数
+    PassiveStatusPtr<uint32_t> crcErrorCount_;
     // copyset上的IO类型的metric统计
     CSIOMetric ioMetrics_;
 };
@@ -456,6 +468,18 @@ class ChunkServerMetric : public Uncopyable {
      */
     void MonitorTrash(Trash* trash);
 
+    /**
+     * 监视chunk数据页缓存，包括命中次数、未命中次数和占用的内存
+     * @param pageCache: 页缓存的对象指针
+     */
+    void MonitorPageCache(CSPageCache* pageCache);
+
+    /**
+     * 监视inflight流控，包括当前的inflight上限和因过载被拒绝的请求数
+     * @param inflightThrottle: inflight流控的对象指针
+     */
+    void MonitorInflightThrottle(InflightThrottle* inflightThrottle);
+
     /**
      * 增加 leader count 计数
      */
@@ -466,6 +490,16 @@ class ChunkServerMetric : public Uncopyable {
      */
     void DecreaseLeaderCount();
 
+    /**
+     * 增加leader持有lease直接读本地数据的读请求计数
+     */
+    void IncreaseLeaseReadCount();
+
+    /**
+     * 增加通过raft协议的读请求计数
+     */
+    void IncreaseProposeReadCount();
+
     /**
      * 更新配置项数据
      * @param conf: 配置内容
@@ -495,6 +529,18 @@ class ChunkServerMetric : public Uncopyable {
         return leaderCount_->get_value();
     }
 
+    const uint64_t GetLeaseReadCount() const {
+        if (leaseReadCount_ == nullptr)
+            return 0;
+        return leaseReadCount_->get_value();
+    }
+
+    const uint64_t GetProposeReadCount() const {
+        if (proposeReadCount_ == nullptr)
+            return 0;
+        return proposeReadCount_->get_value();
+    }
+
     const uint32_t GetTotalChunkCount() {
         if (chunkCount_ == nullptr)
             return 0;
@@ -551,16 +597,34 @@ class ChunkServerMetric : public Uncopyable {
     ChunkServerMetricOptions option_;
     // leader 的数量
     AdderPtr<uint32_t> leaderCount_;
+    // leader持有lease直接读本地数据的读请求数
+    AdderPtr<uint64_t> leaseReadCount_;
+    // 通过raft协议的读请求数
+    AdderPtr<uint64_t> proposeReadCount_;
     // chunkfilepool  中剩余的 chunk 的数量
     PassiveStatusPtr<uint32_t> chunkLeft_;
     // walfilepool  中剩余的 wal segment 的数量
     PassiveStatusPtr<uint32_t> walSegmentLeft_;
     // trash 中的 chunk 的数量
     PassiveStatusPtr<uint32_t> chunkTrashed_;
+    // 页缓存命中的读请求数
+    PassiveStatusPtr<uint64_t> pageCacheHit_;
+    // 页缓存未命中的读请求数
+    PassiveStatusPtr<uint64_t> pageCacheMiss_;
+    // 页缓存占用的内存
+    PassiveStatusPtr<uint64_t> pageCacheBytes_;
+    // 当前的inflight上限
+    PassiveStatusPtr<uint64_t> inflightLimit_;
+    // 因过载被拒绝的请求数
+    PassiveStatusPtr<uint64_t> inflightShedCount_;
     // chunkserver上的 chunk 的数量
     PassiveStatusPtr<uint32_t> chunkCount_;
     // The total number of WAL segment in chunkserver
     PassiveStatusPtr<uint32_t> walSegmentCount_;
+    // 写路径上用户态拷贝的数据量，目前只有wal direct write会拷贝
+    PassiveStatusPtr<uint64_t> walCopyBytes_;
+    // 平均每个写请求拷贝的数据量
+    PassiveStatusPtr<double> writeCopyBytesPerRequest_;
     // chunkserver上的 快照文件 的数量
     PassiveStatusPtr<uint32_t> snapshotCount_;
     // chunkserver上的 clone chunk 的数量
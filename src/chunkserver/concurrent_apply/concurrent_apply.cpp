@@ -43,9 +43,20 @@ bool ConcurrentApplyModule::Init(const ConcurrentApplyOption &opt) {
     }
 
     start_ = true;
-    cond_.Reset(opt.rconcurrentsize + opt.wconcurrentsize);
+    cond_.Reset(opt.rconcurrentsize +
+                (wasync_ ? wasyncthreads_ : opt.wconcurrentsize));
     InitThreadPool(ThreadPoolType::READ, rconcurrentsize_, rqueuedepth_);
     InitThreadPool(ThreadPoolType::WRITE, wconcurrentsize_, wqueuedepth_);
+    if (wasync_) {
+        for (int i = 0; i < wasyncthreads_; i++) {
+            asyncQueues_.emplace_back(
+                new MPSCRingQueue<ApplyTask>(wqueuedepth_));
+        }
+        for (int i = 0; i < wasyncthreads_; i++) {
+            asyncThreads_.emplace_back(
+                &ConcurrentApplyModule::RunAsync, this, i);
+        }
+    }
 
     if (!cond_.WaitFor(5000)) {
         LOG(ERROR) << "init concurrent module's threads fail";
@@ -68,10 +79,20 @@ bool ConcurrentApplyModule::checkOptAndInit(
         return false;
     }
 
+    if (opt.wasync && opt.wasyncthreads <= 0) {
+        LOG(INFO) << "init concurrent module fail, wasyncthreads must >0"
+            << " when wasync is enabled"
+            << ", wasyncthreads=" << opt.wasyncthreads;
+        return false;
+    }
+
     wconcurrentsize_ = opt.wconcurrentsize;
     wqueuedepth_ = opt.wqueuedepth;
     rconcurrentsize_ = opt.rconcurrentsize;
     rqueuedepth_ = opt.rqueuedepth;
+    wasync_ = opt.wasync;
+    wasyncthreads_ = opt.wasync ? opt.wasyncthreads : 0;
+    wmergemaxbytes_ = opt.wmergemaxbytes > 0 ? opt.wmergemaxbytes : 0;
 
     return true;
 }
@@ -102,8 +123,11 @@ void ConcurrentApplyModule::InitThreadPool(
             break;
 
         case ThreadPoolType::WRITE:
-            wapplyMap_[i]->th =
-                std::thread(&ConcurrentApplyModule::Run, this, type, i);
+            // 异步写模式下请求直接分发给io线程，不需要写线程
+            if (!wasync_) {
+                wapplyMap_[i]->th =
+                    std::thread(&ConcurrentApplyModule::Run, this, type, i);
+            }
             break;
         }
     }
@@ -111,16 +135,70 @@ void ConcurrentApplyModule::InitThreadPool(
 
 void ConcurrentApplyModule::Run(ThreadPoolType type, int index) {
     cond_.Signal();
+    ApplyTask task;
     while (start_) {
         switch (type) {
         case ThreadPoolType::READ:
-            rapplyMap_[index]->tq.Pop()();
+            rapplyMap_[index]->tq.Pop(&task);
             break;
 
         case ThreadPoolType::WRITE:
-            wapplyMap_[index]->tq.Pop()();
+            wapplyMap_[index]->tq.Pop(&task);
             break;
         }
+        task();
+        task.Reset();
+    }
+}
+
+void ConcurrentApplyModule::RunAsync(int index) {
+    cond_.Signal();
+    ApplyTask task;
+    while (start_) {
+        asyncQueues_[index]->Pop(&task);
+        task();
+        task.Reset();
+    }
+}
+
+void ConcurrentApplyModule::Dispatch(int index, uint64_t key,
+                                     ApplyTask* task) {
+    taskthread_t* shard = wapplyMap_[index];
+    {
+        std::lock_guard<std::mutex> lk(shard->asyncMtx);
+        uint64_t seq = shard->nextSeq++;
+        shard->pendingSeqs.insert(seq);
+        auto iter = shard->chunkTasks.find(key);
+        if (iter != shard->chunkTasks.end()) {
+            // 该chunk上有请求正在执行，排队保证同一chunk的请求顺序
+            iter->second.emplace_back(seq, std::move(*task));
+            return;
+        }
+        shard->chunkTasks[key].emplace_back(seq, std::move(*task));
+    }
+    asyncQueues_[Hash(key, wasyncthreads_)]->Push(ApplyTask(
+        std::bind(&ConcurrentApplyModule::RunChunkTasks, this, index, key)));
+}
+
+void ConcurrentApplyModule::RunChunkTasks(int index, uint64_t key) {
+    taskthread_t* shard = wapplyMap_[index];
+    std::unique_lock<std::mutex> lk(shard->asyncMtx);
+    while (true) {
+        auto iter = shard->chunkTasks.find(key);
+        if (iter->second.empty()) {
+            shard->chunkTasks.erase(iter);
+            return;
+        }
+        uint64_t seq = iter->second.front().first;
+        ApplyTask task(std::move(iter->second.front().second));
+        iter->second.pop_front();
+        lk.unlock();
+
+        task();
+
+        lk.lock();
+        shard->pendingSeqs.erase(seq);
+        shard->asyncCv.notify_all();
     }
 }
 
@@ -129,33 +207,64 @@ void ConcurrentApplyModule::Stop() {
     start_ = false;
     auto wakeup = []() {};
     for (auto iter : rapplyMap_) {
-        iter.second->tq.Push(wakeup);
+        iter.second->tq.Push(ApplyTask(wakeup));
         iter.second->th.join();
         delete iter.second;
     }
     rapplyMap_.clear();
 
     for (auto iter : wapplyMap_) {
-        iter.second->tq.Push(wakeup);
-        iter.second->th.join();
+        if (iter.second->th.joinable()) {
+            iter.second->tq.Push(ApplyTask(wakeup));
+            iter.second->th.join();
+        }
         delete iter.second;
     }
     wapplyMap_.clear();
 
+    for (size_t i = 0; i < asyncThreads_.size(); i++) {
+        asyncQueues_[i]->Push(ApplyTask(wakeup));
+    }
+    for (auto& th : asyncThreads_) {
+        th.join();
+    }
+    asyncThreads_.clear();
+    asyncQueues_.clear();
+
     LOG(INFO) << "stop ConcurrentApplyModule ok.";
 }
 
 void ConcurrentApplyModule::Flush() {
-    CountDownEvent event(wconcurrentsize_);
-    auto flushtask = [&event]() {
-        event.Signal();
-    };
+    if (!wasync_) {
+        CountDownEvent event(wconcurrentsize_);
+        auto flushtask = [&event]() {
+            event.Signal();
+        };
+        for (int i = 0; i < wconcurrentsize_; i++) {
+            wapplyMap_[i]->tq.Push(ApplyTask(flushtask));
+        }
+        event.Wait();
+        return;
+    }
 
+    // 异步写模式下，记录当前已分发请求的序号，等待序号之前的请求全部
+    // 执行完成
+    std::vector<uint64_t> barriers(wconcurrentsize_, 0);
     for (int i = 0; i < wconcurrentsize_; i++) {
-        wapplyMap_[i]->tq.Push(flushtask);
+        taskthread_t* shard = wapplyMap_[i];
+        std::lock_guard<std::mutex> lk(shard->asyncMtx);
+        barriers[i] = shard->nextSeq;
     }
 
-    event.Wait();
+    for (int i = 0; i < wconcurrentsize_; i++) {
+        taskthread_t* shard = wapplyMap_[i];
+        uint64_t barrier = barriers[i];
+        std::unique_lock<std::mutex> lk(shard->asyncMtx);
+        shard->asyncCv.wait(lk, [shard, barrier]() {
+            return shard->pendingSeqs.empty() ||
+                   *shard->pendingSeqs.begin() >= barrier;
+        });
+    }
 }
 
 ThreadPoolType ConcurrentApplyModule::Schedule(CHUNK_OP_TYPE optype) {
@@ -26,19 +26,26 @@
 #include <glog/logging.h>
 #include <unistd.h>
 #include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <mutex>    // NOLINT
+#include <set>
 #include <thread>    // NOLINT
 #include <unordered_map>
 #include <utility>
+#include <vector>
 #include <condition_variable>    // NOLINT
 
-#include "src/common/concurrent/task_queue.h"
 #include "src/common/concurrent/count_down_event.h"
+#include "src/common/concurrent/inplace_task.h"
+#include "src/common/concurrent/mpsc_ring_queue.h"
 #include "proto/chunk.pb.h"
 #include "include/curve_compiler_specific.h"
 
-using curve::common::TaskQueue;
 using curve::common::CountDownEvent;
+using curve::common::InplaceTask;
+using curve::common::MPSCRingQueue;
 using curve::chunkserver::CHUNK_OP_TYPE;
 
 namespace curve {
@@ -50,10 +57,21 @@ struct ConcurrentApplyOption {
     int wqueuedepth;
     int rconcurrentsize;
     int rqueuedepth;
+    // 写请求异步apply：请求按chunk分发，由wasyncthreads个I/O线程执行，
+    // 同一chunk的请求保持顺序，不同chunk的请求可以并发下盘
+    bool wasync;
+    int wasyncthreads;
+    // 一批raft log中同一chunk上相邻或重叠的写请求合并后的最大字节数，
+    // 合并后只写一次数据和一次metapage，0表示不合并
+    int wmergemaxbytes;
 };
 
 enum class ThreadPoolType {READ, WRITE};
 
+// apply任务，OnApply/OnApplyFromLog绑定的参数在这个大小以内时不需要在
+// 堆上分配内存
+using ApplyTask = InplaceTask<256>;
+
 class CURVE_CACHELINE_ALIGNMENT ConcurrentApplyModule {
  public:
     ConcurrentApplyModule(): start_(false),
@@ -61,6 +79,9 @@ class CURVE_CACHELINE_ALIGNMENT ConcurrentApplyModule {
                              wconcurrentsize_(0),
                              rqueuedepth_(0),
                              wqueuedepth_(0),
+                             wasync_(false),
+                             wasyncthreads_(0),
+                             wmergemaxbytes_(0),
                              cond_(0) {}
     ~ConcurrentApplyModule() {}
 
@@ -70,6 +91,9 @@ class CURVE_CACHELINE_ALIGNMENT ConcurrentApplyModule {
      * @param[in] wqueuedepth: depth of write queue in ervery thread
      * @param[in] rconcurrentsizee: num of read threads
      * @param[in] wqueuedephth: depth of read queue in every thread
+     * @param[in] wasync: whether write tasks are executed asynchronously
+     * @param[in] wasyncthreads: num of io threads in async write mode
+     * @param[in] wmergemaxbytes: max bytes of coalesced writes, 0 disables
      */
     bool Init(const ConcurrentApplyOption &opt);
 
@@ -82,33 +106,86 @@ class CURVE_CACHELINE_ALIGNMENT ConcurrentApplyModule {
      */
     template<class F, class... Args>
     bool Push(uint64_t key, CHUNK_OP_TYPE optype, F&& f, Args&&... args) {
-        auto task = std::bind(std::forward<F>(f), std::forward<Args>(args)...);
-        switch (Schedule(optype)) {
-            case ThreadPoolType::READ:
-                rapplyMap_[Hash(key, rconcurrentsize_)]->tq.Push(task);
-                break;
-            case ThreadPoolType::WRITE:
-                wapplyMap_[Hash(key, wconcurrentsize_)]->tq.Push(task);
-                break;
-        }
+        ApplyTask task(
+            std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+        return PushTask(Schedule(optype), key, &task);
+    }
 
-        return true;
+    /**
+     * PushAfterWrites: task will be push to the write queue of key, so it is
+     * executed after all write tasks of the key pushed before it
+     * @param[in] key: used to hash task to specified queue
+     * @param[in] f: task
+     * @param[in] args: param to excute task
+     */
+    template<class F, class... Args>
+    bool PushAfterWrites(uint64_t key, F&& f, Args&&... args) {
+        ApplyTask task(
+            std::bind(std::forward<F>(f), std::forward<Args>(args)...));
+        return PushTask(ThreadPoolType::WRITE, key, &task);
     }
 
     /**
-     * Flush: finish all task in write threads
+     * Flush: finish all task in write threads, in async write mode
+     * wait for the tasks dispatched to io threads
      */
     void Flush();
 
     void Stop();
 
+    /**
+     * WriteMergeMaxBytes: max bytes of writes to the same chunk that can be
+     * coalesced in apply, 0 means coalescing is disabled
+     */
+    uint32_t WriteMergeMaxBytes() const {
+        return wmergemaxbytes_;
+    }
+
  private:
     bool checkOptAndInit(const ConcurrentApplyOption &option);
 
     void Run(ThreadPoolType type, int index);
 
+    // 异步写模式下io线程的执行循环
+    void RunAsync(int index);
+
+    /**
+     * 异步写模式下分发写请求，如果该chunk已有请求在执行，则排在其后，
+     * 否则交给io线程执行，task会被移走
+     */
+    void Dispatch(int index, uint64_t key, ApplyTask* task);
+
+    /**
+     * 在io线程上执行，依次执行该chunk上排队的请求，直到该chunk没有排队的请求
+     */
+    void RunChunkTasks(int index, uint64_t key);
+
     ThreadPoolType Schedule(CHUNK_OP_TYPE optype);
 
+    // 把task放入key对应的读或写队列，task会被移走
+    bool PushTask(ThreadPoolType type, uint64_t key, ApplyTask* task) {
+        switch (type) {
+            case ThreadPoolType::READ:
+                rapplyMap_[Hash(key, rconcurrentsize_)]->tq.Push(
+                    std::move(*task));
+                break;
+            case ThreadPoolType::WRITE:
+                if (wasync_) {
+                    // 写请求来自copyset的apply线程，lease读经
+                    // PushAfterWrites来自rpc线程；Dispatch在shard的
+                    // asyncMtx下分配序号并入队，同一chunk的请求按取得
+                    // 该锁的顺序执行，实际的写由I/O线程执行
+                    Dispatch(Hash(key, wconcurrentsize_), key, task);
+                } else {
+                    wapplyMap_[Hash(key, wconcurrentsize_)]->tq.Push(
+                        std::move(*task));
+                }
+                break;
+        }
+
+        return true;
+    }
+
     void InitThreadPool(ThreadPoolType type, int concorrent, int depth);
 
     int Hash(uint64_t key, int concurrent) {
@@ -119,8 +196,18 @@ class CURVE_CACHELINE_ALIGNMENT ConcurrentApplyModule {
     typedef uint8_t threadIndex;
     typedef struct taskthread {
         std::thread th;
-        TaskQueue tq;
-        taskthread(size_t capacity):tq(capacity) {}
+        // 生产者为raft的apply线程，消费者为本线程
+        MPSCRingQueue<ApplyTask> tq;
+        // 以下仅在异步写模式下使用，此时写线程不启动
+        std::mutex asyncMtx;
+        std::condition_variable asyncCv;
+        // chunk上排队等待执行的请求，key存在表示该chunk有请求正在执行
+        std::unordered_map<uint64_t,
+            std::deque<std::pair<uint64_t, ApplyTask>>> chunkTasks;
+        // 已分发但还未执行完成的请求序号
+        std::set<uint64_t> pendingSeqs;
+        uint64_t nextSeq;
+        taskthread(size_t capacity):tq(capacity), nextSeq(0) {}
         ~taskthread() = default;
     } taskthread_t;
 
@@ -129,7 +216,14 @@ class CURVE_CACHELINE_ALIGNMENT ConcurrentApplyModule {
     int rqueuedepth_;
     int wconcurrentsize_;
     int wqueuedepth_;
+    bool wasync_;
+    int wasyncthreads_;
+    uint32_t wmergemaxbytes_;
     CountDownEvent cond_;
+    // 每个io线程一个队列，chunk按key固定分给一个io线程，生产者为
+    // copyset的apply线程，与读写线程使用同样的无锁环形队列和ApplyTask
+    std::vector<std::unique_ptr<MPSCRingQueue<ApplyTask>>> asyncQueues_;
+    std::vector<std::thread> asyncThreads_;
     CURVE_CACHELINE_ALIGNMENT std::unordered_map<threadIndex, taskthread_t*> wapplyMap_; // NOLINT
     CURVE_CACHELINE_ALIGNMENT std::unordered_map<threadIndex, taskthread_t*> rapplyMap_;   // NOLINT
 };
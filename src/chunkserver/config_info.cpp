@@ -43,9 +43,14 @@ CopysetNodeOptions::CopysetNodeOptions()
       port(8200),
       maxChunkSize(16 * 1024 * 1024),
       pageSize(4096),
+      cloneMetaFlushPages(0),
+      enableLeaseRead(false),
+      enableChunkIndex(false),
+      enablePageChecksum(false),
       concurrentapply(nullptr),
       chunkFilePool(nullptr),
       walFilePool(nullptr),
+      pageCache(nullptr),
       localFileSystem(nullptr),
       snapshotThrottle(nullptr) {
 }
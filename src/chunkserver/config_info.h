@@ -39,8 +39,10 @@ using curve::fs::LocalFileSystem;
 using curve::chunkserver::concurrent::ConcurrentApplyModule;
 
 class FilePool;
+class CSPageCache;
 class CopysetNodeManager;
 class CloneManager;
+class DmClockScheduler;
 
 /**
  * copyset node的配置选项
@@ -92,6 +94,16 @@ struct CopysetNodeOptions {
     uint32_t pageSize;
     // clone chunk的location长度限制
     uint32_t locationLimit;
+    // clone chunk新写入多少个page后持久化bitmap，期间bitmap的变化由raft log
+    // 保证，打快照时也会持久化；0表示每次写都持久化
+    uint32_t cloneMetaFlushPages;
+    // leader持有有效的lease时，读请求直接读本地数据，不再走raft协议
+    bool enableLeaseRead;
+    // 打快照时保存所有chunk的metapage索引，重启时根据索引加载chunk，
+    // 不再逐个打开chunk文件读取metapage
+    bool enableChunkIndex;
+    // 维护每个page的crc，读数据时校验，scan时直接比较记录的crc
+    bool enablePageChecksum;
 
     // 并发模块
     ConcurrentApplyModule *concurrentapply;
@@ -99,6 +111,8 @@ struct CopysetNodeOptions {
     std::shared_ptr<FilePool> chunkFilePool;
     // WAL file pool
     std::shared_ptr<FilePool> walFilePool;
+    // 所有copyset共享的chunk数据页缓存，为nullptr表示不开启
+    std::shared_ptr<CSPageCache> pageCache;
     // 文件系统适配层
     std::shared_ptr<LocalFileSystem> localFileSystem;
     // 回收站, 心跳模块判断该chunkserver不在copyset配置组时，
@@ -131,6 +145,8 @@ struct ChunkServiceOptions {
     CopysetNodeManager *copysetNodeManager;
     CloneManager *cloneManager;
     std::shared_ptr<InflightThrottle> inflightThrottle;
+    // 读写请求的qos调度器，为空表示不开启qos
+    std::shared_ptr<DmClockScheduler> qosScheduler;
 };
 
 }  // namespace chunkserver
@@ -23,6 +23,7 @@
 #include "src/chunkserver/copyset_node.h"
 
 #include <glog/logging.h>
+#include <gflags/gflags.h>
 #include <brpc/controller.h>
 #include <butil/sys_byteorder.h>
 #include <braft/closure_helper.h>
@@ -43,11 +44,16 @@
 #include "src/chunkserver/uri_paser.h"
 #include "src/common/crc32.h"
 #include "src/common/fs_util.h"
+#include "src/common/timeutility.h"
 
 namespace curve {
 namespace chunkserver {
 
 using curve::fs::FileSystemInfo;
+using curve::common::TimeUtility;
+
+DEFINE_uint32(crcErrorTransferLeaderIntervalS, 60,
+              "minimum interval of transferring leader on page crc error");
 
 const char *kCurveConfEpochFilename = "conf.epoch";
 
@@ -65,8 +71,10 @@ CopysetNode::CopysetNode(const LogicPoolID &logicPoolId,
     chunkDataRpath_(),
     appliedIndex_(0),
     leaderTerm_(-1),
+    enableLeaseRead_(false),
     scaning_(false),
     lastScanSec_(0),
+    lastCrcErrorTransferSec_(0),
     configChange_(std::make_shared<ConfigurationChange>()) {
 }
 
@@ -105,6 +113,7 @@ int CopysetNode::Init(const CopysetNodeOptions &options) {
     copysetDirPath_.append("/").append(groupId);
     fs_ = options.localFileSystem;
     CHECK(nullptr != fs_) << "local file sytem is null";
+    enableLeaseRead_ = options.enableLeaseRead;
     epochFile_.reset(new ConfEpochFile(fs_));
 
     chunkDataRpath_ = RAFT_DATA_DIR;
@@ -114,6 +123,10 @@ int CopysetNode::Init(const CopysetNodeOptions &options) {
     dsOptions.chunkSize = options.maxChunkSize;
     dsOptions.pageSize = options.pageSize;
     dsOptions.locationLimit = options.locationLimit;
+    dsOptions.metaFlushPages = options.cloneMetaFlushPages;
+    dsOptions.pageCache = options.pageCache;
+    dsOptions.enableChunkIndex = options.enableChunkIndex;
+    dsOptions.enablePageChecksum = options.enablePageChecksum;
     dataStore_ = std::make_shared<CSDataStore>(options.localFileSystem,
                                                options.chunkFilePool,
                                                dsOptions);
@@ -233,6 +246,10 @@ void CopysetNode::InitRaftNodeOptions(const CopysetNodeOptions &options) {
 }
 
 void CopysetNode::on_apply(::braft::Iterator &iter) {
+    // 本批日志中每个chunk上等待合并下发的写请求
+    std::unordered_map<ChunkID, std::shared_ptr<WriteChunkMerger>> mergers;
+    uint32_t mergeMaxBytes = concurrentapply_->WriteMergeMaxBytes();
+
     for (; iter.valid(); iter.next()) {
         // 放在bthread中异步执行，避免阻塞当前状态机的执行
         braft::AsyncClosureGuard doneGuard(iter.done());
@@ -253,12 +270,30 @@ void CopysetNode::on_apply(::braft::Iterator &iter) {
             CHECK(nullptr != chunkClosure)
                 << "ChunkClosure dynamic cast failed";
             std::shared_ptr<ChunkOpRequest> opRequest = chunkClosure->request_;
+            auto chunkId = opRequest->ChunkId();
+            if (mergeMaxBytes > 0 &&
+                opRequest->OpType() == CHUNK_OP_TYPE::CHUNK_OP_WRITE) {
+                auto &merger = mergers[chunkId];
+                if (merger != nullptr &&
+                    merger->Add(opRequest, iter.index(), closure)) {
+                    doneGuard.release();
+                    continue;
+                }
+                ApplyMergedWrite(&merger);
+                merger = std::make_shared<WriteChunkMerger>(dataStore_,
+                                                            mergeMaxBytes);
+                if (merger->Add(opRequest, iter.index(), closure)) {
+                    doneGuard.release();
+                    continue;
+                }
+            } else {
+                ApplyMergedWrite(chunkId, &mergers);
+            }
             auto task = std::bind(&ChunkOpRequest::OnApply,
                                   opRequest,
                                   iter.index(),
                                   doneGuard.release());
-            concurrentapply_->Push(
-                opRequest->ChunkId(), opRequest->OpType(), task);
+            concurrentapply_->Push(chunkId, opRequest->OpType(), task);
         } else {
             // 获取log entry
             butil::IOBuf log = iter.data();
@@ -273,6 +308,19 @@ void CopysetNode::on_apply(::braft::Iterator &iter) {
             auto opReq = ChunkOpRequest::Decode(log, &request, &data,
                                                 iter.index(), GetLeaderId());
             auto chunkId = request.chunkid();
+            if (mergeMaxBytes > 0 && nullptr != opReq &&
+                request.optype() == CHUNK_OP_TYPE::CHUNK_OP_WRITE) {
+                auto &merger = mergers[chunkId];
+                if (merger != nullptr && merger->Add(request, data)) {
+                    continue;
+                }
+                ApplyMergedWrite(&merger);
+                merger = std::make_shared<WriteChunkMerger>(dataStore_,
+                                                            mergeMaxBytes);
+                merger->Add(request, data);
+                continue;
+            }
+            ApplyMergedWrite(chunkId, &mergers);
             auto task = std::bind(&ChunkOpRequest::OnApplyFromLog,
                                   opReq,
                                   dataStore_,
@@ -281,6 +329,29 @@ void CopysetNode::on_apply(::braft::Iterator &iter) {
             concurrentapply_->Push(chunkId, request.optype(), task);
         }
     }
+
+    for (auto &item : mergers) {
+        ApplyMergedWrite(&item.second);
+    }
+}
+
+void CopysetNode::ApplyMergedWrite(std::shared_ptr<WriteChunkMerger> *merger) {
+    if (*merger == nullptr || (*merger)->Empty()) {
+        return;
+    }
+    auto chunkId = (*merger)->ChunkId();
+    concurrentapply_->Push(chunkId, CHUNK_OP_TYPE::CHUNK_OP_WRITE,
+                           &WriteChunkMerger::Apply, *merger);
+    merger->reset();
+}
+
+void CopysetNode::ApplyMergedWrite(ChunkID chunkId,
+    std::unordered_map<ChunkID, std::shared_ptr<WriteChunkMerger>> *mergers) {
+    // 同一个chunk上的其他请求必须在已合并的写请求之后执行
+    auto it = mergers->find(chunkId);
+    if (it != mergers->end()) {
+        ApplyMergedWrite(&it->second);
+    }
 }
 
 void CopysetNode::on_shutdown() {
@@ -296,6 +367,22 @@ void CopysetNode::on_snapshot_save(::braft::SnapshotWriter *writer,
      */
     concurrentapply_->Flush();
 
+    /**
+     * clone chunk的bitmap可能只更新在内存中，快照之前的日志会被删除，
+     * 需要先持久化
+     */
+    if (CSErrorCode::Success != dataStore_->SyncChunkMetaPages()) {
+        done->status().set_error(EIO, "sync chunk metapage failed");
+        LOG(ERROR) << "SyncChunkMetaPages failed. "
+                   << "Copyset: " << GroupIdString();
+        return;
+    }
+    // chunk索引只用于加快重启，保存失败不影响快照
+    if (CSErrorCode::Success != dataStore_->SaveChunkIndex()) {
+        LOG(WARNING) << "SaveChunkIndex failed. "
+                     << "Copyset: " << GroupIdString();
+    }
+
     /**
      * 2.保存配置版本: conf.epoch，注意conf.epoch是存放在data目录下
      */
@@ -322,6 +409,15 @@ void CopysetNode::on_snapshot_save(::braft::SnapshotWriter *writer,
             if (isSnapshot) {
                 continue;
             }
+            // chunk索引只对本地的chunk文件有效，不能随快照发送
+            if (DatastoreFileHelper::IsIndexFile(fileName)) {
+                continue;
+            }
+            // 校验和文件同样只对本地的chunk有效，安装快照后的chunk没有记录
+            // 校验和，由之后的写入重新记录
+            if (DatastoreFileHelper::IsChecksumFile(fileName)) {
+                continue;
+            }
             std::string chunkApath;
             // 通过绝对路径，算出相对于快照目录的路径
             chunkApath.append(chunkDataApath_);
@@ -601,6 +697,24 @@ bool CopysetNode::IsLeaderTerm() const {
     return false;
 }
 
+bool CopysetNode::IsLeaseLeader() const {
+    if (!enableLeaseRead_) {
+        return false;
+    }
+    int64_t term = leaderTerm_.load(std::memory_order_acquire);
+    if (term <= 0) {
+        return false;
+    }
+    /**
+     * lease的任期必须和on_leader_start设置的任期相同，此时之前任期的日志
+     * 都已经由on_apply提交给了并发模块，lease read放入chunk的写队列，
+     * 排在这些写之后执行
+     */
+    braft::LeaderLeaseStatus status;
+    raftNode_->get_leader_lease_status(&status);
+    return status.state == braft::LEASE_VALID && status.term == term;
+}
+
 PeerId CopysetNode::GetLeaderId() const {
     return raftNode_->leader_id();
 }
@@ -638,6 +752,28 @@ butil::Status CopysetNode::TransferLeader(const Peer& peer) {
     return status;
 }
 
+void CopysetNode::TransferLeaderOnCrcError() {
+    if (!IsLeaderTerm()) {
+        return;
+    }
+    // 多个chunk同时损坏时只切换一次，避免leader来回切换
+    uint64_t now = TimeUtility::GetTimeofDaySec();
+    uint64_t last = lastCrcErrorTransferSec_.load(std::memory_order_relaxed);
+    if (now < last + FLAGS_crcErrorTransferLeaderIntervalS ||
+        !lastCrcErrorTransferSec_.compare_exchange_strong(last, now)) {
+        return;
+    }
+    // 由braft选择日志最新的副本作为新的leader
+    int rc = raftNode_->transfer_leadership_to(braft::ANY_PEER);
+    if (rc != 0) {
+        LOG(ERROR) << "Failed to transfer leader on crc error, copyset "
+                   << GroupIdString() << ", error: " << berror(rc);
+        return;
+    }
+    LOG(WARNING) << "Transferring leader of copyset " << GroupIdString()
+                 << " to other peer on crc error";
+}
+
 butil::Status CopysetNode::AddPeer(const Peer& peer) {
     std::vector<PeerId> peers;
     PeerId peerId(peer.address());
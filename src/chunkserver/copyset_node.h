@@ -29,6 +29,7 @@
 #include <vector>
 #include <climits>
 #include <memory>
+#include <unordered_map>
 
 #include "src/chunkserver/concurrent_apply/concurrent_apply.h"
 #include "src/chunkserver/datastore/chunkserver_datastore.h"
@@ -54,6 +55,7 @@ using ::curve::mds::heartbeat::ConfigChangeType;
 using ::curve::common::Peer;
 
 class CopysetNodeManager;
+class WriteChunkMerger;
 
 extern const char *kCurveConfEpochFilename;
 
@@ -167,6 +169,14 @@ class CopysetNode : public braft::StateMachine,
      */
     virtual bool IsLeaderTerm() const;
 
+    /**
+     * 返回当前副本是否是持有有效lease的leader，只有开启lease read时才可能
+     * 返回true。lease有效期内不会有其他副本当选leader，读请求可以直接读
+     * 本地数据而不用走raft协议
+     * @return
+     */
+    virtual bool IsLeaseLeader() const;
+
     /**
      * 返回当前的任期
      * @return 当前的任期
@@ -186,6 +196,12 @@ class CopysetNode : public braft::StateMachine,
      */
     butil::Status TransferLeader(const Peer& peer);
 
+    /**
+     * @brief 本地读数据page校验失败时，把leader切换到其他副本，client重试
+     *        时从其他副本读取。一段时间内只切换一次
+     */
+    void TransferLeaderOnCrcError();
+
     /**
      * @brief 复制组添加新成员
      * @param[in] peerId 新成员的ID
@@ -411,6 +427,19 @@ class CopysetNode : public braft::StateMachine,
         return ToGroupIdString(logicPoolId_, copysetId_);
     }
 
+    /**
+     * 把合并后的写请求交给并发模块执行，merger随后被置空
+     * @param merger:待下发的合并写请求
+     */
+    void ApplyMergedWrite(std::shared_ptr<WriteChunkMerger> *merger);
+
+    /**
+     * 下发chunkId上等待合并的写请求
+     */
+    void ApplyMergedWrite(ChunkID chunkId,
+        std::unordered_map<ChunkID,
+                           std::shared_ptr<WriteChunkMerger>> *mergers);
+
  private:
     // 逻辑池 id
     LogicPoolID logicPoolId_;
@@ -448,6 +477,8 @@ class CopysetNode : public braft::StateMachine,
     std::atomic<uint64_t> appliedIndex_;
     // 复制组当前任期，如果<=0表明不是leader
     std::atomic<int64_t> leaderTerm_;
+    // 是否开启lease read
+    bool enableLeaseRead_;
     // 复制组数据回收站目录
     std::string recyclerUri_;
     // 复制组的metric信息
@@ -461,6 +492,8 @@ class CopysetNode : public braft::StateMachine,
     bool scaning_;
     // last scan time
     uint64_t lastScanSec_;
+    // 上一次因为page校验失败切换leader的时间
+    std::atomic<uint64_t> lastCrcErrorTransferSec_;
     // failed check scanmap
     std::vector<ScanMap> failedScanMaps_;
 };
@@ -0,0 +1,274 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <glog/logging.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <string.h>
+
+#include "src/chunkserver/datastore/chunk_index.h"
+#include "src/chunkserver/datastore/chunkserver_chunkfile.h"
+#include "src/chunkserver/datastore/filename_operator.h"
+#include "src/common/crc32.h"
+
+namespace curve {
+namespace chunkserver {
+
+namespace {
+
+const uint32_t kChunkIndexMagic = 0x58444e49;  // "INDX"
+const uint32_t kChunkIndexVersion = 1;
+const size_t kChunkIndexHeaderSize = 24;
+
+template <typename T>
+void AppendValue(std::string* buf, const T& value) {
+    buf->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool ParseValue(const char* buf, size_t size, size_t* pos, T* value) {
+    if (*pos + sizeof(T) > size) {
+        return false;
+    }
+    memcpy(value, buf + *pos, sizeof(T));
+    *pos += sizeof(T);
+    return true;
+}
+
+}  // namespace
+
+CSChunkIndex::CSChunkIndex(std::shared_ptr<LocalFileSystem> lfs,
+                           const std::string& baseDir,
+                           ChunkSizeType chunkSize,
+                           PageSizeType pageSize)
+    : lfs_(lfs),
+      baseDir_(baseDir),
+      chunkSize_(chunkSize),
+      pageSize_(pageSize),
+      valid_(false),
+      changes_(0) {
+    path_ = baseDir_ + "/" + FileNameOperator::GenerateIndexFileName();
+}
+
+bool CSChunkIndex::Load(ChunkIndexMap* chunks) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    valid_ = false;
+    int fd = lfs_->Open(path_, O_RDONLY);
+    if (fd < 0) {
+        LOG(WARNING) << "Open chunk index failed, path = " << path_;
+        removeIndex();
+        return false;
+    }
+    struct stat fileInfo;
+    int rc = lfs_->Fstat(fd, &fileInfo);
+    if (rc < 0) {
+        LOG(WARNING) << "Stat chunk index failed, path = " << path_;
+        lfs_->Close(fd);
+        removeIndex();
+        return false;
+    }
+    std::string buf(fileInfo.st_size, '\0');
+    rc = buf.empty() ? 0 : lfs_->Read(fd, &buf[0], 0, buf.size());
+    lfs_->Close(fd);
+    if (rc != static_cast<int>(buf.size())
+        || !decode(buf.data(), buf.size(), chunks)) {
+        LOG(WARNING) << "Invalid chunk index, path = " << path_;
+        chunks->clear();
+        removeIndex();
+        return false;
+    }
+    valid_ = true;
+    return true;
+}
+
+int CSChunkIndex::Save(const std::function<void(ChunkIndexMap*)>& collect) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    uint64_t changes = changes_.load();
+    ChunkIndexMap chunks;
+    collect(&chunks);
+
+    std::string buf;
+    encode(chunks, &buf);
+    std::string tmpPath = path_ + ".tmp";
+    int rc = writeFile(tmpPath, buf);
+    if (rc < 0) {
+        LOG(ERROR) << "Write chunk index failed, path = " << tmpPath;
+        lfs_->Delete(tmpPath);
+        return rc;
+    }
+    rc = lfs_->Rename(tmpPath, path_);
+    if (rc < 0) {
+        LOG(ERROR) << "Rename chunk index failed, path = " << tmpPath;
+        lfs_->Delete(tmpPath);
+        return rc;
+    }
+    rc = syncDir();
+    if (rc < 0) {
+        removeIndex();
+        return rc;
+    }
+
+    // valid_ must be set before checking changes_, Invalidate changes them
+    // in the opposite order, so either the change is seen here, or the
+    // Invalidate sees valid_ and removes the index after we release the lock
+    valid_ = true;
+    if (changes_.load() != changes) {
+        LOG(INFO) << "Chunk metapage changed during saving chunk index, "
+                  << "path = " << path_;
+        removeIndex();
+        return -EAGAIN;
+    }
+    return 0;
+}
+
+void CSChunkIndex::Invalidate() {
+    changes_.fetch_add(1);
+    if (!valid_.load()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (valid_) {
+        removeIndex();
+    }
+}
+
+void CSChunkIndex::removeIndex() {
+    valid_ = false;
+    int rc = lfs_->Delete(path_);
+    if (rc < 0 && lfs_->FileExists(path_)) {
+        // the chunk files can not be changed while a stale index exists
+        LOG(FATAL) << "Remove chunk index failed, path = " << path_;
+    }
+    // the removal must be persisted before the metapage changes
+    rc = syncDir();
+    LOG_IF(FATAL, rc < 0) << "Sync dir failed, path = " << baseDir_;
+}
+
+int CSChunkIndex::writeFile(const std::string& path, const std::string& buf) {
+    int fd = lfs_->Open(path, O_RDWR|O_CREAT|O_TRUNC);
+    if (fd < 0) {
+        return fd;
+    }
+    int rc = lfs_->Write(fd, buf.data(), 0, buf.size());
+    if (rc == static_cast<int>(buf.size())) {
+        rc = lfs_->Fsync(fd);
+    } else if (rc >= 0) {
+        rc = -EIO;
+    }
+    lfs_->Close(fd);
+    return rc < 0 ? rc : 0;
+}
+
+int CSChunkIndex::syncDir() {
+    int fd = lfs_->Open(baseDir_, O_RDONLY|O_DIRECTORY);
+    if (fd < 0) {
+        LOG(ERROR) << "Open dir failed, path = " << baseDir_;
+        return fd;
+    }
+    int rc = lfs_->Fsync(fd);
+    lfs_->Close(fd);
+    return rc;
+}
+
+void CSChunkIndex::encode(const ChunkIndexMap& chunks, std::string* buf) {
+    AppendValue(buf, kChunkIndexMagic);
+    AppendValue(buf, kChunkIndexVersion);
+    AppendValue(buf, chunkSize_);
+    AppendValue(buf, pageSize_);
+    AppendValue(buf, static_cast<uint64_t>(chunks.size()));
+    for (const auto& item : chunks) {
+        const ChunkFileMetaPage& metaPage = item.second;
+        AppendValue(buf, item.first);
+        AppendValue(buf, metaPage.version);
+        AppendValue(buf, metaPage.sn);
+        AppendValue(buf, metaPage.correctedSn);
+        AppendValue(buf, static_cast<uint32_t>(metaPage.location.size()));
+        if (!metaPage.location.empty()) {
+            buf->append(metaPage.location);
+            uint32_t bits = metaPage.bitmap->Size();
+            AppendValue(buf, bits);
+            buf->append(metaPage.bitmap->GetBitmap(), (bits + 8 - 1) >> 3);
+        }
+    }
+    AppendValue(buf, ::curve::common::CRC32(buf->data(), buf->size()));
+}
+
+bool CSChunkIndex::decode(const char* buf, size_t size,
+                          ChunkIndexMap* chunks) {
+    if (size < kChunkIndexHeaderSize + sizeof(uint32_t)) {
+        return false;
+    }
+    size_t dataSize = size - sizeof(uint32_t);
+    uint32_t recordCrc;
+    memcpy(&recordCrc, buf + dataSize, sizeof(recordCrc));
+    if (recordCrc != ::curve::common::CRC32(buf, dataSize)) {
+        LOG(WARNING) << "Checking chunk index crc failed.";
+        return false;
+    }
+
+    size_t pos = 0;
+    uint32_t magic, version, chunkSize, pageSize;
+    uint64_t count;
+    ParseValue(buf, dataSize, &pos, &magic);
+    ParseValue(buf, dataSize, &pos, &version);
+    ParseValue(buf, dataSize, &pos, &chunkSize);
+    ParseValue(buf, dataSize, &pos, &pageSize);
+    ParseValue(buf, dataSize, &pos, &count);
+    if (magic != kChunkIndexMagic || version != kChunkIndexVersion
+        || chunkSize != chunkSize_ || pageSize != pageSize_) {
+        LOG(WARNING) << "Chunk index mismatch, version = " << version
+                     << ", chunk size = " << chunkSize
+                     << ", page size = " << pageSize;
+        return false;
+    }
+
+    for (uint64_t i = 0; i < count; ++i) {
+        ChunkID id;
+        ChunkFileMetaPage metaPage;
+        uint32_t locSize;
+        if (!ParseValue(buf, dataSize, &pos, &id)
+            || !ParseValue(buf, dataSize, &pos, &metaPage.version)
+            || !ParseValue(buf, dataSize, &pos, &metaPage.sn)
+            || !ParseValue(buf, dataSize, &pos, &metaPage.correctedSn)
+            || !ParseValue(buf, dataSize, &pos, &locSize)
+            || pos + locSize > dataSize) {
+            return false;
+        }
+        if (locSize > 0) {
+            metaPage.location.assign(buf + pos, locSize);
+            pos += locSize;
+            uint32_t bits;
+            if (!ParseValue(buf, dataSize, &pos, &bits)
+                || bits != chunkSize_ / pageSize_
+                || pos + ((bits + 8 - 1) >> 3) > dataSize) {
+                return false;
+            }
+            metaPage.bitmap = std::make_shared<Bitmap>(bits, buf + pos);
+            pos += (bits + 8 - 1) >> 3;
+        }
+        (*chunks)[id] = metaPage;
+    }
+    return pos == dataSize;
+}
+
+}  // namespace chunkserver
+}  // namespace curve
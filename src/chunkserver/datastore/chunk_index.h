@@ -0,0 +1,124 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_CHUNKSERVER_DATASTORE_CHUNK_INDEX_H_
+#define SRC_CHUNKSERVER_DATASTORE_CHUNK_INDEX_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "include/chunkserver/chunkserver_common.h"
+#include "src/fs/local_filesystem.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::fs::LocalFileSystem;
+
+struct ChunkFileMetaPage;
+using ChunkIndexMap = std::unordered_map<ChunkID, ChunkFileMetaPage>;
+
+/**
+ * Chunk Index File Format
+ * magic: 4 bytes
+ * version: 4 bytes
+ * chunkSize: 4 bytes
+ * pageSize: 4 bytes
+ * count: 8 bytes
+ * entries: count * (id: 8 bytes, version: 1 byte, sn: 8 bytes,
+ *          correctedSn: 8 bytes, location size: 4 bytes, location,
+ *          and if location is not empty, bits: 4 bytes, bitmap)
+ * crc: 4 bytes
+ *
+ * The index records the metapages of all the chunks in a datastore, so the
+ * datastore can be loaded without opening every chunk file. It is written
+ * when the raft snapshot is saved, and removed before any metapage of the
+ * datastore is changed on disk, so an index found at startup always matches
+ * the chunk files
+ */
+class CSChunkIndex {
+ public:
+    CSChunkIndex(std::shared_ptr<LocalFileSystem> lfs,
+                 const std::string& baseDir,
+                 ChunkSizeType chunkSize,
+                 PageSizeType pageSize);
+    virtual ~CSChunkIndex() {}
+
+    /**
+     * Load the index, the caller should make sure the index exists
+     * A broken or mismatched index is removed
+     * If the index is loaded, it is regarded as valid until Invalidate
+     * @param chunks[out]: the metapages of the chunks in the index
+     * @return: true if the index exists and is valid
+     */
+    bool Load(ChunkIndexMap* chunks);
+
+    /**
+     * Write the index with the metapages collected by collect
+     * If any metapage is changed during saving, the new index is removed
+     * @param collect: collect the metapages of all the chunks
+     * @return: return 0 on success, otherwise return a negative number
+     */
+    int Save(const std::function<void(ChunkIndexMap*)>& collect);
+
+    /**
+     * Must be called before any metapage is changed on disk, or any chunk
+     * file is created or deleted. Remove the index if it is valid
+     */
+    void Invalidate();
+
+    std::string GetPath() const {
+        return path_;
+    }
+
+ private:
+    void encode(const ChunkIndexMap& chunks, std::string* buf);
+    bool decode(const char* buf, size_t size, ChunkIndexMap* chunks);
+    int writeFile(const std::string& path, const std::string& buf);
+    void removeIndex();
+    int syncDir();
+
+ private:
+    std::shared_ptr<LocalFileSystem> lfs_;
+    // the directory of the datastore
+    std::string baseDir_;
+    // the path of the index file
+    std::string path_;
+    ChunkSizeType chunkSize_;
+    PageSizeType pageSize_;
+    // whether the index on disk matches the chunk files
+    std::atomic<bool> valid_;
+    // the number of metapage changes, used to detect the changes during
+    // saving the index
+    std::atomic<uint64_t> changes_;
+    // serialize saving and removing the index
+    std::mutex mtx_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_DATASTORE_CHUNK_INDEX_H_
@@ -25,6 +25,7 @@
 
 #include "src/chunkserver/datastore/chunkserver_datastore.h"
 #include "src/chunkserver/datastore/chunkserver_chunkfile.h"
+#include "src/chunkserver/datastore/chunk_index.h"
 #include "src/common/crc32.h"
 
 namespace curve {
@@ -145,15 +146,24 @@ CSChunkFile::CSChunkFile(std::shared_ptr<LocalFileSystem> lfs,
                          std::shared_ptr<FilePool> chunkFilePool,
                          const ChunkOptions& options)
     : fd_(-1),
+      lazyOpen_(false),
       size_(options.chunkSize),
       pageSize_(options.pageSize),
       chunkId_(options.id),
       baseDir_(options.baseDir),
       isCloneChunk_(false),
+      unflushedPages_(0),
+      metaFlushPages_(options.metaFlushPages),
       snapshot_(nullptr),
       chunkFilePool_(chunkFilePool),
       lfs_(lfs),
-      metric_(options.metric) {
+      metric_(options.metric),
+      pageCache_(options.pageCache),
+      cacheOwner_(options.cacheOwner),
+      index_(options.index),
+      enableChecksum_(options.enableChecksum),
+      crcFd_(-1),
+      crcDirty_(false) {
     CHECK(!baseDir_.empty()) << "Create chunk file failed";
     CHECK(lfs_ != nullptr) << "Create chunk file failed";
     metaPage_.sn = options.sn;
@@ -180,6 +190,10 @@ CSChunkFile::~CSChunkFile() {
         lfs_->Close(fd_);
     }
 
+    if (crcFd_ >= 0) {
+        lfs_->Close(crcFd_);
+    }
+
     if (metric_ != nullptr) {
         metric_->chunkFileCount << -1;
         if (isCloneChunk_) {
@@ -195,6 +209,7 @@ CSErrorCode CSChunkFile::Open(bool createFile) {
     // The existence of chunk files may be caused by two situations:
     // 1. getchunk succeeded, but failed in stat or load metapage last time;
     // 2. Two write requests concurrently create new chunk files
+    bool created = false;
     if (createFile
         && !lfs_->FileExists(chunkFilePath)
         && metaPage_.sn > 0) {
@@ -203,6 +218,7 @@ CSErrorCode CSChunkFile::Open(bool createFile) {
         metaPage_.version = FORMAT_VERSION_V2;
         metaPage_.encode(buf);
 
+        invalidateIndex();
         int rc = chunkFilePool_->GetFile(chunkFilePath, buf, true);
         // When creating files concurrently, the previous thread may have been
         // created successfully, then -EEXIST will be returned here. At this
@@ -214,6 +230,7 @@ CSErrorCode CSChunkFile::Open(bool createFile) {
                        << " filepath = " << chunkFilePath;
             return CSErrorCode::InternalError;
         }
+        created = (rc == 0);
     }
     int rc = lfs_->Open(chunkFilePath, O_RDWR|O_NOATIME|O_DSYNC);
     if (rc < 0) {
@@ -239,6 +256,13 @@ CSErrorCode CSChunkFile::Open(bool createFile) {
     }
 
     CSErrorCode errCode = loadMetaPage();
+    if (errCode == CSErrorCode::Success && enableChecksum_) {
+        // The checksums left by a deleted chunk with the same id are invalid
+        rc = openChecksum(created);
+        if (rc < 0) {
+            return CSErrorCode::InternalError;
+        }
+    }
     // After restarting, only after reopening and loading the metapage,
     // can we know whether it is a clone chunk
     if (!metaPage_.location.empty() && !isCloneChunk_) {
@@ -250,6 +274,160 @@ CSErrorCode CSChunkFile::Open(bool createFile) {
     return errCode;
 }
 
+void CSChunkFile::LoadFromIndex(const ChunkFileMetaPage& metaPage) {
+    WriteLockGuard writeGuard(rwLock_);
+    metaPage_ = metaPage;
+    lazyOpen_ = true;
+    if (!metaPage_.location.empty() && !isCloneChunk_) {
+        if (metric_ != nullptr) {
+            metric_->cloneChunkCount << 1;
+        }
+        isCloneChunk_ = true;
+    }
+}
+
+int CSChunkFile::ensureOpened() {
+    if (!lazyOpen_.load(std::memory_order_acquire)) {
+        return 0;
+    }
+    // Read only holds the read lock, so the chunk may be opened by
+    // several readers at the same time
+    std::lock_guard<std::mutex> lk(openMutex_);
+    if (!lazyOpen_.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+    int rc = lfs_->Open(path(), O_RDWR|O_NOATIME|O_DSYNC);
+    if (rc < 0) {
+        LOG(ERROR) << "Error occured when opening file."
+                   << " filepath = " << path();
+        return rc;
+    }
+    fd_ = rc;
+    if (enableChecksum_) {
+        rc = openChecksum(false);
+        if (rc < 0) {
+            lfs_->Close(fd_);
+            fd_ = -1;
+            return rc;
+        }
+    }
+    lazyOpen_.store(false, std::memory_order_release);
+    return 0;
+}
+
+int CSChunkFile::openChecksum(bool create) {
+    // The checksum file is not opened with O_DSYNC, it is synced before the
+    // raft snapshot is saved, the checksums lost on power failure after
+    // that are recomputed by replaying the raft log
+    int flags = O_RDWR|O_CREAT|O_NOATIME;
+    if (create) {
+        flags |= O_TRUNC;
+    }
+    int rc = lfs_->Open(checksumPath(), flags);
+    if (rc < 0) {
+        LOG(ERROR) << "Error occured when opening checksum file."
+                   << " filepath = " << checksumPath();
+        return rc;
+    }
+    int fd = rc;
+    // The pages beyond the end of the file have no checksum recorded
+    pageCrcs_.assign(size_ / pageSize_, PageChecksum{0, 0});
+    if (!create) {
+        rc = lfs_->Read(fd, reinterpret_cast<char*>(pageCrcs_.data()), 0,
+                        pageCrcs_.size() * sizeof(PageChecksum));
+        if (rc < 0) {
+            LOG(ERROR) << "Error occured when reading checksum file."
+                       << " filepath = " << checksumPath();
+            lfs_->Close(fd);
+            return rc;
+        }
+    }
+    if (crcFd_ >= 0) {
+        lfs_->Close(crcFd_);
+    }
+    crcFd_ = fd;
+    return 0;
+}
+
+int CSChunkFile::updateChecksum(const butil::IOBuf* buf,
+                                off_t offset,
+                                size_t length) {
+    uint32_t beginIndex = offset / pageSize_;
+    uint32_t endIndex = (offset + length - 1) / pageSize_;
+    std::unique_ptr<char[]> page(new char[pageSize_]);
+    for (uint32_t i = beginIndex; i <= endIndex; ++i) {
+        off_t pageOff = static_cast<off_t>(i) * pageSize_;
+        if (buf != nullptr && pageOff >= offset
+            && pageOff + pageSize_ <= offset + length) {
+            buf->copy_to(page.get(), pageSize_, pageOff - offset);
+        } else {
+            int rc = readData(page.get(), pageOff, pageSize_);
+            if (rc < 0) {
+                return rc;
+            }
+        }
+        pageCrcs_[i].crc = ::curve::common::CRC32(page.get(), pageSize_);
+        pageCrcs_[i].flags = kPageChecksumValid;
+    }
+    size_t count = endIndex - beginIndex + 1;
+    int rc = lfs_->Write(crcFd_,
+                         reinterpret_cast<char*>(&pageCrcs_[beginIndex]),
+                         beginIndex * sizeof(PageChecksum),
+                         count * sizeof(PageChecksum));
+    if (rc < 0) {
+        return rc;
+    }
+    crcDirty_ = true;
+    return 0;
+}
+
+CSErrorCode CSChunkFile::verifyChecksum(const char* buf,
+                                        off_t offset,
+                                        size_t length) {
+    uint32_t beginIndex = offset / pageSize_;
+    uint32_t endIndex = (offset + length - 1) / pageSize_;
+    std::unique_ptr<char[]> page;
+    for (uint32_t i = beginIndex; i <= endIndex; ++i) {
+        if (!pageCrcs_[i].valid()) {
+            continue;
+        }
+        off_t pageOff = static_cast<off_t>(i) * pageSize_;
+        const char* data = buf + (pageOff - offset);
+        if (pageOff < offset || pageOff + pageSize_ > offset + length) {
+            if (page == nullptr) {
+                page.reset(new char[pageSize_]);
+            }
+            int rc = readData(page.get(), pageOff, pageSize_);
+            if (rc < 0) {
+                LOG(ERROR) << "Read chunk file failed."
+                           << "ChunkID: " << chunkId_
+                           << ",chunk sn: " << metaPage_.sn;
+                return CSErrorCode::InternalError;
+            }
+            data = page.get();
+        }
+        uint32_t crc = ::curve::common::CRC32(data, pageSize_);
+        if (crc != pageCrcs_[i].crc) {
+            LOG(ERROR) << "Checking page crc32c failed."
+                       << "ChunkID: " << chunkId_
+                       << ", page index: " << i
+                       << ", expect crc: " << pageCrcs_[i].crc
+                       << ", real crc: " << crc;
+            if (metric_ != nullptr) {
+                metric_->crcErrorCount << 1;
+            }
+            return CSErrorCode::CrcCheckError;
+        }
+    }
+    return CSErrorCode::Success;
+}
+
+void CSChunkFile::invalidateIndex() {
+    if (index_ != nullptr) {
+        index_->Invalidate();
+    }
+}
+
 CSErrorCode CSChunkFile::LoadSnapshot(SequenceNum sn) {
     WriteLockGuard writeGuard(rwLock_);
     if (snapshot_ != nullptr) {
@@ -311,6 +489,13 @@ CSErrorCode CSChunkFile::Write(SequenceNum sn,
                      << ",request sn: " << sn
                      << ",chunk sn: " << metaPage_.sn
                      << ",correctedSn: " << metaPage_.correctedSn;
+        // The data has been written before the restart, but its checksums
+        // may be lost with the page cache, recompute them from the chunk file
+        if (enableChecksum_ && updateChecksum(nullptr, offset, length) < 0) {
+            LOG(ERROR) << "Update page checksum failed."
+                       << "ChunkID: " << chunkId_;
+            return CSErrorCode::InternalError;
+        }
         return CSErrorCode::BackwardRequestError;
     }
     // Determine whether to create a snapshot file
@@ -390,6 +575,20 @@ CSErrorCode CSChunkFile::Write(SequenceNum sn,
                    << "ChunkID: " << chunkId_
                    << ",request sn: " << sn
                    << ",chunk sn: " << metaPage_.sn;
+        // The data on disk is unknown, drop the cached pages
+        if (pageCache_ != nullptr) {
+            pageCache_->Invalidate(cacheOwner_, chunkId_, offset, length);
+        }
+        return CSErrorCode::InternalError;
+    }
+    if (pageCache_ != nullptr) {
+        pageCache_->Update(cacheOwner_, chunkId_, buf, offset, length);
+    }
+    if (enableChecksum_ && updateChecksum(&buf, offset, length) < 0) {
+        LOG(ERROR) << "Update page checksum failed."
+                   << "ChunkID: " << chunkId_
+                   << ",request sn: " << sn
+                   << ",chunk sn: " << metaPage_.sn;
         return CSErrorCode::InternalError;
     }
     // If it is a clone chunk, the bitmap will be updated
@@ -440,6 +639,12 @@ CSErrorCode CSChunkFile::Paste(const char * buf, off_t offset, size_t length) {
         pasteOff = range.beginIndex * pageSize_;
         pasteSize = (range.endIndex - range.beginIndex + 1) * pageSize_;
         int rc = writeData(buf + (pasteOff - offset), pasteOff, pasteSize);
+        if (rc == 0 && enableChecksum_) {
+            butil::IOBuf data;
+            data.append_user_data(const_cast<char*>(buf + (pasteOff - offset)),
+                                  pasteSize, TrivialDeleter);
+            rc = updateChecksum(&data, pasteOff, pasteSize);
+        }
         if (rc < 0) {
             LOG(ERROR) << "Paste data to chunk failed."
                        << "ChunkID: " << chunkId_
@@ -494,6 +699,11 @@ CSErrorCode CSChunkFile::Read(char * buf, off_t offset, size_t length) {
         }
     }
 
+    if (pageCache_ != nullptr &&
+        pageCache_->Read(cacheOwner_, chunkId_, buf, offset, length)) {
+        return CSErrorCode::Success;
+    }
+
     int rc = readData(buf, offset, length);
     if (rc < 0) {
         LOG(ERROR) << "Read chunk file failed."
@@ -501,6 +711,16 @@ CSErrorCode CSChunkFile::Read(char * buf, off_t offset, size_t length) {
                    << ",chunk sn: " << metaPage_.sn;
         return CSErrorCode::InternalError;
     }
+    // The cached pages have been verified when they were filled
+    if (enableChecksum_) {
+        CSErrorCode errorCode = verifyChecksum(buf, offset, length);
+        if (errorCode != CSErrorCode::Success) {
+            return errorCode;
+        }
+    }
+    if (pageCache_ != nullptr) {
+        pageCache_->Fill(cacheOwner_, chunkId_, buf, offset, length);
+    }
     return CSErrorCode::Success;
 }
 
@@ -516,6 +736,57 @@ CSErrorCode CSChunkFile::ReadMetaPage(char * buf) {
     return CSErrorCode::Success;
 }
 
+CSErrorCode CSChunkFile::GetChecksum(off_t offset,
+                                     size_t length,
+                                     uint32_t* crc) {
+    ReadLockGuard readGuard(rwLock_);
+    if (length == 0 || !CheckOffsetAndLength(offset, length, pageSize_)) {
+        LOG(ERROR) << "Get checksum failed, invalid offset or length."
+                   << "ChunkID: " << chunkId_
+                   << ", offset: " << offset
+                   << ", length: " << length
+                   << ", page size: " << pageSize_
+                   << ", chunk size: " << size_;
+        return CSErrorCode::InvalidArgError;
+    }
+    uint32_t beginIndex = offset / pageSize_;
+    uint32_t endIndex = (offset + length - 1) / pageSize_;
+    if (isCloneChunk_ && metaPage_.bitmap->NextClearBit(beginIndex, endIndex)
+                         != Bitmap::NO_POS) {
+        return CSErrorCode::PageNerverWrittenError;
+    }
+    int rc = ensureOpened();
+    if (rc < 0) {
+        return CSErrorCode::InternalError;
+    }
+
+    std::unique_ptr<char[]> page;
+    uint32_t result = 0;
+    for (uint32_t i = beginIndex; i <= endIndex; ++i) {
+        uint32_t pageCrc = 0;
+        if (enableChecksum_ && pageCrcs_[i].valid()) {
+            pageCrc = pageCrcs_[i].crc;
+        } else {
+            if (page == nullptr) {
+                page.reset(new char[pageSize_]);
+            }
+            rc = readData(page.get(), static_cast<off_t>(i) * pageSize_,
+                          pageSize_);
+            if (rc < 0) {
+                LOG(ERROR) << "Read chunk file failed."
+                           << "ChunkID: " << chunkId_
+                           << ",chunk sn: " << metaPage_.sn;
+                return CSErrorCode::InternalError;
+            }
+            pageCrc = ::curve::common::CRC32(page.get(), pageSize_);
+        }
+        result = ::curve::common::CRC32(
+            result, reinterpret_cast<const char*>(&pageCrc), sizeof(pageCrc));
+    }
+    *crc = result;
+    return CSErrorCode::Success;
+}
+
 CSErrorCode CSChunkFile::ReadSpecifiedChunk(SequenceNum sn,
                                             char * buf,
                                             off_t offset,
@@ -623,13 +894,29 @@ CSErrorCode CSChunkFile::Delete(SequenceNum sn)  {
         snapshot_ = nullptr;
     }
 
+    if (pageCache_ != nullptr) {
+        pageCache_->Invalidate(cacheOwner_, chunkId_, 0, size_);
+    }
     if (fd_ >= 0) {
         lfs_->Close(fd_);
         fd_ = -1;
     }
+    // the chunk file is gone, never open it again
+    lazyOpen_ = false;
+    invalidateIndex();
     int ret = chunkFilePool_->RecycleFile(path());
     if (ret < 0)
         return CSErrorCode::InternalError;
+    if (enableChecksum_) {
+        if (crcFd_ >= 0) {
+            lfs_->Close(crcFd_);
+            crcFd_ = -1;
+        }
+        // A chunk created later with the same id truncates the checksum
+        // file, so failing to delete it is harmless
+        lfs_->Delete(checksumPath());
+        crcDirty_ = false;
+    }
 
     LOG(INFO) << "Chunk deleted."
               << "ChunkID: " << chunkId_
@@ -740,6 +1027,11 @@ void CSChunkFile::GetInfo(CSChunkInfo* info)  {
         info->bitmap = nullptr;
 }
 
+void CSChunkFile::GetMetaPage(ChunkFileMetaPage* metaPage) {
+    ReadLockGuard readGuard(rwLock_);
+    *metaPage = metaPage_;
+}
+
 CSErrorCode CSChunkFile::GetHash(off_t offset,
                                  size_t length,
                                  std::string* hash)  {
@@ -751,7 +1043,10 @@ CSErrorCode CSChunkFile::GetHash(off_t offset,
         return CSErrorCode::InternalError;
     }
 
-    int rc = lfs_->Read(fd_, buf, offset, length);
+    int rc = ensureOpened();
+    if (rc == 0) {
+        rc = lfs_->Read(fd_, buf, offset, length);
+    }
     if (rc < 0) {
         LOG(ERROR) << "Read chunk file failed."
                    << "ChunkID: " << chunkId_
@@ -845,6 +1140,7 @@ CSErrorCode CSChunkFile::updateMetaPage(ChunkFileMetaPage* metaPage) {
     char buf[pageSize_];  // NOLINT
     memset(buf, 0, sizeof(buf));
     metaPage->encode(buf);
+    invalidateIndex();
     int rc = writeMetaPage(buf);
     if (rc < 0) {
         LOG(ERROR) << "Update metapage failed."
@@ -922,8 +1218,23 @@ CSErrorCode CSChunkFile::copy2Snapshot(off_t offset, size_t length) {
 }
 
 CSErrorCode CSChunkFile::flush() {
-    ChunkFileMetaPage tempMeta = metaPage_;
+    // Only update the bitmap in memory, the writes have been recorded in the
+    // raft log and will be replayed after restart
     bool needUpdateMeta = dirtyPages_.size() > 0;
+    if (isCloneChunk_ && metaFlushPages_ > 0 && needUpdateMeta) {
+        for (auto pageIndex : dirtyPages_) {
+            metaPage_.bitmap->Set(pageIndex);
+        }
+        unflushedPages_ += dirtyPages_.size();
+        dirtyPages_.clear();
+        // Converting to a normal chunk must be persisted immediately
+        if (unflushedPages_ < metaFlushPages_ &&
+            metaPage_.bitmap->NextClearBit(0) != Bitmap::NO_POS) {
+            return CSErrorCode::Success;
+        }
+    }
+
+    ChunkFileMetaPage tempMeta = metaPage_;
     bool clearClone = false;
     for (auto pageIndex : dirtyPages_) {
         tempMeta.bitmap->Set(pageIndex);
@@ -948,6 +1259,7 @@ CSErrorCode CSChunkFile::flush() {
         metaPage_.bitmap = tempMeta.bitmap;
         metaPage_.location = tempMeta.location;
         dirtyPages_.clear();
+        unflushedPages_ = 0;
         if (clearClone) {
             if (metric_ != nullptr) {
                 metric_->cloneChunkCount << -1;
@@ -958,5 +1270,30 @@ CSErrorCode CSChunkFile::flush() {
     return CSErrorCode::Success;
 }
 
+CSErrorCode CSChunkFile::SyncMetaPage() {
+    WriteLockGuard writeGuard(rwLock_);
+    if (crcDirty_) {
+        int rc = lfs_->Fsync(crcFd_);
+        if (rc < 0) {
+            LOG(ERROR) << "Sync checksum file failed."
+                       << "ChunkID: " << chunkId_;
+            return CSErrorCode::InternalError;
+        }
+        crcDirty_ = false;
+    }
+    if (unflushedPages_ == 0) {
+        return CSErrorCode::Success;
+    }
+    CSErrorCode errorCode = updateMetaPage(&metaPage_);
+    if (errorCode != CSErrorCode::Success) {
+        LOG(ERROR) << "Sync metapage failed."
+                   << "ChunkID: " << chunkId_
+                   << ",chunk sn: " << metaPage_.sn;
+        return errorCode;
+    }
+    unflushedPages_ = 0;
+    return CSErrorCode::Success;
+}
+
 }  // namespace chunkserver
 }  // namespace curve
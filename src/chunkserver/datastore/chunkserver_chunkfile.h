@@ -30,6 +30,7 @@
 #include <atomic>
 #include <functional>
 #include <memory>
+#include <mutex>
 
 #include "include/curve_compiler_specific.h"
 #include "include/chunkserver/chunkserver_common.h"
@@ -40,6 +41,7 @@
 #include "src/chunkserver/datastore/chunkserver_snapshot.h"
 #include "src/chunkserver/datastore/define.h"
 #include "src/chunkserver/datastore/file_pool.h"
+#include "src/chunkserver/datastore/page_cache.h"
 
 #include "src/common/fast_align.h"
 
@@ -54,6 +56,7 @@ using curve::common::BitRange;
 
 class FilePool;
 class CSSnapshot;
+class CSChunkIndex;
 struct DataStoreMetric;
 
 /**
@@ -90,6 +93,25 @@ struct ChunkFileMetaPage {
     CSErrorCode decode(const char* buf);
 };
 
+/**
+ * Checksum File Format
+ * An entry of 8 bytes for every page of the chunk, indexed by page:
+ * crc: 4 bytes, the crc32c of the page
+ * flags: 4 bytes, kPageChecksumValid if the crc is recorded
+ * The entries of the pages never written since checksum is enabled are
+ * all zero, so any crc value, including 0, can be recorded and verified
+ */
+const uint32_t kPageChecksumValid = 1;
+
+struct PageChecksum {
+    uint32_t crc;
+    uint32_t flags;
+
+    bool valid() const {
+        return flags & kPageChecksumValid;
+    }
+};
+
 struct ChunkOptions {
     // The id of the chunk, used as the file name of the chunk
     ChunkID         id;
@@ -109,6 +131,21 @@ struct ChunkOptions {
     PageSizeType    pageSize;
     // datastore internal statistical metric
     std::shared_ptr<DataStoreMetric> metric;
+    // The bitmap changes of a clone chunk are recorded by the write and paste
+    // requests in the raft log, so they can be kept in memory and persisted
+    // after this many pages have been newly written, or when the raft
+    // snapshot is saved. After restart the bitmap is rebuilt by replaying the
+    // raft log. 0 means the metapage is persisted after every write
+    uint32_t        metaFlushPages;
+    // The page cache shared by the datastores, nullptr means disabled
+    std::shared_ptr<CSPageCache> pageCache;
+    // The owner id of the datastore in the page cache
+    uint64_t        cacheOwner;
+    // The chunk index of the datastore, nullptr means disabled
+    std::shared_ptr<CSChunkIndex> index;
+    // Keep a crc32c of every page in a checksum file beside the chunk file,
+    // updated on write and verified on read
+    bool            enableChecksum;
 
     ChunkOptions() : id(0)
                    , sn(0)
@@ -117,7 +154,12 @@ struct ChunkOptions {
                    , location("")
                    , chunkSize(0)
                    , pageSize(0)
-                   , metric(nullptr) {}
+                   , metric(nullptr)
+                   , metaFlushPages(0)
+                   , pageCache(nullptr)
+                   , cacheOwner(0)
+                   , index(nullptr)
+                   , enableChecksum(false) {}
 };
 
 class CSChunkFile {
@@ -137,6 +179,14 @@ class CSChunkFile {
      * @return returns the error code
      */
     CSErrorCode Open(bool createFile);
+    /**
+     * Called when the chunk is found in the chunk index during Datastore
+     * initialization, the metapage is taken from the index instead of the
+     * chunk file, and the chunk file is opened on the first access
+     * Normally, there is no concurrency, add write lock
+     * @param metaPage: the metapage of the chunk recorded in the index
+     */
+    void LoadFromIndex(const ChunkFileMetaPage& metaPage);
     /**
      * Called when a snapshot file is found during Datastore initialization
      * Load the metapage of the snapshot file into the memory inside the
@@ -187,6 +237,19 @@ class CSChunkFile {
      */
     CSErrorCode Read(char * buf, off_t offset, size_t length);
 
+    /**
+     * Get the checksum of the pages in the range from the recorded page
+     * checksums, the chunk data is read only for the pages without recorded
+     * checksum. The result is the crc32c of the page checksums, so it is the
+     * same on the replicas with the same data
+     * There may be concurrency, add read lock
+     * @param offset: the starting offset, must be page aligned
+     * @param length: the length, must be page aligned
+     * @param crc[out]: the checksum of the range
+     * @return: return error code
+     */
+    CSErrorCode GetChecksum(off_t offset, size_t length, uint32_t* crc);
+
     /**
      * Read chunk meta data
      * There may be concurrency, add read lock
@@ -236,6 +299,12 @@ class CSChunkFile {
      * @param[out]: the chunk info getted
      */
     void GetInfo(CSChunkInfo* info);
+    /**
+     * Get a copy of the metapage, used to save the chunk index
+     * There may be concurrency, add read lock
+     * @param[out]: the metapage of the chunk
+     */
+    void GetMetaPage(ChunkFileMetaPage* metaPage);
     /**
      * Get the hash value of the chunk, this interface is used for test
      * @param[out]: chunk hash value
@@ -256,6 +325,14 @@ class CSChunkFile {
         metaPage_ = metaPage;
     }
 
+    /**
+     * Persist the bitmap of the clone chunk which has only been updated in
+     * memory and the page checksums, do nothing if there is no such update
+     * There may be concurrency, add write lock
+     * @return: return error code
+     */
+    CSErrorCode SyncMetaPage();
+
  private:
     /**
      * Determine whether you need to create a new snapshot
@@ -294,8 +371,51 @@ class CSChunkFile {
      * Update the bitmap of the clone chunk
      * If all pages have been written, the clone chunk will be converted
      * to a normal chunk
+     * If metaFlushPages_ is set, the metapage is persisted only when enough
+     * pages have been written since the last persistence
      */
     CSErrorCode flush();
+    /**
+     * Open the chunk file if it is loaded from the chunk index and has not
+     * been opened yet
+     * @return: return 0 on success, otherwise return a negative number
+     */
+    int ensureOpened();
+    /**
+     * Must be called before the metapage is changed on disk, or the chunk
+     * file is created or deleted
+     */
+    void invalidateIndex();
+    /**
+     * Open the checksum file and load the page checksums
+     * @param create: true to truncate the checksum file of a new chunk
+     * @return: return 0 on success, otherwise return a negative number
+     */
+    int openChecksum(bool create);
+    /**
+     * Update the checksums of the pages in the written range and write them
+     * to the checksum file, the pages partially written are read back from
+     * the chunk file
+     * @param buf: the data written, nullptr to read all the pages back
+     * @param offset: the starting offset of the written range
+     * @param length: the length of the written range
+     * @return: return 0 on success, otherwise return a negative number
+     */
+    int updateChecksum(const butil::IOBuf* buf, off_t offset, size_t length);
+    /**
+     * Verify the data read against the page checksums, the pages partially
+     * read are read again as a whole
+     * @param buf: the data read
+     * @param offset: the starting offset of the data
+     * @param length: the length of the data
+     * @return: return error code
+     */
+    CSErrorCode verifyChecksum(const char* buf, off_t offset, size_t length);
+
+    inline string checksumPath() {
+        return baseDir_ + "/" +
+                    FileNameOperator::GenerateChecksumFileName(chunkId_);
+    }
 
     inline string path() {
         return baseDir_ + "/" +
@@ -307,19 +427,35 @@ class CSChunkFile {
     }
 
     inline int readMetaPage(char* buf) {
+        int rc = ensureOpened();
+        if (rc < 0) {
+            return rc;
+        }
         return lfs_->Read(fd_, buf, 0, pageSize_);
     }
 
     inline int writeMetaPage(const char* buf) {
+        int rc = ensureOpened();
+        if (rc < 0) {
+            return rc;
+        }
         return lfs_->Write(fd_, buf, 0, pageSize_);
     }
 
     inline int readData(char* buf, off_t offset, size_t length) {
+        int rc = ensureOpened();
+        if (rc < 0) {
+            return rc;
+        }
         return lfs_->Read(fd_, buf, offset + pageSize_, length);
     }
 
     inline int writeData(const char* buf, off_t offset, size_t length) {
-        int rc = lfs_->Write(fd_, buf, offset + pageSize_, length);
+        int rc = ensureOpened();
+        if (rc < 0) {
+            return rc;
+        }
+        rc = lfs_->Write(fd_, buf, offset + pageSize_, length);
         if (rc < 0) {
             return rc;
         }
@@ -339,7 +475,11 @@ class CSChunkFile {
     }
 
     inline int writeData(const butil::IOBuf& buf, off_t offset, size_t length) {
-        int rc = lfs_->Write(fd_, buf, offset + pageSize_, length);
+        int rc = ensureOpened();
+        if (rc < 0) {
+            return rc;
+        }
+        rc = lfs_->Write(fd_, buf, offset + pageSize_, length);
         if (rc < 0) {
             return rc;
         }
@@ -371,6 +511,10 @@ class CSChunkFile {
  private:
     // file descriptor of chunk file
     int fd_;
+    // loaded from the chunk index and the chunk file is not opened yet,
+    // fd_ is set under openMutex_ before this is cleared
+    std::atomic<bool> lazyOpen_;
+    std::mutex openMutex_;
     // The logical size of the chunk, not including metapage
     ChunkSizeType size_;
     // The smallest atomic read and write unit
@@ -386,6 +530,10 @@ class CSChunkFile {
     // has been written but has not yet been updated to the
     // page index in the metapage
     std::set<uint32_t> dirtyPages_;
+    // the number of pages set in the bitmap of memory but not persisted
+    uint32_t unflushedPages_;
+    // persist the bitmap after so many pages are written, 0 means every write
+    uint32_t metaFlushPages_;
     // read-write lock
     RWLock rwLock_;
     // Snapshot file pointer
@@ -396,6 +544,20 @@ class CSChunkFile {
     std::shared_ptr<LocalFileSystem> lfs_;
     // datastore internal statistical indicators
     std::shared_ptr<DataStoreMetric> metric_;
+    // Cache of the chunk pages, accessed with rwLock_ held
+    std::shared_ptr<CSPageCache> pageCache_;
+    // The owner id of the datastore in the page cache
+    uint64_t cacheOwner_;
+    // The chunk index of the datastore, may be nullptr
+    std::shared_ptr<CSChunkIndex> index_;
+    // Whether the page checksums are maintained
+    bool enableChecksum_;
+    // file descriptor of the checksum file
+    int crcFd_;
+    // The checksum entry of every page, same as the checksum file
+    std::vector<PageChecksum> pageCrcs_;
+    // The checksum file has been written since the last sync
+    bool crcDirty_;
 };
 }  // namespace chunkserver
 }  // namespace curve
@@ -23,17 +23,47 @@
 #include <gflags/gflags.h>
 #include <fcntl.h>
 #include <cstring>
+#include <algorithm>
 #include <iostream>
 #include <list>
 #include <memory>
 
 #include "src/chunkserver/datastore/chunkserver_datastore.h"
+#include "src/chunkserver/datastore/datastore_file_helper.h"
 #include "src/chunkserver/datastore/filename_operator.h"
 #include "src/common/location_operator.h"
+#include "src/common/timeutility.h"
 
 namespace curve {
 namespace chunkserver {
 
+using curve::common::TimeUtility;
+
+namespace {
+
+// The time spent in each stage of loading the datastores at startup and the
+// number of chunks loaded in each way, accumulated over all the copysets
+bvar::Adder<uint64_t> g_init_list_us("datastore_init_list_us");
+bvar::Adder<uint64_t> g_init_index_us("datastore_init_index_us");
+bvar::Adder<uint64_t> g_init_load_us("datastore_init_load_us");
+bvar::Adder<uint64_t> g_init_indexed_chunks("datastore_init_indexed_chunks");
+bvar::Adder<uint64_t> g_init_opened_chunks("datastore_init_opened_chunks");
+
+using ChunkFileList = std::vector<std::pair<ChunkID, CSChunkFilePtr>>;
+
+// Collect the chunks for callers that may block on each chunk, the lock
+// of the meta cache is only held while collecting
+ChunkFileList ListChunkFiles(CSMetaCache* metaCache) {
+    ChunkFileList chunkFiles;
+    chunkFiles.reserve(metaCache->Size());
+    metaCache->ForEach([&chunkFiles](ChunkID id, const CSChunkFilePtr& chunk) {
+        chunkFiles.emplace_back(id, chunk);
+    });
+    return chunkFiles;
+}
+
+}  // namespace
+
 CSDataStore::CSDataStore(std::shared_ptr<LocalFileSystem> lfs,
                          std::shared_ptr<FilePool> chunkFilePool,
                          const DataStoreOptions& options)
@@ -41,11 +71,19 @@ CSDataStore::CSDataStore(std::shared_ptr<LocalFileSystem> lfs,
       pageSize_(options.pageSize),
       baseDir_(options.baseDir),
       locationLimit_(options.locationLimit),
+      metaFlushPages_(options.metaFlushPages),
+      pageCache_(options.pageCache),
+      cacheOwner_(0),
       chunkFilePool_(chunkFilePool),
-      lfs_(lfs) {
+      lfs_(lfs),
+      enablePageChecksum_(options.enablePageChecksum) {
     CHECK(!baseDir_.empty()) << "Create datastore failed";
     CHECK(lfs_ != nullptr) << "Create datastore failed";
     CHECK(chunkFilePool_ != nullptr) << "Create datastore failed";
+    if (options.enableChunkIndex) {
+        chunkIndex_ = std::make_shared<CSChunkIndex>(lfs_, baseDir_,
+                                                     chunkSize_, pageSize_);
+    }
 }
 
 CSDataStore::~CSDataStore() {
@@ -61,22 +99,30 @@ bool CSDataStore::Initialize() {
         }
     }
 
+    uint64_t startUs = TimeUtility::GetTimeofDayUs();
     vector<string> files;
     int rc = lfs_->List(baseDir_, &files);
     if (rc < 0) {
         LOG(ERROR) << "List " << baseDir_ << " failed.";
         return false;
     }
+    uint64_t listUs = TimeUtility::GetTimeofDayUs();
 
     // If loaded before, reload here
     metaCache_.Clear();
+    cacheOwner_ = CSPageCache::NewOwner();
     metric_ = std::make_shared<DataStoreMetric>();
+    ChunkIndexMap indexedChunks;
+    bool useIndex = loadChunkIndex(files, &indexedChunks);
+    uint64_t indexUs = TimeUtility::GetTimeofDayUs();
     for (size_t i = 0; i < files.size(); ++i) {
         FileNameOperator::FileInfo info =
             FileNameOperator::ParseFileName(files[i]);
         if (info.type == FileNameOperator::FileType::CHUNK) {
             // If the chunk file has not been loaded yet, load it to metaCache
-            CSErrorCode errorCode = loadChunkFile(info.id);
+            CSErrorCode errorCode = useIndex
+                ? loadChunkFileFromIndex(info.id, indexedChunks[info.id])
+                : loadChunkFile(info.id);
             if (errorCode != CSErrorCode::Success) {
                 LOG(ERROR) << "Load chunk file failed: " << files[i];
                 return false;
@@ -104,11 +150,71 @@ bool CSDataStore::Initialize() {
                 LOG(ERROR) << "Load snapshot failed.";
                 return false;
             }
-        } else {
+        } else if (DatastoreFileHelper::IsChecksumFile(files[i])) {
+            // The checksums are not updated while disabled, so they are stale
+            if (!enablePageChecksum_) {
+                lfs_->Delete(baseDir_ + "/" + files[i]);
+            }
+        } else if (!DatastoreFileHelper::IsIndexFile(files[i])) {
             LOG(WARNING) << "Unknown file: " << files[i];
         }
     }
-    LOG(INFO) << "Initialize data store success.";
+    uint64_t loadUs = TimeUtility::GetTimeofDayUs();
+    g_init_list_us << listUs - startUs;
+    g_init_index_us << indexUs - listUs;
+    g_init_load_us << loadUs - indexUs;
+    if (useIndex) {
+        g_init_indexed_chunks << indexedChunks.size();
+    } else {
+        g_init_opened_chunks << metaCache_.Size();
+    }
+    LOG(INFO) << "Initialize data store success."
+              << " path = " << baseDir_
+              << ", chunks = " << metaCache_.Size()
+              << ", use index = " << useIndex
+              << ", list us = " << listUs - startUs
+              << ", index us = " << indexUs - listUs
+              << ", load us = " << loadUs - indexUs;
+    return true;
+}
+
+bool CSDataStore::loadChunkIndex(const vector<string>& files,
+                                 ChunkIndexMap* chunks) {
+    string indexName = FileNameOperator::GenerateIndexFileName();
+    if (std::find(files.begin(), files.end(), indexName) == files.end()) {
+        return false;
+    }
+    if (chunkIndex_ == nullptr) {
+        // The index saved when it was enabled may be stale now
+        lfs_->Delete(baseDir_ + "/" + indexName);
+        return false;
+    }
+    if (!chunkIndex_->Load(chunks)) {
+        return false;
+    }
+
+    bool match = true;
+    size_t chunkCount = 0;
+    for (const auto& file : files) {
+        FileNameOperator::FileInfo info =
+            FileNameOperator::ParseFileName(file);
+        if (info.type != FileNameOperator::FileType::CHUNK) {
+            continue;
+        }
+        ++chunkCount;
+        if (chunks->find(info.id) == chunks->end()) {
+            LOG(WARNING) << "Chunk not found in chunk index: " << file;
+            match = false;
+        }
+    }
+    if (!match || chunkCount != chunks->size()) {
+        LOG(WARNING) << "Chunk index mismatch, path = " << baseDir_
+                     << ", chunk files = " << chunkCount
+                     << ", chunks in index = " << chunks->size();
+        chunkIndex_->Invalidate();
+        chunks->clear();
+        return false;
+    }
     return true;
 }
 
@@ -248,7 +354,12 @@ CSErrorCode CSDataStore::WriteChunk(ChunkID id,
         options.chunkSize = chunkSize_;
         options.location = cloneSourceLocation;
         options.pageSize = pageSize_;
+        options.metaFlushPages = metaFlushPages_;
+        options.pageCache = pageCache_;
+        options.cacheOwner = cacheOwner_;
         options.metric = metric_;
+        options.index = chunkIndex_;
+        options.enableChecksum = enablePageChecksum_;
         CSErrorCode errorCode = CreateChunkFile(options, &chunkFile);
         if (errorCode != CSErrorCode::Success) {
             return errorCode;
@@ -296,7 +407,12 @@ CSErrorCode CSDataStore::CreateCloneChunk(ChunkID id,
         options.baseDir = baseDir_;
         options.chunkSize = chunkSize_;
         options.pageSize = pageSize_;
+        options.metaFlushPages = metaFlushPages_;
+        options.pageCache = pageCache_;
+        options.cacheOwner = cacheOwner_;
         options.metric = metric_;
+        options.index = chunkIndex_;
+        options.enableChecksum = enablePageChecksum_;
         CSErrorCode errorCode = CreateChunkFile(options, &chunkFile);
         if (errorCode != CSErrorCode::Success) {
             return errorCode;
@@ -371,11 +487,25 @@ CSErrorCode CSDataStore::GetChunkHash(ChunkID id,
     return chunkFile->GetHash(offset, length, hash);
 }
 
+CSErrorCode CSDataStore::GetChunkChecksum(ChunkID id,
+                                          off_t offset,
+                                          size_t length,
+                                          uint32_t* crc) {
+    auto chunkFile = metaCache_.Get(id);
+    if (chunkFile == nullptr) {
+        LOG(INFO) << "Get chunk checksum failed, Chunk not exists."
+                  << "ChunkID = " << id;
+        return CSErrorCode::ChunkNotExistError;
+    }
+    return chunkFile->GetChecksum(offset, length, crc);
+}
+
 DataStoreStatus CSDataStore::GetStatus() {
     DataStoreStatus status;
     status.chunkFileCount = metric_->chunkFileCount.get_value();
     status.cloneChunkCount = metric_->cloneChunkCount.get_value();
     status.snapshotCount = metric_->snapshotCount.get_value();
+    status.crcErrorCount = metric_->crcErrorCount.get_value();
     return status;
 }
 
@@ -388,7 +518,12 @@ CSErrorCode CSDataStore::loadChunkFile(ChunkID id) {
         options.baseDir = baseDir_;
         options.chunkSize = chunkSize_;
         options.pageSize = pageSize_;
+        options.metaFlushPages = metaFlushPages_;
+        options.pageCache = pageCache_;
+        options.cacheOwner = cacheOwner_;
         options.metric = metric_;
+        options.index = chunkIndex_;
+        options.enableChecksum = enablePageChecksum_;
         CSChunkFilePtr chunkFilePtr =
             std::make_shared<CSChunkFile>(lfs_,
                                           chunkFilePool_,
@@ -401,9 +536,69 @@ CSErrorCode CSDataStore::loadChunkFile(ChunkID id) {
     return CSErrorCode::Success;
 }
 
+CSErrorCode CSDataStore::loadChunkFileFromIndex(
+    ChunkID id, const ChunkFileMetaPage& metaPage) {
+    if (metaCache_.Get(id) == nullptr) {
+        ChunkOptions options;
+        options.id = id;
+        options.sn = 0;
+        options.baseDir = baseDir_;
+        options.chunkSize = chunkSize_;
+        options.pageSize = pageSize_;
+        options.metaFlushPages = metaFlushPages_;
+        options.pageCache = pageCache_;
+        options.cacheOwner = cacheOwner_;
+        options.metric = metric_;
+        options.index = chunkIndex_;
+        options.enableChecksum = enablePageChecksum_;
+        CSChunkFilePtr chunkFilePtr =
+            std::make_shared<CSChunkFile>(lfs_,
+                                          chunkFilePool_,
+                                          options);
+        chunkFilePtr->LoadFromIndex(metaPage);
+        metaCache_.Set(id, chunkFilePtr);
+    }
+    return CSErrorCode::Success;
+}
+
 ChunkMap CSDataStore::GetChunkMap() {
     return metaCache_.GetMap();
 }
 
+CSErrorCode CSDataStore::SyncChunkMetaPages() {
+    if (metaFlushPages_ == 0 && !enablePageChecksum_) {
+        return CSErrorCode::Success;
+    }
+    // SyncMetaPage does IO, don't call it under the lock of the meta cache
+    for (auto& item : ListChunkFiles(&metaCache_)) {
+        CSErrorCode errorCode = item.second->SyncMetaPage();
+        if (errorCode != CSErrorCode::Success) {
+            LOG(ERROR) << "Sync chunk metapage failed."
+                       << "ChunkID = " << item.first;
+            return errorCode;
+        }
+    }
+    return CSErrorCode::Success;
+}
+
+CSErrorCode CSDataStore::SaveChunkIndex() {
+    if (chunkIndex_ == nullptr) {
+        return CSErrorCode::Success;
+    }
+    int rc = chunkIndex_->Save([this](ChunkIndexMap* chunks) {
+        // GetMetaPage waits for the lock of the chunk, which may be held
+        // by a write, so don't call it under the lock of the meta cache
+        for (auto& item : ListChunkFiles(&metaCache_)) {
+            item.second->GetMetaPage(&(*chunks)[item.first]);
+        }
+    });
+    if (rc < 0) {
+        LOG(WARNING) << "Save chunk index failed, path = " << baseDir_
+                     << ", rc = " << rc;
+        return CSErrorCode::InternalError;
+    }
+    return CSErrorCode::Success;
+}
+
 }  // namespace chunkserver
 }  // namespace curve
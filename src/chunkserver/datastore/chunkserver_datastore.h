@@ -37,6 +37,7 @@
 #include "src/common/concurrent/concurrent.h"
 #include "src/chunkserver/datastore/define.h"
 #include "src/chunkserver/datastore/chunkserver_chunkfile.h"
+#include "src/chunkserver/datastore/chunk_index.h"
 #include "src/chunkserver/datastore/file_pool.h"
 #include "src/fs/local_filesystem.h"
 
@@ -59,6 +60,28 @@ struct DataStoreOptions {
     ChunkSizeType                       chunkSize;
     PageSizeType                        pageSize;
     uint32_t                            locationLimit;
+    // The number of newly written pages a clone chunk accumulates in memory
+    // before its bitmap is persisted to the metapage, 0 means persisting
+    // after every write. See ChunkOptions::metaFlushPages
+    uint32_t                            metaFlushPages;
+    // The page cache shared by all datastores, nullptr means disabled
+    std::shared_ptr<CSPageCache>        pageCache;
+    // Save the metapages of all chunks into an index when the raft snapshot
+    // is saved, and load the chunks from the index at startup without
+    // opening the chunk files. See CSChunkIndex
+    bool                                enableChunkIndex;
+    // Keep a crc32c of every page of the chunks, verified on read and used
+    // by the scan instead of reading the chunk data. See
+    // CSChunkFile::GetChecksum
+    bool                                enablePageChecksum;
+
+    DataStoreOptions() : chunkSize(0)
+                       , pageSize(0)
+                       , locationLimit(0)
+                       , metaFlushPages(0)
+                       , pageCache(nullptr)
+                       , enableChunkIndex(false)
+                       , enablePageChecksum(false) {}
 };
 
 /**
@@ -66,14 +89,17 @@ struct DataStoreOptions {
  * chunkFileCount: the number of chunks in the DataStore
  * snapshotCount: the number of snapshots in the DataStore
  * cloneChunkCount: the number of clone chunks
+ * crcErrorCount: the number of page checksum mismatches found on read
  */
 struct DataStoreStatus {
     uint32_t chunkFileCount;
     uint32_t snapshotCount;
     uint32_t cloneChunkCount;
+    uint32_t crcErrorCount;
     DataStoreStatus() : chunkFileCount(0)
                     , snapshotCount(0)
-                    , cloneChunkCount(0) {}
+                    , cloneChunkCount(0)
+                    , crcErrorCount(0) {}
 };
 
 /**
@@ -81,66 +107,124 @@ struct DataStoreStatus {
  * chunkFileCount: the number of chunks in the DataStore
  * snapshotCount: the number of snapshots in the DataStore
  * cloneChunkCount: the number of clone chunks
+ * crcErrorCount: the number of page checksum mismatches found on read
  */
 struct DataStoreMetric {
     bvar::Adder<uint32_t> chunkFileCount;
     bvar::Adder<uint32_t> snapshotCount;
     bvar::Adder<uint32_t> cloneChunkCount;
+    bvar::Adder<uint32_t> crcErrorCount;
 };
 using DataStoreMetricPtr = std::shared_ptr<DataStoreMetric>;
 
 using ChunkMap = std::unordered_map<ChunkID, CSChunkFilePtr>;
-// For the mapping from chunkid to chunkfile,
-// use read-write lock to protect the map operation
+// For the mapping from chunkid to chunkfile. The map is split into shards
+// by chunk id, each shard is protected by its own read-write lock, so the
+// lookups of the apply threads on different chunks do not contend on
+// the same lock
 class CSMetaCache {
  public:
-    CSMetaCache() {}
+    static const uint32_t kDefaultShardNum = 64;
+
+    explicit CSMetaCache(uint32_t shardNum = kDefaultShardNum) {
+        if (shardNum == 0) {
+            shardNum = 1;
+        }
+        for (uint32_t i = 0; i < shardNum; ++i) {
+            shards_.emplace_back(new Shard());
+        }
+    }
     virtual ~CSMetaCache() {}
 
+    /**
+     * Return a copy of all the chunks, prefer ForEach if the caller
+     * does not need to keep the map
+     */
     ChunkMap GetMap() {
-        ReadLockGuard readGuard(rwLock_);
-        return chunkMap_;
+        ChunkMap chunkMap;
+        for (auto& shard : shards_) {
+            ReadLockGuard readGuard(shard->rwLock);
+            chunkMap.insert(shard->chunkMap.begin(), shard->chunkMap.end());
+        }
+        return chunkMap;
+    }
+
+    /**
+     * Call func(id, chunkFile) for each chunk without copying the map,
+     * func is called with the read lock of the shard held, so it should
+     * not block or access the cache
+     */
+    template <typename Func>
+    void ForEach(const Func& func) {
+        for (auto& shard : shards_) {
+            ReadLockGuard readGuard(shard->rwLock);
+            for (const auto& item : shard->chunkMap) {
+                func(item.first, item.second);
+            }
+        }
+    }
+
+    size_t Size() {
+        size_t size = 0;
+        for (auto& shard : shards_) {
+            ReadLockGuard readGuard(shard->rwLock);
+            size += shard->chunkMap.size();
+        }
+        return size;
     }
 
     CSChunkFilePtr Get(ChunkID id) {
-        ReadLockGuard readGuard(rwLock_);
-        if (chunkMap_.find(id) == chunkMap_.end()) {
+        Shard* shard = GetShard(id);
+        ReadLockGuard readGuard(shard->rwLock);
+        auto it = shard->chunkMap.find(id);
+        if (it == shard->chunkMap.end()) {
             return nullptr;
         }
-        return chunkMap_[id];
+        return it->second;
     }
 
     CSChunkFilePtr Set(ChunkID id, CSChunkFilePtr chunkFile) {
-        WriteLockGuard writeGuard(rwLock_);
-       // When two write requests are concurrently created to create a chunk
-       // file, return the first set chunkFile
-        if (chunkMap_.find(id) == chunkMap_.end()) {
-            chunkMap_[id] = chunkFile;
-        }
-        return chunkMap_[id];
+        Shard* shard = GetShard(id);
+        WriteLockGuard writeGuard(shard->rwLock);
+        // When two write requests are concurrently created to create a chunk
+        // file, return the first set chunkFile
+        auto ret = shard->chunkMap.emplace(id, chunkFile);
+        return ret.first->second;
     }
 
     void Remove(ChunkID id) {
-        WriteLockGuard writeGuard(rwLock_);
-        if (chunkMap_.find(id) != chunkMap_.end()) {
-            chunkMap_.erase(id);
-        }
+        Shard* shard = GetShard(id);
+        WriteLockGuard writeGuard(shard->rwLock);
+        shard->chunkMap.erase(id);
     }
 
     void Clear() {
-        WriteLockGuard writeGuard(rwLock_);
-        chunkMap_.clear();
+        for (auto& shard : shards_) {
+            WriteLockGuard writeGuard(shard->rwLock);
+            shard->chunkMap.clear();
+        }
+    }
+
+ private:
+    // Each shard is allocated separately to keep the locks of different
+    // shards out of the same cache line
+    struct Shard {
+        RWLock      rwLock;
+        ChunkMap    chunkMap;
+    };
+
+    Shard* GetShard(ChunkID id) {
+        return shards_[id % shards_.size()].get();
     }
 
  private:
-    RWLock      rwLock_;
-    ChunkMap    chunkMap_;
+    std::vector<std::unique_ptr<Shard>> shards_;
 };
 
 class CSDataStore {
  public:
     // for ut mock
-    CSDataStore() {}
+    CSDataStore() : enablePageChecksum_(false) {}
 
     CSDataStore(std::shared_ptr<LocalFileSystem> lfs,
                 std::shared_ptr<FilePool> chunkFilePool,
@@ -298,6 +382,29 @@ class CSDataStore {
                                      off_t offset,
                                      size_t length,
                                      std::string* hash);
+    /**
+     * Get the checksum of a page aligned range of the chunk, computed from
+     * the page checksums if enabled, so it does not read the chunk data.
+     * The result differs from the crc32c of the data in the range, all the
+     * replicas must use the same page checksum setting
+     * @param id[in]: chunk id
+     * @param offset[in]: the starting offset, must be page aligned
+     * @param length[in]: the length, must be page aligned
+     * @param crc[out]: the checksum of the range
+     * @return: return error code
+     */
+    virtual CSErrorCode GetChunkChecksum(ChunkID id,
+                                         off_t offset,
+                                         size_t length,
+                                         uint32_t* crc);
+
+    /**
+     * Whether the page checksums of the chunks are maintained
+     */
+    virtual bool PageChecksumEnabled() const {
+        return enablePageChecksum_;
+    }
+
     /**
      * Get internal statistics of DataStore
      * @return: internal statistics of datastore
@@ -306,8 +413,33 @@ class CSDataStore {
 
     virtual ChunkMap GetChunkMap();
 
+    /**
+     * Persist the bitmaps of all clone chunks that are only updated in
+     * memory and the page checksums, called before the raft snapshot is saved so that the raft log
+     * covering these updates can be truncated
+     * @return: return error code
+     */
+    virtual CSErrorCode SyncChunkMetaPages();
+
+    /**
+     * Save the metapages of all chunks into the chunk index, called when
+     * the raft snapshot is saved, do nothing if the chunk index is disabled
+     * @return: return error code
+     */
+    virtual CSErrorCode SaveChunkIndex();
+
  private:
     CSErrorCode loadChunkFile(ChunkID id);
+    CSErrorCode loadChunkFileFromIndex(ChunkID id,
+                                       const ChunkFileMetaPage& metaPage);
+    /**
+     * Load the chunk index and check that it records exactly the chunk
+     * files in the directory
+     * @param files: the files in the datastore directory
+     * @param chunks[out]: the metapages of the chunks in the index
+     * @return: true if the chunks can be loaded from the index
+     */
+    bool loadChunkIndex(const vector<string>& files, ChunkIndexMap* chunks);
     CSErrorCode CreateChunkFile(const ChunkOptions & ops,
                                 CSChunkFilePtr* chunkFile);
 
@@ -318,6 +450,13 @@ class CSDataStore {
     PageSizeType pageSize_;
     // clone chunk location length limit
     uint32_t locationLimit_;
+    // the threshold of pages to persist the bitmap of clone chunk
+    uint32_t metaFlushPages_;
+    // the page cache of chunk data, may be nullptr
+    std::shared_ptr<CSPageCache> pageCache_;
+    // the owner id in the page cache, renewed on every Initialize, so the
+    // pages cached before reloading are never hit
+    uint64_t cacheOwner_;
     // datastore management directory
     std::string baseDir_;
     // the mapping of chunkid->chunkfile
@@ -329,6 +468,10 @@ class CSDataStore {
     std::shared_ptr<LocalFileSystem> lfs_;
     // internal statistics of datastore
     DataStoreMetricPtr metric_;
+    // the chunk index, nullptr if disabled
+    std::shared_ptr<CSChunkIndex> chunkIndex_;
+    // whether the page checksums are maintained
+    bool enablePageChecksum_;
 };
 
 }  // namespace chunkserver
@@ -68,5 +68,18 @@ bool DatastoreFileHelper::IsChunkFile(const string& fileName) {
     return info.type == FileNameOperator::FileType::CHUNK;
 }
 
+bool DatastoreFileHelper::IsIndexFile(const string& fileName) {
+    string indexName = FileNameOperator::GenerateIndexFileName();
+    return fileName.compare(0, indexName.size(), indexName) == 0;
+}
+
+bool DatastoreFileHelper::IsChecksumFile(const string& fileName) {
+    vector<string> elements;
+    ::curve::common::SplitString(fileName, "_", &elements);
+    return elements.size() == 3
+           && elements[0].compare("chunk") == 0
+           && elements[2].compare("crc") == 0;
+}
+
 }  // namespace chunkserver
 }  // namespace curve
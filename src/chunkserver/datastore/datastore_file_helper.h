@@ -78,6 +78,20 @@ class DatastoreFileHelper {
      */
     static bool IsChunkFile(const string& fileName);
 
+    /**
+     * Determine whether the file is the chunk index of the datastore
+     * @param fileName: file name
+     * @return true-is the chunk index or its temporary file, false-not
+     */
+    static bool IsIndexFile(const string& fileName);
+
+    /**
+     * Determine whether the file stores the page checksums of a chunk
+     * @param fileName: file name
+     * @return true-is a checksum file, false-not a checksum file
+     */
+    static bool IsChecksumFile(const string& fileName);
+
  private:
     std::shared_ptr<LocalFileSystem> fs_;
 };
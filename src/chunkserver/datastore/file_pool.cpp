@@ -41,6 +41,7 @@
 #include "src/common/curve_define.h"
 
 using curve::common::kFilePoolMaigic;
+using curve::fs::FileSystemInfo;
 
 namespace curve {
 namespace chunkserver {
@@ -52,6 +53,7 @@ const uint32_t FilePoolHelper::kPersistSize = 4096;
 const std::string FilePool::kCleanChunkSuffix_ = ".clean";  // NOLINT
 const std::chrono::milliseconds FilePool::kSuccessSleepMsec_(10);
 const std::chrono::milliseconds FilePool::kFailSleepMsec_(500);
+const std::chrono::milliseconds FilePool::kMaxCleanSleepMsec_(2000);
 
 int FilePoolHelper::PersistEnCodeMetaInfo(
     std::shared_ptr<LocalFileSystem> fsptr, uint32_t chunkSize,
@@ -201,10 +203,12 @@ int FilePoolHelper::DecodeMetaInfoFromMetaFile(
 }
 
 FilePool::FilePool(std::shared_ptr<LocalFileSystem> fsptr)
-    : currentmaxfilenum_(0) {
+    : currentmaxfilenum_(0),
+      zeroingOffload_(false) {
     CHECK(fsptr != nullptr) << "fs ptr allocate failed!";
     fsptr_ = fsptr;
     cleanAlived_ = false;
+    allocAlived_ = false;
     dirtyChunks_.clear();
     cleanChunks_.clear();
     char* buffer = new (std::nothrow) (char[poolOpt_.bytesPerWrite]);
@@ -214,6 +218,7 @@ FilePool::FilePool(std::shared_ptr<LocalFileSystem> fsptr)
 
 bool FilePool::Initialize(const FilePoolOptions& cfopt) {
     poolOpt_ = cfopt;
+    zeroingOffload_.store(poolOpt_.zeroingOffload);
     if (poolOpt_.getFileFromPool) {
         if (!CheckValid()) {
             LOG(ERROR) << "check valid failed!";
@@ -273,7 +278,7 @@ bool FilePool::CleanChunk(uint64_t chunkid, bool onlyMarked) {
             LOG(ERROR) << "Fallocate file failed: " << chunkpath;
             return false;
         }
-    } else {
+    } else if (!OffloadZeroing(fd, chunklen)) {
         int nbytes;
         uint64_t nwrite = 0;
         uint64_t ntotal = chunklen;
@@ -306,6 +311,25 @@ bool FilePool::CleanChunk(uint64_t chunkid, bool onlyMarked) {
     return true;
 }
 
+bool FilePool::OffloadZeroing(int fd, uint64_t chunklen) {
+    if (!zeroingOffload_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    int ret = fsptr_->Fallocate(fd, FALLOC_FL_WRITE_ZEROES, 0, chunklen);
+    if (ret == -EOPNOTSUPP || ret == -EINVAL) {
+        LOG(WARNING) << "The device does not support write zeroes offload, "
+                     << "fall back to write zero to clean chunk";
+        zeroingOffload_.store(false);
+        return false;
+    } else if (ret < 0 || fsptr_->Fsync(fd) < 0) {
+        return false;
+    }
+
+    cleanThrottle_.Add(false, chunklen);
+    return true;
+}
+
 bool FilePool::CleaningChunk() {
     auto popBack = [this](std::vector<uint64_t>* chunks,
         uint64_t* chunksLeft) -> uint64_t {
@@ -345,10 +369,30 @@ bool FilePool::CleaningChunk() {
     return true;
 }
 
+std::chrono::milliseconds FilePool::CalcCleanInterval(
+    std::chrono::milliseconds current, uint64_t latencyUs,
+    uint32_t thresholdUs) {
+    if (latencyUs > thresholdUs) {
+        return std::min(current * 2, kMaxCleanSleepMsec_);
+    }
+    return std::max(current / 2, kSuccessSleepMsec_);
+}
+
 void FilePool::CleanWorker() {
     auto sleepInterval = kSuccessSleepMsec_;
+    auto cleanInterval = kSuccessSleepMsec_;
     while (cleanSleeper_.wait_for(sleepInterval)) {
-        sleepInterval = CleaningChunk() ? kSuccessSleepMsec_ : kFailSleepMsec_;
+        if (!CleaningChunk()) {
+            sleepInterval = kFailSleepMsec_;
+            continue;
+        }
+
+        // Give way to foreground io when its latency is high
+        if (latencyProbe_ && poolOpt_.cleanLatencyThresholdUs > 0) {
+            cleanInterval = CalcCleanInterval(cleanInterval, latencyProbe_(),
+                poolOpt_.cleanLatencyThresholdUs);
+        }
+        sleepInterval = cleanInterval;
     }
 }
 
@@ -376,6 +420,96 @@ bool FilePool::StopCleaning() {
     return true;
 }
 
+bool FilePool::AllocatingChunk(bool* finished) {
+    *finished = false;
+    FileSystemInfo info;
+    if (fsptr_->Statfs(currentdir_, &info) != 0) {
+        LOG(ERROR) << "Get disk usage info failed: " << currentdir_;
+        return false;
+    }
+
+    uint64_t chunklen = poolOpt_.fileSize + poolOpt_.metaPageSize;
+    uint64_t used = info.total - info.available;
+    if (used + chunklen > info.total / 100 * poolOpt_.allocatePercent) {
+        *finished = true;
+        return true;
+    }
+
+    uint64_t chunkid = 0;
+    {
+        std::unique_lock<std::mutex> lk(mtx_);
+        chunkid = currentmaxfilenum_.fetch_add(1) + 1;
+    }
+    std::string chunkpath = currentdir_ + "/" + std::to_string(chunkid);
+    int fd = fsptr_->Open(chunkpath, O_RDWR | O_CREAT);
+    if (fd < 0) {
+        LOG(ERROR) << "Open file failed: " << chunkpath;
+        return false;
+    }
+
+    // The new chunk is dirty, it will be zeroed by the clean thread
+    int ret = fsptr_->Fallocate(fd, 0, 0, chunklen);
+    if (ret == 0) {
+        ret = fsptr_->Fsync(fd);
+    }
+    fsptr_->Close(fd);
+    if (ret < 0) {
+        LOG(ERROR) << "Allocate file failed: " << chunkpath;
+        fsptr_->Delete(chunkpath);
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lk(mtx_);
+    dirtyChunks_.push_back(chunkid);
+    currentState_.dirtyChunksLeft++;
+    currentState_.preallocatedChunksLeft++;
+    return true;
+}
+
+void FilePool::AllocateWorker() {
+    auto sleepInterval = kSuccessSleepMsec_;
+    auto allocInterval = kSuccessSleepMsec_;
+    while (allocSleeper_.wait_for(sleepInterval)) {
+        bool finished = false;
+        if (!AllocatingChunk(&finished)) {
+            sleepInterval = kFailSleepMsec_;
+            continue;
+        } else if (finished) {
+            LOG(INFO) << "Allocate chunk finished, now chunkpool size = "
+                      << Size();
+            break;
+        }
+
+        // Give way to foreground io when its latency is high
+        if (latencyProbe_ && poolOpt_.cleanLatencyThresholdUs > 0) {
+            allocInterval = CalcCleanInterval(allocInterval, latencyProbe_(),
+                poolOpt_.cleanLatencyThresholdUs);
+        }
+        sleepInterval = allocInterval;
+    }
+}
+
+bool FilePool::StartAllocating() {
+    if (poolOpt_.getFileFromPool && poolOpt_.allocateInBackground
+        && !allocAlived_.exchange(true)) {
+        allocThread_ = Thread(&FilePool::AllocateWorker, this);
+        LOG(INFO) << "Start allocate thread ok.";
+    }
+
+    return true;
+}
+
+bool FilePool::StopAllocating() {
+    if (allocAlived_.exchange(false)) {
+        LOG(INFO) << "Stop allocating...";
+        allocSleeper_.interrupt();
+        allocThread_.join();
+        LOG(INFO) << "Stop allocate thread ok.";
+    }
+
+    return true;
+}
+
 bool FilePool::GetChunk(bool needClean, uint64_t* chunkid, bool* isCleaned) {
     auto pop = [&](std::vector<uint64_t>* chunks,
         uint64_t* chunksLeft, bool isCleanChunks) -> bool {
@@ -549,6 +683,39 @@ bool FilePool::WriteMetaPage(const std::string& sourcepath, char* page) {
     return true;
 }
 
+bool FilePool::CheckRecycleFile(const std::string& chunkpath) {
+    // Check whether the size of the file to be recovered meets the
+    // requirements
+    uint64_t chunklen = poolOpt_.fileSize + poolOpt_.metaPageSize;
+    int fd = fsptr_->Open(chunkpath.c_str(), O_RDWR);
+    if (fd < 0) {
+        LOG(ERROR) << "file open failed! delete file dirctly"
+                   << ", filename = " << chunkpath.c_str();
+        return false;
+    }
+
+    struct stat info;
+    int ret = fsptr_->Fstat(fd, &info);
+    if (ret != 0) {
+        LOG(ERROR) << "Fstat file " << chunkpath.c_str()
+                   << "failed, ret = " << ret << ", delete file dirctly";
+        fsptr_->Close(fd);
+        return false;
+    }
+
+    if (info.st_size != chunklen) {
+        LOG(ERROR) << "file size illegal, " << chunkpath.c_str()
+                   << ", delete file dirctly"
+                   << ", standard size = " << chunklen
+                   << ", current file size = " << info.st_size;
+        fsptr_->Close(fd);
+        return false;
+    }
+
+    fsptr_->Close(fd);
+    return true;
+}
+
 int FilePool::RecycleFile(const std::string& chunkpath) {
     if (!poolOpt_.getFileFromPool) {
         int ret = fsptr_->Delete(chunkpath.c_str());
@@ -557,36 +724,11 @@ int FilePool::RecycleFile(const std::string& chunkpath) {
             return -1;
         }
     } else {
-        // Check whether the size of the file to be recovered meets the
-        // requirements, and delete it if it does not
-        uint64_t chunklen = poolOpt_.fileSize + poolOpt_.metaPageSize;
-        int fd = fsptr_->Open(chunkpath.c_str(), O_RDWR);
-        if (fd < 0) {
-            LOG(ERROR) << "file open failed! delete file dirctly"
-                       << ", filename = " << chunkpath.c_str();
+        // Delete the file if it does not meet the requirements
+        if (!CheckRecycleFile(chunkpath)) {
             return fsptr_->Delete(chunkpath.c_str());
         }
 
-        struct stat info;
-        int ret = fsptr_->Fstat(fd, &info);
-        if (ret != 0) {
-            LOG(ERROR) << "Fstat file " << chunkpath.c_str()
-                       << "failed, ret = " << ret << ", delete file dirctly";
-            fsptr_->Close(fd);
-            return fsptr_->Delete(chunkpath.c_str());
-        }
-
-        if (info.st_size != chunklen) {
-            LOG(ERROR) << "file size illegal, " << chunkpath.c_str()
-                       << ", delete file dirctly"
-                       << ", standard size = " << chunklen
-                       << ", current file size = " << info.st_size;
-            fsptr_->Close(fd);
-            return fsptr_->Delete(chunkpath.c_str());
-        }
-
-        fsptr_->Close(fd);
-
         uint64_t newfilenum = 0;
         std::string newfilename;
         {
@@ -597,7 +739,7 @@ int FilePool::RecycleFile(const std::string& chunkpath) {
         }
         std::string targetpath = currentdir_ + "/" + newfilename;
 
-        ret = fsptr_->Rename(chunkpath.c_str(), targetpath.c_str());
+        int ret = fsptr_->Rename(chunkpath.c_str(), targetpath.c_str());
         if (ret < 0) {
             LOG(ERROR) << "file rename failed, " << chunkpath.c_str();
             return -1;
@@ -614,6 +756,69 @@ int FilePool::RecycleFile(const std::string& chunkpath) {
     return 0;
 }
 
+int FilePool::RecycleFiles(const std::vector<std::string>& chunkpaths,
+                           uint64_t* recycledNum) {
+    int ret = 0;
+    *recycledNum = 0;
+    if (!poolOpt_.getFileFromPool) {
+        for (auto& chunkpath : chunkpaths) {
+            if (fsptr_->Delete(chunkpath.c_str()) < 0) {
+                LOG(ERROR) << "Recycle chunk failed, " << chunkpath;
+                ret = -1;
+            } else {
+                ++(*recycledNum);
+            }
+        }
+        return ret;
+    }
+
+    std::vector<std::string> validpaths;
+    validpaths.reserve(chunkpaths.size());
+    for (auto& chunkpath : chunkpaths) {
+        if (CheckRecycleFile(chunkpath)) {
+            validpaths.push_back(chunkpath);
+        } else if (fsptr_->Delete(chunkpath.c_str()) < 0) {
+            ret = -1;
+        } else {
+            ++(*recycledNum);
+        }
+    }
+    if (validpaths.empty()) {
+        return ret;
+    }
+
+    // Allocate file names for the whole batch at once
+    uint64_t firstfilenum = 0;
+    {
+        std::unique_lock<std::mutex> lk(mtx_);
+        firstfilenum = currentmaxfilenum_.fetch_add(validpaths.size()) + 1;
+    }
+
+    std::vector<uint64_t> recycled;
+    recycled.reserve(validpaths.size());
+    for (size_t i = 0; i < validpaths.size(); ++i) {
+        uint64_t newfilenum = firstfilenum + i;
+        std::string targetpath = currentdir_ + "/" +
+                                 std::to_string(newfilenum);
+        if (fsptr_->Rename(validpaths[i].c_str(), targetpath.c_str()) < 0) {
+            LOG(ERROR) << "file rename failed, " << validpaths[i];
+            ret = -1;
+            continue;
+        }
+        recycled.push_back(newfilenum);
+    }
+
+    *recycledNum += recycled.size();
+    std::unique_lock<std::mutex> lk(mtx_);
+    dirtyChunks_.insert(dirtyChunks_.end(), recycled.begin(), recycled.end());
+    currentState_.dirtyChunksLeft += recycled.size();
+    currentState_.preallocatedChunksLeft += recycled.size();
+    LOG(INFO) << "Recycle " << recycled.size() << " of " << chunkpaths.size()
+              << " files success, now chunkpool size = "
+              << currentState_.dirtyChunksLeft;
+    return ret;
+}
+
 void FilePool::UnInitialize() {
     currentdir_ = "";
 
@@ -32,6 +32,8 @@
 #include <memory>
 #include <deque>
 #include <atomic>
+#include <chrono>  // NOLINT
+#include <functional>
 
 #include "src/common/concurrent/concurrent.h"
 #include "src/common/interruptible_sleeper.h"
@@ -55,6 +57,17 @@ struct FilePoolOptions {
     // Bytes per write for cleaning chunk (4096)
     uint32_t    bytesPerWrite;
     uint32_t    iops4clean;
+    // Zeroing chunk by fallocate(FALLOC_FL_WRITE_ZEROES) when cleaning,
+    // which is offloaded to the device, fall back to write if not supported
+    bool        zeroingOffload;
+    // Slow down cleaning when the foreground write latency(us) exceeds it,
+    // 0 means cleaning at a fixed pace
+    uint32_t    cleanLatencyThresholdUs;
+    // Keep allocating chunks into the pool in background, so chunkserver
+    // can start with a partially formatted pool
+    bool        allocateInBackground;
+    // Stop allocating when the disk usage reaches the percent
+    uint32_t    allocatePercent;
     // it should be set when getFileFromPool=false
     char        filePoolDir[256];
     uint32_t    fileSize;
@@ -69,6 +82,10 @@ struct FilePoolOptions {
         needClean = false;
         bytesPerWrite = 4096;
         iops4clean = -1;
+        zeroingOffload = false;
+        cleanLatencyThresholdUs = 0;
+        allocateInBackground = false;
+        allocatePercent = 80;
         metaFileSize = 4096;
         fileSize = 0;
         metaPageSize = 0;
@@ -82,6 +99,10 @@ struct FilePoolOptions {
         needClean = other.needClean;
         bytesPerWrite = other.bytesPerWrite;
         iops4clean = other.iops4clean;
+        zeroingOffload = other.zeroingOffload;
+        cleanLatencyThresholdUs = other.cleanLatencyThresholdUs;
+        allocateInBackground = other.allocateInBackground;
+        allocatePercent = other.allocatePercent;
         metaFileSize = other.metaFileSize;
         fileSize = other.fileSize;
         retryTimes = other.retryTimes;
@@ -96,6 +117,10 @@ struct FilePoolOptions {
         needClean = other.needClean;
         bytesPerWrite = other.bytesPerWrite;
         iops4clean = other.iops4clean;
+        zeroingOffload = other.zeroingOffload;
+        cleanLatencyThresholdUs = other.cleanLatencyThresholdUs;
+        allocateInBackground = other.allocateInBackground;
+        allocatePercent = other.allocatePercent;
         metaFileSize = other.metaFileSize;
         fileSize = other.fileSize;
         retryTimes = other.retryTimes;
@@ -185,6 +210,14 @@ class CURVE_CACHELINE_ALIGNMENT FilePool {
      * @param: chunkpath is the chunk path that needs to be recycled
      */
     virtual int RecycleFile(const std::string& chunkpath);
+    /**
+     * Recycle a batch of files, all files enter the pool under one lock
+     * @param: chunkpaths are the paths of files need to be recycled
+     * @param: recycledNum returns how many files are recycled
+     * @return: return 0 if all files are recycled, otherwise return -1
+     */
+    virtual int RecycleFiles(const std::vector<std::string>& chunkpaths,
+                             uint64_t* recycledNum);
     /**
      * Get the current chunkfile pool size
      */
@@ -232,6 +265,39 @@ class CURVE_CACHELINE_ALIGNMENT FilePool {
      */
     bool StopCleaning();
 
+    /**
+     * @brief: Start thread for allocating chunk in background, it keeps
+     *         filling the pool until the disk usage reaches allocatePercent
+     * @return: Return true if success, otherwise return false
+     */
+    bool StartAllocating();
+
+    /**
+     * @brief: Stop thread for allocating chunk
+     * @return: Return true if success, otherwise return false
+     */
+    bool StopAllocating();
+
+    /**
+     * @brief: Set the probe of foreground write latency(us), the cleaning
+     *         thread slows down when the latency exceeds the threshold
+     */
+    void SetLatencyProbe(std::function<uint64_t()> probe) {
+        latencyProbe_ = probe;
+    }
+
+    /**
+     * @brief: Calculate the pause before cleaning next chunk
+     * @param current: The current pause
+     * @param latencyUs: The foreground write latency
+     * @param thresholdUs: The latency threshold
+     * @return: Double the pause if the latency exceeds the threshold,
+     *          otherwise halve it
+     */
+    static std::chrono::milliseconds CalcCleanInterval(
+        std::chrono::milliseconds current, uint64_t latencyUs,
+        uint32_t thresholdUs);
+
  private:
     // Traverse the pre-allocated chunk information from the
     // chunkfile pool directory
@@ -245,6 +311,12 @@ class CURVE_CACHELINE_ALIGNMENT FilePool {
      * @return: returns true if successful, otherwise false
      */
     bool WriteMetaPage(const std::string& sourcepath, char* page);
+    /**
+     * Check whether the file to be recycled has a valid size
+     * @param: chunkpath is the path of file to be recycled
+     * @return: return true if valid, otherwise false
+     */
+    bool CheckRecycleFile(const std::string& chunkpath);
     /**
      * Directly allocate chunks, not from FilePool
      * @param: chunkpath is the path of the chunk file in the datastore
@@ -271,6 +343,15 @@ class CURVE_CACHELINE_ALIGNMENT FilePool {
      */
     bool CleanChunk(uint64_t chunkid, bool onlyMarked);
 
+    /**
+     * @brief: Zeroing chunk file by the device's write zeroes offload
+     * @param fd: The fd of chunk file
+     * @param chunklen: The length of chunk file
+     * @return: Return true if success, return false if failed or
+     *          the device does not support it
+     */
+    bool OffloadZeroing(int fd, uint64_t chunklen);
+
     /**
      * @brief: Clean chunk one by one
      * @return: Return true if clean chunk success, otherwise retrun false
@@ -282,6 +363,18 @@ class CURVE_CACHELINE_ALIGNMENT FilePool {
      */
     void CleanWorker();
 
+    /**
+     * @brief: Allocate a new chunk into the pool
+     * @param finished: Return true if the disk usage reaches allocatePercent
+     * @return: Return true if success or finished, otherwise return false
+     */
+    bool AllocatingChunk(bool* finished);
+
+    /**
+     * @brief: The function of thread for allocating chunk
+     */
+    void AllocateWorker();
+
  private:
     // The suffix of clean chunk file (".0")
     static const std::string kCleanChunkSuffix_;
@@ -292,6 +385,9 @@ class CURVE_CACHELINE_ALIGNMENT FilePool {
     // Sets a pause between cleaning when clean chunk fail
     static const std::chrono::milliseconds kFailSleepMsec_;
 
+    // The max pause between cleaning when foreground latency is high
+    static const std::chrono::milliseconds kMaxCleanSleepMsec_;
+
     // Protect dirtyChunks_, cleanChunks_
     std::mutex mtx_;
 
@@ -331,6 +427,21 @@ class CURVE_CACHELINE_ALIGNMENT FilePool {
 
     // The buffer for write chunk file
     std::unique_ptr<char[]> writeBuffer_;
+
+    // Whether the allocate thread is alive
+    Atomic<bool> allocAlived_;
+
+    // Thread for allocating chunk
+    Thread allocThread_;
+
+    // Sleeper for allocating chunk thread
+    InterruptibleSleeper allocSleeper_;
+
+    // Whether zeroing by offload, disabled once the device doesn't support
+    std::atomic<bool> zeroingOffload_;
+
+    // Get the foreground write latency(us)
+    std::function<uint64_t()> latencyProbe_;
 };
 }   // namespace chunkserver
 }   // namespace curve
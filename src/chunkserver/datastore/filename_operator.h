@@ -61,6 +61,17 @@ class FileNameOperator {
                 + "_snap_" + std::to_string(sn);
     }
 
+    // The index of the chunk metapages in the datastore directory, it is
+    // parsed as UNKNOWN, see CSChunkIndex
+    static inline string GenerateIndexFileName() {
+        return "chunk.index";
+    }
+
+    // The per-page checksums of the chunk, it is parsed as UNKNOWN
+    static inline string GenerateChecksumFileName(ChunkID id) {
+        return GenerateChunkFileName(id) + "_crc";
+    }
+
     static inline FileInfo ParseFileName(const string& fileName) {
         vector<string> elements;
         ::curve::common::SplitString(fileName, "_", &elements);
@@ -0,0 +1,178 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <glog/logging.h>
+#include <string.h>
+#include <algorithm>
+
+#include "src/chunkserver/datastore/page_cache.h"
+
+namespace curve {
+namespace chunkserver {
+
+size_t CSPageCache::PageKeyHash::operator()(const PageKey& key) const {
+    size_t h = std::hash<uint64_t>()(key.id);
+    h ^= std::hash<uint64_t>()(key.owner) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= std::hash<uint32_t>()(key.index) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    return h;
+}
+
+CSPageCache::CSPageCache(const PageCacheOptions& options)
+    : options_(options),
+      usedPages_(0),
+      hits_(0),
+      misses_(0) {
+    CHECK(options_.pageSize > 0) << "Invalid page cache page size";
+    if (options_.shardNum == 0) {
+        options_.shardNum = 1;
+    }
+    shardCapacity_ =
+        options_.capacity / options_.pageSize / options_.shardNum;
+    if (options_.capacity >= options_.pageSize && shardCapacity_ == 0) {
+        shardCapacity_ = 1;
+    }
+    for (uint32_t i = 0; i < options_.shardNum; ++i) {
+        shards_.emplace_back(new Shard());
+    }
+}
+
+uint64_t CSPageCache::NewOwner() {
+    static std::atomic<uint64_t> nextOwner(1);
+    return nextOwner.fetch_add(1, std::memory_order_relaxed);
+}
+
+CSPageCache::Shard* CSPageCache::GetShard(const PageKey& key) {
+    return shards_[PageKeyHash()(key) % shards_.size()].get();
+}
+
+bool CSPageCache::Read(uint64_t owner, ChunkID id, char* buf,
+                       off_t offset, size_t length) {
+    if (length == 0) {
+        return false;
+    }
+    uint32_t pageSize = options_.pageSize;
+    uint32_t beginIndex = offset / pageSize;
+    uint32_t endIndex = (offset + length - 1) / pageSize;
+    for (uint32_t i = beginIndex; i <= endIndex; ++i) {
+        off_t pageOff = static_cast<off_t>(i) * pageSize;
+        off_t copyBegin = std::max(pageOff, offset);
+        off_t copyEnd = std::min<off_t>(pageOff + pageSize, offset + length);
+        PageKey key{owner, id, i};
+        Shard* shard = GetShard(key);
+        std::lock_guard<std::mutex> lk(shard->mtx);
+        auto it = shard->pages.find(key);
+        if (it == shard->pages.end()) {
+            misses_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        shard->lru.splice(shard->lru.begin(), shard->lru, it->second);
+        memcpy(buf + (copyBegin - offset),
+               it->second->data.get() + (copyBegin - pageOff),
+               copyEnd - copyBegin);
+    }
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void CSPageCache::Fill(uint64_t owner, ChunkID id, const char* buf,
+                       off_t offset, size_t length) {
+    if (shardCapacity_ == 0) {
+        return;
+    }
+    uint32_t pageSize = options_.pageSize;
+    // only the pages fully covered by the range can be cached
+    uint64_t beginIndex = (offset + pageSize - 1) / pageSize;
+    uint64_t endIndex = (offset + length) / pageSize;
+    for (uint64_t i = beginIndex; i < endIndex; ++i) {
+        const char* src = buf + (i * pageSize - offset);
+        PageKey key{owner, id, static_cast<uint32_t>(i)};
+        Shard* shard = GetShard(key);
+        std::lock_guard<std::mutex> lk(shard->mtx);
+        auto it = shard->pages.find(key);
+        if (it != shard->pages.end()) {
+            memcpy(it->second->data.get(), src, pageSize);
+            shard->lru.splice(shard->lru.begin(), shard->lru, it->second);
+            continue;
+        }
+        Page page;
+        page.key = key;
+        page.data.reset(new char[pageSize]);
+        memcpy(page.data.get(), src, pageSize);
+        shard->lru.push_front(std::move(page));
+        shard->pages[key] = shard->lru.begin();
+        usedPages_.fetch_add(1, std::memory_order_relaxed);
+        while (shard->pages.size() > shardCapacity_) {
+            shard->pages.erase(shard->lru.back().key);
+            shard->lru.pop_back();
+            usedPages_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void CSPageCache::Update(uint64_t owner, ChunkID id, const butil::IOBuf& buf,
+                         off_t offset, size_t length) {
+    if (length == 0) {
+        return;
+    }
+    uint32_t pageSize = options_.pageSize;
+    uint32_t beginIndex = offset / pageSize;
+    uint32_t endIndex = (offset + length - 1) / pageSize;
+    for (uint32_t i = beginIndex; i <= endIndex; ++i) {
+        off_t pageOff = static_cast<off_t>(i) * pageSize;
+        off_t copyBegin = std::max(pageOff, offset);
+        off_t copyEnd = std::min<off_t>(pageOff + pageSize, offset + length);
+        PageKey key{owner, id, i};
+        Shard* shard = GetShard(key);
+        std::lock_guard<std::mutex> lk(shard->mtx);
+        auto it = shard->pages.find(key);
+        if (it == shard->pages.end()) {
+            continue;
+        }
+        buf.copy_to(it->second->data.get() + (copyBegin - pageOff),
+                    copyEnd - copyBegin, copyBegin - offset);
+    }
+}
+
+void CSPageCache::Invalidate(uint64_t owner, ChunkID id,
+                             off_t offset, size_t length) {
+    if (length == 0) {
+        return;
+    }
+    uint32_t pageSize = options_.pageSize;
+    uint32_t beginIndex = offset / pageSize;
+    uint32_t endIndex = (offset + length - 1) / pageSize;
+    for (uint32_t i = beginIndex; i <= endIndex; ++i) {
+        PageKey key{owner, id, i};
+        Shard* shard = GetShard(key);
+        std::lock_guard<std::mutex> lk(shard->mtx);
+        auto it = shard->pages.find(key);
+        if (it == shard->pages.end()) {
+            continue;
+        }
+        shard->lru.erase(it->second);
+        shard->pages.erase(it);
+        usedPages_.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,156 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_CHUNKSERVER_DATASTORE_PAGE_CACHE_H_
+#define SRC_CHUNKSERVER_DATASTORE_PAGE_CACHE_H_
+
+#include <butil/iobuf.h>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "include/chunkserver/chunkserver_common.h"
+
+namespace curve {
+namespace chunkserver {
+
+struct PageCacheOptions {
+    // The max bytes of page data in the cache
+    uint64_t capacity;
+    // The size of a cached page, should be the page size of datastore
+    uint32_t pageSize;
+    // The number of shards, each shard has its own lock and lru list
+    uint32_t shardNum;
+
+    PageCacheOptions() : capacity(0), pageSize(4096), shardNum(32) {}
+};
+
+/**
+ * A memory bounded cache of chunk pages shared by all datastores of the
+ * chunkserver. Pages are keyed by (owner, chunk id, page index), the owner
+ * identifies a loaded datastore, so the pages of a datastore which is
+ * reloaded after installing a raft snapshot are never hit again and will be
+ * evicted by lru.
+ * Pages are filled after reading from the chunk file and updated in place
+ * when the chunk is written, the chunk file calls these interfaces with its
+ * lock held, so the cache is always consistent with the file.
+ */
+class CSPageCache {
+ public:
+    explicit CSPageCache(const PageCacheOptions& options);
+    ~CSPageCache() = default;
+
+    /**
+     * Allocate an owner id for a datastore
+     */
+    static uint64_t NewOwner();
+
+    /**
+     * Read the data from the cache, only succeed if all the pages covering
+     * [offset, offset + length) are cached
+     * @return: true if all the data is read from the cache
+     */
+    bool Read(uint64_t owner, ChunkID id, char* buf,
+              off_t offset, size_t length);
+
+    /**
+     * Put the pages fully covered by [offset, offset + length) into the cache
+     * @param buf: the data read from the chunk file
+     */
+    void Fill(uint64_t owner, ChunkID id, const char* buf,
+              off_t offset, size_t length);
+
+    /**
+     * Update the cached pages overlapping with [offset, offset + length),
+     * pages not in the cache are not inserted
+     * @param buf: the data written to the chunk file
+     */
+    void Update(uint64_t owner, ChunkID id, const butil::IOBuf& buf,
+                off_t offset, size_t length);
+
+    /**
+     * Remove the cached pages of [offset, offset + length)
+     */
+    void Invalidate(uint64_t owner, ChunkID id, off_t offset, size_t length);
+
+    uint64_t GetHitCount() const {
+        return hits_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetMissCount() const {
+        return misses_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetUsedBytes() const {
+        return usedPages_.load(std::memory_order_relaxed) *
+               options_.pageSize;
+    }
+
+ private:
+    struct PageKey {
+        uint64_t owner;
+        ChunkID id;
+        uint32_t index;
+
+        bool operator==(const PageKey& other) const {
+            return owner == other.owner && id == other.id &&
+                   index == other.index;
+        }
+    };
+
+    struct PageKeyHash {
+        size_t operator()(const PageKey& key) const;
+    };
+
+    struct Page {
+        PageKey key;
+        std::unique_ptr<char[]> data;
+    };
+
+    using PageList = std::list<Page>;
+
+    struct Shard {
+        std::mutex mtx;
+        // The most recently used page is at the front
+        PageList lru;
+        std::unordered_map<PageKey, PageList::iterator, PageKeyHash> pages;
+    };
+
+    Shard* GetShard(const PageKey& key);
+
+ private:
+    PageCacheOptions options_;
+    // The max pages of each shard
+    uint64_t shardCapacity_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<uint64_t> usedPages_;
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_DATASTORE_PAGE_CACHE_H_
@@ -0,0 +1,402 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include "src/chunkserver/dmclock_scheduler.h"
+
+#include <bthread/bthread.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <chrono>   // NOLINT
+#include <limits>
+#include <utility>
+
+#include "src/common/timeutility.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::common::LockGuard;
+using curve::common::TimeUtility;
+using curve::common::UniqueLock;
+
+namespace {
+
+const double kMaxTag = std::numeric_limits<double>::max();
+const double kUsPerSecond = 1000000.0;
+const uint32_t kCostUnitBytes = 64 * 1024;
+// 队列为空或者下发的请求数达到上限时，调度线程的最长等待时间
+const uint64_t kIdleWaitUs = 100 * 1000;
+
+struct DispatchArg {
+    DmClockScheduler* scheduler;
+    QosTask task;
+    QosPhase phase;
+    uint32_t cost;
+};
+
+}  // namespace
+
+DmClockQueue::DmClockQueue(const DmClockOptions& options)
+    : options_(options),
+      size_(0) {
+    if (options_.weight == 0) {
+        options_.weight = 1;
+    }
+}
+
+void DmClockQueue::Push(const QosClientKey& clientId, uint64_t copysetId,
+                        uint32_t delta, uint32_t rho, uint32_t cost,
+                        uint64_t nowUs, QosTask task) {
+    ClientRecord& record = clients_[clientId];
+    double now = static_cast<double>(nowUs);
+    delta = std::max(delta, 1u);
+    rho = std::max(rho, 1u);
+    cost = std::max(cost, 1u);
+
+    Request request;
+    request.copysetId = copysetId;
+    request.cost = cost;
+    request.task = std::move(task);
+    if (options_.reservation > 0) {
+        request.reservationInc =
+            kUsPerSecond * rho * cost / options_.reservation;
+        request.reservation = std::max(
+            now, record.prevReservation + request.reservationInc);
+        record.prevReservation = request.reservation;
+    } else {
+        request.reservationInc = 0;
+        request.reservation = kMaxTag;
+    }
+    request.proportion = std::max(
+        now, record.prevProportion + kUsPerSecond * delta * cost
+                                     / options_.weight);
+    record.prevProportion = request.proportion;
+    if (options_.limit > 0) {
+        request.limit = std::max(
+            now, record.prevLimit + kUsPerSecond * delta * cost
+                                    / options_.limit);
+        record.prevLimit = request.limit;
+    } else {
+        request.limit = 0;
+    }
+
+    record.lastActiveUs = nowUs;
+    record.requests.push_back(std::move(request));
+    ++size_;
+}
+
+bool DmClockQueue::Pop(uint64_t nowUs, const QosDispatchable& dispatchable,
+                       QosTask* task, uint64_t* copysetId, QosPhase* phase,
+                       uint32_t* cost, uint64_t* waitUs) {
+    if (size_ == 0) {
+        return false;
+    }
+    double now = static_cast<double>(nowUs);
+
+    // 1.reservation阶段，选出已经到期的R最小的请求
+    ClientRecord* selected = nullptr;
+    for (auto& item : clients_) {
+        ClientRecord& record = item.second;
+        if (record.requests.empty()) {
+            continue;
+        }
+        const Request& head = record.requests.front();
+        if (!dispatchable(head.copysetId)) {
+            continue;
+        }
+        if (head.reservation <= now && (nullptr == selected
+            || head.reservation < selected->requests.front().reservation)) {
+            selected = &record;
+        }
+    }
+    if (nullptr != selected) {
+        *phase = QosPhase::RESERVATION;
+    } else {
+        // 2.priority阶段，在没有超过上限的请求中选出P最小的请求
+        double next = kMaxTag;
+        for (auto& item : clients_) {
+            ClientRecord& record = item.second;
+            if (record.requests.empty()) {
+                continue;
+            }
+            const Request& head = record.requests.front();
+            if (!dispatchable(head.copysetId)) {
+                continue;
+            }
+            if (head.limit > now) {
+                next = std::min(next, std::min(head.limit,
+                                               head.reservation));
+                continue;
+            }
+            if (nullptr == selected || head.proportion
+                < selected->requests.front().proportion) {
+                selected = &record;
+            }
+        }
+        if (nullptr == selected) {
+            if (next < kMaxTag) {
+                *waitUs = static_cast<uint64_t>(next - now) + 1;
+            }
+            return false;
+        }
+        *phase = QosPhase::PRIORITY;
+    }
+
+    Request request = std::move(selected->requests.front());
+    selected->requests.pop_front();
+    --size_;
+    // priority阶段处理的请求不应计入保底，剩余请求的R要相应减小
+    if (QosPhase::PRIORITY == *phase && request.reservationInc > 0) {
+        for (auto& remain : selected->requests) {
+            remain.reservation -= request.reservationInc;
+        }
+        selected->prevReservation -= request.reservationInc;
+    }
+    selected->lastActiveUs = nowUs;
+    *task = std::move(request.task);
+    *copysetId = request.copysetId;
+    *cost = request.cost;
+    return true;
+}
+
+void DmClockQueue::RemoveIdleClients(uint64_t nowUs) {
+    uint64_t idleUs = static_cast<uint64_t>(options_.idleTimeoutS)
+                      * kUsPerSecond;
+    for (auto iter = clients_.begin(); iter != clients_.end();) {
+        if (iter->second.requests.empty()
+            && nowUs >= iter->second.lastActiveUs + idleUs) {
+            iter = clients_.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+}
+
+DmClockScheduler::DmClockScheduler(const DmClockOptions& options)
+    : queue_(options),
+      maxInflight_(std::max(options.maxInflight, 1u)),
+      maxInflightPerCopyset_(std::max(options.maxInflightPerCopyset, 1u)),
+      idleTimeoutS_(options.idleTimeoutS),
+      inflight_(0),
+      runningTasks_(0),
+      running_(false),
+      waiting_(false) {
+    reservationCount_.expose("chunkserver_qos_reservation_count");
+    priorityCount_.expose("chunkserver_qos_priority_count");
+    queuedCount_.expose("chunkserver_qos_queued_requests");
+}
+
+DmClockScheduler::~DmClockScheduler() {
+    Stop();
+}
+
+int DmClockScheduler::Start() {
+    LockGuard lk(mtx_);
+    if (running_) {
+        return 0;
+    }
+    running_ = true;
+    worker_ = Thread(&DmClockScheduler::Run, this);
+    LOG(INFO) << "DmClock scheduler started, max inflight: " << maxInflight_
+              << ", max inflight per copyset: " << maxInflightPerCopyset_;
+    return 0;
+}
+
+void DmClockScheduler::Stop() {
+    {
+        LockGuard lk(mtx_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+        cond_.notify_all();
+    }
+    worker_.join();
+    DispatchAll();
+    UniqueLock lk(mtx_);
+    while (runningTasks_ > 0) {
+        cond_.wait(lk);
+    }
+    LOG(INFO) << "DmClock scheduler stopped.";
+}
+
+void DmClockScheduler::Submit(const QosClientKey& clientId,
+                              uint64_t copysetId, uint32_t delta,
+                              uint32_t rho, uint32_t size, QosTask task) {
+    {
+        LockGuard lk(mtx_);
+        if (running_) {
+            queue_.Push(clientId, copysetId, delta, rho, CalcCost(size),
+                        TimeUtility::GetTimeofDayUs(), std::move(task));
+            queuedCount_ << 1;
+            // 调度线程没有在等待，或者下发已满，新的请求不能改变它的
+            // 选择，不需要唤醒
+            if (waiting_ && inflight_ < maxInflight_) {
+                waiting_ = false;
+                cond_.notify_one();
+            }
+            return;
+        }
+        // 调度器已经停止，直接处理，同样在OnComplete时释放名额
+        AcquireSlot(copysetId);
+    }
+    priorityCount_ << 1;
+    task(QosPhase::PRIORITY, CalcCost(size));
+}
+
+void DmClockScheduler::OnComplete(uint64_t copysetId) {
+    LockGuard lk(mtx_);
+    --inflight_;
+    auto iter = copysetInflight_.find(copysetId);
+    if (iter != copysetInflight_.end() && --iter->second == 0) {
+        copysetInflight_.erase(iter);
+    }
+    if (waiting_) {
+        waiting_ = false;
+        cond_.notify_one();
+    }
+}
+
+QosClientKey DmClockScheduler::ClientKey(uint64_t clientId,
+                                         const butil::EndPoint& peer) {
+    if (clientId != 0) {
+        return QosClientKey{clientId, false};
+    }
+    uint64_t ip = butil::ip2int(peer.ip);
+    return QosClientKey{(ip << 16) | static_cast<uint16_t>(peer.port), true};
+}
+
+uint32_t DmClockScheduler::CalcCost(uint32_t size) {
+    return std::max(1u, (size + kCostUnitBytes - 1) / kCostUnitBytes);
+}
+
+bool DmClockScheduler::Dispatchable(uint64_t copysetId) const {
+    auto iter = copysetInflight_.find(copysetId);
+    return iter == copysetInflight_.end()
+           || iter->second < maxInflightPerCopyset_;
+}
+
+void DmClockScheduler::AcquireSlot(uint64_t copysetId) {
+    ++inflight_;
+    ++copysetInflight_[copysetId];
+}
+
+void DmClockScheduler::Run() {
+    uint64_t lastCleanUs = TimeUtility::GetTimeofDayUs();
+    QosDispatchable dispatchable = [this](uint64_t copysetId) {
+        return Dispatchable(copysetId);
+    };
+    UniqueLock lk(mtx_);
+    while (running_) {
+        uint64_t nowUs = TimeUtility::GetTimeofDayUs();
+        if (nowUs - lastCleanUs >= idleTimeoutS_ * kUsPerSecond) {
+            queue_.RemoveIdleClients(nowUs);
+            lastCleanUs = nowUs;
+        }
+
+        QosTask task;
+        uint64_t copysetId;
+        QosPhase phase;
+        uint32_t cost;
+        uint64_t waitUs = kIdleWaitUs;
+        if (inflight_ >= maxInflight_
+            || !queue_.Pop(nowUs, dispatchable, &task, &copysetId,
+                           &phase, &cost, &waitUs)) {
+            waiting_ = true;
+            cond_.wait_for(lk, std::chrono::microseconds(
+                std::min(waitUs, kIdleWaitUs)));
+            waiting_ = false;
+            continue;
+        }
+        AcquireSlot(copysetId);
+        ++runningTasks_;
+        lk.unlock();
+
+        queuedCount_ << -1;
+        if (QosPhase::RESERVATION == phase) {
+            reservationCount_ << 1;
+        } else {
+            priorityCount_ << 1;
+        }
+        Dispatch(std::move(task), phase, cost);
+
+        lk.lock();
+    }
+}
+
+void DmClockScheduler::Dispatch(QosTask task, QosPhase phase,
+                                uint32_t cost) {
+    DispatchArg* arg = new DispatchArg;
+    arg->scheduler = this;
+    arg->task = std::move(task);
+    arg->phase = phase;
+    arg->cost = cost;
+    bthread_t tid;
+    if (bthread_start_background(&tid, nullptr, RunTask, arg) != 0) {
+        LOG(ERROR) << "Start bthread to dispatch request failed, "
+                   << "run it in the scheduler thread.";
+        RunTask(arg);
+    }
+}
+
+void* DmClockScheduler::RunTask(void* arg) {
+    DispatchArg* dispatchArg = static_cast<DispatchArg*>(arg);
+    dispatchArg->task(dispatchArg->phase, dispatchArg->cost);
+    dispatchArg->scheduler->OnTaskReturned();
+    delete dispatchArg;
+    return nullptr;
+}
+
+void DmClockScheduler::OnTaskReturned() {
+    LockGuard lk(mtx_);
+    --runningTasks_;
+    // 只有Stop在等待task返回
+    if (!running_) {
+        cond_.notify_all();
+    }
+}
+
+void DmClockScheduler::DispatchAll() {
+    QosDispatchable dispatchable = [](uint64_t) { return true; };
+    while (true) {
+        QosTask task;
+        uint64_t copysetId;
+        QosPhase phase;
+        uint32_t cost;
+        uint64_t waitUs;
+        {
+            LockGuard lk(mtx_);
+            if (!queue_.Pop(std::numeric_limits<uint64_t>::max(),
+                            dispatchable, &task, &copysetId, &phase,
+                            &cost, &waitUs)) {
+                return;
+            }
+            AcquireSlot(copysetId);
+        }
+        queuedCount_ << -1;
+        task(phase, cost);
+    }
+}
+
+}  // namespace chunkserver
+}  // namespace curve
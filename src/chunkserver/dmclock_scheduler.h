@@ -0,0 +1,276 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_CHUNKSERVER_DMCLOCK_SCHEDULER_H_
+#define SRC_CHUNKSERVER_DMCLOCK_SCHEDULER_H_
+
+#include <butil/endpoint.h>
+#include <bvar/bvar.h>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+
+#include "src/common/concurrent/concurrent.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::common::ConditionVariable;
+using curve::common::Mutex;
+using curve::common::Thread;
+
+// dmClock调度阶段，取值与QosResponseParas中的phase一致
+enum class QosPhase {
+    RESERVATION = 0,
+    PRIORITY = 1,
+};
+
+struct DmClockOptions {
+    // 每个卷的保底iops，0表示不保底
+    uint32_t reservation = 0;
+    // 每个卷的权重，保底之外的处理能力按权重在卷之间分配
+    uint32_t weight = 100;
+    // 每个卷的iops上限，0表示不限制
+    uint32_t limit = 0;
+    // 同时在处理中的最大读写请求数，请求返回给client之后才释放名额，
+    // 一个chunkserver对应一块盘，即每块盘上同时处理的请求数
+    uint32_t maxInflight = 128;
+    // 每个copyset同时在处理中的最大读写请求数，copyset处理不过来时请求
+    // 留在dmClock队列中按标签排队，而不是堆积在raft和apply队列中
+    uint32_t maxInflightPerCopyset = 16;
+    // 卷空闲超过该时间后清理其调度状态
+    uint32_t idleTimeoutS = 600;
+};
+
+/**
+ * 调度器中卷的标识，新版本的client以卷的inode id标识；老版本的client
+ * 不带qos参数，以client的地址(ip << 16 | port)标识，两者互不冲突
+ */
+struct QosClientKey {
+    uint64_t id;
+    bool legacy;
+
+    bool operator==(const QosClientKey& other) const {
+        return id == other.id && legacy == other.legacy;
+    }
+};
+
+struct QosClientKeyHash {
+    size_t operator()(const QosClientKey& key) const {
+        return std::hash<uint64_t>()(key.id) ^ key.legacy;
+    }
+};
+
+// 调度到的请求的回调，参数为请求被调度的阶段和请求的代价
+using QosTask = std::function<void(QosPhase phase, uint32_t cost)>;
+
+// 判断copyset是否还能下发请求
+using QosDispatchable = std::function<bool(uint64_t copysetId)>;
+
+/**
+ * dmClock的请求队列，不加锁，由DmClockScheduler保护
+ * 每个卷（client）一个FIFO队列，请求到达时按dmClock算法计算三个标签:
+ *   R = max(R' + rho * cost / reservation, now)
+ *   P = max(P' + delta * cost / weight, now)
+ *   L = max(L' + delta * cost / limit, now)
+ * delta/rho由client给出，分别是自上次向本chunkserver发请求以来，该卷在
+ * 其它chunkserver上完成的请求数和在reservation阶段完成的请求数(均加1)，
+ * 这样保底、权重和上限作用于整个卷，而不是单个chunkserver
+ * 出队时先选R <= now中R最小的请求(reservation阶段)，没有则在L <= now的
+ * 请求中选P最小的(priority阶段)，所属copyset已经下发满的请求不参与选择
+ * 活跃的卷一般不多，这里直接遍历所有卷的队首
+ */
+class DmClockQueue {
+ public:
+    explicit DmClockQueue(const DmClockOptions& options);
+
+    /**
+     * 请求入队
+     * @param clientId: 请求所属的卷，见DmClockScheduler::ClientKey
+     * @param copysetId: 请求所属的copyset
+     * @param delta: client给出的dmclock delta
+     * @param rho: client给出的dmclock rho
+     * @param cost: 请求的代价
+     * @param nowUs: 当前时间
+     * @param task: 请求被调度时的回调
+     */
+    void Push(const QosClientKey& clientId, uint64_t copysetId,
+              uint32_t delta, uint32_t rho, uint32_t cost, uint64_t nowUs,
+              QosTask task);
+
+    /**
+     * 取出下一个可以处理的请求
+     * @param nowUs: 当前时间
+     * @param dispatchable: 请求所属的copyset是否还能下发
+     * @param task[out]: 取到的请求的回调
+     * @param copysetId[out]: 请求所属的copyset
+     * @param phase[out]: 请求被调度的阶段
+     * @param cost[out]: 请求的代价
+     * @param waitUs[out]: 没有可处理的请求时，到下一个请求可以处理的时间，
+     *                     队列为空或者请求都在等copyset时不修改
+     * @return: true表示取到了请求
+     */
+    bool Pop(uint64_t nowUs, const QosDispatchable& dispatchable,
+             QosTask* task, uint64_t* copysetId, QosPhase* phase,
+             uint32_t* cost, uint64_t* waitUs);
+
+    /**
+     * 清理空闲时间超过idleTimeoutS的卷
+     */
+    void RemoveIdleClients(uint64_t nowUs);
+
+    size_t Size() const {
+        return size_;
+    }
+
+    size_t ClientCount() const {
+        return clients_.size();
+    }
+
+ private:
+    struct Request {
+        double reservation;
+        double proportion;
+        double limit;
+        // 该请求使reservation标签增加的值
+        double reservationInc;
+        uint64_t copysetId;
+        uint32_t cost;
+        QosTask task;
+    };
+
+    struct ClientRecord {
+        double prevReservation = 0;
+        double prevProportion = 0;
+        double prevLimit = 0;
+        uint64_t lastActiveUs = 0;
+        std::deque<Request> requests;
+    };
+
+    DmClockOptions options_;
+    std::unordered_map<QosClientKey, ClientRecord, QosClientKeyHash> clients_;
+    // 所有卷排队中的请求数
+    size_t size_;
+};
+
+/**
+ * 读写请求的dmClock调度器
+ * 请求先在DmClockQueue中排队，调度线程按dmClock取出请求，在bthread中
+ * 交给copyset处理，调度线程不会被某个请求的处理阻塞。
+ * 请求从下发到返回给client一直占用名额(OnComplete释放)，处理中的请求
+ * 总数不超过maxInflight，每个copyset不超过maxInflightPerCopyset，
+ * 下层处理不过来时请求留在dmClock队列中，保底和权重才能起作用；
+ * 个别copyset处理慢也只占住它自己的名额
+ */
+class DmClockScheduler {
+ public:
+    explicit DmClockScheduler(const DmClockOptions& options);
+    ~DmClockScheduler();
+
+    /**
+     * 启动调度线程
+     */
+    int Start();
+
+    /**
+     * 停止调度线程，队列中剩余的请求会被立即下发，返回前等待所有下发中的
+     * task执行完(不等待请求完成)
+     */
+    void Stop();
+
+    /**
+     * 提交请求，请求被调度时在bthread中执行task，请求完成时必须调用
+     * OnComplete释放名额
+     * @param clientId: 请求所属的卷，见ClientKey
+     * @param copysetId: 请求所属的copyset，见ToGroupNid
+     * @param delta: client给出的dmclock delta
+     * @param rho: client给出的dmclock rho
+     * @param size: 请求的数据大小
+     * @param task: 请求被调度时的回调
+     */
+    void Submit(const QosClientKey& clientId, uint64_t copysetId,
+                uint32_t delta, uint32_t rho, uint32_t size, QosTask task);
+
+    /**
+     * 请求处理完成(返回给client)时调用，释放请求占用的名额
+     * @param copysetId: 请求所属的copyset
+     */
+    void OnComplete(uint64_t copysetId);
+
+    /**
+     * 计算请求在调度器中所属的卷
+     * 老版本的client不带qos参数，clientId为0，这些请求按client的地址
+     * 分到各自的队列中，不和其它client共用一个卷的份额
+     * @param clientId: 请求中的clientId，即卷的inode id
+     * @param peer: 发送请求的client地址
+     */
+    static QosClientKey ClientKey(uint64_t clientId,
+                                  const butil::EndPoint& peer);
+
+    /**
+     * 计算请求的代价，每64KB数据计为一个单位，不足64KB的请求代价为1
+     */
+    static uint32_t CalcCost(uint32_t size);
+
+ private:
+    void Run();
+    void DispatchAll();
+    // 调用时需持有mtx_
+    bool Dispatchable(uint64_t copysetId) const;
+    void AcquireSlot(uint64_t copysetId);
+    // 在bthread中执行task
+    void Dispatch(QosTask task, QosPhase phase, uint32_t cost);
+    static void* RunTask(void* arg);
+    void OnTaskReturned();
+
+ private:
+    DmClockQueue queue_;
+    uint32_t maxInflight_;
+    uint32_t maxInflightPerCopyset_;
+    uint32_t idleTimeoutS_;
+    // 已下发，还没有完成的请求数
+    uint32_t inflight_;
+    // 每个copyset已下发，还没有完成的请求数
+    std::unordered_map<uint64_t, uint32_t> copysetInflight_;
+    // 已下发，task还没有返回的请求数，Stop时等待
+    uint32_t runningTasks_;
+    bool running_;
+    // 调度线程在等待，只有这时Submit和OnComplete才需要唤醒它
+    bool waiting_;
+    Mutex mtx_;
+    ConditionVariable cond_;
+    Thread worker_;
+
+    // 在reservation阶段调度的请求数
+    bvar::Adder<uint64_t> reservationCount_;
+    // 在priority阶段调度的请求数
+    bvar::Adder<uint64_t> priorityCount_;
+    // 排队中的请求数
+    bvar::Adder<int64_t> queuedCount_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_DMCLOCK_SCHEDULER_H_
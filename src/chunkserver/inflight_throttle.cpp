@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include "src/chunkserver/inflight_throttle.h"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "src/common/timeutility.h"
+
+namespace curve {
+namespace chunkserver {
+
+using curve::common::LockGuard;
+using curve::common::TimeUtility;
+
+namespace {
+
+// 每个采样窗口至少需要的请求数，请求太少时延时不具有代表性
+const uint64_t kMinWindowSamples = 10;
+// 长期平均延时的平滑系数
+const double kLongLatencyFactor = 0.05;
+// 新上限的平滑系数
+const double kLimitSmoothing = 0.2;
+
+}  // namespace
+
+InflightThrottle::InflightThrottle(uint64_t maxInflight)
+    : inflightRequestCount_(0),
+      limit_(maxInflight),
+      shedCount_(0),
+      windowStartUs_(0),
+      windowCount_(0),
+      windowLatencySum_(0),
+      windowMaxInflight_(0),
+      longLatency_(0) {
+    options_.maxInflight = maxInflight;
+}
+
+InflightThrottle::InflightThrottle(const InflightThrottleOptions& options)
+    : InflightThrottle(options.maxInflight) {
+    options_ = options;
+    options_.minInflight = std::max<uint64_t>(
+        1, std::min(options_.minInflight, options_.maxInflight));
+    if (options_.latencyTolerance < 1.0) {
+        options_.latencyTolerance = 1.0;
+    }
+}
+
+void InflightThrottle::OnResponse(uint64_t latencyUs) {
+    if (!options_.enableAdaptive) {
+        return;
+    }
+
+    uint64_t nowUs = TimeUtility::GetTimeofDayUs();
+    LockGuard lk(mtx_);
+    if (windowStartUs_ == 0) {
+        windowStartUs_ = nowUs;
+    }
+    ++windowCount_;
+    windowLatencySum_ += latencyUs;
+    windowMaxInflight_ = std::max(windowMaxInflight_, GetInflightCount());
+    if (nowUs < windowStartUs_ + options_.sampleWindowMs * 1000
+        || windowCount_ < kMinWindowSamples) {
+        return;
+    }
+    double shortLatency =
+        static_cast<double>(windowLatencySum_) / windowCount_;
+    UpdateLimit(std::max(shortLatency, 1.0));
+    windowStartUs_ = nowUs;
+    windowCount_ = 0;
+    windowLatencySum_ = 0;
+    windowMaxInflight_ = 0;
+}
+
+void InflightThrottle::UpdateLimit(double shortLatency) {
+    if (longLatency_ == 0) {
+        longLatency_ = shortLatency;
+    } else {
+        longLatency_ = longLatency_ * (1 - kLongLatencyFactor)
+                       + shortLatency * kLongLatencyFactor;
+    }
+    // 负载下降之后长期平均延时远高于当前延时，让其更快地回落
+    if (longLatency_ > 2 * shortLatency) {
+        longLatency_ = longLatency_ * (1 - kLongLatencyFactor)
+                       + shortLatency * kLongLatencyFactor;
+    }
+
+    double limit = static_cast<double>(GetLimit());
+    // 请求量不足上限的一半时，延时不受上限影响，不再提高上限
+    if (windowMaxInflight_ < limit / 2 && shortLatency <= longLatency_) {
+        return;
+    }
+    double gradient = options_.latencyTolerance * longLatency_ / shortLatency;
+    gradient = std::max(0.5, std::min(1.0, gradient));
+    double newLimit = limit * gradient + std::sqrt(limit);
+    newLimit = limit * (1 - kLimitSmoothing) + newLimit * kLimitSmoothing;
+    newLimit = std::max(static_cast<double>(options_.minInflight),
+                        std::min(static_cast<double>(options_.maxInflight),
+                                 newLimit));
+    uint64_t result = static_cast<uint64_t>(newLimit);
+    if (result != GetLimit()) {
+        VLOG(3) << "Inflight limit changed from " << GetLimit()
+                << " to " << result << ", short latency: " << shortLatency
+                << "us, long latency: " << longLatency_ << "us";
+    }
+    limit_.store(result, std::memory_order_relaxed);
+}
+
+}  // namespace chunkserver
+}  // namespace curve
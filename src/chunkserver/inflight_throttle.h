@@ -23,31 +23,54 @@
 #include <atomic>
 #include <cstdint>
 
+#include "src/common/concurrent/concurrent.h"
+
 #ifndef SRC_CHUNKSERVER_INFLIGHT_THROTTLE_H_
 #define SRC_CHUNKSERVER_INFLIGHT_THROTTLE_H_
 
 namespace curve {
 namespace chunkserver {
 
+struct InflightThrottleOptions {
+    // 最大的inflight request数量
+    uint64_t maxInflight = 5000;
+    // 是否根据请求延时自适应调整inflight上限
+    bool enableAdaptive = false;
+    // 自适应调整时inflight上限的最小值
+    uint64_t minInflight = 32;
+    // 短期平均延时超过长期平均延时的倍数，超过后开始降低inflight上限
+    double latencyTolerance = 2.0;
+    // 采样窗口的时长，每个窗口结束时调整一次inflight上限
+    uint64_t sampleWindowMs = 100;
+};
+
 /**
  * 负责控制最大inflight request数量
+ * 开启自适应时，按gradient算法根据请求从进入chunk service到返回的延时
+ * 调整inflight上限:
+ *   gradient = clamp(tolerance * longLatency / shortLatency, 0.5, 1.0)
+ *   newLimit = limit * gradient + sqrt(limit)
+ * shortLatency为当前窗口的平均延时，longLatency为各窗口平均延时的滑动
+ * 平均，排队导致延时上升时上限迅速下降，超出上限的请求直接返回OVERLOAD，
+ * 延时平稳时上限缓慢上升，直到maxInflight
+ * 一个chunkserver对应一块盘，因此上限也是按盘调整的
  */
 class InflightThrottle {
  public:
-    explicit InflightThrottle(uint64_t maxInflight)
-        : inflightRequestCount_(0),
-          kMaxInflightRequest_(maxInflight) { }
+    explicit InflightThrottle(uint64_t maxInflight);
+    explicit InflightThrottle(const InflightThrottleOptions& options);
     virtual ~InflightThrottle() = default;
 
     /**
-     * @brief: 判断是否过载
+     * @brief: 判断是否过载，过载时请求会被拒绝，计入shed count
      * @return true，过载，false没有过载
      */
     inline bool IsOverLoad() {
-        if (kMaxInflightRequest_ >=
+        if (limit_.load(std::memory_order_relaxed) >=
             inflightRequestCount_.load(std::memory_order_relaxed)) {
             return false;
         } else {
+            shedCount_.fetch_add(1, std::memory_order_relaxed);
             return true;
         }
     }
@@ -66,11 +89,56 @@ class InflightThrottle {
         inflightRequestCount_.fetch_sub(1, std::memory_order_relaxed);
     }
 
+    /**
+     * @brief: 请求处理完成，开启自适应时根据请求延时调整inflight上限
+     * @param latencyUs: 请求的延时
+     */
+    void OnResponse(uint64_t latencyUs);
+
+    /**
+     * @brief: 获取当前的inflight上限
+     */
+    uint64_t GetLimit() const {
+        return limit_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief: 获取因过载被拒绝的请求数
+     */
+    uint64_t GetShedCount() const {
+        return shedCount_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief: 获取当前inflight request数量
+     */
+    uint64_t GetInflightCount() const {
+        return inflightRequestCount_.load(std::memory_order_relaxed);
+    }
+
+ private:
+    void UpdateLimit(double shortLatency);
+
  private:
     // 当前inflight request数量
     std::atomic<uint64_t> inflightRequestCount_;
-    // 最大的inflight request数量
-    const uint64_t kMaxInflightRequest_;
+    // 当前的inflight上限，不开启自适应时等于maxInflight
+    std::atomic<uint64_t> limit_;
+    // 因过载被拒绝的请求数
+    std::atomic<uint64_t> shedCount_;
+
+    InflightThrottleOptions options_;
+    // 保护以下采样窗口的数据
+    curve::common::Mutex mtx_;
+    // 当前采样窗口的开始时间
+    uint64_t windowStartUs_;
+    // 当前采样窗口内的请求数和延时之和
+    uint64_t windowCount_;
+    uint64_t windowLatencySum_;
+    // 当前采样窗口内观察到的最大inflight request数量
+    uint64_t windowMaxInflight_;
+    // 长期平均延时
+    double longLatency_;
 };
 
 }  // namespace chunkserver
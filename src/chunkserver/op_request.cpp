@@ -27,10 +27,12 @@
 #include <butil/sys_byteorder.h>
 #include <brpc/closure_guard.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
 #include "src/chunkserver/copyset_node.h"
+#include "src/chunkserver/chunkserver_metrics.h"
 #include "src/chunkserver/chunk_closure.h"
 #include "src/chunkserver/clone_manager.h"
 #include "src/chunkserver/clone_task.h"
@@ -254,49 +256,72 @@ void ReadChunkRequest::Process() {
     if ((request_->has_appliedindex()
         && node_->GetAppliedIndex() >= request_->appliedindex())
         || request_->optype() == CHUNK_OP_TYPE::CHUNK_OP_RECOVER) {
-        /**
-         * 构造shared_ptr<ReadChunkRequest>，因为在ChunkOpRequest只指定了
-         * std::enable_shared_from_this<ChunkOpRequest>，所以
-         * shared_from_this()返回的是shared_ptr<ChunkOpRequest>
-         */
-        auto thisPtr
-            = std::dynamic_pointer_cast<ReadChunkRequest>(shared_from_this());
-        /*
-         * 将read扔给并发层出于两个原因：
-         *  (1). 将read I/O操作和write等其它I/O操作都放在并发层处理，以便隔离
-         *  disk I/O和其他逻辑
-         *  (2). 为了保证线性一致性read的语义。因为当前apply是并发的，所以applied
-         *  index更新也是并发的，尽管applied index更新能够保证单调的，但是可能会存
-         *  在更新跳跃的情况，例如，index=6,7的2个op同时进入并发模块，并且都执行成
-         *  功返回了，这个时候leader挂了，new leader选出来，new leader上面有
-         *  index=6,7两个op的日志，但是没有apply，那么new leader必然需要回放这两
-         *  条日志，因为是并发的，所以index=7的op log可能先于index=6的被apply，然后
-         *  new leader的applied index会被更新为7，这个时候client来了一个想读index=6
-         *  的op写下的数据，携带的是applied index=7，这个时候ChunkServer比较携带的
-         *  applied index和Chunkserver的applied index，那么会判定通过走直接读，但是
-         *  ChunkServer实际上index=6的数据还没落盘。那么就会出现stale read。解决方法
-         *  就是read也进并发层排队，那么需要read index=6的read request，必定会排在
-         *  index=6的op的后面，也就是它们操作的是同一个chunk，并发层会将它们放在同一个
-         *  队列中，这样就能保证index=6的op apply之后，read才会被执行，这样就不会出现
-         *  stale read，保证了read的线性一致性
-         */
-        auto task = std::bind(&ReadChunkRequest::OnApply,
-                              thisPtr,
-                              node_->GetAppliedIndex(),
-                              doneGuard.release());
-        concurrentApplyModule_->Push(
-            request_->chunkid(), request_->optype(), task);
+        ReadWithoutPropose(doneGuard.release(), false);
         return;
     }
 
     /**
-     * 如果没有携带applied index，那么走raft一致性协议read
+     * 开启了lease read，且leader lease有效，那么lease期间不会有其他leader
+     * 产生，也不需要走一致性协议。读和写在并发模块中分别由读、写线程池执行，
+     * 因此lease read放入chunk的写队列，排在该chunk上已经由on_apply提交给
+     * 并发模块的写请求之后执行，能读到所有已经返回给client的写。
+     * 已提交但还没有on_apply的写与这个读是并发的，可能读不到
+     */
+    if (node_->IsLeaseLeader()) {
+        ChunkServerMetric::GetInstance()->IncreaseLeaseReadCount();
+        ReadWithoutPropose(doneGuard.release(), true);
+        return;
+    }
+
+    /**
+     * 如果没有携带applied index，且lease无效，那么走raft一致性协议read
      */
     if (0 == Propose(request_, nullptr)) {
+        ChunkServerMetric::GetInstance()->IncreaseProposeReadCount();
         doneGuard.release();
     }
 }
 
+void ReadChunkRequest::ReadWithoutPropose(::google::protobuf::Closure *done,
+                                          bool afterWrites) {
+    /**
+     * 构造shared_ptr<ReadChunkRequest>，因为在ChunkOpRequest只指定了
+     * std::enable_shared_from_this<ChunkOpRequest>，所以
+     * shared_from_this()返回的是shared_ptr<ChunkOpRequest>
+     */
+    auto thisPtr
+        = std::dynamic_pointer_cast<ReadChunkRequest>(shared_from_this());
+    /*
+     * 将read扔给并发层出于两个原因：
+     *  (1). 将read I/O操作和write等其它I/O操作都放在并发层处理，以便隔离
+     *  disk I/O和其他逻辑
+     *  (2). 为了保证线性一致性read的语义。因为当前apply是并发的，所以applied
+     *  index更新也是并发的，尽管applied index更新能够保证单调的，但是可能会存
+     *  在更新跳跃的情况，例如，index=6,7的2个op同时进入并发模块，并且都执行成
+     *  功返回了，这个时候leader挂了，new leader选出来，new leader上面有
+     *  index=6,7两个op的日志，但是没有apply，那么new leader必然需要回放这两
+     *  条日志，因为是并发的，所以index=7的op log可能先于index=6的被apply，然后
+     *  new leader的applied index会被更新为7，这个时候client来了一个想读index=6
+     *  的op写下的数据，携带的是applied index=7，这个时候ChunkServer比较携带的
+     *  applied index和Chunkserver的applied index，那么会判定通过走直接读，但是
+     *  ChunkServer实际上index=6的数据还没落盘。那么就会出现stale read。解决方法
+     *  就是read也进并发层排队，那么需要read index=6的read request，必定会排在
+     *  index=6的op的后面，也就是它们操作的是同一个chunk，并发层会将它们放在同一个
+     *  队列中，这样就能保证index=6的op apply之后，read才会被执行，这样就不会出现
+     *  stale read，保证了read的线性一致性
+     */
+    auto task = std::bind(&ReadChunkRequest::OnApply,
+                          thisPtr,
+                          node_->GetAppliedIndex(),
+                          done);
+    if (afterWrites) {
+        concurrentApplyModule_->PushAfterWrites(request_->chunkid(), task);
+        return;
+    }
+    concurrentApplyModule_->Push(
+        request_->chunkid(), request_->optype(), task);
+}
+
 void ReadChunkRequest::OnApply(uint64_t index,
                                ::google::protobuf::Closure *done) {
     // 先清除response中的status，以保证CheckForward后的判断的正确性
@@ -423,6 +448,16 @@ void ReadChunkRequest::ReadChunk() {
                    << " data size: " << request_->size()
                    << " read len :" << size
                    << " data store return: " << ret;
+    } else if (CSErrorCode::CrcCheckError == ret) {
+        // 本地数据已损坏，把leader切换到其他副本，client重试时从其他副本读取
+        LOG(ERROR) << "read failed, page crc mismatch: "
+                   << " logic pool id: " << request_->logicpoolid()
+                   << " copyset id: " << request_->copysetid()
+                   << " chunkid: " << request_->chunkid()
+                   << " offset: " << request_->offset()
+                   << " read len :" << size;
+        response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_CRC_FAIL);
+        node_->TransferLeaderOnCrcError();
     } else {
         LOG(ERROR) << "read failed: "
                    << " logic pool id: " << request_->logicpoolid()
@@ -455,7 +490,10 @@ void WriteChunkRequest::OnApply(uint64_t index,
                                       request_->size(),
                                       &cost,
                                       cloneSourceLocation);
+    HandleApplyResult(index, ret);
+}
 
+void WriteChunkRequest::HandleApplyResult(uint64_t index, CSErrorCode ret) {
     if (CSErrorCode::Success == ret) {
         response_->set_status(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
         node_->UpdateAppliedIndex(index);
@@ -519,6 +557,11 @@ void WriteChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
                                      request.size(),
                                      &cost,
                                      cloneSourceLocation);
+    HandleApplyResultFromLog(request, ret);
+}
+
+void WriteChunkRequest::HandleApplyResultFromLog(const ChunkRequest &request,
+                                                 CSErrorCode ret) {
      if (CSErrorCode::Success == ret) {
          return;
      } else if (CSErrorCode::BackwardRequestError == ret) {
@@ -547,6 +590,125 @@ void WriteChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
     }
 }
 
+WriteChunkMerger::WriteChunkMerger(std::shared_ptr<CSDataStore> datastore,
+                                   uint32_t maxBytes) :
+    datastore_(datastore),
+    maxBytes_(maxBytes),
+    fromLog_(false),
+    chunkId_(0),
+    sn_(0),
+    offset_(0),
+    end_(0) {
+}
+
+bool WriteChunkMerger::Add(std::shared_ptr<ChunkOpRequest> request,
+                           uint64_t index,
+                           ::google::protobuf::Closure *done) {
+    auto writeRequest = std::dynamic_pointer_cast<WriteChunkRequest>(request);
+    if (writeRequest == nullptr) {
+        return false;
+    }
+    const ChunkRequest *chunkRequest = request->request_;
+    std::string cloneSourceLocation;
+    if (existCloneInfo(chunkRequest)) {
+        auto func = ::curve::common::LocationOperator::GenerateCurveLocation;
+        cloneSourceLocation = func(chunkRequest->clonefilesource(),
+                                   chunkRequest->clonefileoffset());
+    }
+    if (!CanMerge(*chunkRequest, cloneSourceLocation, false)) {
+        return false;
+    }
+    Merge(*chunkRequest, cloneSourceLocation,
+          request->cntl_->request_attachment(), false);
+    requests_.push_back({writeRequest, index, done});
+    return true;
+}
+
+bool WriteChunkMerger::Add(const ChunkRequest &request,
+                           const butil::IOBuf &data) {
+    std::string cloneSourceLocation;
+    if (existCloneInfo(&request)) {
+        auto func = ::curve::common::LocationOperator::GenerateCurveLocation;
+        cloneSourceLocation = func(request.clonefilesource(),
+                                   request.clonefileoffset());
+    }
+    if (!CanMerge(request, cloneSourceLocation, true)) {
+        return false;
+    }
+    Merge(request, cloneSourceLocation, data, true);
+    logRequests_.push_back(request);
+    return true;
+}
+
+bool WriteChunkMerger::CanMerge(const ChunkRequest &request,
+                                const std::string &cloneSourceLocation,
+                                bool fromLog) const {
+    if (Empty()) {
+        return true;
+    }
+    if (fromLog != fromLog_ ||
+        request.chunkid() != chunkId_ ||
+        request.sn() != sn_ ||
+        cloneSourceLocation != cloneSourceLocation_) {
+        return false;
+    }
+    // 只合并相邻或重叠的请求，合并后的区间必须是连续的
+    uint64_t begin = request.offset();
+    uint64_t end = begin + request.size();
+    if (end < offset_ || begin > end_) {
+        return false;
+    }
+    return std::max(end, end_) - std::min(begin, offset_) <= maxBytes_;
+}
+
+void WriteChunkMerger::Merge(const ChunkRequest &request,
+                             const std::string &cloneSourceLocation,
+                             const butil::IOBuf &data, bool fromLog) {
+    uint64_t begin = request.offset();
+    uint64_t end = begin + request.size();
+    if (Empty()) {
+        fromLog_ = fromLog;
+        chunkId_ = request.chunkid();
+        sn_ = request.sn();
+        cloneSourceLocation_ = cloneSourceLocation;
+        offset_ = begin;
+        end_ = end;
+        data.append_to(&data_, request.size());
+        return;
+    }
+
+    // 只引用IOBuf的block，不拷贝数据，重叠部分使用新请求的数据
+    butil::IOBuf merged;
+    if (begin > offset_) {
+        data_.append_to(&merged, begin - offset_);
+    }
+    data.append_to(&merged, request.size());
+    if (end_ > end) {
+        data_.append_to(&merged, end_ - end, end - offset_);
+    }
+    data_.swap(merged);
+    offset_ = std::min(begin, offset_);
+    end_ = std::max(end, end_);
+}
+
+void WriteChunkMerger::Apply() {
+    uint32_t cost;
+    auto ret = datastore_->WriteChunk(chunkId_,
+                                      sn_,
+                                      data_,
+                                      offset_,
+                                      end_ - offset_,
+                                      &cost,
+                                      cloneSourceLocation_);
+    for (auto &item : requests_) {
+        brpc::ClosureGuard doneGuard(item.done);
+        item.request->HandleApplyResult(item.index, ret);
+    }
+    for (auto &request : logRequests_) {
+        WriteChunkRequest::HandleApplyResultFromLog(request, ret);
+    }
+}
+
 void ReadSnapshotRequest::OnApply(uint64_t index,
                                   ::google::protobuf::Closure *done) {
     brpc::ClosureGuard doneGuard(done);
@@ -866,32 +1028,54 @@ void PasteChunkInternalRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> data
     }
 }
 
-void ScanChunkRequest::OnApply(uint64_t index,
-                               ::google::protobuf::Closure *done) {
-    brpc::ClosureGuard doneGuard(done);
+/**
+ * 计算scan区域的crc，开启page校验时根据记录的page crc计算，不读取数据，
+ * 所以各副本必须使用相同的page校验配置
+ */
+static CSErrorCode ScanChunkCrc(std::shared_ptr<CSDataStore> datastore,
+                                const ChunkRequest &request,
+                                uint32_t *crc) {
+    size_t size = request.size();
+    bool readMetaPage = request.has_readmetapage() && request.readmetapage();
+    if (!readMetaPage && datastore->PageChecksumEnabled()) {
+        return datastore->GetChunkChecksum(request.chunkid(),
+                                           request.offset(),
+                                           size,
+                                           crc);
+    }
 
-    // read and calculate crc, build scanmap
-    uint32_t crc = 0;
-    size_t size = request_->size();
     std::unique_ptr<char[]> readBuffer(new(std::nothrow)char[size]);
     CHECK(nullptr != readBuffer)
         << "new readBuffer failed " << strerror(errno);
     // scan chunk metapage or user data
-    auto ret = 0;
-    if (request_->has_readmetapage() && request_->readmetapage()) {
-        ret = datastore_->ReadChunkMetaPage(request_->chunkid(),
-                                            request_->sn(),
-                                            readBuffer.get());
+    CSErrorCode ret;
+    if (readMetaPage) {
+        ret = datastore->ReadChunkMetaPage(request.chunkid(),
+                                           request.sn(),
+                                           readBuffer.get());
     } else {
-        ret = datastore_->ReadChunk(request_->chunkid(),
-                                    request_->sn(),
-                                    readBuffer.get(),
-                                    request_->offset(),
-                                    size);
+        ret = datastore->ReadChunk(request.chunkid(),
+                                   request.sn(),
+                                   readBuffer.get(),
+                                   request.offset(),
+                                   size);
+    }
+    if (CSErrorCode::Success == ret) {
+        *crc = ::curve::common::CRC32(readBuffer.get(), size);
     }
+    return ret;
+}
+
+void ScanChunkRequest::OnApply(uint64_t index,
+                               ::google::protobuf::Closure *done) {
+    brpc::ClosureGuard doneGuard(done);
+
+    // read and calculate crc, build scanmap
+    uint32_t crc = 0;
+    size_t size = request_->size();
+    auto ret = ScanChunkCrc(datastore_, *request_, &crc);
 
     if (CSErrorCode::Success == ret) {
-        crc = ::curve::common::CRC32(readBuffer.get(), size);
         // build scanmap
         ScanMap scanMap;
         scanMap.set_logicalpoolid(request_->logicpoolid());
@@ -928,26 +1112,9 @@ void ScanChunkRequest::OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,  /
                                                const butil::IOBuf &data) {
     uint32_t crc = 0;
     size_t size = request.size();
-    std::unique_ptr<char[]> readBuffer(new(std::nothrow)char[size]);
-    CHECK(nullptr != readBuffer)
-        << "new readBuffer failed " << strerror(errno);
-
-    // scan chunk metapage or user data
-    auto ret = 0;
-    if (request.has_readmetapage() && request.readmetapage()) {
-        ret = datastore->ReadChunkMetaPage(request.chunkid(),
-                                            request.sn(),
-                                            readBuffer.get());
-    } else {
-        ret = datastore->ReadChunk(request.chunkid(),
-                                    request.sn(),
-                                    readBuffer.get(),
-                                    request.offset(),
-                                    size);
-    }
+    auto ret = ScanChunkCrc(datastore, request, &crc);
 
     if (CSErrorCode::Success == ret) {
-        crc = ::curve::common::CRC32(readBuffer.get(), size);
         BuildAndSendScanMap(request, index_, crc);
     } else if (CSErrorCode::ChunkNotExistError == ret) {
         LOG(ERROR) << "scan failed: chunk not exist, "
@@ -28,6 +28,8 @@
 #include <brpc/controller.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "proto/chunk.pb.h"
 #include "include/chunkserver/chunkserver_common.h"
@@ -123,6 +125,8 @@ class ChunkOpRequest : public std::enable_shared_from_this<ChunkOpRequest> {
     virtual void RedirectChunkRequest();
 
  public:
+    friend class WriteChunkMerger;
+
     /**
      * Op序列化工具函数
      * |            data                 |
@@ -234,6 +238,14 @@ class ReadChunkRequest : public ChunkOpRequest {
     bool NeedClone(const CSChunkInfo& chunkInfo);
     // 从chunk文件中读数据
     void ReadChunk();
+    /**
+     * 不走raft协议，直接将read提交给并发模块执行
+     * @param done: 请求完成后的回调
+     * @param afterWrites: 是否放入chunk的写队列，排在该chunk上已经提交给
+     *        并发模块的写请求之后执行
+     */
+    void ReadWithoutPropose(::google::protobuf::Closure *done,
+                            bool afterWrites);
 
  private:
     CloneManager* cloneMgr_;
@@ -263,6 +275,103 @@ class WriteChunkRequest : public ChunkOpRequest {
     void OnApplyFromLog(std::shared_ptr<CSDataStore> datastore,
                         const ChunkRequest &request,
                         const butil::IOBuf &data) override;
+
+    /**
+     * 根据写盘的结果设置response并更新applied index
+     * @param index:此op log entry的index
+     * @param ret:datastore WriteChunk的返回值
+     */
+    void HandleApplyResult(uint64_t index, CSErrorCode ret);
+
+    /**
+     * 从log apply时处理写盘的结果
+     */
+    static void HandleApplyResultFromLog(const ChunkRequest &request,
+                                         CSErrorCode ret);
+};
+
+/**
+ * apply阶段合并同一个chunk上的写请求
+ * 一批raft log中同一个chunk上sn和克隆源相同、写入区间相邻或重叠的写请求
+ * 合并成一次WriteChunk，只下发一次写和一次metapage/bitmap的更新；
+ * 重叠部分以后面的请求为准，每个请求的closure和applied index仍然单独处理
+ * leader上从内存中拿到的请求和从log反序列化的请求不会合并到一起
+ */
+class WriteChunkMerger {
+ public:
+    WriteChunkMerger(std::shared_ptr<CSDataStore> datastore,
+                     uint32_t maxBytes);
+
+    /**
+     * 加入leader上的写请求，不是WriteChunkRequest或者不能与已有的请求
+     * 合并时返回false，此时done的所有权不转移
+     * @param request:写请求
+     * @param index:此op log entry的index
+     * @param done:对应的ChunkClosure
+     */
+    bool Add(std::shared_ptr<ChunkOpRequest> request, uint64_t index,
+             ::google::protobuf::Closure *done);
+
+    /**
+     * 加入从log反序列化出的写请求，不能合并时返回false
+     */
+    bool Add(const ChunkRequest &request, const butil::IOBuf &data);
+
+    /**
+     * 下发合并后的写请求，并依次完成每个请求
+     */
+    void Apply();
+
+    size_t Size() const {
+        return fromLog_ ? logRequests_.size() : requests_.size();
+    }
+
+    bool Empty() const {
+        return Size() == 0;
+    }
+
+    ChunkID ChunkId() const {
+        return chunkId_;
+    }
+
+    uint64_t Offset() const {
+        return offset_;
+    }
+
+    uint64_t Length() const {
+        return end_ - offset_;
+    }
+
+ private:
+    struct LeaderRequest {
+        std::shared_ptr<WriteChunkRequest> request;
+        uint64_t index;
+        ::google::protobuf::Closure *done;
+    };
+
+    // request能否与已有的请求合并
+    bool CanMerge(const ChunkRequest &request,
+                  const std::string &cloneSourceLocation,
+                  bool fromLog) const;
+
+    // 把request的数据合并到data_中
+    void Merge(const ChunkRequest &request,
+               const std::string &cloneSourceLocation,
+               const butil::IOBuf &data, bool fromLog);
+
+ private:
+    std::shared_ptr<CSDataStore> datastore_;
+    uint32_t maxBytes_;
+    bool fromLog_;
+    ChunkID chunkId_;
+    SequenceNum sn_;
+    std::string cloneSourceLocation_;
+    // 合并后的数据覆盖[offset_, end_)
+    uint64_t offset_;
+    uint64_t end_;
+    butil::IOBuf data_;
+    std::vector<LeaderRequest> requests_;
+    std::vector<ChunkRequest> logRequests_;
 };
 
 class ReadSnapshotRequest : public ChunkOpRequest {
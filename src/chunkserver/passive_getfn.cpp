@@ -88,6 +88,16 @@ uint32_t GetDatastoreCloneChunkCountFunc(void* arg) {
     return cloneChunkCount;
 }
 
+uint32_t GetDatastoreCrcErrorCountFunc(void* arg) {
+    CSDataStore* dataStore = reinterpret_cast<CSDataStore*>(arg);
+    uint32_t crcErrorCount = 0;
+    if (dataStore != nullptr) {
+        DataStoreStatus status = dataStore->GetStatus();
+        crcErrorCount = status.crcErrorCount;
+    }
+    return crcErrorCount;
+}
+
 uint32_t GetChunkTrashedFunc(void* arg) {
     Trash* trash = reinterpret_cast<Trash*>(arg);
     uint32_t chunkTrashed = 0;
@@ -97,6 +107,53 @@ uint32_t GetChunkTrashedFunc(void* arg) {
     return chunkTrashed;
 }
 
+uint64_t GetPageCacheHitFunc(void* arg) {
+    CSPageCache* pageCache = reinterpret_cast<CSPageCache*>(arg);
+    uint64_t hits = 0;
+    if (pageCache != nullptr) {
+        hits = pageCache->GetHitCount();
+    }
+    return hits;
+}
+
+uint64_t GetPageCacheMissFunc(void* arg) {
+    CSPageCache* pageCache = reinterpret_cast<CSPageCache*>(arg);
+    uint64_t misses = 0;
+    if (pageCache != nullptr) {
+        misses = pageCache->GetMissCount();
+    }
+    return misses;
+}
+
+uint64_t GetPageCacheBytesFunc(void* arg) {
+    CSPageCache* pageCache = reinterpret_cast<CSPageCache*>(arg);
+    uint64_t bytes = 0;
+    if (pageCache != nullptr) {
+        bytes = pageCache->GetUsedBytes();
+    }
+    return bytes;
+}
+
+uint64_t GetInflightLimitFunc(void* arg) {
+    InflightThrottle* inflightThrottle =
+        reinterpret_cast<InflightThrottle*>(arg);
+    uint64_t limit = 0;
+    if (inflightThrottle != nullptr) {
+        limit = inflightThrottle->GetLimit();
+    }
+    return limit;
+}
+
+uint64_t GetInflightShedCountFunc(void* arg) {
+    InflightThrottle* inflightThrottle =
+        reinterpret_cast<InflightThrottle*>(arg);
+    uint64_t shedCount = 0;
+    if (inflightThrottle != nullptr) {
+        shedCount = inflightThrottle->GetShedCount();
+    }
+    return shedCount;
+}
+
 uint32_t GetTotalChunkCountFunc(void* arg) {
     uint32_t chunkCount = 0;
     ChunkServerMetric* csMetric = reinterpret_cast<ChunkServerMetric*>(arg);
@@ -117,6 +174,24 @@ uint32_t GetTotalWalSegmentCountFunc(void* arg) {
     return walSegmentCount;
 }
 
+uint64_t GetWalCopyBytesFunc(void* arg) {
+    return GetWalCopyBytes();
+}
+
+double GetWriteCopyBytesPerRequestFunc(void* arg) {
+    ChunkServerMetric* csMetric = reinterpret_cast<ChunkServerMetric*>(arg);
+    IOMetricPtr writeMetric =
+        csMetric->GetIOMetric(CSIOMetricType::WRITE_CHUNK);
+    if (writeMetric == nullptr) {
+        return 0;
+    }
+    uint64_t reqNum = writeMetric->reqNum_.get_value();
+    if (reqNum == 0) {
+        return 0;
+    }
+    return static_cast<double>(GetWalCopyBytes()) / reqNum;
+}
+
 uint32_t GetTotalSnapshotCountFunc(void* arg) {
     uint32_t snapshotCount = 0;
     ChunkServerMetric* csMetric = reinterpret_cast<ChunkServerMetric*>(arg);
@@ -26,6 +26,8 @@
 #include "src/chunkserver/trash.h"
 #include "src/chunkserver/copyset_node_manager.h"
 #include "src/chunkserver/datastore/file_pool.h"
+#include "src/chunkserver/datastore/page_cache.h"
+#include "src/chunkserver/inflight_throttle.h"
 #include "src/chunkserver/raftlog/curve_segment_log_storage.h"
 
 namespace curve {
@@ -51,6 +53,11 @@ namespace chunkserver {
      * @param arg: datastore的对象指针
      */
     uint32_t GetDatastoreCloneChunkCountFunc(void* arg);
+    /**
+     * 获取datastore读数据时page校验失败的次数
+     * @param arg: datastore的对象指针
+     */
+    uint32_t GetDatastoreCrcErrorCountFunc(void* arg);
     /**
      * 获取chunkserver上chunk文件的数量
      * @param arg: nullptr
@@ -61,6 +68,16 @@ namespace chunkserver {
      * @param arg: The pointer to ChunkServerMetric
      */
     uint32_t GetTotalWalSegmentCountFunc(void* arg);
+    /**
+     * @brief: Get the bytes memcpy'd by wal direct write in chunkserver
+     * @param arg: nullptr
+     */
+    uint64_t GetWalCopyBytesFunc(void* arg);
+    /**
+     * @brief: Get the average bytes memcpy'd per write request
+     * @param arg: The pointer to ChunkServerMetric
+     */
+    double GetWriteCopyBytesPerRequestFunc(void* arg);
 
     /**
      * 获取chunkserver上快照chunk的数量
@@ -87,6 +104,31 @@ namespace chunkserver {
      * @param arg: trash的对象指针
      */
     uint32_t GetChunkTrashedFunc(void* arg);
+    /**
+     * 获取页缓存命中的读请求数
+     * @param arg: 页缓存的对象指针
+     */
+    uint64_t GetPageCacheHitFunc(void* arg);
+    /**
+     * 获取页缓存未命中的读请求数
+     * @param arg: 页缓存的对象指针
+     */
+    uint64_t GetPageCacheMissFunc(void* arg);
+    /**
+     * 获取页缓存占用的内存
+     * @param arg: 页缓存的对象指针
+     */
+    uint64_t GetPageCacheBytesFunc(void* arg);
+    /**
+     * 获取当前的inflight上限
+     * @param arg: inflight流控的对象指针
+     */
+    uint64_t GetInflightLimitFunc(void* arg);
+    /**
+     * 获取因过载被拒绝的请求数
+     * @param arg: inflight流控的对象指针
+     */
+    uint64_t GetInflightShedCountFunc(void* arg);
 
 }  // namespace chunkserver
 }  // namespace curve
@@ -43,8 +43,10 @@
 #include <butil/raw_pack.h>
 #include <braft/local_storage.pb.h>
 #include <braft/fsync.h>
+#include <bvar/bvar.h>
 #include "src/chunkserver/raftlog/curve_segment.h"
 #include "src/chunkserver/raftlog/define.h"
+#include "src/chunkserver/raftlog/wal_group_commit.h"
 
 namespace curve {
 namespace chunkserver {
@@ -53,6 +55,52 @@ DEFINE_bool(raftSyncSegments, true, "call fsync when a segment is closed");
 DEFINE_bool(enableWalDirectWrite, true, "enable wal direct write or not");
 DEFINE_uint32(walAlignSize, 4096, "wal align size to write");
 
+namespace {
+
+// direct write时拷贝到对齐内存中的数据量
+bvar::Adder<uint64_t> g_walCopyBytes;
+
+// 线程复用的对齐内存，direct write时不需要每条日志都申请和释放内存，
+// 大块内存通过mmap申请，每次都会产生缺页并由内核清零，带来额外的内存带宽开销
+// append的拷贝和pwrite之间不会切换bthread，所以可以按线程复用
+class AlignedBuffer {
+ public:
+    AlignedBuffer() : buf_(nullptr), size_(0) {}
+    ~AlignedBuffer() {
+        free(buf_);
+    }
+
+    char* Get(size_t size) {
+        if (size <= size_) {
+            return buf_;
+        }
+        free(buf_);
+        size_t cap = std::max<size_t>(size_ * 2, 64 * 1024);
+        while (cap < size) {
+            cap *= 2;
+        }
+        buf_ = nullptr;
+        int ret = posix_memalign(reinterpret_cast<void **>(&buf_),
+                                 FLAGS_walAlignSize, cap);
+        LOG_IF(FATAL, ret != 0 || buf_ == nullptr)
+            << "posix_memalign WAL write buffer failed " << strerror(ret);
+        size_ = cap;
+        return buf_;
+    }
+
+ private:
+    char* buf_;
+    size_t size_;
+};
+
+thread_local AlignedBuffer tlsWriteBuffer;
+
+}  // namespace
+
+uint64_t GetWalCopyBytes() {
+    return g_walCopyBytes.get_value();
+}
+
 int CurveSegment::create() {
     if (!_is_open) {
         CHECK(false) << "Create on a closed segment at first_index="
@@ -412,14 +460,10 @@ int CurveSegment::append(const braft::LogEntry* entry) {
     data.resize(data.length() + zero_bytes_num);
     to_write = kEntryHeaderSize + data.length();
     CHECK_LE(data.length(), 1ul << 56ul);
-    char* write_buf = nullptr;
+    char header_buf[kEntryHeaderSize];
+    char* write_buf = header_buf;
     if (FLAGS_enableWalDirectWrite) {
-        int ret = posix_memalign(reinterpret_cast<void **>(&write_buf),
-                                 FLAGS_walAlignSize, to_write);
-        LOG_IF(FATAL, ret < 0 || write_buf == nullptr)
-        << "posix_memalign WAL write buffer failed " << strerror(ret);
-    } else {
-        write_buf = new char[kEntryHeaderSize];
+        write_buf = tlsWriteBuffer.Get(to_write);
     }
 
     const uint32_t meta_field = (entry->type << 24) | (_checksum_type << 16);
@@ -432,9 +476,11 @@ int CurveSegment::append(const braft::LogEntry* entry) {
     packer.pack32(get_checksum(
                   _checksum_type, write_buf, kEntryHeaderSize - 4));
     if (FLAGS_enableWalDirectWrite) {
+        // O_DIRECT要求内存对齐，而收到的IOBuf block不是对齐的，只能拷贝一次
         data.copy_to(write_buf + kEntryHeaderSize, real_length);
+        memset(write_buf + kEntryHeaderSize + real_length, 0, zero_bytes_num);
+        g_walCopyBytes << real_length;
         int ret = ::pwrite(_direct_fd, write_buf, to_write, _meta.bytes);
-        free(write_buf);
         if (ret != to_write) {
             LOG(ERROR) << "Fail to write directly to fd=" << _direct_fd;
             return -1;
@@ -442,7 +488,6 @@ int CurveSegment::append(const braft::LogEntry* entry) {
     } else {
         butil::IOBuf header;
         header.append(write_buf, kEntryHeaderSize);
-        delete write_buf;
         butil::IOBuf* pieces[2] = { &header, &data };
         size_t start = 0;
         ssize_t written = 0;
@@ -469,19 +514,15 @@ int CurveSegment::append(const braft::LogEntry* entry) {
 }
 
 int CurveSegment::_update_meta_page() {
-    char* metaPage = nullptr;
-    int ret = posix_memalign(reinterpret_cast<void **>(&metaPage),
-                            FLAGS_walAlignSize, _meta_page_size);
-    LOG_IF(FATAL, ret < 0 || metaPage == nullptr)
-        << "posix_memalign WAL meta page failed " << strerror(ret);
+    char* metaPage = tlsWriteBuffer.Get(_meta_page_size);
     memset(metaPage, 0, _meta_page_size);
     memcpy(metaPage, &_meta.bytes, sizeof(_meta.bytes));
+    int ret = 0;
     if (FLAGS_enableWalDirectWrite) {
         ret = ::pwrite(_direct_fd, metaPage, _meta_page_size, 0);
     } else {
         ret = ::pwrite(_fd, metaPage, _meta_page_size, 0);
     }
-    free(metaPage);
     if (ret != _meta_page_size) {
         LOG(ERROR) << "Fail to write meta page into fd="
                    << (FLAGS_enableWalDirectWrite ? _direct_fd : _fd)
@@ -604,7 +645,7 @@ int CurveSegment::close(bool will_sync) {
     if (_last_index > _first_index) {
         if (FLAGS_raftSyncSegments && will_sync &&
                                 !FLAGS_enableWalDirectWrite) {
-            ret = braft::raft_fsync(_fd);
+            ret = _fsync();
         }
     }
     if (ret == 0) {
@@ -625,7 +666,7 @@ int CurveSegment::sync(bool will_sync) {
         // CHECK(_is_open);
         if (!FLAGS_enableWalDirectWrite && braft::FLAGS_raft_sync
                                             && will_sync) {
-            return braft::raft_fsync(_fd);
+            return _fsync();
         } else {
             return 0;
         }
@@ -634,6 +675,14 @@ int CurveSegment::sync(bool will_sync) {
     }
 }
 
+int CurveSegment::_fsync() {
+    if (FLAGS_walGroupCommit) {
+        // 与其他copyset的sync合并到同一个落盘窗口
+        return WalGroupCommitter::GetInstance()->Sync(_fd);
+    }
+    return braft::raft_fsync(_fd);
+}
+
 static void* run_unlink(void* arg) {
     std::string* file_path = (std::string*) arg;
     butil::Timer timer;
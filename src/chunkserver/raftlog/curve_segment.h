@@ -61,6 +61,9 @@ namespace chunkserver {
 
 DECLARE_bool(enableWalDirectWrite);
 
+// 获取所有segment在direct write时拷贝的数据总量
+uint64_t GetWalCopyBytes();
+
 struct CurveSegmentMeta {
     CurveSegmentMeta() : bytes(0) {}
     int64_t bytes;
@@ -162,6 +165,8 @@ class BAIDU_CACHELINE_ALIGNMENT CurveSegment:
 
     int _update_meta_page();
 
+    int _fsync();
+
     std::string _path;
     CurveSegmentMeta _meta;
     mutable braft::raft_mutex_t _mutex;
@@ -0,0 +1,887 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <string.h>
+#include <unistd.h>
+#include <glog/logging.h>
+#include <butil/fd_utility.h>
+#include <butil/file_util.h>
+#include <butil/files/dir_reader_posix.h>
+#include <butil/raw_pack.h>
+#include <bthread/countdown_event.h>
+#include <braft/fsync.h>
+#include <braft/util.h>
+#include <algorithm>
+#include <chrono>  // NOLINT
+
+#include "src/chunkserver/raftlog/shared_wal.h"
+
+namespace curve {
+namespace chunkserver {
+
+namespace {
+
+const uint32_t kWalMagic = 0x4357414C;  // "CWAL"
+// | magic | type | entry type | data len | key | term | index |
+// | data checksum | header checksum |
+const size_t kRecordHeaderSize = 48;
+const char kSegmentPattern[] = "journal_%020" PRIu64;
+
+}  // namespace
+
+struct SharedWal::WriteRequest {
+    uint64_t key;
+    // 编码后的记录
+    butil::IOBuf buf;
+    // 每条记录的头部和长度，写入成功后用于更新索引
+    std::vector<RecordHeader> headers;
+    std::vector<uint32_t> lengths;
+    // REGISTER记录的路径
+    std::string path;
+    // 写入的文件和偏移，由写线程分配
+    uint64_t segment;
+    uint64_t offset;
+    int ret;
+    bthread::CountdownEvent done;
+
+    explicit WriteRequest(uint64_t key)
+        : key(key), segment(0), offset(0), ret(0), done(1) {}
+
+    void Add(const RecordHeader& header, const butil::IOBuf& data) {
+        size_t before = buf.size();
+        EncodeRecord(header, data, &buf);
+        headers.push_back(header);
+        lengths.push_back(buf.size() - before);
+    }
+};
+
+void CopysetWalIndex::Append(int64_t index,
+                             const WalEntryLocation& location) {
+    if (entries.empty()) {
+        firstIndex = index;
+    } else if (index <= LastIndex()) {
+        // 重启回放时，被截断后重新写入的entry
+        TruncateSuffix(index - 1);
+        if (entries.empty()) {
+            firstIndex = index;
+        }
+    } else if (index > LastIndex() + 1) {
+        // 之前的日志文件已经被回收
+        Reset(index);
+    }
+    entries.push_back(location);
+}
+
+void CopysetWalIndex::TruncatePrefix(int64_t firstIndexKept) {
+    if (firstIndexKept <= firstIndex) {
+        return;
+    }
+    size_t count = std::min(entries.size(),
+        static_cast<size_t>(firstIndexKept - firstIndex));
+    entries.erase(entries.begin(), entries.begin() + count);
+    firstIndex = firstIndexKept;
+}
+
+void CopysetWalIndex::TruncateSuffix(int64_t lastIndexKept) {
+    while (!entries.empty() && LastIndex() > lastIndexKept) {
+        entries.pop_back();
+    }
+    if (entries.empty()) {
+        firstIndex = std::min(firstIndex, lastIndexKept + 1);
+    }
+}
+
+void CopysetWalIndex::Reset(int64_t nextLogIndex) {
+    entries.clear();
+    firstIndex = nextLogIndex;
+}
+
+SharedWal::SharedWal()
+    : inited_(false),
+      writerRunning_(false),
+      curSeq_(0),
+      curFd_(-1),
+      curOffset_(0),
+      reclaimerRunning_(false) {}
+
+SharedWal::~SharedWal() {
+    Fini();
+}
+
+SharedWal* SharedWal::GetInstance() {
+    static SharedWal wal;
+    return &wal;
+}
+
+uint64_t SharedWal::KeyOfPath(const std::string& path) {
+    // FNV-1a，重启前后需要保持一致
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : path) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::string SharedWal::SegmentPath(uint64_t seq) const {
+    std::string path(options_.dir);
+    butil::string_appendf(&path, "/");
+    butil::string_appendf(&path, kSegmentPattern, seq);
+    return path;
+}
+
+int SharedWal::Init(const SharedWalOptions& options) {
+    if (inited_) {
+        return 0;
+    }
+    options_ = options;
+    butil::File::Error e;
+    if (!butil::CreateDirectoryAndGetError(butil::FilePath(options_.dir),
+                                           &e, true)) {
+        LOG(ERROR) << "Fail to create shared wal dir " << options_.dir
+                   << " : " << e;
+        return -1;
+    }
+
+    std::vector<uint64_t> seqs;
+    butil::DirReaderPosix reader(options_.dir.c_str());
+    if (!reader.IsValid()) {
+        LOG(ERROR) << "Fail to list shared wal dir " << options_.dir;
+        return -1;
+    }
+    while (reader.Next()) {
+        uint64_t seq = 0;
+        if (sscanf(reader.name(), kSegmentPattern, &seq) == 1) {
+            seqs.push_back(seq);
+        }
+    }
+    std::sort(seqs.begin(), seqs.end());
+
+    // 按顺序回放所有的日志文件
+    for (uint64_t seq : seqs) {
+        int fd = -1;
+        if (OpenSegment(seq, false, &fd) != 0) {
+            return -1;
+        }
+        segments_[seq] = fd;
+        int64_t valid = ReplaySegment(seq, fd);
+        LOG(INFO) << "Replayed shared wal segment " << SegmentPath(seq)
+                  << ", valid length: " << valid;
+    }
+
+    // 目录已经不存在的copyset已经被删除
+    for (auto it = indexes_.begin(); it != indexes_.end();) {
+        if (it->second.path.empty() ||
+            ::access(it->second.path.c_str(), F_OK) != 0) {
+            LOG(INFO) << "Drop wal index of removed copyset, path: "
+                      << it->second.path;
+            it = indexes_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // 每次启动都写新的日志文件，不需要处理上一个文件末尾不完整的记录
+    curSeq_ = seqs.empty() ? 1 : seqs.back() + 1;
+    if (OpenSegment(curSeq_, true, &curFd_) != 0) {
+        return -1;
+    }
+    segments_[curSeq_] = curFd_;
+    curOffset_ = 0;
+    if (WriteCheckpoint() != 0 || braft::raft_fsync(curFd_) != 0) {
+        LOG(ERROR) << "Fail to write checkpoint to shared wal segment "
+                   << SegmentPath(curSeq_);
+        return -1;
+    }
+
+    writerRunning_ = true;
+    writer_ = std::thread(&SharedWal::WriteLoop, this);
+    reclaimerRunning_ = true;
+    reclaimer_ = std::thread(&SharedWal::ReclaimLoop, this);
+    inited_ = true;
+    LOG(INFO) << "Init shared wal success, dir: " << options_.dir
+              << ", copysets: " << indexes_.size()
+              << ", segments: " << segments_.size();
+    return 0;
+}
+
+void SharedWal::Fini() {
+    if (!inited_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lk(reclaimMtx_);
+        reclaimerRunning_ = false;
+        reclaimCv_.notify_all();
+    }
+    reclaimer_.join();
+    {
+        std::lock_guard<std::mutex> lk(writeMtx_);
+        writerRunning_ = false;
+        writeCv_.notify_all();
+    }
+    writer_.join();
+
+    common::WriteLockGuard guard(segmentLock_);
+    for (auto& item : segments_) {
+        ::close(item.second);
+    }
+    segments_.clear();
+    curFd_ = -1;
+    {
+        std::lock_guard<std::mutex> lk(indexMtx_);
+        indexes_.clear();
+    }
+    inited_ = false;
+}
+
+int SharedWal::OpenSegment(uint64_t seq, bool create, int* fd) {
+    std::string path = SegmentPath(seq);
+    int flags = O_RDWR | O_NOATIME;
+    if (create) {
+        flags |= O_CREAT | O_EXCL;
+    }
+    *fd = ::open(path.c_str(), flags, 0644);
+    if (*fd < 0) {
+        LOG(ERROR) << "Fail to open shared wal segment " << path
+                   << ", error: " << strerror(errno);
+        return -1;
+    }
+    butil::make_close_on_exec(*fd);
+    if (create) {
+        // 新文件需要持久化目录项
+        int dirFd = ::open(options_.dir.c_str(), O_RDONLY);
+        if (dirFd >= 0) {
+            braft::raft_fsync(dirFd);
+            ::close(dirFd);
+        }
+    }
+    return 0;
+}
+
+void SharedWal::EncodeRecord(const RecordHeader& header,
+                             const butil::IOBuf& data, butil::IOBuf* out) {
+    char buf[kRecordHeaderSize];
+    butil::RawPacker packer(buf);
+    packer.pack32(kWalMagic)
+          .pack32(header.type)
+          .pack32(static_cast<uint32_t>(header.entryType))
+          .pack32(static_cast<uint32_t>(data.size()))
+          .pack64(header.key)
+          .pack64(static_cast<uint64_t>(header.term))
+          .pack64(static_cast<uint64_t>(header.index))
+          .pack32(braft::crc32(data));
+    packer.pack32(braft::crc32(buf, kRecordHeaderSize - 4));
+    out->append(buf, kRecordHeaderSize);
+    out->append(data);
+}
+
+int64_t SharedWal::ReplaySegment(uint64_t seq, int fd) {
+    uint64_t offset = 0;
+    while (true) {
+        butil::IOPortal buf;
+        ssize_t n = braft::file_pread(&buf, fd, offset, kRecordHeaderSize);
+        if (n != static_cast<ssize_t>(kRecordHeaderSize)) {
+            break;
+        }
+        char headerBuf[kRecordHeaderSize];
+        buf.copy_to(headerBuf, kRecordHeaderSize);
+        uint32_t magic = 0;
+        uint32_t entryType = 0;
+        uint64_t term = 0;
+        uint64_t index = 0;
+        uint32_t headerChecksum = 0;
+        RecordHeader header;
+        butil::RawUnpacker unpacker(headerBuf);
+        unpacker.unpack32(magic)
+                .unpack32(header.type)
+                .unpack32(entryType)
+                .unpack32(header.dataLen)
+                .unpack64(header.key)
+                .unpack64(term)
+                .unpack64(index)
+                .unpack32(header.dataChecksum)
+                .unpack32(headerChecksum);
+        if (magic != kWalMagic || headerChecksum !=
+                braft::crc32(headerBuf, kRecordHeaderSize - 4)) {
+            // 文件末尾没有写完整的记录
+            break;
+        }
+        header.entryType = static_cast<int>(entryType);
+        header.term = static_cast<int64_t>(term);
+        header.index = static_cast<int64_t>(index);
+
+        butil::IOPortal data;
+        if (header.dataLen > 0) {
+            n = braft::file_pread(&data, fd, offset + kRecordHeaderSize,
+                                  header.dataLen);
+            if (n != static_cast<ssize_t>(header.dataLen) ||
+                braft::crc32(data) != header.dataChecksum) {
+                LOG(WARNING) << "Found incomplete record in shared wal "
+                             << SegmentPath(seq) << " at offset " << offset;
+                break;
+            }
+        }
+        uint32_t length = kRecordHeaderSize + header.dataLen;
+        ApplyRecord(header, seq, offset, length, data);
+        offset += length;
+    }
+    return offset;
+}
+
+void SharedWal::ApplyRecord(const RecordHeader& header, uint64_t seq,
+                            uint64_t offset, uint32_t length,
+                            const butil::IOBuf& data) {
+    std::lock_guard<std::mutex> lk(indexMtx_);
+    CopysetWalIndex& index = indexes_[header.key];
+    switch (header.type) {
+    case RECORD_ENTRY: {
+        WalEntryLocation location;
+        location.segment = seq;
+        location.offset = offset;
+        location.length = length;
+        location.term = header.term;
+        location.type = header.entryType;
+        index.Append(header.index, location);
+        break;
+    }
+    case RECORD_TRUNCATE_PREFIX:
+        index.TruncatePrefix(header.index);
+        break;
+    case RECORD_TRUNCATE_SUFFIX:
+        index.TruncateSuffix(header.index);
+        break;
+    case RECORD_RESET:
+        index.Reset(header.index);
+        break;
+    case RECORD_REGISTER:
+        index.path = data.to_string();
+        break;
+    default:
+        LOG(ERROR) << "Unknown shared wal record type " << header.type;
+        break;
+    }
+}
+
+int SharedWal::Submit(WriteRequest* request) {
+    {
+        std::lock_guard<std::mutex> lk(writeMtx_);
+        if (!writerRunning_) {
+            return -1;
+        }
+        writeQueue_.push_back(request);
+        if (writeQueue_.size() == 1) {
+            writeCv_.notify_one();
+        }
+    }
+    request->done.wait();
+    return request->ret;
+}
+
+void SharedWal::WriteLoop() {
+    std::vector<WriteRequest*> batch;
+    std::unique_lock<std::mutex> lk(writeMtx_);
+    while (true) {
+        writeCv_.wait(lk, [this]() {
+            return !writeQueue_.empty() || !writerRunning_;
+        });
+        if (writeQueue_.empty()) {
+            break;
+        }
+        batch.assign(writeQueue_.begin(), writeQueue_.end());
+        writeQueue_.clear();
+        lk.unlock();
+        WriteBatch(batch);
+        lk.lock();
+    }
+}
+
+void SharedWal::WriteBatch(const std::vector<WriteRequest*>& batch) {
+    // 同时提交的请求合并成一次顺序写和一次fdatasync，
+    // 当前文件写不下时先把已经合并的部分落盘，再切换到新文件
+    std::vector<WriteRequest*> group;
+    butil::IOBuf data;
+    uint64_t groupOffset = curOffset_;
+    for (auto request : batch) {
+        size_t len = request->buf.size();
+        if (curOffset_ > 0 && curOffset_ + len > options_.segmentSize) {
+            if (!group.empty()) {
+                FlushGroup(group, &data, groupOffset);
+                group.clear();
+            }
+            if (RollSegment() != 0) {
+                request->ret = -1;
+                request->done.signal();
+                continue;
+            }
+            groupOffset = curOffset_;
+        }
+        request->segment = curSeq_;
+        request->offset = curOffset_;
+        curOffset_ += len;
+        data.append(request->buf);
+        group.push_back(request);
+    }
+    if (!group.empty()) {
+        FlushGroup(group, &data, groupOffset);
+    }
+}
+
+void SharedWal::FlushGroup(const std::vector<WriteRequest*>& group,
+                           butil::IOBuf* data, uint64_t offset) {
+    int ret = 0;
+    while (!data->empty()) {
+        ssize_t n = data->pcut_into_file_descriptor(curFd_, offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG(ERROR) << "Fail to write shared wal segment "
+                       << SegmentPath(curSeq_) << ", error: "
+                       << strerror(errno);
+            ret = -1;
+            break;
+        }
+        offset += n;
+    }
+    if (ret == 0 && braft::raft_fsync(curFd_) != 0) {
+        LOG(ERROR) << "Fail to sync shared wal segment "
+                   << SegmentPath(curSeq_) << ", error: " << strerror(errno);
+        ret = -1;
+    }
+    data->clear();
+    if (ret != 0) {
+        // 文件中可能有部分写入的数据，后续的写入换到新文件
+        curOffset_ = options_.segmentSize;
+    }
+
+    for (auto request : group) {
+        if (ret == 0) {
+            // 落盘后在写线程上更新索引，回收线程看到的索引不会落后于文件
+            uint64_t recordOffset = request->offset;
+            for (size_t i = 0; i < request->headers.size(); ++i) {
+                butil::IOBuf path;
+                if (request->headers[i].type == RECORD_REGISTER) {
+                    path.append(request->path);
+                }
+                ApplyRecord(request->headers[i], request->segment,
+                            recordOffset, request->lengths[i], path);
+                recordOffset += request->lengths[i];
+            }
+        }
+        request->ret = ret;
+        request->done.signal();
+    }
+}
+
+int SharedWal::RollSegment() {
+    uint64_t seq = curSeq_ + 1;
+    int fd = -1;
+    if (OpenSegment(seq, true, &fd) != 0) {
+        return -1;
+    }
+    {
+        common::WriteLockGuard guard(segmentLock_);
+        segments_[seq] = fd;
+    }
+    {
+        std::lock_guard<std::mutex> lk(indexMtx_);
+        curSeq_ = seq;
+    }
+    curFd_ = fd;
+    curOffset_ = 0;
+
+    if (WriteCheckpoint() != 0) {
+        return -1;
+    }
+    LOG(INFO) << "Switch shared wal to new segment " << SegmentPath(seq);
+    return 0;
+}
+
+int SharedWal::WriteCheckpoint() {
+    // 新文件开头记录所有copyset的路径和空日志的起始index，
+    // 之前的文件被回收之后回放时仍然可以恢复这些信息
+    butil::IOBuf data;
+    {
+        std::lock_guard<std::mutex> lk(indexMtx_);
+        for (auto& item : indexes_) {
+            if (item.second.path.empty()) {
+                continue;
+            }
+            RecordHeader header;
+            header.type = RECORD_REGISTER;
+            header.entryType = 0;
+            header.key = item.first;
+            header.term = 0;
+            header.index = 0;
+            butil::IOBuf path;
+            path.append(item.second.path);
+            EncodeRecord(header, path, &data);
+            if (item.second.entries.empty()) {
+                header.type = RECORD_RESET;
+                header.index = item.second.firstIndex;
+                EncodeRecord(header, butil::IOBuf(), &data);
+            }
+        }
+    }
+    uint64_t offset = curOffset_;
+    while (!data.empty()) {
+        ssize_t n = data.pcut_into_file_descriptor(curFd_, offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG(ERROR) << "Fail to write shared wal segment "
+                       << SegmentPath(curSeq_) << ", error: "
+                       << strerror(errno);
+            return -1;
+        }
+        offset += n;
+    }
+    curOffset_ = offset;
+    return 0;
+}
+
+int SharedWal::WriteControl(uint64_t key, uint32_t type, int64_t index,
+                            const std::string& data) {
+    WriteRequest request(key);
+    RecordHeader header;
+    header.type = type;
+    header.entryType = 0;
+    header.key = key;
+    header.term = 0;
+    header.index = index;
+    butil::IOBuf buf;
+    buf.append(data);
+    request.path = data;
+    request.Add(header, buf);
+    return Submit(&request);
+}
+
+int SharedWal::Open(const std::string& path, bool fresh, uint64_t* key) {
+    *key = KeyOfPath(path);
+    {
+        std::lock_guard<std::mutex> lk(indexMtx_);
+        CopysetWalIndex& index = indexes_[*key];
+        if (!index.path.empty() && index.path != path) {
+            LOG(ERROR) << "Shared wal key conflict, path: " << path
+                       << ", exist path: " << index.path;
+            return -1;
+        }
+        if (index.opened) {
+            LOG(ERROR) << "Shared wal of " << path << " is already opened";
+            return -1;
+        }
+        index.path = path;
+        index.opened = true;
+    }
+    // 注册和重置记录在同一次提交中写入，不会只有其中一条落盘
+    WriteRequest request(*key);
+    RecordHeader header;
+    header.type = RECORD_REGISTER;
+    header.entryType = 0;
+    header.key = *key;
+    header.term = 0;
+    header.index = 0;
+    butil::IOBuf buf;
+    buf.append(path);
+    request.path = path;
+    request.Add(header, buf);
+    if (fresh) {
+        header.type = RECORD_RESET;
+        header.index = 1;
+        request.Add(header, butil::IOBuf());
+    }
+    if (Submit(&request) != 0) {
+        Close(*key);
+        return -1;
+    }
+    return 0;
+}
+
+void SharedWal::Close(uint64_t key) {
+    std::lock_guard<std::mutex> lk(indexMtx_);
+    auto it = indexes_.find(key);
+    if (it != indexes_.end()) {
+        it->second.opened = false;
+    }
+}
+
+int SharedWal::Append(uint64_t key,
+                      const std::vector<braft::LogEntry*>& entries) {
+    WriteRequest request(key);
+    for (auto entry : entries) {
+        butil::IOBuf data;
+        switch (entry->type) {
+        case braft::ENTRY_TYPE_DATA:
+            data.append(entry->data);
+            break;
+        case braft::ENTRY_TYPE_NO_OP:
+            break;
+        case braft::ENTRY_TYPE_CONFIGURATION: {
+            butil::Status status =
+                braft::serialize_configuration_meta(entry, data);
+            if (!status.ok()) {
+                LOG(ERROR) << "Fail to serialize ConfigurationPBMeta, key: "
+                           << key;
+                return -1;
+            }
+            break;
+        }
+        default:
+            LOG(FATAL) << "unknow entry type: " << entry->type;
+            return -1;
+        }
+        RecordHeader header;
+        header.type = RECORD_ENTRY;
+        header.entryType = entry->type;
+        header.key = key;
+        header.term = entry->id.term;
+        header.index = entry->id.index;
+        request.Add(header, data);
+    }
+    if (Submit(&request) != 0) {
+        return -1;
+    }
+    return entries.size();
+}
+
+int SharedWal::TruncatePrefix(uint64_t key, int64_t firstIndexKept) {
+    return WriteControl(key, RECORD_TRUNCATE_PREFIX, firstIndexKept, "");
+}
+
+int SharedWal::TruncateSuffix(uint64_t key, int64_t lastIndexKept) {
+    return WriteControl(key, RECORD_TRUNCATE_SUFFIX, lastIndexKept, "");
+}
+
+int SharedWal::Reset(uint64_t key, int64_t nextLogIndex) {
+    return WriteControl(key, RECORD_RESET, nextLogIndex, "");
+}
+
+int64_t SharedWal::FirstLogIndex(uint64_t key) {
+    std::lock_guard<std::mutex> lk(indexMtx_);
+    return indexes_[key].firstIndex;
+}
+
+int64_t SharedWal::LastLogIndex(uint64_t key) {
+    std::lock_guard<std::mutex> lk(indexMtx_);
+    return indexes_[key].LastIndex();
+}
+
+int64_t SharedWal::GetTerm(uint64_t key, int64_t index) {
+    std::lock_guard<std::mutex> lk(indexMtx_);
+    const CopysetWalIndex& walIndex = indexes_[key];
+    if (index < walIndex.firstIndex || index > walIndex.LastIndex()) {
+        return 0;
+    }
+    return walIndex.entries[index - walIndex.firstIndex].term;
+}
+
+int SharedWal::ReadRecord(const WalEntryLocation& location,
+                          RecordHeader* header, butil::IOBuf* data) {
+    common::ReadLockGuard guard(segmentLock_);
+    auto it = segments_.find(location.segment);
+    if (it == segments_.end()) {
+        return -1;
+    }
+    butil::IOPortal buf;
+    ssize_t n = braft::file_pread(&buf, it->second, location.offset,
+                                  location.length);
+    if (n != static_cast<ssize_t>(location.length)) {
+        LOG(ERROR) << "Fail to read shared wal segment "
+                   << SegmentPath(location.segment)
+                   << " at offset " << location.offset;
+        return -1;
+    }
+    char headerBuf[kRecordHeaderSize];
+    buf.cutn(headerBuf, kRecordHeaderSize);
+    uint32_t magic = 0;
+    uint32_t entryType = 0;
+    uint64_t term = 0;
+    uint64_t index = 0;
+    uint32_t headerChecksum = 0;
+    butil::RawUnpacker unpacker(headerBuf);
+    unpacker.unpack32(magic)
+            .unpack32(header->type)
+            .unpack32(entryType)
+            .unpack32(header->dataLen)
+            .unpack64(header->key)
+            .unpack64(term)
+            .unpack64(index)
+            .unpack32(header->dataChecksum)
+            .unpack32(headerChecksum);
+    if (magic != kWalMagic ||
+        headerChecksum != braft::crc32(headerBuf, kRecordHeaderSize - 4) ||
+        header->dataLen != buf.size() ||
+        header->dataChecksum != braft::crc32(buf)) {
+        LOG(ERROR) << "Found corrupted record in shared wal segment "
+                   << SegmentPath(location.segment)
+                   << " at offset " << location.offset;
+        return -1;
+    }
+    header->entryType = static_cast<int>(entryType);
+    header->term = static_cast<int64_t>(term);
+    header->index = static_cast<int64_t>(index);
+    data->swap(buf);
+    return 0;
+}
+
+braft::LogEntry* SharedWal::GetEntry(uint64_t key, int64_t index) {
+    WalEntryLocation location;
+    {
+        std::lock_guard<std::mutex> lk(indexMtx_);
+        const CopysetWalIndex& walIndex = indexes_[key];
+        if (index < walIndex.firstIndex || index > walIndex.LastIndex()) {
+            return nullptr;
+        }
+        location = walIndex.entries[index - walIndex.firstIndex];
+    }
+
+    RecordHeader header;
+    butil::IOBuf data;
+    if (ReadRecord(location, &header, &data) != 0) {
+        return nullptr;
+    }
+    if (header.key != key || header.index != index ||
+        header.type != RECORD_ENTRY) {
+        LOG(ERROR) << "Shared wal record mismatch, key: " << key
+                   << ", index: " << index << ", record key: " << header.key
+                   << ", record index: " << header.index;
+        return nullptr;
+    }
+
+    braft::LogEntry* entry = new braft::LogEntry();
+    entry->AddRef();
+    entry->id.index = index;
+    entry->id.term = header.term;
+    entry->type = static_cast<braft::EntryType>(header.entryType);
+    switch (header.entryType) {
+    case braft::ENTRY_TYPE_DATA:
+        entry->data.swap(data);
+        break;
+    case braft::ENTRY_TYPE_NO_OP:
+        break;
+    case braft::ENTRY_TYPE_CONFIGURATION: {
+        butil::Status status = braft::parse_configuration_meta(data, entry);
+        if (!status.ok()) {
+            LOG(WARNING) << "Fail to parse ConfigurationPBMeta, key: " << key
+                         << ", index: " << index;
+            entry->Release();
+            return nullptr;
+        }
+        break;
+    }
+    default:
+        LOG(ERROR) << "Unknown entry type " << header.entryType
+                   << ", key: " << key << ", index: " << index;
+        entry->Release();
+        return nullptr;
+    }
+    return entry;
+}
+
+void SharedWal::ListConfigurationEntries(
+    uint64_t key, std::vector<braft::LogEntry*>* entries) {
+    std::vector<int64_t> indexes;
+    {
+        std::lock_guard<std::mutex> lk(indexMtx_);
+        const CopysetWalIndex& walIndex = indexes_[key];
+        for (size_t i = 0; i < walIndex.entries.size(); ++i) {
+            if (walIndex.entries[i].type ==
+                braft::ENTRY_TYPE_CONFIGURATION) {
+                indexes.push_back(walIndex.firstIndex + i);
+            }
+        }
+    }
+    for (int64_t index : indexes) {
+        braft::LogEntry* entry = GetEntry(key, index);
+        if (entry != nullptr) {
+            entries->push_back(entry);
+        }
+    }
+}
+
+int SharedWal::Reclaim() {
+    uint64_t minSeq = 0;
+    {
+        std::lock_guard<std::mutex> lk(indexMtx_);
+        minSeq = curSeq_;
+        for (auto it = indexes_.begin(); it != indexes_.end();) {
+            CopysetWalIndex& index = it->second;
+            if (!index.opened && (index.path.empty() ||
+                ::access(index.path.c_str(), F_OK) != 0)) {
+                // copyset已经被删除
+                it = indexes_.erase(it);
+                continue;
+            }
+            if (!index.entries.empty()) {
+                minSeq = std::min(minSeq, index.entries.front().segment);
+            }
+            ++it;
+        }
+    }
+
+    std::vector<std::pair<uint64_t, int>> reclaimed;
+    {
+        common::WriteLockGuard guard(segmentLock_);
+        for (auto it = segments_.begin();
+             it != segments_.end() && it->first < minSeq;) {
+            reclaimed.push_back(*it);
+            it = segments_.erase(it);
+        }
+    }
+    for (auto& item : reclaimed) {
+        ::close(item.second);
+        std::string path = SegmentPath(item.first);
+        if (::unlink(path.c_str()) != 0) {
+            LOG(ERROR) << "Fail to unlink shared wal segment " << path
+                       << ", error: " << strerror(errno);
+        } else {
+            LOG(INFO) << "Reclaimed shared wal segment " << path;
+        }
+    }
+    return reclaimed.size();
+}
+
+void SharedWal::ReclaimLoop() {
+    std::unique_lock<std::mutex> lk(reclaimMtx_);
+    while (reclaimerRunning_) {
+        reclaimCv_.wait_for(lk,
+            std::chrono::seconds(options_.reclaimIntervalS));
+        if (!reclaimerRunning_) {
+            break;
+        }
+        lk.unlock();
+        Reclaim();
+        lk.lock();
+    }
+}
+
+uint32_t SharedWal::GetSegmentCount() {
+    common::ReadLockGuard guard(segmentLock_);
+    return segments_.size();
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,261 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_CHUNKSERVER_RAFTLOG_SHARED_WAL_H_
+#define SRC_CHUNKSERVER_RAFTLOG_SHARED_WAL_H_
+
+#include <butil/iobuf.h>
+#include <braft/log_entry.h>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "src/common/concurrent/rw_lock.h"
+
+namespace curve {
+namespace chunkserver {
+
+struct SharedWalOptions {
+    // 日志文件所在目录
+    std::string dir;
+    // 单个日志文件的大小，写满后切换到新文件
+    uint64_t segmentSize;
+    // 后台回收日志文件的间隔
+    uint32_t reclaimIntervalS;
+
+    SharedWalOptions() : segmentSize(64 * 1024 * 1024), reclaimIntervalS(5) {}
+};
+
+// 一条raft log在日志文件中的位置
+struct WalEntryLocation {
+    uint64_t segment;
+    uint64_t offset;
+    uint32_t length;
+    int64_t term;
+    int type;
+};
+
+/**
+ * 一个copyset在共享日志中的内存索引
+ * entries[i]对应的raft log index为firstIndex + i
+ */
+struct CopysetWalIndex {
+    std::string path;
+    int64_t firstIndex;
+    std::deque<WalEntryLocation> entries;
+    // 是否有LogStorage正在使用
+    bool opened;
+
+    CopysetWalIndex() : firstIndex(1), opened(false) {}
+
+    int64_t LastIndex() const {
+        return firstIndex + static_cast<int64_t>(entries.size()) - 1;
+    }
+
+    // 追加index对应的位置，index不连续时先截断或重置
+    void Append(int64_t index, const WalEntryLocation& location);
+    // [firstIndex, firstIndexKept)之间的日志被丢弃
+    void TruncatePrefix(int64_t firstIndexKept);
+    // (lastIndexKept, +inf)之间的日志被丢弃
+    void TruncateSuffix(int64_t lastIndexKept);
+    void Reset(int64_t nextLogIndex);
+};
+
+/**
+ * 一块盘上所有copyset共享的raft日志
+ * 所有copyset的log entry都顺序追加到同一组日志文件（journal_xxx）中，
+ * 每个copyset在内存中只维护自己的entry位置索引。后台写线程把同一时刻
+ * 各个copyset提交的追加合并成一次顺序写和一次fdatasync，
+ * HDD和QLC盘上的大量随机小写因此变成顺序写。
+ * truncate_prefix/truncate_suffix/reset只修改内存索引并追加一条控制记录，
+ * 重启时按顺序回放所有记录恢复索引。
+ * 不再被任何copyset引用的日志文件由后台线程删除。
+ */
+class SharedWal {
+ public:
+    SharedWal();
+    ~SharedWal();
+
+    static SharedWal* GetInstance();
+
+    /**
+     * 打开日志目录，回放已有的日志文件恢复各个copyset的索引
+     * @return 成功返回0，失败返回-1
+     */
+    int Init(const SharedWalOptions& options);
+
+    void Fini();
+
+    bool IsInited() const {
+        return inited_;
+    }
+
+    /**
+     * LogStorage初始化时调用，获取copyset的索引并写入注册记录
+     * @param path: copyset的raft log目录
+     * @param fresh: log目录是新创建的，copyset被删除后在同一路径重建时，
+     *        共享日志中可能还有旧copyset的索引和记录，此时同时写入一条
+     *        RESET记录，使内存索引和重启回放的结果都从空日志开始
+     * @param key[out]: copyset在共享日志中的标识
+     * @return 成功返回0，失败返回-1
+     */
+    int Open(const std::string& path, bool fresh, uint64_t* key);
+
+    // LogStorage析构时调用
+    void Close(uint64_t key);
+
+    /**
+     * 追加一组log entry，返回时已经落盘
+     * @return 成功追加的条数，失败返回-1
+     */
+    int Append(uint64_t key, const std::vector<braft::LogEntry*>& entries);
+
+    int TruncatePrefix(uint64_t key, int64_t firstIndexKept);
+    int TruncateSuffix(uint64_t key, int64_t lastIndexKept);
+    int Reset(uint64_t key, int64_t nextLogIndex);
+
+    int64_t FirstLogIndex(uint64_t key);
+    int64_t LastLogIndex(uint64_t key);
+    int64_t GetTerm(uint64_t key, int64_t index);
+
+    /**
+     * 读取一条log entry
+     * @return 成功返回引用计数为1的entry，不存在或读取失败返回nullptr
+     */
+    braft::LogEntry* GetEntry(uint64_t key, int64_t index);
+
+    /**
+     * 获取copyset当前所有的配置变更entry，LogStorage初始化时使用
+     */
+    void ListConfigurationEntries(uint64_t key,
+                                  std::vector<braft::LogEntry*>* entries);
+
+    // 回收不再使用的日志文件，返回删除的文件数
+    int Reclaim();
+
+    // 当前的日志文件数
+    uint32_t GetSegmentCount();
+
+    static uint64_t KeyOfPath(const std::string& path);
+
+ private:
+    enum RecordType {
+        RECORD_ENTRY = 1,
+        RECORD_TRUNCATE_PREFIX = 2,
+        RECORD_TRUNCATE_SUFFIX = 3,
+        RECORD_RESET = 4,
+        RECORD_REGISTER = 5,
+    };
+
+    struct RecordHeader {
+        uint32_t type;
+        int entryType;
+        uint64_t key;
+        int64_t term;
+        int64_t index;
+        uint32_t dataLen;
+        uint32_t dataChecksum;
+    };
+
+    // 一次提交，包含同一个copyset的若干条记录，写入后一起落盘
+    struct WriteRequest;
+
+    static void EncodeRecord(const RecordHeader& header,
+                             const butil::IOBuf& data, butil::IOBuf* out);
+
+    int Submit(WriteRequest* request);
+
+    // 写一条控制记录并落盘
+    int WriteControl(uint64_t key, uint32_t type, int64_t index,
+                     const std::string& data);
+
+    void WriteLoop();
+
+    // 把一批请求写入日志文件，需要时切换文件
+    void WriteBatch(const std::vector<WriteRequest*>& batch);
+
+    // 顺序写入并落盘一组请求，然后更新索引并唤醒请求方
+    void FlushGroup(const std::vector<WriteRequest*>& group,
+                    butil::IOBuf* data, uint64_t offset);
+
+    void ReclaimLoop();
+
+    // 切换到新的日志文件，只在写线程上调用
+    int RollSegment();
+
+    // 在当前文件中写入所有copyset的注册信息，不落盘
+    int WriteCheckpoint();
+
+    int OpenSegment(uint64_t seq, bool create, int* fd);
+
+    std::string SegmentPath(uint64_t seq) const;
+
+    // 回放一个日志文件，返回有效数据的长度
+    int64_t ReplaySegment(uint64_t seq, int fd);
+
+    void ApplyRecord(const RecordHeader& header, uint64_t seq,
+                     uint64_t offset, uint32_t length,
+                     const butil::IOBuf& data);
+
+    int ReadRecord(const WalEntryLocation& location, RecordHeader* header,
+                   butil::IOBuf* data);
+
+ private:
+    SharedWalOptions options_;
+    bool inited_;
+
+    // copyset索引，由indexMtx_保护
+    std::mutex indexMtx_;
+    std::unordered_map<uint64_t, CopysetWalIndex> indexes_;
+
+    // 日志文件，修改时持有写锁，读entry时持有读锁
+    common::RWLock segmentLock_;
+    std::map<uint64_t, int> segments_;
+
+    // 写请求队列，由writeMtx_保护
+    std::mutex writeMtx_;
+    std::condition_variable writeCv_;
+    std::deque<WriteRequest*> writeQueue_;
+    bool writerRunning_;
+    std::thread writer_;
+    // 当前写入的文件，只在写线程上修改，curSeq_修改时同时持有indexMtx_
+    uint64_t curSeq_;
+    int curFd_;
+    uint64_t curOffset_;
+
+    std::mutex reclaimMtx_;
+    std::condition_variable reclaimCv_;
+    bool reclaimerRunning_;
+    std::thread reclaimer_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_RAFTLOG_SHARED_WAL_H_
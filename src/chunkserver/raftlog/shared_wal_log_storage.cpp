@@ -0,0 +1,138 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <glog/logging.h>
+#include <butil/file_util.h>
+#include <braft/configuration_manager.h>
+#include <braft/util.h>
+
+#include "src/chunkserver/raftlog/shared_wal_log_storage.h"
+
+namespace curve {
+namespace chunkserver {
+
+void RegisterSharedWalLogStorageOrDie() {
+    static SharedWalLogStorage logStorage;
+    braft::log_storage_extension()->RegisterOrDie(
+                                    "curvewal", &logStorage);
+}
+
+SharedWalLogStorage::~SharedWalLogStorage() {
+    if (_opened) {
+        _wal->Close(_key);
+    }
+}
+
+int SharedWalLogStorage::init(
+                    braft::ConfigurationManager* configuration_manager) {
+    if (!_wal->IsInited()) {
+        LOG(ERROR) << "Shared wal is not inited, path: " << _path;
+        return -1;
+    }
+    // 目录只用来标识copyset，删除copyset时随copyset目录一起删除
+    butil::FilePath dir_path(_path);
+    // 目录不存在说明是新建的copyset，同一路径上被删除的copyset的日志不能再用
+    bool fresh = !butil::DirectoryExists(dir_path);
+    butil::File::Error e;
+    if (!butil::CreateDirectoryAndGetError(
+                dir_path, &e, braft::FLAGS_raft_create_parent_directories)) {
+        LOG(ERROR) << "Fail to create " << dir_path.value() << " : " << e;
+        return -1;
+    }
+    if (_wal->Open(_path, fresh, &_key) != 0) {
+        LOG(ERROR) << "Fail to open shared wal, path: " << _path;
+        return -1;
+    }
+    _opened = true;
+
+    std::vector<braft::LogEntry*> entries;
+    _wal->ListConfigurationEntries(_key, &entries);
+    for (auto entry : entries) {
+        braft::ConfigurationEntry conf_entry(*entry);
+        configuration_manager->add(conf_entry);
+        entry->Release();
+    }
+    LOG(INFO) << "Init shared wal log storage success, path: " << _path
+              << ", first_log_index: " << first_log_index()
+              << ", last_log_index: " << last_log_index();
+    return 0;
+}
+
+int64_t SharedWalLogStorage::first_log_index() {
+    return _wal->FirstLogIndex(_key);
+}
+
+int64_t SharedWalLogStorage::last_log_index() {
+    return _wal->LastLogIndex(_key);
+}
+
+braft::LogEntry* SharedWalLogStorage::get_entry(const int64_t index) {
+    return _wal->GetEntry(_key, index);
+}
+
+int64_t SharedWalLogStorage::get_term(const int64_t index) {
+    return _wal->GetTerm(_key, index);
+}
+
+int SharedWalLogStorage::append_entry(const braft::LogEntry* entry) {
+    std::vector<braft::LogEntry*> entries;
+    entries.push_back(const_cast<braft::LogEntry*>(entry));
+    return append_entries(entries) == 1 ? 0 : -1;
+}
+
+int SharedWalLogStorage::append_entries(
+                        const std::vector<braft::LogEntry*>& entries) {
+    if (entries.empty()) {
+        return 0;
+    }
+    if (last_log_index() + 1 != entries.front()->id.index) {
+        LOG(FATAL) << "There's gap between appending entries and"
+                   << " _last_log_index path: " << _path;
+        return -1;
+    }
+    return _wal->Append(_key, entries);
+}
+
+int SharedWalLogStorage::truncate_prefix(const int64_t first_index_kept) {
+    return _wal->TruncatePrefix(_key, first_index_kept);
+}
+
+int SharedWalLogStorage::truncate_suffix(const int64_t last_index_kept) {
+    return _wal->TruncateSuffix(_key, last_index_kept);
+}
+
+int SharedWalLogStorage::reset(const int64_t next_log_index) {
+    if (next_log_index <= 0) {
+        LOG(ERROR) << "Invalid next_log_index=" << next_log_index
+                   << " path: " << _path;
+        return EINVAL;
+    }
+    return _wal->Reset(_key, next_log_index);
+}
+
+braft::LogStorage* SharedWalLogStorage::new_instance(
+    const std::string& uri) const {
+    return new SharedWalLogStorage(uri, _wal);
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_CHUNKSERVER_RAFTLOG_SHARED_WAL_LOG_STORAGE_H_
+#define SRC_CHUNKSERVER_RAFTLOG_SHARED_WAL_LOG_STORAGE_H_
+
+#include <braft/log_entry.h>
+#include <braft/storage.h>
+#include <string>
+#include <vector>
+
+#include "src/chunkserver/raftlog/shared_wal.h"
+
+namespace curve {
+namespace chunkserver {
+
+void RegisterSharedWalLogStorageOrDie();
+
+// 基于SharedWal的LogStorage，同一块盘上所有copyset的raft log写到
+// 同一组日志文件中，使用前需要先初始化SharedWal::GetInstance()
+// uri格式: curvewal://${copyset_dir}/log
+class SharedWalLogStorage : public braft::LogStorage {
+ public:
+    explicit SharedWalLogStorage(const std::string& path,
+                                 SharedWal* wal = SharedWal::GetInstance())
+        : _path(path), _wal(wal), _key(0), _opened(false) {}
+
+    SharedWalLogStorage()
+        : _wal(SharedWal::GetInstance()), _key(0), _opened(false) {}
+
+    virtual ~SharedWalLogStorage();
+
+    // init logstorage, recover index of this copyset from shared wal
+    virtual int init(braft::ConfigurationManager* configuration_manager);
+
+    // first log index in log
+    virtual int64_t first_log_index();
+
+    // last log index in log
+    virtual int64_t last_log_index();
+
+    // get logentry by index
+    virtual braft::LogEntry* get_entry(const int64_t index);
+
+    // get logentry's term by index
+    virtual int64_t get_term(const int64_t index);
+
+    // append entry to log
+    int append_entry(const braft::LogEntry* entry);
+
+    // append entries to log, return success append number
+    virtual int append_entries(const std::vector<braft::LogEntry*>& entries);
+
+    // delete logs from storage's head, [1, first_index_kept) will be discarded
+    virtual int truncate_prefix(const int64_t first_index_kept);
+
+    // delete uncommitted logs from storage's tail,
+    // (last_index_kept, infinity) will be discarded
+    virtual int truncate_suffix(const int64_t last_index_kept);
+
+    virtual int reset(const int64_t next_log_index);
+
+    LogStorage* new_instance(const std::string& uri) const;
+
+ private:
+    std::string _path;
+    SharedWal* _wal;
+    uint64_t _key;
+    bool _opened;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_RAFTLOG_SHARED_WAL_LOG_STORAGE_H_
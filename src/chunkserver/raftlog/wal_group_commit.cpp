@@ -0,0 +1,221 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <glog/logging.h>
+#include <bthread/bthread.h>
+#include <bthread/countdown_event.h>
+#include <braft/fsync.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <map>
+
+#include "src/chunkserver/raftlog/wal_group_commit.h"
+
+namespace curve {
+namespace chunkserver {
+
+DEFINE_bool(walGroupCommit, false, "coalesce wal syncs of all copysets "
+            "into group commit windows. every file still needs its own "
+            "fdatasync unless walGroupCommitUseSyncfs is enabled, so it "
+            "only saves disk flushes together with syncfs");
+DEFINE_uint32(walGroupCommitMaxDelayUs, 200, "max time in us to wait for "
+              "more sync requests before flushing a group commit window, "
+              "only used with walGroupCommitUseSyncfs");
+DEFINE_uint32(walGroupCommitMaxBatch, 256, "max sync requests in a group "
+              "commit window");
+DEFINE_bool(walGroupCommitUseSyncfs, false, "use one syncfs instead of "
+            "fdatasync every file when a window contains several files. "
+            "syncfs also flushes all dirty chunk data on the filesystem, "
+            "and only reports writeback errors since Linux 5.8, so only "
+            "enable it when wal is on a dedicated filesystem and the "
+            "kernel is 5.8 or later");
+
+struct WalGroupCommitter::SyncRequest {
+    int fd;
+    int ret;
+    int err;
+    bthread::CountdownEvent done;
+
+    explicit SyncRequest(int fd) : fd(fd), ret(0), err(0), done(1) {}
+};
+
+namespace {
+
+struct FsyncTask {
+    int fd;
+    int err;
+    bthread::CountdownEvent* done;
+};
+
+void* RunFsyncTask(void* arg) {
+    FsyncTask* task = static_cast<FsyncTask*>(arg);
+    if (braft::raft_fsync(task->fd) != 0) {
+        task->err = errno;
+        LOG(ERROR) << "wal group commit fsync failed, fd: " << task->fd
+                   << ", error: " << strerror(task->err);
+    }
+    task->done->signal();
+    return nullptr;
+}
+
+}  // namespace
+
+WalGroupCommitter::WalGroupCommitter()
+    : running_(false),
+      stopped_(false),
+      flushCount_(0),
+      requestCount_(0) {}
+
+WalGroupCommitter::~WalGroupCommitter() {
+    Stop();
+}
+
+WalGroupCommitter* WalGroupCommitter::GetInstance() {
+    static WalGroupCommitter committer;
+    return &committer;
+}
+
+int WalGroupCommitter::Sync(int fd) {
+    SyncRequest request(fd);
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (stopped_) {
+            return braft::raft_fsync(fd);
+        }
+        if (!running_) {
+            running_ = true;
+            thread_ = std::thread(&WalGroupCommitter::Run, this);
+        }
+        queue_.push_back(&request);
+        // 只在窗口开始和攒够一批时唤醒后台线程
+        if (queue_.size() == 1 ||
+            queue_.size() >= FLAGS_walGroupCommitMaxBatch) {
+            cv_.notify_one();
+        }
+    }
+    request.done.wait();
+    if (request.ret != 0) {
+        errno = request.err;
+    }
+    return request.ret;
+}
+
+void WalGroupCommitter::Stop() {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (stopped_) {
+            return;
+        }
+        stopped_ = true;
+        cv_.notify_one();
+    }
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void WalGroupCommitter::Run() {
+    std::vector<SyncRequest*> batch;
+    std::unique_lock<std::mutex> lk(mtx_);
+    while (true) {
+        cv_.wait(lk, [this]() { return !queue_.empty() || stopped_; });
+        if (queue_.empty()) {
+            break;
+        }
+
+        // 窗口开始，等待更多的请求加入，攒够一批或者停止时提前结束。
+        // 不使用syncfs时每个文件仍要各自落盘，等待窗口只会增加延迟，
+        // 这时只合并上一次落盘期间排队的请求
+        uint32_t maxBatch = std::max(FLAGS_walGroupCommitMaxBatch, 1u);
+        if (FLAGS_walGroupCommitMaxDelayUs > 0 &&
+            FLAGS_walGroupCommitUseSyncfs) {
+            auto deadline = std::chrono::steady_clock::now() +
+                std::chrono::microseconds(FLAGS_walGroupCommitMaxDelayUs);
+            cv_.wait_until(lk, deadline, [this, maxBatch]() {
+                return queue_.size() >= maxBatch || stopped_;
+            });
+        }
+
+        batch.clear();
+        while (!queue_.empty() && batch.size() < maxBatch) {
+            batch.push_back(queue_.front());
+            queue_.pop_front();
+        }
+        lk.unlock();
+        FlushBatch(batch);
+        lk.lock();
+    }
+}
+
+void WalGroupCommitter::FlushBatch(const std::vector<SyncRequest*>& batch) {
+    // 同一个文件在窗口内只需要落盘一次
+    std::map<int, int> fdErr;
+    for (auto request : batch) {
+        fdErr[request->fd] = 0;
+    }
+
+    if (fdErr.size() > 1 && FLAGS_walGroupCommitUseSyncfs) {
+        int ret = ::syncfs(fdErr.begin()->first);
+        int err = errno;
+        LOG_IF(ERROR, ret != 0) << "wal group commit syncfs failed, files: "
+                                << fdErr.size() << ", error: "
+                                << strerror(err);
+        for (auto& item : fdErr) {
+            item.second = ret == 0 ? 0 : err;
+        }
+    } else {
+        // 各个文件的fdatasync并发执行，窗口的落盘时间取决于最慢的文件，
+        // 而不是所有文件落盘时间之和
+        std::vector<FsyncTask> tasks;
+        tasks.reserve(fdErr.size());
+        bthread::CountdownEvent done(fdErr.size());
+        for (auto& item : fdErr) {
+            tasks.push_back(FsyncTask{item.first, 0, &done});
+        }
+        for (size_t i = 1; i < tasks.size(); ++i) {
+            bthread_t tid;
+            if (bthread_start_background(&tid, nullptr, RunFsyncTask,
+                                         &tasks[i]) != 0) {
+                RunFsyncTask(&tasks[i]);
+            }
+        }
+        RunFsyncTask(&tasks[0]);
+        done.wait();
+        for (const auto& task : tasks) {
+            fdErr[task.fd] = task.err;
+        }
+    }
+
+    flushCount_.fetch_add(1, std::memory_order_relaxed);
+    requestCount_.fetch_add(batch.size(), std::memory_order_relaxed);
+    for (auto request : batch) {
+        request->err = fdErr[request->fd];
+        request->ret = request->err == 0 ? 0 : -1;
+        request->done.signal();
+    }
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_CHUNKSERVER_RAFTLOG_WAL_GROUP_COMMIT_H_
+#define SRC_CHUNKSERVER_RAFTLOG_WAL_GROUP_COMMIT_H_
+
+#include <gflags/gflags.h>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace curve {
+namespace chunkserver {
+
+DECLARE_bool(walGroupCommit);
+DECLARE_uint32(walGroupCommitMaxDelayUs);
+DECLARE_uint32(walGroupCommitMaxBatch);
+DECLARE_bool(walGroupCommitUseSyncfs);
+
+/**
+ * wal的组提交
+ * 一个chunkserver对应一块盘，盘上所有copyset的segment在append之后
+ * 需要落盘时，不再各自调用fdatasync，而是把sync请求提交到这里。
+ * 后台线程收集一个时间窗口（最长walGroupCommitMaxDelayUs）内的请求，
+ * 整个窗口只做一次落盘：默认对窗口内每个文件并发各fdatasync一次，
+ * 同一文件的多个请求只落盘一次；开启walGroupCommitUseSyncfs后，
+ * 有多个文件时调用一次syncfs，由文件系统一次日志提交完成所有文件的落盘。
+ * 不开启syncfs时每个文件仍要各自落盘，收益有限，因此不等待窗口，
+ * 只合并上一次落盘期间排队的请求；组提交只有配合syncfs才能减少落盘次数。
+ * syncfs会同时刷下该文件系统上所有未落盘的chunk数据，使wal提交延迟
+ * 受数据回写影响，并且5.8之前的内核syncfs不返回回写错误，因此默认关闭。
+ * 每个请求在其所在的窗口落盘完成后才返回，返回值是该窗口落盘的结果，
+ * 因此每个copyset的持久化语义不变。
+ */
+class WalGroupCommitter {
+ public:
+    WalGroupCommitter();
+    ~WalGroupCommitter();
+
+    static WalGroupCommitter* GetInstance();
+
+    /**
+     * 把fd加入当前的提交窗口，阻塞直到该窗口落盘完成
+     * 可以在bthread中调用
+     * @param fd: 需要落盘的文件
+     * @return 成功返回0，失败返回-1并设置errno
+     */
+    int Sync(int fd);
+
+    void Stop();
+
+    // 已经完成的落盘窗口数
+    uint64_t GetFlushCount() const {
+        return flushCount_.load(std::memory_order_relaxed);
+    }
+
+    // 已经完成的sync请求数
+    uint64_t GetRequestCount() const {
+        return requestCount_.load(std::memory_order_relaxed);
+    }
+
+ private:
+    struct SyncRequest;
+
+    void Run();
+
+    // 对一个窗口内的请求做一次落盘，并设置每个请求的结果
+    void FlushBatch(const std::vector<SyncRequest*>& batch);
+
+ private:
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::deque<SyncRequest*> queue_;
+    std::thread thread_;
+    bool running_;
+    bool stopped_;
+    std::atomic<uint64_t> flushCount_;
+    std::atomic<uint64_t> requestCount_;
+};
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_RAFTLOG_WAL_GROUP_COMMIT_H_
@@ -43,14 +43,91 @@
 #include <brpc/closure_guard.h>
 #include <brpc/controller.h>
 #include <braft/util.h>
+#include <string.h>
+#include <algorithm>
 #include <stack>
 #include "src/chunkserver/raftsnapshot/curve_file_service.h"
+#include "src/chunkserver/raftsnapshot/curve_snapshot_digest.h"
+#include "src/chunkserver/datastore/filename_operator.h"
 
 namespace curve {
 namespace chunkserver {
 
+DEFINE_bool(raftSnapshotSkipHole, false, "skip the zero pages and the "
+            "unwritten pages of clone chunks when sending snapshot files, "
+            "only enable it after all chunkservers are upgraded");
+
 CurveFileService& kCurveFileService = CurveFileService::GetInstance();
 
+namespace {
+// 检查空洞的粒度，普通chunk文件按这个大小检查全零页
+const uint32_t kHolePageSize = 4096;
+
+bool IsZeroData(const butil::IOBuf& data) {
+    static const char kZero[kHolePageSize] = {0};
+    for (size_t i = 0; i < data.backing_block_num(); ++i) {
+        butil::StringPiece block = data.backing_block(i);
+        size_t pos = 0;
+        while (pos < block.size()) {
+            size_t len = std::min<size_t>(kHolePageSize, block.size() - pos);
+            if (memcmp(block.data() + pos, kZero, len) != 0) {
+                return false;
+            }
+            pos += len;
+        }
+    }
+    return true;
+}
+
+/**
+ * 把从offset开始的buf按页切分，跳过全零页和clone chunk中未写过的页，
+ * 连续的需要传输的页合并成一个segment，接收方从chunkfilepool中取的是
+ * 清零过的文件，跳过的部分读出来为零
+ * @param bitmap: clone chunk的bitmap，第0页为metapage，第i页对应bitmap的第i-1位
+ */
+void AppendSparseData(butil::IOBuf* buf, off_t offset,
+                      const curve::common::Bitmap* bitmap,
+                      uint32_t page_size,
+                      braft::FileSegData* seg_data) {
+    off_t cur = offset;
+    off_t pending_offset = offset;
+    butil::IOBuf pending;
+    while (!buf->empty()) {
+        size_t len = std::min<size_t>(buf->size(),
+                                      page_size - cur % page_size);
+        butil::IOBuf page;
+        buf->cutn(&page, len);
+        uint64_t index = cur / page_size;
+        bool skip = false;
+        if (index > 0) {
+            skip = (bitmap != nullptr &&
+                    (index - 1 >= bitmap->Size() || !bitmap->Test(index - 1)))
+                   || IsZeroData(page);
+        }
+        if (skip) {
+            if (!pending.empty()) {
+                seg_data->append(pending, pending_offset);
+                pending.clear();
+            }
+        } else {
+            if (pending.empty()) {
+                pending_offset = cur;
+            }
+            pending.append(page);
+        }
+        cur += len;
+    }
+    if (!pending.empty()) {
+        seg_data->append(pending, pending_offset);
+    }
+}
+
+FileNameOperator::FileType GetFileType(const std::string& filename) {
+    std::string basename = butil::FilePath(filename).BaseName().value();
+    return FileNameOperator::ParseFileName(basename).type;
+}
+}  // namespace
+
 void CurveFileService::get_file(::google::protobuf::RpcController* controller,
                                const ::braft::GetFileRequest* request,
                                ::braft::GetFileResponse* response,
@@ -88,6 +165,7 @@ void CurveFileService::get_file(::google::protobuf::RpcController* controller,
     butil::IOBuf buf;
     bool is_eof = false;
     size_t read_count = 0;
+    std::string sourceFilename;
     // 1. 如果是read attch meta file
     if (request->filename() == BRAFT_SNAPSHOT_ATTACH_META_FILE) {
         // 如果没有设置snapshot attachment，那么read文件的长度为零
@@ -148,8 +226,29 @@ void CurveFileService::get_file(::google::protobuf::RpcController* controller,
             is_eof = true;
             read_count = buf.size();
         }
+    } else if (IsDigestFilename(request->filename(), &sourceFilename)) {
+        // 2. 如果是获取快照文件的摘要，由reader根据文件内容计算
+        CurveSnapshotFileReader *curveReader =
+            dynamic_cast<CurveSnapshotFileReader*>(reader.get());
+        if (curveReader == nullptr) {
+            cntl->SetFailed(EPERM, "Reader of path=%s not support digest",
+                            reader->path().c_str());
+            return;
+        }
+        const int rc = curveReader->read_file_digest(
+                                &buf, sourceFilename,
+                                request->offset(), request->count(),
+                                &read_count,
+                                &is_eof);
+        if (rc != 0) {
+            cntl->SetFailed(rc, "Fail to read digest from path=%s "
+                            "filename=%s : %s",
+                            reader->path().c_str(),
+                            sourceFilename.c_str(), berror(rc));
+            return;
+        }
     } else {
-        // 2. 否则其它文件下载继续走raft原先的文件下载流程
+        // 3. 否则其它文件下载继续走raft原先的文件下载流程
         const int rc = reader->read_file(
                                 &buf, request->filename(),
                                 request->offset(), request->count(),
@@ -172,7 +271,30 @@ void CurveFileService::get_file(::google::protobuf::RpcController* controller,
     }
 
     braft::FileSegData seg_data;
-    seg_data.append(buf, request->offset());
+    CurveSnapshotFileReader *curveReader =
+        dynamic_cast<CurveSnapshotFileReader*>(reader.get());
+    FileNameOperator::FileType type = GetFileType(request->filename());
+    if (FLAGS_raftSnapshotSkipHole && sourceFilename.empty() &&
+        curveReader != nullptr &&
+        type != FileNameOperator::FileType::UNKNOWN) {
+        std::shared_ptr<curve::common::Bitmap> bitmap;
+        uint32_t page_size = kHolePageSize;
+        if (type == FileNameOperator::FileType::CHUNK) {
+            int rc = curveReader->read_chunk_bitmap(request->filename(),
+                                                    &bitmap, &page_size);
+            if (rc != 0) {
+                cntl->SetFailed(rc, "Fail to read bitmap from path=%s "
+                                "filename=%s : %s",
+                                reader->path().c_str(),
+                                request->filename().c_str(), berror(rc));
+                return;
+            }
+        }
+        AppendSparseData(&buf, request->offset(), bitmap.get(), page_size,
+                         &seg_data);
+    } else {
+        seg_data.append(buf, request->offset());
+    }
     cntl->response_attachment().swap(seg_data.data());
 }
 
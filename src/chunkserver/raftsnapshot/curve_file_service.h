@@ -54,6 +54,7 @@ namespace curve {
 namespace chunkserver {
 
 DECLARE_string(raft_snapshot_dir);
+DECLARE_bool(raftSnapshotSkipHole);
 
 class BAIDU_CACHELINE_ALIGNMENT CurveFileService : public braft::FileService {
  public:
@@ -21,9 +21,11 @@
  */
 
 #include <butil/fd_utility.h>
+#include <butil/files/file_path.h>
 #include <vector>
 
 #include "src/chunkserver/raftsnapshot/curve_filesystem_adaptor.h"
+#include "src/chunkserver/datastore/datastore_file_helper.h"
 
 namespace curve {
 namespace chunkserver {
@@ -78,8 +80,9 @@ braft::FileAdaptor* CurveFilesystemAdaptor::open(const std::string& path,
     if (!NeedFilter(path) &&
         (oflag & O_CREAT) &&
         false == lfs_->FileExists(path)) {
-        // 从chunkfile pool中取出chunk返回
-        int rc = chunkFilePool_->GetFile(path, tempMetaPageContent);
+        // 从chunkfile pool中取出chunk返回，leader传输快照时会跳过空洞，
+        // 所以需要取清零过的chunk，保证没有传输的部分读出来为零
+        int rc = chunkFilePool_->GetFile(path, tempMetaPageContent, true);
         // 如果从FilePool中取失败，返回错误。
         if (rc != 0) {
             LOG(ERROR) << "get chunk from chunkfile pool failed!";
@@ -187,6 +190,11 @@ void CurveFilesystemAdaptor::SetFilterList(
 }
 
 bool CurveFilesystemAdaptor::NeedFilter(const std::string& filename) {
+    // chunk的校验和文件不是chunk，不能从chunkfilepool中取
+    std::string baseName = butil::FilePath(filename).BaseName().value();
+    if (DatastoreFileHelper::IsChecksumFile(baseName)) {
+        return true;
+    }
     bool ret = false;
     for (auto name : filterList_) {
         if (filename.find(name) != filename.npos) {
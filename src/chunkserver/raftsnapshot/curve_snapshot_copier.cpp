@@ -39,16 +39,47 @@
 //          Zheng,Pengfei(zhengpengfei@baidu.com)
 //          Xiong,Kai(xiongkai@baidu.com)
 
+#include <braft/file_service.pb.h>
+#include <brpc/controller.h>
+#include <bthread/bthread.h>
+#include <butil/file_util.h>
+#include <bvar/bvar.h>
+#include <stdarg.h>
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include <memory>
 #include "src/chunkserver/raftsnapshot/curve_snapshot_copier.h"
 
 namespace curve {
 namespace chunkserver {
 
+DEFINE_bool(raftSnapshotDeltaCopy, true, "only download the ranges which "
+            "differ from the local chunk file when installing snapshot");
+DEFINE_uint32(raftSnapshotCopyConcurrency, 4, "max files downloaded "
+              "concurrently by one snapshot copier");
+
+namespace {
+// 安装快照的进度和吞吐，所有copyset共享
+bvar::Adder<int64_t> g_snapshot_copy_bytes("raft_snapshot_copy_bytes");
+bvar::PerSecond<bvar::Adder<int64_t>> g_snapshot_copy_throughput(
+    "raft_snapshot_copy_throughput", &g_snapshot_copy_bytes);
+bvar::Adder<int64_t> g_snapshot_reuse_bytes("raft_snapshot_reuse_bytes");
+bvar::Adder<int64_t> g_snapshot_copied_files("raft_snapshot_copied_files");
+bvar::Adder<int64_t> g_snapshot_copying_files("raft_snapshot_copying_files");
+
+// 增量下载时一次rpc最多下载的字节数
+const size_t kMaxDeltaFetchBytes = 1024 * 1024;
+const int64_t kDeltaFetchTimeoutMs = 10 * 1000;
+const int64_t kDeltaFetchRetryIntervalUs = 100 * 1000;
+}  // namespace
+
 CurveSnapshotCopier::CurveSnapshotCopier(CurveSnapshotStorage* storage,
                                          bool filter_before_copy_remote,
                                          braft::FileSystemAdaptor* fs,
                                          braft::SnapshotThrottle* throttle)
-    : _tid(INVALID_BTHREAD)
+    : _copy_failed(false)
+    , _tid(INVALID_BTHREAD)
     , _cancelled(false)
     , _filter_before_copy_remote(filter_before_copy_remote)
     , _fs(fs)
@@ -56,7 +87,8 @@ CurveSnapshotCopier::CurveSnapshotCopier(CurveSnapshotStorage* storage,
     , _writer(NULL)
     , _storage(storage)
     , _reader(NULL)
-    , _cur_session(NULL)
+    , _reader_id(0)
+    , _delta_copy_supported(true)
 {}
 
 CurveSnapshotCopier::~CurveSnapshotCopier() {
@@ -82,9 +114,7 @@ void CurveSnapshotCopier::copy() {
         }
         std::vector<std::string> files;
         _remote_snapshot.list_files(&files);
-        for (size_t i = 0; i < files.size() && ok(); ++i) {
-            copy_file(files[i]);
-        }
+        copy_files(files, false);
 
         // 下载snapshot attachment文件
         load_attach_meta_table();
@@ -93,9 +123,7 @@ void CurveSnapshotCopier::copy() {
         }
         std::vector<std::string> attachFiles;
         _remote_snapshot.list_attach_files(&attachFiles);
-        for (size_t i = 0; i < attachFiles.size() && ok(); ++i) {
-            copy_file(attachFiles[i], true);
-        }
+        copy_files(attachFiles, true);
     } while (0);
     if (!ok() && _writer && _writer->ok()) {
         LOG(WARNING) << "Fail to copy, error_code " << error_code()
@@ -126,11 +154,11 @@ void CurveSnapshotCopier::load_meta_table() {
     scoped_refptr<braft::RemoteFileCopier::Session> session
             = _copier.start_to_copy_to_iobuf(BRAFT_SNAPSHOT_META_FILE,
                                             &meta_buf, NULL);
-    _cur_session = session.get();
+    _cur_sessions.insert(session.get());
     lck.unlock();
     session->join();
     lck.lock();
-    _cur_session = NULL;
+    _cur_sessions.erase(session.get());
     lck.unlock();
     if (!session->status().ok()) {
         LOG(WARNING) << "Fail to copy meta file : " << session->status();
@@ -156,11 +184,11 @@ void CurveSnapshotCopier::load_attach_meta_table() {
     scoped_refptr<braft::RemoteFileCopier::Session> session
         = _copier.start_to_copy_to_iobuf(BRAFT_SNAPSHOT_ATTACH_META_FILE,
                                          &meta_buf, NULL);
-    _cur_session = session.get();
+    _cur_sessions.insert(session.get());
     lck.unlock();
     session->join();
     lck.lock();
-    _cur_session = NULL;
+    _cur_sessions.erase(session.get());
     lck.unlock();
     if (!session->status().ok()) {
         LOG(WARNING) << "Fail to copy attach meta file : " << session->status();
@@ -305,12 +333,62 @@ void CurveSnapshotCopier::filter() {
     }
 }
 
-void CurveSnapshotCopier::copy_file(const std::string& filename, bool attch) {
-    if (_writer->get_file_meta(filename, NULL) == 0) {
-        LOG(INFO) << "Skipped downloading " << filename
-                  << " path: " << _writer->get_path();
+void CurveSnapshotCopier::copy_files(const std::vector<std::string>& files,
+                                     bool attach) {
+    size_t concurrency = std::min<size_t>(FLAGS_raftSnapshotCopyConcurrency,
+                                          files.size());
+    if (concurrency <= 1) {
+        for (size_t i = 0; i < files.size() && !copy_failed(); ++i) {
+            copy_file(files[i], attach);
+        }
         return;
     }
+
+    // 启动concurrency个bthread，每个bthread依次从files中取下一个文件下载
+    std::atomic<size_t> next(0);
+    std::function<void()> worker = [&]() {
+        for (size_t i = next.fetch_add(1);
+             i < files.size() && !copy_failed(); i = next.fetch_add(1)) {
+            copy_file(files[i], attach);
+        }
+    };
+    std::vector<bthread_t> tids(concurrency, INVALID_BTHREAD);
+    for (size_t i = 1; i < concurrency; ++i) {
+        if (bthread_start_background(&tids[i], NULL, run_closure,
+                                     &worker) != 0) {
+            PLOG(WARNING) << "Fail to start bthread to copy files";
+            tids[i] = INVALID_BTHREAD;
+        }
+    }
+    worker();
+    for (size_t i = 1; i < concurrency; ++i) {
+        if (tids[i] != INVALID_BTHREAD) {
+            bthread_join(tids[i], NULL);
+        }
+    }
+}
+
+void* CurveSnapshotCopier::run_closure(void* arg) {
+    (*reinterpret_cast<std::function<void()>*>(arg))();
+    return NULL;
+}
+
+void CurveSnapshotCopier::copy_file(const std::string& filename, bool attch) {
+    {
+        BAIDU_SCOPED_LOCK(_writer_mutex);
+        if (_writer->get_file_meta(filename, NULL) == 0) {
+            LOG(INFO) << "Skipped downloading " << filename
+                      << " path: " << _writer->get_path();
+            return;
+        }
+    }
+    g_snapshot_copying_files << 1;
+    copy_file_internal(filename, attch);
+    g_snapshot_copying_files << -1;
+}
+
+void CurveSnapshotCopier::copy_file_internal(const std::string& filename,
+                                             bool attch) {
     std::string rfilename = get_rfilename(filename);
     std::string file_path = _writer->get_path() + '/' + rfilename;
     butil::FilePath sub_path(rfilename);
@@ -329,30 +407,43 @@ void CurveSnapshotCopier::copy_file(const std::string& filename, bool attch) {
         if (!rc) {
             LOG(ERROR) << "Fail to create directory for " << file_path
                        << " : " << butil::File::ErrorToString(e);
-            set_error(braft::file_error_to_os_error(e),
-                      "Fail to create directory");
+            set_copy_error(braft::file_error_to_os_error(e),
+                           "Fail to create directory");
         }
     }
     braft::LocalFileMeta meta;
     _remote_snapshot.get_file_meta(filename, &meta);
+    // 只有chunk文件(相对路径指向copyset的data目录)才尝试增量下载
+    if (!attch && rfilename != filename && FLAGS_raftSnapshotDeltaCopy &&
+        _delta_copy_supported && delta_copy_file(filename, file_path)) {
+        add_file_to_writer(filename, &meta);
+        return;
+    }
     std::unique_lock<braft::raft_mutex_t> lck(_mutex);
+    // 在_mutex内检查，set_copy_error设置失败之后不会再有新的下载加入
+    // _cur_sessions，已经加入的都会被取消
+    if (copy_failed()) {
+        return;
+    }
     if (_cancelled) {
-        set_error(ECANCELED, "%s", berror(ECANCELED));
+        lck.unlock();
+        set_copy_error(ECANCELED, "%s", berror(ECANCELED));
         return;
     }
     scoped_refptr<braft::RemoteFileCopier::Session> session
         = _copier.start_to_copy_to_file(filename, file_path, NULL);
     if (session == NULL) {
+        lck.unlock();
         LOG(WARNING) << "Fail to copy " << filename
                      << " path: " << _writer->get_path();
-        set_error(-1, "Fail to copy %s", filename.c_str());
+        set_copy_error(-1, "Fail to copy %s", filename.c_str());
         return;
     }
-    _cur_session = session.get();
+    _cur_sessions.insert(session.get());
     lck.unlock();
     session->join();
     lck.lock();
-    _cur_session = NULL;
+    _cur_sessions.erase(session.get());
     lck.unlock();
     if (!session->status().ok()) {
         // 如果是文件不存在，那么删除刚开始open的文件
@@ -361,25 +452,279 @@ void CurveSnapshotCopier::copy_file(const std::string& filename, bool attch) {
             if (!rc) {
                 LOG(ERROR) << "Fail to delete file" << file_path
                            << " : " << ::berror(errno);
-                set_error(errno,
-                          "Fail to create delete file " + file_path);
+                set_copy_error(errno, "Fail to delete file %s",
+                               file_path.c_str());
             }
             return;
         }
 
-        set_error(session->status().error_code(),
-                  session->status().error_cstr());
+        set_copy_error(session->status().error_code(), "%s",
+                       session->status().error_cstr());
         return;
     }
+    int64_t file_size = 0;
+    if (butil::GetFileSize(butil::FilePath(file_path), &file_size)) {
+        g_snapshot_copy_bytes << file_size;
+    }
     // 如果是attach file，那么不需要持久化file meta信息
-    if (!attch && _writer->add_file(filename, &meta) != 0) {
-        set_error(EIO, "Fail to add file to writer");
+    add_file_to_writer(filename, attch ? NULL : &meta);
+}
+
+void CurveSnapshotCopier::add_file_to_writer(const std::string& filename,
+                                    const braft::LocalFileMeta* meta) {
+    BAIDU_SCOPED_LOCK(_writer_mutex);
+    if (meta != NULL && _writer->add_file(filename, meta) != 0) {
+        set_copy_error(EIO, "Fail to add file to writer");
         return;
     }
     if (_writer->sync() != 0) {
-        set_error(EIO, "Fail to sync writer");
+        set_copy_error(EIO, "Fail to sync writer");
         return;
     }
+    g_snapshot_copied_files << 1;
+}
+
+void CurveSnapshotCopier::set_copy_error(int error_code,
+                                         const char* error_fmt, ...) {
+    {
+        BAIDU_SCOPED_LOCK(_error_mutex);
+        // 并发下载时只保留第一个错误
+        if (!ok()) {
+            return;
+        }
+        va_list ap;
+        va_start(ap, error_fmt);
+        set_errorv(error_code, error_fmt, ap);
+        va_end(ap);
+        _copy_failed.store(true, std::memory_order_release);
+    }
+    // 整个快照已经失败，取消其他文件正在进行的下载
+    BAIDU_SCOPED_LOCK(_mutex);
+    for (auto session : _cur_sessions) {
+        session->cancel();
+    }
+}
+
+bool CurveSnapshotCopier::delta_copy_file(const std::string& filename,
+                                          const std::string& file_path) {
+    // filename是相对于快照目录的路径，拼上快照目录就是本地的chunk文件
+    std::string local_path = _writer->get_path() + '/' + filename;
+    if (!_fs->path_exists(local_path)) {
+        return false;
+    }
+    FileDigest digest;
+    int rc = load_file_digest(filename, &digest);
+    if (rc != 0) {
+        // 老版本的leader不认识摘要文件名返回EPERM，之后的文件都整个下载；
+        // 其他错误(比如文件不在leader的快照中返回ENOENT)只对该文件整个下载
+        if (rc == EPERM) {
+            LOG(INFO) << "Remote peer not support snapshot digest, "
+                      << "fallback to download the whole files";
+            _delta_copy_supported = false;
+        }
+        return false;
+    }
+
+    butil::File::Error e;
+    std::unique_ptr<braft::FileAdaptor> local(_fs->open(
+        local_path, O_RDONLY | O_CLOEXEC, NULL, &e));
+    if (!local) {
+        LOG(WARNING) << "Fail to open " << local_path
+                     << " : " << butil::File::ErrorToString(e);
+        return false;
+    }
+    std::unique_ptr<braft::FileAdaptor> dest(_fs->open(
+        file_path, O_CREAT | O_WRONLY | O_CLOEXEC, NULL, &e));
+    if (!dest) {
+        LOG(WARNING) << "Fail to open " << file_path
+                     << " : " << butil::File::ErrorToString(e);
+        return false;
+    }
+    // 失败时删除下载了一部分的文件，再整个下载
+    auto fail = [&]() {
+        dest.reset();
+        _fs->delete_file(file_path, false);
+        return false;
+    };
+
+    uint64_t reused = 0;
+    uint64_t fetched = 0;
+    // 连续的不一致的range合并成一段下载
+    off_t span_offset = 0;
+    size_t span_length = 0;
+    for (size_t i = 0; i < digest.ranges.size(); ++i) {
+        off_t offset = static_cast<off_t>(i) * digest.rangeSize;
+        uint32_t length = digest.RangeLength(i);
+        butil::IOPortal data;
+        ssize_t nread = local->read(&data, offset, length);
+        if (nread == static_cast<ssize_t>(length) &&
+            CalcRangeDigest(data) == digest.ranges[i]) {
+            if (dest->write(data, offset) != static_cast<ssize_t>(length)) {
+                LOG(WARNING) << "Fail to write " << file_path
+                             << " : " << berror(errno);
+                return fail();
+            }
+            reused += length;
+            continue;
+        }
+        if (span_length > 0 &&
+            span_offset + static_cast<off_t>(span_length) == offset &&
+            span_length + length <= kMaxDeltaFetchBytes) {
+            span_length += length;
+            continue;
+        }
+        if (span_length > 0) {
+            rc = fetch_range(filename, span_offset, span_length, dest.get());
+            if (rc != 0) {
+                break;
+            }
+            fetched += span_length;
+        }
+        span_offset = offset;
+        span_length = length;
+    }
+    if (rc == 0 && span_length > 0) {
+        rc = fetch_range(filename, span_offset, span_length, dest.get());
+        fetched += span_length;
+    }
+    if (rc != 0) {
+        if (rc == ECANCELED) {
+            set_copy_error(ECANCELED, "%s", berror(ECANCELED));
+        }
+        LOG(WARNING) << "Fail to download " << filename << " by range, "
+                     << "error: " << berror(rc);
+        return fail();
+    }
+    if (!dest->sync()) {
+        LOG(WARNING) << "Fail to sync " << file_path;
+        return fail();
+    }
+    // 拼装完成之后校验整个文件，任何一个range拼错都整个重新下载
+    if (!verify_file_digest(file_path, digest)) {
+        LOG(WARNING) << "Delta copied " << filename
+                     << " mismatch the digest of leader, "
+                     << "fallback to download the whole file";
+        return fail();
+    }
+    g_snapshot_reuse_bytes << reused;
+    LOG(INFO) << "Delta copied " << filename
+              << " path: " << _writer->get_path()
+              << ", reused bytes: " << reused
+              << ", fetched bytes: " << fetched;
+    return true;
+}
+
+bool CurveSnapshotCopier::verify_file_digest(const std::string& file_path,
+                                             const FileDigest& digest) {
+    butil::File::Error e;
+    std::unique_ptr<braft::FileAdaptor> file(_fs->open(
+        file_path, O_RDONLY | O_CLOEXEC, NULL, &e));
+    if (!file) {
+        LOG(WARNING) << "Fail to open " << file_path
+                     << " : " << butil::File::ErrorToString(e);
+        return false;
+    }
+    FileDigest local;
+    int rc = ComputeFileDigest(file.get(), digest.rangeSize, &local);
+    if (rc != 0) {
+        LOG(WARNING) << "Fail to compute digest of " << file_path
+                     << " : " << berror(rc);
+        return false;
+    }
+    return local.fileSize == digest.fileSize &&
+           local.fileHash == digest.fileHash;
+}
+
+int CurveSnapshotCopier::load_file_digest(const std::string& filename,
+                                          FileDigest* digest) {
+    butil::IOBuf digest_buf;
+    std::unique_lock<braft::raft_mutex_t> lck(_mutex);
+    if (_cancelled || copy_failed()) {
+        return ECANCELED;
+    }
+    // 不支持摘要的leader会返回EPERM，不需要重试
+    braft::CopyOptions options;
+    options.max_retry = 0;
+    scoped_refptr<braft::RemoteFileCopier::Session> session
+        = _copier.start_to_copy_to_iobuf(GetDigestFilename(filename),
+                                         &digest_buf, &options);
+    _cur_sessions.insert(session.get());
+    lck.unlock();
+    session->join();
+    lck.lock();
+    _cur_sessions.erase(session.get());
+    lck.unlock();
+    if (!session->status().ok()) {
+        LOG(WARNING) << "Fail to copy digest of " << filename
+                     << " : " << session->status();
+        return session->status().error_code();
+    }
+    if (digest->Decode(digest_buf) != 0) {
+        LOG(WARNING) << "Bad digest format of " << filename;
+        return EINVAL;
+    }
+    return 0;
+}
+
+int CurveSnapshotCopier::fetch_range(const std::string& filename,
+                                     off_t offset, size_t count,
+                                     braft::FileAdaptor* dest) {
+    braft::FileService_Stub stub(&_channel);
+    size_t done = 0;
+    while (done < count) {
+        {
+            BAIDU_SCOPED_LOCK(_mutex);
+            if (_cancelled || copy_failed()) {
+                return ECANCELED;
+            }
+        }
+        size_t max_count = count - done;
+        if (_throttle) {
+            max_count = _throttle->throttled_by_throughput(max_count);
+            if (max_count == 0) {
+                bthread_usleep(kDeltaFetchRetryIntervalUs);
+                continue;
+            }
+        }
+        braft::GetFileRequest request;
+        request.set_reader_id(_reader_id);
+        request.set_filename(filename);
+        request.set_offset(offset + done);
+        request.set_count(max_count);
+        request.set_read_partly(true);
+        braft::GetFileResponse response;
+        brpc::Controller cntl;
+        cntl.set_timeout_ms(kDeltaFetchTimeoutMs);
+        stub.get_file(&cntl, &request, &response, NULL);
+        if (cntl.Failed()) {
+            // leader被限流，稍后重试
+            if (cntl.ErrorCode() == EAGAIN) {
+                bthread_usleep(kDeltaFetchRetryIntervalUs);
+                continue;
+            }
+            LOG(WARNING) << "Fail to get " << filename
+                         << " offset: " << offset + done
+                         << " : " << cntl.ErrorText();
+            return cntl.ErrorCode();
+        }
+        braft::FileSegData seg_data(cntl.response_attachment());
+        uint64_t seg_offset = 0;
+        butil::IOBuf seg;
+        while (seg_data.next(&seg_offset, &seg) != 0) {
+            ssize_t nwritten = dest->write(seg, seg_offset);
+            if (nwritten != static_cast<ssize_t>(seg.size())) {
+                return EIO;
+            }
+            seg.clear();
+        }
+        done += response.read_size();
+        g_snapshot_copy_bytes << response.read_size();
+        // leader上的文件比摘要中记录的短
+        if (response.eof() && done < count) {
+            return EIO;
+        }
+    }
+    return 0;
 }
 
 std::string CurveSnapshotCopier::get_rfilename(const std::string& filename) {
@@ -411,13 +756,30 @@ void CurveSnapshotCopier::cancel() {
         return;
     }
     _cancelled = true;
-    if (_cur_session) {
-        _cur_session->cancel();
+    for (auto session : _cur_sessions) {
+        session->cancel();
     }
 }
 
 int CurveSnapshotCopier::init(const std::string& uri) {
-    return _copier.init(uri, _fs, _throttle);
+    int ret = _copier.init(uri, _fs, _throttle);
+    if (ret != 0) {
+        return ret;
+    }
+    // uri的格式为remote://ip:port/reader_id，已经在_copier.init中校验过
+    static const size_t prefix_size = strlen("remote://");
+    size_t slash_pos = uri.find('/', prefix_size);
+    std::string ip_and_port = uri.substr(prefix_size,
+                                         slash_pos - prefix_size);
+    _reader_id = strtoll(uri.c_str() + slash_pos + 1, NULL, 10);
+    butil::EndPoint ep;
+    if (butil::str2endpoint(ip_and_port.c_str(), &ep) != 0 ||
+        _channel.Init(ep, NULL) != 0) {
+        LOG(WARNING) << "Fail to init channel to " << ip_and_port
+                     << ", disable delta copy";
+        _delta_copy_supported = false;
+    }
+    return 0;
 }
 
 }  // namespace chunkserver
@@ -43,14 +43,22 @@
 #define SRC_CHUNKSERVER_RAFTSNAPSHOT_CURVE_SNAPSHOT_COPIER_H_
 
 #include <braft/storage.h>
+#include <brpc/channel.h>
+#include <gflags/gflags.h>
+#include <atomic>
+#include <set>
 #include <vector>
 #include <string>
 #include "src/chunkserver/raftsnapshot/curve_snapshot.h"
+#include "src/chunkserver/raftsnapshot/curve_snapshot_digest.h"
 #include "src/chunkserver/raftsnapshot/curve_snapshot_storage.h"
 
 namespace curve {
 namespace chunkserver {
 
+DECLARE_bool(raftSnapshotDeltaCopy);
+DECLARE_uint32(raftSnapshotCopyConcurrency);
+
 class CurveSnapshotStorage;
 
 class CurveSnapshotCopier : public braft::SnapshotCopier {
@@ -74,11 +82,49 @@ class CurveSnapshotCopier : public braft::SnapshotCopier {
     int filter_before_copy(CurveSnapshotWriter* writer,
                            braft::SnapshotReader* last_snapshot);
     void filter();
+    // 最多启动raftSnapshotCopyConcurrency个bthread并发下载files
+    void copy_files(const std::vector<std::string>& files, bool attach);
+    static void* run_closure(void* arg);
     void copy_file(const std::string& filename, bool attach = false);
+    void copy_file_internal(const std::string& filename, bool attach);
+    // 下载完成后把文件记录到writer中并持久化，attach文件的meta为NULL
+    void add_file_to_writer(const std::string& filename,
+                            const braft::LocalFileMeta* meta);
+    // 多个文件并发下载时，保证只有一个线程设置错误，并取消其他正在进行的下载，
+    // 调用时不能持有_mutex
+    void set_copy_error(int error_code, const char* error_fmt, ...)
+        __attribute__((format(printf, 3, 4)));
+    // 下载文件的bthread检查是否已经有文件下载失败，不能直接读ok()
+    bool copy_failed() const {
+        return _copy_failed.load(std::memory_order_acquire);
+    }
     // 这里的filename是相对于快照目录的路径，为了先把文件下载到临时目录，需要把前面的..去掉
     std::string get_rfilename(const std::string& filename);
+    /**
+     * 本地存在同名chunk文件时，先从leader获取文件摘要，只下载摘要不一致的
+     * range，其余range从本地文件拷贝，拼装完成后校验整个文件的摘要
+     * @param filename: 相对于快照目录的文件名
+     * @param file_path: 下载到的临时文件路径
+     * @return: 成功返回true，失败返回false，由调用者退回到下载整个文件
+     */
+    bool delta_copy_file(const std::string& filename,
+                         const std::string& file_path);
+    // 从leader获取文件的摘要，成功返回0，否则返回错误码
+    int load_file_digest(const std::string& filename, FileDigest* digest);
+    // 校验拼装完成的文件与leader的摘要一致
+    bool verify_file_digest(const std::string& file_path,
+                            const FileDigest& digest);
+    // 从leader下载文件的[offset, offset + count)写到dest，成功返回0
+    int fetch_range(const std::string& filename, off_t offset, size_t count,
+                    braft::FileAdaptor* dest);
 
+    // 保护_cancelled和_cur_sessions
     braft::raft_mutex_t _mutex;
+    // 保护并发下载时对_writer的访问
+    braft::raft_mutex_t _writer_mutex;
+    braft::raft_mutex_t _error_mutex;
+    // 下载文件失败，在_error_mutex内设置了错误之后置为true
+    std::atomic<bool> _copy_failed;
     bthread_t _tid;
     bool _cancelled;
     bool _filter_before_copy_remote;
@@ -87,9 +133,15 @@ class CurveSnapshotCopier : public braft::SnapshotCopier {
     CurveSnapshotWriter* _writer;
     CurveSnapshotStorage* _storage;
     braft::SnapshotReader* _reader;
-    braft::RemoteFileCopier::Session* _cur_session;
+    // 正在进行的下载，cancel时需要全部取消
+    std::set<braft::RemoteFileCopier::Session*> _cur_sessions;
     CurveSnapshot _remote_snapshot;
     braft::RemoteFileCopier _copier;
+    // 用于下载文件部分range的channel，指向uri中的leader
+    brpc::Channel _channel;
+    int64_t _reader_id;
+    // leader不支持获取摘要时，后续文件不再尝试增量下载
+    std::atomic<bool> _delta_copy_supported;
 };
 }  // namespace chunkserver
 }  // namespace curve
@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <butil/sys_byteorder.h>
+#include <glog/logging.h>
+#include <openssl/sha.h>
+#include <string.h>
+#include <algorithm>
+
+#include "src/chunkserver/raftsnapshot/curve_snapshot_digest.h"
+#include "src/chunkserver/raftsnapshot/define.h"
+
+namespace curve {
+namespace chunkserver {
+
+static bool ValidateRangeSize(const char* flagname, uint32_t value) {
+    return value > 0;
+}
+
+DEFINE_uint32(raftSnapshotDigestRangeSize, 64 * 1024,
+              "range size of the snapshot file digest");
+DEFINE_validator(raftSnapshotDigestRangeSize, ValidateRangeSize);
+
+namespace {
+// rangeSize + fileSize + range count + 整个文件的摘要
+const size_t kDigestHeaderSize =
+    sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint32_t) +
+    SHA256_DIGEST_LENGTH;
+
+void UpdateHash(SHA256_CTX* ctx, const butil::IOBuf& data) {
+    for (size_t i = 0; i < data.backing_block_num(); ++i) {
+        butil::StringPiece block = data.backing_block(i);
+        SHA256_Update(ctx, block.data(), block.size());
+    }
+}
+
+std::string FinalHash(SHA256_CTX* ctx) {
+    unsigned char hash[SHA256_DIGEST_LENGTH];
+    SHA256_Final(hash, ctx);
+    return std::string(reinterpret_cast<char*>(hash), sizeof(hash));
+}
+}  // namespace
+
+void FileDigest::Encode(butil::IOBuf* buf) const {
+    uint32_t rangeSizeNet = butil::HostToNet32(rangeSize);
+    uint64_t fileSizeNet = butil::HostToNet64(fileSize);
+    uint32_t countNet = butil::HostToNet32(ranges.size());
+    buf->append(&rangeSizeNet, sizeof(rangeSizeNet));
+    buf->append(&fileSizeNet, sizeof(fileSizeNet));
+    buf->append(&countNet, sizeof(countNet));
+    CHECK(fileHash.size() == SHA256_DIGEST_LENGTH) << "Invalid file hash";
+    buf->append(fileHash);
+    for (const auto& hash : ranges) {
+        CHECK(hash.size() == SHA256_DIGEST_LENGTH) << "Invalid range hash";
+        buf->append(hash);
+    }
+}
+
+int FileDigest::Decode(const butil::IOBuf& buf) {
+    if (buf.size() < kDigestHeaderSize) {
+        return -1;
+    }
+    char header[kDigestHeaderSize];
+    buf.copy_to(header, kDigestHeaderSize);
+    uint32_t rangeSizeNet;
+    uint64_t fileSizeNet;
+    uint32_t countNet;
+    memcpy(&rangeSizeNet, header, sizeof(rangeSizeNet));
+    memcpy(&fileSizeNet, header + sizeof(uint32_t), sizeof(fileSizeNet));
+    memcpy(&countNet, header + sizeof(uint32_t) + sizeof(uint64_t),
+           sizeof(countNet));
+    uint32_t decodedRangeSize = butil::NetToHost32(rangeSizeNet);
+    uint64_t decodedFileSize = butil::NetToHost64(fileSizeNet);
+    uint32_t count = butil::NetToHost32(countNet);
+    if (decodedRangeSize == 0 ||
+        count != (decodedFileSize + decodedRangeSize - 1) / decodedRangeSize ||
+        buf.size() != kDigestHeaderSize +
+                      static_cast<uint64_t>(count) * SHA256_DIGEST_LENGTH) {
+        return -1;
+    }
+
+    rangeSize = decodedRangeSize;
+    fileSize = decodedFileSize;
+    size_t pos = kDigestHeaderSize - SHA256_DIGEST_LENGTH;
+    buf.copy_to(&fileHash, SHA256_DIGEST_LENGTH, pos);
+    pos += SHA256_DIGEST_LENGTH;
+    ranges.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        buf.copy_to(&ranges[i], SHA256_DIGEST_LENGTH, pos);
+        pos += SHA256_DIGEST_LENGTH;
+    }
+    return 0;
+}
+
+uint32_t FileDigest::RangeLength(size_t index) const {
+    uint64_t offset = static_cast<uint64_t>(index) * rangeSize;
+    if (offset >= fileSize) {
+        return 0;
+    }
+    return std::min<uint64_t>(rangeSize, fileSize - offset);
+}
+
+bool IsDigestFilename(const std::string& filename, std::string* source) {
+    size_t suffixLen = strlen(SNAPSHOT_DIGEST_SUFFIX);
+    if (filename.size() <= suffixLen ||
+        filename.compare(filename.size() - suffixLen, suffixLen,
+                         SNAPSHOT_DIGEST_SUFFIX) != 0) {
+        return false;
+    }
+    if (source != nullptr) {
+        *source = filename.substr(0, filename.size() - suffixLen);
+    }
+    return true;
+}
+
+std::string GetDigestFilename(const std::string& filename) {
+    return filename + SNAPSHOT_DIGEST_SUFFIX;
+}
+
+std::string CalcRangeDigest(const butil::IOBuf& data) {
+    SHA256_CTX ctx;
+    SHA256_Init(&ctx);
+    UpdateHash(&ctx, data);
+    return FinalHash(&ctx);
+}
+
+int ComputeFileDigest(braft::FileAdaptor* file,
+                      uint32_t rangeSize,
+                      FileDigest* digest) {
+    CHECK(rangeSize > 0) << "Invalid digest range size";
+    ssize_t fileSize = file->size();
+    if (fileSize < 0) {
+        return errno;
+    }
+    digest->rangeSize = rangeSize;
+    digest->fileSize = fileSize;
+    digest->ranges.clear();
+    digest->ranges.reserve((fileSize + rangeSize - 1) / rangeSize);
+    SHA256_CTX fileCtx;
+    SHA256_Init(&fileCtx);
+    for (off_t offset = 0; offset < fileSize; offset += rangeSize) {
+        size_t length = std::min<uint64_t>(rangeSize, fileSize - offset);
+        butil::IOPortal portal;
+        ssize_t nread = file->read(&portal, offset, length);
+        if (nread != static_cast<ssize_t>(length)) {
+            // 文件在计算期间被截断也当作读失败处理
+            return nread < 0 ? errno : EIO;
+        }
+        digest->ranges.push_back(CalcRangeDigest(portal));
+        UpdateHash(&fileCtx, portal);
+    }
+    digest->fileHash = FinalHash(&fileCtx);
+    return 0;
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,103 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_CHUNKSERVER_RAFTSNAPSHOT_CURVE_SNAPSHOT_DIGEST_H_
+#define SRC_CHUNKSERVER_RAFTSNAPSHOT_CURVE_SNAPSHOT_DIGEST_H_
+
+#include <braft/file_system_adaptor.h>
+#include <butil/iobuf.h>
+#include <gflags/gflags.h>
+#include <string>
+#include <vector>
+
+namespace curve {
+namespace chunkserver {
+
+DECLARE_uint32(raftSnapshotDigestRangeSize);
+
+/**
+ * 快照文件的内容摘要，把文件按rangeSize切分，每个range记录一个SHA-256，
+ * 另外记录整个文件的SHA-256。follower安装快照时先下载摘要，只下载与
+ * 本地文件摘要不一致的range，一致的range直接从本地chunk文件拷贝，
+ * 拼装完成后再用整个文件的摘要校验一次
+ */
+struct FileDigest {
+    // 每个range的大小，最后一个range可能不足rangeSize
+    uint32_t rangeSize;
+    // 计算摘要时文件的大小
+    uint64_t fileSize;
+    // 整个文件的SHA-256
+    std::string fileHash;
+    // 每个range的SHA-256
+    std::vector<std::string> ranges;
+
+    FileDigest() : rangeSize(0), fileSize(0) {}
+
+    /**
+     * 序列化到buf中，整数均为网络字节序
+     */
+    void Encode(butil::IOBuf* buf) const;
+
+    /**
+     * 从buf中反序列化
+     * @return: 成功返回0，格式错误返回-1
+     */
+    int Decode(const butil::IOBuf& buf);
+
+    /**
+     * 获取第index个range的长度
+     */
+    uint32_t RangeLength(size_t index) const;
+};
+
+/**
+ * 判断是否是获取摘要的文件名，摘要文件名为: 原文件名 + kSnapshotDigestSuffix
+ * @param[in] filename: 请求的文件名
+ * @param[out] source: 摘要对应的原文件名
+ */
+bool IsDigestFilename(const std::string& filename, std::string* source);
+
+/**
+ * 获取文件对应的摘要文件名
+ */
+std::string GetDigestFilename(const std::string& filename);
+
+/**
+ * 计算一个range数据的SHA-256
+ */
+std::string CalcRangeDigest(const butil::IOBuf& data);
+
+/**
+ * 计算文件的摘要
+ * @param file: 已打开的文件
+ * @param rangeSize: range的大小，必须大于0
+ * @param[out] digest: 计算得到的摘要
+ * @return: 成功返回0，读文件失败返回errno
+ */
+int ComputeFileDigest(braft::FileAdaptor* file,
+                      uint32_t rangeSize,
+                      FileDigest* digest);
+
+}  // namespace chunkserver
+}  // namespace curve
+
+#endif  // SRC_CHUNKSERVER_RAFTSNAPSHOT_CURVE_SNAPSHOT_DIGEST_H_
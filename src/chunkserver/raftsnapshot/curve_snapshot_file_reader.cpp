@@ -39,11 +39,18 @@
 //          Zheng,Pengfei(zhengpengfei@baidu.com)
 //          Xiong,Kai(xiongkai@baidu.com)
 
+#include <memory>
+
 #include "src/chunkserver/raftsnapshot/curve_snapshot_file_reader.h"
+#include "src/chunkserver/raftsnapshot/curve_snapshot_digest.h"
+#include "src/chunkserver/datastore/chunkserver_chunkfile.h"
 
 namespace curve {
 namespace chunkserver {
 
+// chunk文件的metapage不小于4KB，bitmap一定在前4KB中
+const size_t kChunkMetaReadSize = 4096;
+
 CurveSnapshotAttachMetaTable::CurveSnapshotAttachMetaTable() {}
 
 CurveSnapshotAttachMetaTable::~CurveSnapshotAttachMetaTable() {}
@@ -140,7 +147,7 @@ int CurveSnapshotFileReader::read_file(butil::IOBuf* out,
     braft::LocalFileMeta file_meta;
     if (_meta_table.get_file_meta(filename, &file_meta) != 0 &&
         _attach_meta_table.get_attach_file_meta(filename, nullptr)) {
-        return EPERM;
+        return ENOENT;
     }
     size_t new_max_count = max_count;
     if (_snapshot_throttle &&
@@ -173,5 +180,85 @@ int CurveSnapshotFileReader::read_file(butil::IOBuf* out,
                                     offset, new_max_count, read_count, is_eof);
 }
 
+int CurveSnapshotFileReader::read_file_digest(butil::IOBuf* out,
+                                              const std::string &filename,
+                                              off_t offset,
+                                              size_t max_count,
+                                              size_t* read_count,
+                                              bool* is_eof) const {
+    // 只有snapshot meta中记录的文件才提供摘要，不能返回EPERM，
+    // follower会把EPERM当作leader不支持摘要，之后的文件都不再增量下载
+    if (_meta_table.get_file_meta(filename, nullptr) != 0) {
+        return ENOENT;
+    }
+    std::string file_path(path() + "/" + filename);
+    butil::File::Error e;
+    std::unique_ptr<braft::FileAdaptor> file(file_system()->open(
+        file_path, O_RDONLY | O_CLOEXEC, nullptr, &e));
+    if (!file) {
+        return braft::file_error_to_os_error(e);
+    }
+    FileDigest digest;
+    int ret = ComputeFileDigest(file.get(),
+                                FLAGS_raftSnapshotDigestRangeSize,
+                                &digest);
+    if (ret != 0) {
+        LOG(WARNING) << "Fail to compute digest of " << file_path
+                     << ", error: " << berror(ret);
+        return ret;
+    }
+
+    butil::IOBuf buf;
+    digest.Encode(&buf);
+    size_t total = buf.size();
+    buf.pop_front(offset);
+    buf.cutn(out, max_count);
+    *read_count = out->size();
+    *is_eof = offset + *read_count >= total;
+    return 0;
+}
+
+int CurveSnapshotFileReader::read_chunk_bitmap(
+                        const std::string &filename,
+                        std::shared_ptr<curve::common::Bitmap>* bitmap,
+                        uint32_t* page_size) const {
+    *bitmap = nullptr;
+    std::string file_path(path() + "/" + filename);
+    butil::File::Error e;
+    std::unique_ptr<braft::FileAdaptor> file(file_system()->open(
+        file_path, O_RDONLY | O_CLOEXEC, nullptr, &e));
+    if (!file) {
+        return braft::file_error_to_os_error(e);
+    }
+    ssize_t file_size = file->size();
+    if (file_size < 0) {
+        return errno;
+    }
+    butil::IOPortal portal;
+    ssize_t nread = file->read(&portal, 0, kChunkMetaReadSize);
+    if (nread < 0) {
+        return errno;
+    }
+    if (nread != static_cast<ssize_t>(kChunkMetaReadSize)) {
+        return 0;
+    }
+    char buf[kChunkMetaReadSize];
+    portal.copy_to(buf, kChunkMetaReadSize);
+    ChunkFileMetaPage metaPage;
+    if (metaPage.decode(buf) != CSErrorCode::Success ||
+        metaPage.bitmap == nullptr) {
+        return 0;
+    }
+    uint64_t pages = metaPage.bitmap->Size() + 1;
+    if (file_size % pages != 0) {
+        LOG(WARNING) << "Chunk file " << file_path << " size " << file_size
+                     << " not match bitmap size " << metaPage.bitmap->Size();
+        return 0;
+    }
+    *page_size = file_size / pages;
+    *bitmap = metaPage.bitmap;
+    return 0;
+}
+
 }  // namespace chunkserver
 }  // namespace curve
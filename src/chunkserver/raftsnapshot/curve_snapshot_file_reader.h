@@ -48,8 +48,10 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
 #include "proto/curve_storage.pb.h"
 #include "src/chunkserver/raftsnapshot/define.h"
+#include "src/common/bitmap.h"
 
 namespace curve {
 namespace chunkserver {
@@ -109,6 +111,33 @@ class CurveSnapshotFileReader : public braft::LocalDirReader {
                   size_t* read_count,
                   bool* is_eof) const override;
 
+    /**
+     * 读取快照文件的摘要，摘要在每次请求时根据文件当前的内容计算
+     * @param[out] out: 摘要中[offset, offset + max_count)的部分
+     * @param filename: 快照中的文件名，不包含摘要后缀
+     * @return: 成功返回0，文件不在快照中返回ENOENT，读文件失败返回errno
+     */
+    virtual int read_file_digest(butil::IOBuf* out,
+                                 const std::string &filename,
+                                 off_t offset,
+                                 size_t max_count,
+                                 size_t* read_count,
+                                 bool* is_eof) const;
+
+    /**
+     * 读取chunk文件metapage中的clone bitmap，传输快照时跳过clone chunk
+     * 中未写过的页，这些页的数据在clone源上
+     * @param filename: 快照中的chunk文件名
+     * @param[out] bitmap: 不是clone chunk时为nullptr
+     * @param[out] page_size: bitmap中每一位对应的页大小，
+     *                        chunk文件由metapage加上bitmap->Size()个页组成
+     * @return: 成功返回0，读文件失败返回errno
+     */
+    virtual int read_chunk_bitmap(
+                        const std::string &filename,
+                        std::shared_ptr<curve::common::Bitmap>* bitmap,
+                        uint32_t* page_size) const;
+
     braft::LocalSnapshotMetaTable get_meta_table() {
         return _meta_table;
     }
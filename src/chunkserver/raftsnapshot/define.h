@@ -37,6 +37,8 @@ const char RAFT_LOG_DIR[]  = "log";
 #define BRAFT_SNAPSHOT_META_FILE        "__raft_snapshot_meta"
 #define BRAFT_SNAPSHOT_ATTACH_META_FILE "__raft_snapshot_attach_meta"
 #define BRAFT_PROTOBUF_FILE_TEMP ".tmp"
+// 获取快照文件摘要时，请求的文件名为原文件名加上这个后缀
+const char SNAPSHOT_DIGEST_SUFFIX[] = "@digest";
 
 }  // namespace chunkserver
 }  // namespace curve
@@ -167,7 +167,14 @@ void Trash::DeleteEligibleFileInTrash() {
             continue;
         }
 
-        if (!RecycleChunksAndWALInDir(copysetDir, file)) {
+        // 先收集目录下所有的chunk和wal文件，再批量归还到池中
+        std::vector<std::string> chunks;
+        std::vector<std::string> wals;
+        bool ret = CollectChunksAndWALInDir(copysetDir, file, &chunks, &wals);
+        // recycle 失败不应该中断其他文件的recycle
+        ret = RecycleChunkfiles(chunks) && ret;
+        ret = RecycleWALs(wals) && ret;
+        if (!ret) {
             continue;
         }
 
@@ -223,18 +230,18 @@ bool Trash::IsChunkOrSnapShotFile(const std::string &chunkName) {
         FileNameOperator::ParseFileName(chunkName).type;
 }
 
-bool Trash::RecycleChunksAndWALInDir(
-    const std::string &copysetPath, const std::string &filename) {
+bool Trash::CollectChunksAndWALInDir(
+    const std::string &copysetPath, const std::string &filename,
+    std::vector<std::string> *chunks, std::vector<std::string> *wals) {
     bool isDir = localFileSystem_->DirExists(copysetPath);
     // 是文件看是否需要回收
     if (!isDir) {
         if (IsChunkOrSnapShotFile(filename)) {
-            return RecycleChunkfile(copysetPath, filename);
+            chunks->push_back(copysetPath);
         } else if (IsWALFile(filename)) {
-            return RecycleWAL(copysetPath, filename);
-        } else {
-            return true;
+            wals->push_back(copysetPath);
         }
+        return true;
     }
 
     // 是目录，继续list
@@ -248,37 +255,50 @@ bool Trash::RecycleChunksAndWALInDir(
     bool ret = true;
     for (auto &file : files) {
         std::string filePath = copysetPath + "/" + file;
-        // recycle 失败不应该中断其他文件的recycle
-        if (!RecycleChunksAndWALInDir(filePath, file)) {
+        // list 失败不应该中断其他文件的收集
+        if (!CollectChunksAndWALInDir(filePath, file, chunks, wals)) {
             ret = false;
         }
     }
     return ret;
 }
 
-bool Trash::RecycleChunkfile(
-    const std::string &filepath, const std::string &filename) {
+bool Trash::RecycleChunkfiles(const std::vector<std::string> &chunks) {
+    if (chunks.empty()) {
+        return true;
+    }
+
     LockGuard lg(mtx_);
-    if (0 != chunkFilePool_->RecycleFile(filepath)) {
-        LOG(ERROR) << "Trash  failed recycle chunk " << filepath
-                    << " to FilePool";
+    uint64_t recycledNum = 0;
+    int ret = chunkFilePool_->RecycleFiles(chunks, &recycledNum);
+    chunkNum_.fetch_sub(recycledNum);
+    if (0 != ret) {
+        LOG(ERROR) << "Trash failed recycle "
+                   << chunks.size() - recycledNum << " of "
+                   << chunks.size() << " chunks to FilePool";
         return false;
     }
-
-    chunkNum_.fetch_sub(1);
     return true;
 }
 
-bool Trash::RecycleWAL(
-    const std::string &filepath, const std::string &filename) {
+bool Trash::RecycleWALs(const std::vector<std::string> &wals) {
+    if (wals.empty()) {
+        return true;
+    }
+
     LockGuard lg(mtx_);
-    if (walPool_ != nullptr && 0 != walPool_->RecycleFile(filepath)) {
-        LOG(ERROR) << "Trash  failed recycle WAL " << filepath
-                    << " to WALPool";
+    uint64_t recycledNum = wals.size();
+    int ret = 0;
+    if (walPool_ != nullptr) {
+        ret = walPool_->RecycleFiles(wals, &recycledNum);
+    }
+    chunkNum_.fetch_sub(recycledNum);
+    if (0 != ret) {
+        LOG(ERROR) << "Trash failed recycle "
+                   << wals.size() - recycledNum << " of "
+                   << wals.size() << " WALs to WALPool";
         return false;
     }
-
-    chunkNum_.fetch_sub(1);
     return true;
 }
 
@@ -25,6 +25,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include "src/fs/local_filesystem.h"
 #include "src/chunkserver/datastore/file_pool.h"
 #include "src/common/concurrent/concurrent.h"
@@ -108,35 +109,35 @@ class Trash {
     bool IsChunkOrSnapShotFile(const std::string &chunkName);
 
     /*
-    * @brief Recycle Chunkfile and wal file in Copyset
+    * @brief Collect Chunkfile and wal file in Copyset
     *
     * @param[in] copysetDir copyset dir
     * @param[in] filename filename
+    * @param[out] chunks chunk和snapshot文件路径
+    * @param[out] wals wal文件路径
+    * @return 目录全部遍历成功返回true
     */
-    bool RecycleChunksAndWALInDir(
-        const std::string &copysetDir, const std::string &filename);
+    bool CollectChunksAndWALInDir(
+        const std::string &copysetDir, const std::string &filename,
+        std::vector<std::string> *chunks, std::vector<std::string> *wals);
 
     /*
-    * @brief Recycle Chunkfile
+    * @brief 批量回收Chunkfile
     *
-    * @param[in] filepath 文件路径
-    * @param[in] filename 文件名
+    * @param[in] chunks 文件路径
+    * @return 全部回收成功返回true
     */
-    bool RecycleChunkfile(
-        const std::string &filepath, const std::string &filename);
+    bool RecycleChunkfiles(const std::vector<std::string> &chunks);
 
     /**
-     * @brief Recycle WAL
+     * @brief 批量回收WAL
      *
-     * @param copysetPath copyset dir
-     * @param filename file name
+     * @param wals 文件路径
      *
      * @retval true   success
      * @retval false  failure
      */
-    bool RecycleWAL(
-        const std::string &filepath, const std::string &filename);
-
+    bool RecycleWALs(const std::vector<std::string> &wals);
 
     /**
      * @brief is WAL or not ?
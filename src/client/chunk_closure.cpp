@@ -77,7 +77,7 @@ void ClientClosure::PreProcessBeforeRetry(int rpcstatus, int cntlstatus) {
                   << ", IO id = " << reqDone->GetIOTracker()->GetID()
                   << ", request id = " << reqCtx_->id_
                   << ", remote side = "
-                  << butil::endpoint2str(cntl_->remote_side()).c_str();
+                  << butil::endpoint2str(RpcRemoteSide()).c_str();
         return;
     }
 
@@ -89,7 +89,7 @@ void ClientClosure::PreProcessBeforeRetry(int rpcstatus, int cntlstatus) {
                   << ", IO id = " << reqDone->GetIOTracker()->GetID()
                   << ", request id = " << reqCtx_->id_
                   << ", remote side = "
-                  << butil::endpoint2str(cntl_->remote_side()).c_str();
+                  << butil::endpoint2str(RpcRemoteSide()).c_str();
         bthread_usleep(nextsleeptime);
         return;
     }
@@ -115,7 +115,7 @@ void ClientClosure::PreProcessBeforeRetry(int rpcstatus, int cntlstatus) {
         << ", IO id = " << reqDone->GetIOTracker()->GetID()
         << ", request id = " << reqCtx_->id_
         << ", remote side = "
-        << butil::endpoint2str(cntl_->remote_side()).c_str();
+        << butil::endpoint2str(RpcRemoteSide()).c_str();
 
     if (nextSleepUS != 0) {
         bthread_usleep(nextSleepUS);
@@ -170,6 +170,10 @@ void ClientClosure::Run() {
     status_ = -1;
     cntlstatus_ = cntl_->ErrorCode();
 
+    if (connMetric_ != nullptr) {
+        connMetric_->OnResponse(RpcLatencyUs());
+    }
+
     bool needRetry = false;
 
     if (cntl_->Failed()) {
@@ -225,7 +229,7 @@ void ClientClosure::Run() {
                     << ", IO id = " << reqDone_->GetIOTracker()->GetID()
                     << ", request id = " << reqCtx_->id_
                     << ", remote side = "
-                    << butil::endpoint2str(cntl_->remote_side()).c_str();
+                    << butil::endpoint2str(RpcRemoteSide()).c_str();
             }
             break;
 
@@ -245,7 +249,7 @@ void ClientClosure::Run() {
                 << ", IO id = " << reqDone_->GetIOTracker()->GetID()
                 << ", request id = " << reqCtx_->id_
                 << ", remote side = "
-                << butil::endpoint2str(cntl_->remote_side()).c_str();
+                << butil::endpoint2str(RpcRemoteSide()).c_str();
         }
     }
 
@@ -263,7 +267,10 @@ void ClientClosure::OnRpcFailed() {
     // 如果连接失败，再等一定时间再重试
     if (cntlstatus_ == brpc::ERPCTIMEDOUT) {
         // 如果RPC超时, 对应的chunkserver超时请求次数+1
-        metaCache_->GetUnstableHelper().IncreTimeout(chunkserverID_);
+        // 同一个batch中的请求是一次rpc超时，只计一次
+        if (countTimeout_) {
+            metaCache_->GetUnstableHelper().IncreTimeout(chunkserverID_);
+        }
         MetricHelper::IncremTimeOutRPCCount(fileMetric_, reqCtx_->optype_);
     }
 
@@ -276,7 +283,7 @@ void ClientClosure::OnRpcFailed() {
         << ", IO id = " << reqDone_->GetIOTracker()->GetID()
         << ", request id = " << reqCtx_->id_
         << ", remote side = "
-        << butil::endpoint2str(cntl_->remote_side()).c_str();
+        << butil::endpoint2str(RpcRemoteSide()).c_str();
 
     // it will be invoked in brpc's bthread
     if (reqCtx_->optype_ == OpType::WRITE) {
@@ -319,12 +326,33 @@ void ClientClosure::ProcessUnstableState() {
 void ClientClosure::OnSuccess() {
     reqDone_->SetFailed(0);
 
-    auto duration = cntl_->latency_us();
+    auto duration = RpcLatencyUs();
     MetricHelper::LatencyRecord(fileMetric_, duration, reqCtx_->optype_);
     MetricHelper::IncremRPCQPSCount(
         fileMetric_, reqCtx_->rawlength_, reqCtx_->optype_);
 }
 
+void ClientClosure::PrepareQosParas(
+    curve::chunkserver::QosRequestParas* paras) {
+    if (nullptr == client_) {
+        return;
+    }
+    // 以文件的inode id标识卷
+    MetaCache* metaCache = client_->GetMetaCache();
+    if (nullptr != metaCache) {
+        paras->set_clientid(metaCache->InodeId());
+    }
+    client_->GetDmClockTracker()->PrepareRequest(chunkserverID_, paras);
+}
+
+void ClientClosure::OnQosResponse() {
+    if (nullptr == client_ || !response_->has_phasecost()) {
+        return;
+    }
+    client_->GetDmClockTracker()->OnResponse(chunkserverID_,
+                                             response_->phasecost());
+}
+
 void ClientClosure::OnChunkNotExist() {
     reqDone_->SetFailed(status_);
 
@@ -335,9 +363,9 @@ void ClientClosure::OnChunkNotExist() {
         << ", IO id = " << reqDone_->GetIOTracker()->GetID()
         << ", request id = " << reqCtx_->id_
         << ", remote side = "
-        << butil::endpoint2str(cntl_->remote_side()).c_str();
+        << butil::endpoint2str(RpcRemoteSide()).c_str();
 
-    auto duration = cntl_->latency_us();
+    auto duration = RpcLatencyUs();
     MetricHelper::LatencyRecord(fileMetric_, duration, reqCtx_->optype_);
     MetricHelper::IncremRPCQPSCount(
         fileMetric_, reqCtx_->rawlength_, reqCtx_->optype_);
@@ -353,7 +381,7 @@ void ClientClosure::OnChunkExist() {
         << ", IO id = " << reqDone_->GetIOTracker()->GetID()
         << ", request id = " << reqCtx_->id_
         << ", remote side = "
-        << butil::endpoint2str(cntl_->remote_side()).c_str();
+        << butil::endpoint2str(RpcRemoteSide()).c_str();
 }
 
 void ClientClosure::OnRedirected() {
@@ -366,7 +394,7 @@ void ClientClosure::OnRedirected() {
         << ", redirect leader is "
         << (response_->has_redirect() ? response_->redirect() : "empty")
         << ", remote side = "
-        << butil::endpoint2str(cntl_->remote_side()).c_str();
+        << butil::endpoint2str(RpcRemoteSide()).c_str();
 
     if (response_->has_redirect()) {
         int ret = UpdateLeaderWithRedirectInfo(response_->redirect());
@@ -386,7 +414,7 @@ void ClientClosure::OnCopysetNotExist() {
         << ", IO id = " << reqDone_->GetIOTracker()->GetID()
         << ", request id = " << reqCtx_->id_
         << ", remote side = "
-        << butil::endpoint2str(cntl_->remote_side()).c_str();
+        << butil::endpoint2str(RpcRemoteSide()).c_str();
 
     RefreshLeader();
 }
@@ -449,7 +477,7 @@ void ClientClosure::OnBackward() {
         << ", IO id = " << reqDone_->GetIOTracker()->GetID()
         << ", request id = " << reqCtx_->id_
         << ", remote side = "
-        << butil::endpoint2str(cntl_->remote_side()).c_str();
+        << butil::endpoint2str(RpcRemoteSide()).c_str();
 
     reqCtx_->seq_ = latestSn;
 }
@@ -463,7 +491,7 @@ void ClientClosure::OnInvalidRequest() {
         << ", IO id = " << reqDone_->GetIOTracker()->GetID()
         << ", request id = " << reqCtx_->id_
         << ", remote side = "
-        << butil::endpoint2str(cntl_->remote_side()).c_str();
+        << butil::endpoint2str(RpcRemoteSide()).c_str();
     MetricHelper::IncremFailRPCCount(fileMetric_, reqCtx_->optype_);
 }
 
@@ -478,6 +506,7 @@ void WriteChunkClosure::SendRetryRequest() {
 
 void WriteChunkClosure::OnSuccess() {
     ClientClosure::OnSuccess();
+    OnQosResponse();
 
     metaCache_->UpdateAppliedIndex(
         chunkIdInfo_.lpid_,
@@ -496,6 +525,7 @@ void ReadChunkClosure::SendRetryRequest() {
 
 void ReadChunkClosure::OnSuccess() {
     ClientClosure::OnSuccess();
+    OnQosResponse();
 
     reqCtx_->readData_ = cntl_->response_attachment();
 
@@ -558,7 +588,7 @@ void GetChunkInfoClosure::OnRedirected() {
         << (chunkinforesponse_->has_redirect() ? chunkinforesponse_->redirect()
                                                : "empty")
         << ", remote side = "
-        << butil::endpoint2str(cntl_->remote_side()).c_str();
+        << butil::endpoint2str(RpcRemoteSide()).c_str();
 
     if (chunkinforesponse_->has_redirect()) {
         int ret = UpdateLeaderWithRedirectInfo(chunkinforesponse_->redirect());
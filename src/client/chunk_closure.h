@@ -83,6 +83,27 @@ class ClientClosure : public Closure {
         return chunkserverEndPoint_;
     }
 
+    // 记录rpc是从哪条连接发出的，rpc返回时更新该连接的metric
+    void SetConnectionMetric(const std::shared_ptr<ConnectionMetric>& metric) {
+        connMetric_ = metric;
+    }
+
+    /**
+     * 请求通过batch发送时，子请求的cntl没有真正发送过rpc，
+     * batch返回时用batch的rpc结果设置子请求的延时和对端地址
+     * @param latencyUs: batch rpc的延时
+     * @param remoteSide: batch rpc的对端地址
+     * @param countTimeout: batch超时时是否计入chunkserver的超时次数，
+     *                      一个batch只计一次
+     */
+    void SetBatchResult(int64_t latencyUs, const butil::EndPoint& remoteSide,
+                        bool countTimeout) {
+        batched_ = true;
+        batchLatencyUs_ = latencyUs;
+        batchRemoteSide_ = remoteSide;
+        countTimeout_ = countTimeout;
+    }
+
     // 统一Run函数入口
     void Run() override;
 
@@ -116,6 +137,12 @@ class ClientClosure : public Closure {
     // 发送重试请求
     virtual void SendRetryRequest() = 0;
 
+    /**
+     * 填充读写请求的qos参数，需要在SetChunkServerID之后调用
+     * @param: paras为请求中的qos参数
+     */
+    void PrepareQosParas(curve::chunkserver::QosRequestParas* paras);
+
     // 获取response返回的状态码
     virtual CHUNK_OP_STATUS GetResponseStatus() const {
         return response_->status();
@@ -200,10 +227,22 @@ class ClientClosure : public Closure {
  protected:
     int UpdateLeaderWithRedirectInfo(const std::string& leaderInfo);
 
+    // 记录读写请求在chunkserver上被qos调度的阶段
+    void OnQosResponse();
+
     void ProcessUnstableState();
 
     void RefreshLeader();
 
+    // rpc的延时和对端地址，通过batch发送的请求取batch rpc的
+    int64_t RpcLatencyUs() const {
+        return batched_ ? batchLatencyUs_ : cntl_->latency_us();
+    }
+
+    butil::EndPoint RpcRemoteSide() const {
+        return batched_ ? batchRemoteSide_ : cntl_->remote_side();
+    }
+
     static FailureRequestOption         failReqOpt_;
 
     brpc::Controller*                   cntl_;
@@ -214,6 +253,7 @@ class ClientClosure : public Closure {
     // 这样方便在rpc closure里直接找到，当前是哪个chunkserver返回的失败
     ChunkServerID                       chunkserverID_;
     butil::EndPoint                     chunkserverEndPoint_;
+    std::shared_ptr<ConnectionMetric>   connMetric_;
 
     // 记录当前请求的相关信息
     MetaCache*                          metaCache_;
@@ -225,6 +265,13 @@ class ClientClosure : public Closure {
     // 发送重试请求前是否睡眠
     bool retryDirectly_ = false;
 
+    // 是否通过batch发送，以及batch rpc的延时和对端地址
+    bool batched_ = false;
+    int64_t batchLatencyUs_ = 0;
+    butil::EndPoint batchRemoteSide_;
+    // rpc超时时是否计入chunkserver的超时次数
+    bool countTimeout_ = true;
+
     // response 状态码
     int                                 status_;
 
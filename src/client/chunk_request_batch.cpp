@@ -0,0 +1,144 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include "src/client/chunk_request_batch.h"
+
+#include <brpc/callback.h>
+#include <brpc/errno.pb.h>
+#include <bthread/bthread.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+
+#include "src/client/chunk_closure.h"
+#include "src/client/request_sender.h"
+
+namespace curve {
+namespace client {
+
+using curve::chunkserver::ChunkService_Stub;
+using curve::common::LockGuard;
+
+ChunkRequestBatch::ChunkRequestBatch(
+    std::shared_ptr<ChunkServerConnection> conn, uint32_t maxRequestNum)
+    : conn_(conn),
+      maxRequestNum_(std::max(1u, maxRequestNum)),
+      sent_(false),
+      ctx_(new BatchContext()) {
+    ctx_->conn = conn_;
+}
+
+bool ChunkRequestBatch::Add(ChunkRequest* request, const butil::IOBuf& data,
+                            brpc::Controller* cntl, ChunkResponse* response,
+                            ClientClosure* done, bool* full) {
+    LockGuard lk(mtx_);
+    if (sent_) {
+        return false;
+    }
+
+    ctx_->request.add_requests()->Swap(request);
+    ctx_->cntl.request_attachment().append(data);
+    ctx_->subRequests.push_back({cntl, response, done});
+
+    // batch的超时时间取子请求中最大的
+    if (cntl->timeout_ms() > ctx_->cntl.timeout_ms()) {
+        ctx_->cntl.set_timeout_ms(cntl->timeout_ms());
+    }
+
+    *full = ctx_->subRequests.size() >= maxRequestNum_;
+    return true;
+}
+
+void ChunkRequestBatch::Send() {
+    BatchContext* ctx = nullptr;
+    {
+        LockGuard lk(mtx_);
+        if (sent_) {
+            return;
+        }
+        sent_ = true;
+        ctx = ctx_.release();
+    }
+
+    ctx->conn->metric->OnRequest();
+    ChunkService_Stub stub(&ctx->conn->channel);
+    stub.BatchChunk(&ctx->cntl, &ctx->request, &ctx->response,
+                    brpc::NewCallback(OnBatchReturned, ctx));
+}
+
+void ChunkRequestBatch::OnTimer(void* arg) {
+    // timer线程里不能做耗时的操作，放到bthread中发送
+    bthread_t tid;
+    if (0 != bthread_start_background(&tid, nullptr, RunSend, arg)) {
+        RunSend(arg);
+    }
+}
+
+void* ChunkRequestBatch::RunSend(void* arg) {
+    std::unique_ptr<std::shared_ptr<ChunkRequestBatch>> batch(
+        static_cast<std::shared_ptr<ChunkRequestBatch>*>(arg));
+    (*batch)->Send();
+    return nullptr;
+}
+
+void ChunkRequestBatch::OnBatchReturned(BatchContext* ctx) {
+    std::unique_ptr<BatchContext> ctxGuard(ctx);
+    brpc::Controller& cntl = ctx->cntl;
+    BatchChunkResponse& response = ctx->response;
+    size_t subRequestNum = ctx->subRequests.size();
+
+    ctx->conn->metric->OnResponse(cntl.latency_us());
+
+    bool valid = !cntl.Failed() &&
+                 static_cast<size_t>(response.responses_size()) ==
+                     subRequestNum &&
+                 static_cast<size_t>(response.datasize_size()) == subRequestNum;
+    if (!cntl.Failed() && !valid) {
+        LOG(ERROR) << "invalid batch chunk response, sub request num: "
+                   << subRequestNum
+                   << ", response num: " << response.responses_size()
+                   << ", data size num: " << response.datasize_size()
+                   << ", remote side: " << cntl.remote_side();
+    }
+
+    // 把batch的结果拆分回子请求，由子请求的closure各自处理成功、失败和重试
+    for (size_t i = 0; i < subRequestNum; ++i) {
+        SubRequest& sub = ctx->subRequests[i];
+        // 子请求的延时和对端地址取batch rpc的，batch超时只计一次超时
+        sub.done->SetBatchResult(cntl.latency_us(), cntl.remote_side(),
+                                 0 == i);
+        if (cntl.Failed()) {
+            sub.cntl->SetFailed(cntl.ErrorCode(), "%s",
+                                cntl.ErrorText().c_str());
+        } else if (!valid) {
+            sub.cntl->SetFailed(brpc::ERESPONSE, "invalid batch response");
+        } else {
+            sub.response->Swap(response.mutable_responses(i));
+            cntl.response_attachment().cutn(
+                &sub.cntl->response_attachment(), response.datasize(i));
+        }
+        sub.done->Run();
+    }
+}
+
+}   // namespace client
+}   // namespace curve
@@ -0,0 +1,119 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_CLIENT_CHUNK_REQUEST_BATCH_H_
+#define SRC_CLIENT_CHUNK_REQUEST_BATCH_H_
+
+#include <brpc/controller.h>
+#include <butil/iobuf.h>
+
+#include <memory>
+#include <vector>
+
+#include "proto/chunk.pb.h"
+#include "src/common/concurrent/concurrent.h"
+
+namespace curve {
+namespace client {
+
+using curve::chunkserver::ChunkRequest;
+using curve::chunkserver::ChunkResponse;
+using curve::chunkserver::BatchChunkRequest;
+using curve::chunkserver::BatchChunkResponse;
+
+class ClientClosure;
+struct ChunkServerConnection;
+
+/**
+ * 发往同一个chunkserver的小读写请求在一个时间窗口内攒成一批，
+ * 通过一个BatchChunk rpc发送。每个子请求仍然保留自己的controller、
+ * response和closure，rpc返回后把结果拆分回子请求，再调用子请求的closure，
+ * 这样重试、重定向等逻辑都和单个请求发送时完全一样
+ */
+class ChunkRequestBatch {
+ public:
+    ChunkRequestBatch(std::shared_ptr<ChunkServerConnection> conn,
+                      uint32_t maxRequestNum);
+
+    ~ChunkRequestBatch() = default;
+
+    /**
+     * 加入一个子请求
+     * @param request:子请求，内容会被swap到batch中
+     * @param data:写请求的数据，读请求为空
+     * @param cntl:子请求的controller，rpc返回后设置其错误码和数据
+     * @param response:子请求的response
+     * @param done:子请求的closure
+     * @param[out] full:加入之后batch是否已经攒满
+     * @return batch已经发送返回false，此时请求没有被加入
+     */
+    bool Add(ChunkRequest* request, const butil::IOBuf& data,
+             brpc::Controller* cntl, ChunkResponse* response,
+             ClientClosure* done, bool* full);
+
+    /**
+     * 发送batch，多次调用只有第一次会真正发送
+     */
+    void Send();
+
+    /**
+     * 时间窗口到期的回调
+     * @param arg:new出来的std::shared_ptr<ChunkRequestBatch>，回调中释放
+     */
+    static void OnTimer(void* arg);
+
+ private:
+    struct SubRequest {
+        brpc::Controller* cntl;
+        ChunkResponse* response;
+        ClientClosure* done;
+    };
+
+    // BatchChunk rpc的上下文，rpc返回时析构
+    struct BatchContext {
+        brpc::Controller cntl;
+        BatchChunkRequest request;
+        BatchChunkResponse response;
+        std::vector<SubRequest> subRequests;
+        std::shared_ptr<ChunkServerConnection> conn;
+    };
+
+    static void* RunSend(void* arg);
+
+    static void OnBatchReturned(BatchContext* ctx);
+
+ private:
+    // batch发送使用的connection
+    std::shared_ptr<ChunkServerConnection> conn_;
+    // 攒满的子请求数量
+    uint32_t maxRequestNum_;
+
+    // 保护下面的成员
+    curve::common::Mutex mtx_;
+    bool sent_;
+    std::unique_ptr<BatchContext> ctx_;
+};
+
+}   // namespace client
+}   // namespace curve
+
+#endif  // SRC_CLIENT_CHUNK_REQUEST_BATCH_H_
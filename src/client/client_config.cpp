@@ -73,6 +73,26 @@ int ClientConfig::Init(const char* configpath) {
     LOG_IF(ERROR, ret == false) << "config no chunkserver.enableAppliedIndexRead info";     // NOLINT
     RETURN_IF_FALSE(ret);
 
+    ret = conf_.GetUInt32Value("chunkserver.connectionNum",
+          &fileServiceOption_.ioOpt.ioSenderOpt.chunkserverConnectionNum);
+    LOG_IF(WARNING, ret == false) << "config no chunkserver.connectionNum info";
+
+    ret = conf_.GetBoolValue("chunkserver.connectionLeastInflight",
+          &fileServiceOption_.ioOpt.ioSenderOpt.chunkserverConnectionLeastInflight);    // NOLINT
+    LOG_IF(WARNING, ret == false) << "config no chunkserver.connectionLeastInflight info";   // NOLINT
+
+    ret = conf_.GetUInt64Value("chunkserver.batchWindowUS",
+          &fileServiceOption_.ioOpt.ioSenderOpt.chunkserverBatchWindowUS);
+    LOG_IF(WARNING, ret == false) << "config no chunkserver.batchWindowUS info";
+
+    ret = conf_.GetUInt32Value("chunkserver.batchMaxRequestNum",
+          &fileServiceOption_.ioOpt.ioSenderOpt.chunkserverBatchMaxRequestNum);    // NOLINT
+    LOG_IF(WARNING, ret == false) << "config no chunkserver.batchMaxRequestNum info";    // NOLINT
+
+    ret = conf_.GetUInt32Value("chunkserver.batchMaxRequestBytes",
+          &fileServiceOption_.ioOpt.ioSenderOpt.chunkserverBatchMaxRequestBytes);    // NOLINT
+    LOG_IF(WARNING, ret == false) << "config no chunkserver.batchMaxRequestBytes info";    // NOLINT
+
     ret = conf_.GetUInt32Value("chunkserver.opMaxRetry",
           &fileServiceOption_.ioOpt.ioSenderOpt.failRequestOpt.chunkserverOPMaxRetry);    // NOLINT
     LOG_IF(ERROR, ret == false) << "config no chunkserver.opMaxRetry info";
@@ -275,6 +295,61 @@ int ClientConfig::Init(const char* configpath) {
     LOG_IF(ERROR, ret == false) << "config no discard.taskDelayMs info";
     RETURN_IF_FALSE(ret);
 
+    ret = conf_.GetUInt32Value(
+        "segmentPrealloc.num",
+        &fileServiceOption_.ioOpt.segmentPreallocOpt.preallocSegmentNum);
+    LOG_IF(WARNING, ret == false)
+        << "config no segmentPrealloc.num info, using default value "
+        << fileServiceOption_.ioOpt.segmentPreallocOpt.preallocSegmentNum;
+
+    ret = conf_.GetUInt32Value(
+        "segmentPrealloc.sequentialWriteThreshold",
+        &fileServiceOption_.ioOpt.segmentPreallocOpt.sequentialWriteThreshold);
+    LOG_IF(WARNING, ret == false)
+        << "config no segmentPrealloc.sequentialWriteThreshold info, "
+           "using default value "
+        << fileServiceOption_.ioOpt.segmentPreallocOpt.sequentialWriteThreshold;
+
+    ret = conf_.GetBoolValue("readCache.enable",
+                             &fileServiceOption_.ioOpt.readCacheOpt.enable);
+    LOG_IF(WARNING, ret == false)
+        << "config no readCache.enable info, using default value "
+        << fileServiceOption_.ioOpt.readCacheOpt.enable;
+
+    ret = conf_.GetUInt32Value(
+        "readCache.blockSize",
+        &fileServiceOption_.ioOpt.readCacheOpt.blockSize);
+    LOG_IF(WARNING, ret == false)
+        << "config no readCache.blockSize info, using default value "
+        << fileServiceOption_.ioOpt.readCacheOpt.blockSize;
+
+    if (fileServiceOption_.ioOpt.readCacheOpt.blockSize == 0 ||
+        !common::is_aligned(fileServiceOption_.ioOpt.readCacheOpt.blockSize,
+                            512)) {
+        LOG(ERROR) << "readCache.blockSize must be a positive multiple of 512";
+        RETURN_IF_FALSE(false);
+    }
+
+    ret = conf_.GetUInt64Value(
+        "readCache.memCapacityMB",
+        &fileServiceOption_.ioOpt.readCacheOpt.memCapacityMB);
+    LOG_IF(WARNING, ret == false)
+        << "config no readCache.memCapacityMB info, using default value "
+        << fileServiceOption_.ioOpt.readCacheOpt.memCapacityMB;
+
+    ret = conf_.GetStringValue(
+        "readCache.diskCacheDir",
+        &fileServiceOption_.ioOpt.readCacheOpt.diskCacheDir);
+    LOG_IF(WARNING, ret == false)
+        << "config no readCache.diskCacheDir info, disk tier is disabled";
+
+    ret = conf_.GetUInt64Value(
+        "readCache.diskCapacityMB",
+        &fileServiceOption_.ioOpt.readCacheOpt.diskCapacityMB);
+    LOG_IF(WARNING, ret == false)
+        << "config no readCache.diskCapacityMB info, using default value "
+        << fileServiceOption_.ioOpt.readCacheOpt.diskCapacityMB;
+
     ret = conf_.GetUInt32Value(
         "global.alignment.commonVolume",
         &fileServiceOption_.ioOpt.ioSplitOpt.alignment.commonVolume);
@@ -25,6 +25,7 @@
 
 #include <bvar/bvar.h>
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -102,6 +103,45 @@ struct DiscardMetric {
     bvar::Adder<int64_t> pending;
 };
 
+struct SegmentPreallocMetric {
+    explicit SegmentPreallocMetric(const std::string& prefix)
+        : totalSuccess(prefix, "segment_prealloc_total_success"),
+          totalError(prefix, "segment_prealloc_total_error") {}
+
+    // number of segments pre-allocated / failed to pre-allocate
+    bvar::Adder<int64_t> totalSuccess;
+    bvar::Adder<int64_t> totalError;
+};
+
+struct ReadCacheMetric {
+    explicit ReadCacheMetric(const std::string& prefix)
+        : hit(prefix, "read_cache_hit"),
+          miss(prefix, "read_cache_miss"),
+          diskHit(prefix, "read_cache_disk_hit"),
+          memUsedBytes(prefix, "read_cache_mem_used_bytes"),
+          diskUsedBytes(prefix, "read_cache_disk_used_bytes"),
+          diskPendingWrites(prefix, "read_cache_disk_pending_writes"),
+          hitRatio(prefix, "read_cache_hit_ratio", GetHitRatio, this) {}
+
+    // number of user reads served by / missed in read cache
+    bvar::Adder<int64_t> hit;
+    bvar::Adder<int64_t> miss;
+    // number of blocks loaded from disk tier
+    bvar::Adder<int64_t> diskHit;
+    bvar::Adder<int64_t> memUsedBytes;
+    bvar::Adder<int64_t> diskUsedBytes;
+    // number of blocks waiting to be written to disk tier
+    bvar::Adder<int64_t> diskPendingWrites;
+    bvar::PassiveStatus<double> hitRatio;
+
+    static double GetHitRatio(void* arg) {
+        ReadCacheMetric* metric = static_cast<ReadCacheMetric*>(arg);
+        int64_t hit = metric->hit.get_value();
+        int64_t total = hit + metric->miss.get_value();
+        return total == 0 ? 0 : static_cast<double>(hit) / total;
+    }
+};
+
 // 文件级别metric信息统计
 struct FileMetric {
     const std::string prefix = "curve_client";
@@ -136,6 +176,10 @@ struct FileMetric {
 
     DiscardMetric discardMetric;
 
+    SegmentPreallocMetric segmentPreallocMetric;
+
+    ReadCacheMetric readCacheMetric;
+
     explicit FileMetric(const std::string& name)
         : filename(name),
           inflightRPCNum(prefix, filename + "_inflight_rpc_num"),
@@ -149,7 +193,40 @@ struct FileMetric {
           userDiscard(prefix, filename + "_discard"),
           getLeaderRetryQPS(prefix, filename + "_get_leader_retry_rpc"),
           suspendRPCMetric(prefix, filename + "_suspend_io_num"),
-          discardMetric(prefix + filename) {}
+          discardMetric(prefix + filename),
+          segmentPreallocMetric(prefix + filename),
+          readCacheMetric(prefix + filename) {}
+};
+
+// chunkserver单条连接级别的metric信息统计
+struct ConnectionMetric {
+    const std::string prefix = "curve_client_chunkserver";
+
+    // 当前连接上未返回的rpc数量，同时用于连接选择
+    std::atomic<int64_t> inflight;
+    bvar::PassiveStatus<int64_t> inflightRPCNum;
+    // 当前连接上rpc的latency
+    bvar::LatencyRecorder rpcLatency;
+
+    explicit ConnectionMetric(const std::string& name)
+        : inflight(0),
+          inflightRPCNum(prefix, name + "_inflight_rpc_num",
+                         GetInflight, this),
+          rpcLatency(prefix, name + "_rpc_lat") {}
+
+    void OnRequest() {
+        inflight.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void OnResponse(int64_t latencyUs) {
+        inflight.fetch_sub(1, std::memory_order_relaxed);
+        rpcLatency << latencyUs;
+    }
+
+    static int64_t GetInflight(void* arg) {
+        return static_cast<ConnectionMetric*>(arg)->inflight.load(
+            std::memory_order_relaxed);
+    }
 };
 
 // 用于全局mds接口统计信息调用信息统计
@@ -174,6 +251,8 @@ struct MDSClientMetric {
     InterfaceMetric getServerList;
     // GetOrAllocateSegment接口统计信息
     InterfaceMetric getOrAllocateSegment;
+    // AllocateSegments接口统计信息
+    InterfaceMetric allocateSegments;
     // DeAllocateSegment接口统计信息
     InterfaceMetric deAllocateSegment;
     // RenameFile接口统计信息
@@ -211,6 +290,7 @@ struct MDSClientMetric {
           refreshSession(prefix, "refreshSession"),
           getServerList(prefix, "getServerList"),
           getOrAllocateSegment(prefix, "getOrAllocateSegment"),
+          allocateSegments(prefix, "allocateSegments"),
           deAllocateSegment(prefix, "deAllocateSegment"),
           renameFile(prefix, "renameFile"),
           extendFile(prefix, "extendFile"),
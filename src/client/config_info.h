@@ -156,9 +156,23 @@ struct FailureRequestOption {
  * @chunkserverEnableAppliedIndexRead: 是否开启使用appliedindex read
  * @inflightOpt: 一个文件向chunkserver发送请求时的inflight 请求控制配置
  * @failRequestOpt: rpc发送失败之后，需要进行rpc重试的相关配置
+ * @chunkserverConnectionNum: 与每个chunkserver建立的连接数，大于1时rpc会被
+ *                          分散到多条连接上，避免单条连接成为瓶颈
+ * @chunkserverConnectionLeastInflight: 为true时选择inflight rpc最少的连接，
+ *                          否则在连接之间轮询
+ * @chunkserverBatchWindowUS: 小的读写请求在该时间窗口内攒批，合并成一个
+ *                          BatchChunk rpc发送给chunkserver，为0时不攒批
+ * @chunkserverBatchMaxRequestNum: 一个BatchChunk rpc中最多的子请求数量，
+ *                          攒够之后不再等待时间窗口，立即发送
+ * @chunkserverBatchMaxRequestBytes: 不超过该大小的读写请求才会攒批
  */
 struct IOSenderOption {
     bool chunkserverEnableAppliedIndexRead;
+    uint32_t chunkserverConnectionNum = 1;
+    bool chunkserverConnectionLeastInflight = false;
+    uint64_t chunkserverBatchWindowUS = 0;
+    uint32_t chunkserverBatchMaxRequestNum = 16;
+    uint32_t chunkserverBatchMaxRequestBytes = 64 * 1024;
     InFlightIOCntlInfo inflightOpt;
     FailureRequestOption failRequestOpt;
 };
@@ -236,6 +250,27 @@ struct DiscardOption {
     uint32_t taskDelayMs = 1000 * 60;  // 1 min
 };
 
+// for segment pre-allocation of sequential writes
+struct SegmentPreallocOption {
+    uint32_t preallocSegmentNum = 0;  // 0 means disabled
+    uint32_t sequentialWriteThreshold = 8;
+};
+
+// for client side read cache, the cache belongs to one opened file, it
+// doesn't deduplicate reads of the same clone source from cloned volumes
+struct ReadCacheOption {
+    bool enable = false;
+    // cache granularity, only aligned blocks fully covered by a read
+    // are cached
+    uint32_t blockSize = 4096;
+    // capacities are for each opened file, not for the whole process, a
+    // process opening N files may use N times of them
+    uint64_t memCapacityMB = 256;
+    // disk tier is disabled if diskCacheDir is empty or diskCapacityMB is 0
+    std::string diskCacheDir;
+    uint64_t diskCapacityMB = 0;
+};
+
 /**
  * timed close fd thread in SourceReader config
  * @fdTimeout: sourcereader fd timeout
@@ -262,6 +297,8 @@ struct IOOption {
     CloseFdThreadOption closeFdThreadOption;
     ThrottleOption throttleOption;
     DiscardOption discardOption;
+    SegmentPreallocOption segmentPreallocOpt;
+    ReadCacheOption readCacheOpt;
 };
 
 /**
@@ -33,6 +33,7 @@
 #include "src/client/client_common.h"
 #include "src/client/client_metric.h"
 #include "src/client/config_info.h"
+#include "src/client/dmclock_tracker.h"
 #include "src/client/request_context.h"
 #include "src/client/request_sender_manager.h"
 #include "src/common/concurrent/concurrent.h"
@@ -211,6 +212,13 @@ class CopysetClient {
         }
     }
 
+    /**
+     * 返回当前文件的dmClock qos计数，用于生成读写请求的delta/rho
+     */
+    DmClockTracker* GetDmClockTracker() {
+        return &dmclockTracker_;
+    }
+
  private:
     friend class WriteChunkClosure;
     friend class ReadChunkClosure;
@@ -253,6 +261,9 @@ class CopysetClient {
 
     // 是否在停止状态中，如果是在关闭过程中且session失效，需要将rpc直接返回不下发
     bool exitFlag_;
+
+    // 当前文件在各个chunkserver上完成的请求数，用于chunkserver的qos调度
+    DmClockTracker dmclockTracker_;
 };
 
 }   // namespace client
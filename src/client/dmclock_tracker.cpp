@@ -0,0 +1,79 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include "src/client/dmclock_tracker.h"
+
+#include <algorithm>
+#include <climits>
+#include <mutex>  // NOLINT
+
+namespace curve {
+namespace client {
+
+// 与chunkserver上QosPhase::RESERVATION一致
+static const int32_t kReservationPhase = 0;
+
+void DmClockTracker::PrepareRequest(ChunkServerID csId,
+                                    QosRequestParas* paras) {
+    std::lock_guard<bthread::Mutex> lk(mtx_);
+    uint64_t delta = 1;
+    uint64_t rho = 1;
+    auto iter = servers_.find(csId);
+    if (iter == servers_.end()) {
+        // 第一次向该chunkserver发送请求
+        iter = servers_.emplace(csId, ServerRecord()).first;
+    } else {
+        const ServerRecord& record = iter->second;
+        delta += deltaCounter_ - record.prevDelta - record.ownDelta;
+        rho += rhoCounter_ - record.prevRho - record.ownRho;
+    }
+    ServerRecord& record = iter->second;
+    record.prevDelta = deltaCounter_;
+    record.prevRho = rhoCounter_;
+    record.ownDelta = 0;
+    record.ownRho = 0;
+
+    paras->set_dmclockdelta(static_cast<int32_t>(
+        std::min<uint64_t>(delta, INT32_MAX)));
+    paras->set_dmclockrho(static_cast<int32_t>(
+        std::min<uint64_t>(rho, INT32_MAX)));
+}
+
+void DmClockTracker::OnResponse(ChunkServerID csId,
+                                const QosResponseParas& paras) {
+    std::lock_guard<bthread::Mutex> lk(mtx_);
+    bool reservation = paras.phase() == kReservationPhase;
+    ++deltaCounter_;
+    if (reservation) {
+        ++rhoCounter_;
+    }
+    auto iter = servers_.find(csId);
+    if (iter != servers_.end()) {
+        ++iter->second.ownDelta;
+        if (reservation) {
+            ++iter->second.ownRho;
+        }
+    }
+}
+
+}  // namespace client
+}  // namespace curve
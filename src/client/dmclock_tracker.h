@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_CLIENT_DMCLOCK_TRACKER_H_
+#define SRC_CLIENT_DMCLOCK_TRACKER_H_
+
+#include <bthread/mutex.h>
+
+#include <cstdint>
+#include <unordered_map>
+
+#include "proto/chunk.pb.h"
+#include "src/client/client_common.h"
+
+namespace curve {
+namespace client {
+
+using curve::chunkserver::QosRequestParas;
+using curve::chunkserver::QosResponseParas;
+
+// 记录一个卷在各个chunkserver上完成的请求数，生成dmClock的delta/rho
+// delta: 自上次向该chunkserver发送请求以来，卷在其它chunkserver上完成的
+//        请求数加1
+// rho: 同上，但只统计在reservation阶段完成的请求
+// chunkserver根据delta/rho计算标签，使保底、权重和上限作用于整个卷
+class DmClockTracker {
+ public:
+    DmClockTracker()
+        : deltaCounter_(0),
+          rhoCounter_(0) {}
+
+    DmClockTracker(const DmClockTracker&) = delete;
+    DmClockTracker& operator=(const DmClockTracker&) = delete;
+
+    /**
+     * 生成发往chunkserver的请求的delta/rho
+     * @param csId: 请求发往的chunkserver
+     * @param paras[out]: 请求的qos参数
+     */
+    void PrepareRequest(ChunkServerID csId, QosRequestParas* paras);
+
+    /**
+     * 请求返回时记录chunkserver调度该请求的阶段
+     * @param csId: 返回请求的chunkserver
+     * @param paras: 返回的qos参数
+     */
+    void OnResponse(ChunkServerID csId, const QosResponseParas& paras);
+
+ private:
+    struct ServerRecord {
+        // 上次发送请求时的全局计数
+        uint64_t prevDelta = 0;
+        uint64_t prevRho = 0;
+        // 上次发送请求之后，在该chunkserver上完成的请求数
+        uint64_t ownDelta = 0;
+        uint64_t ownRho = 0;
+    };
+
+    bthread::Mutex mtx_;
+    // 卷在所有chunkserver上完成的请求数
+    uint64_t deltaCounter_;
+    // 卷在所有chunkserver上reservation阶段完成的请求数
+    uint64_t rhoCounter_;
+    std::unordered_map<ChunkServerID, ServerRecord> servers_;
+};
+
+}  // namespace client
+}  // namespace curve
+
+#endif  // SRC_CLIENT_DMCLOCK_TRACKER_H_
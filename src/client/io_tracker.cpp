@@ -35,6 +35,7 @@
 #include "src/client/source_reader.h"
 #include "src/client/metacache_struct.h"
 #include "src/client/discard_task.h"
+#include "src/client/read_cache.h"
 
 namespace curve {
 namespace client {
@@ -53,7 +54,9 @@ IOTracker::IOTracker(IOManager* iomanager,
       iomanager_(iomanager),
       scheduler_(scheduler),
       fileMetric_(clientMetric),
-      disableStripe_(disableStripe) {
+      disableStripe_(disableStripe),
+      readCache_(nullptr),
+      readCacheToken_(0) {
     id_         = tracekerID_.fetch_add(1, std::memory_order_relaxed);
     scc_        = nullptr;
     aioctx_     = nullptr;
@@ -464,6 +467,11 @@ void IOTracker::Done() {
         ReleaseAllSegmentLocks();
     }
 
+    if (readCache_ != nullptr &&
+        (type_ == OpType::WRITE || type_ == OpType::DISCARD)) {
+        readCache_->OnWriteDone();
+    }
+
     if (errcode_ == LIBCURVE_ERROR::OK) {
         uint64_t duration = TimeUtility::GetTimeofDayUs() - opStartTimePoint_;
         MetricHelper::UserLatencyRecord(fileMetric_, duration, type_);
@@ -476,6 +484,10 @@ void IOTracker::Done() {
                 readData.append(buf);
             }
 
+            if (readCache_ != nullptr && type_ == OpType::READ) {
+                readCache_->Put(readCacheToken_, offset_, readData);
+            }
+
             switch (userDataType_) {
                 case UserDataType::RawBuffer: {
                     size_t nc = readData.copy_to(data_, readData.size());
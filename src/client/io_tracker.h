@@ -48,6 +48,7 @@ using curve::common::Throttle;
 class IOManager;
 class FileSegment;
 class DiscardTaskManager;
+class ReadCache;
 
 // IOTracker用于跟踪一个用户IO，因为一个用户IO可能会跨chunkserver，
 // 因此在真正下发的时候会被拆分成多个小IO并发的向下发送，因此我们需要
@@ -207,6 +208,17 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
         userDataType_ = dataType;
     }
 
+    /**
+     * @brief set read cache of current file, read data is filled into
+     *        the cache and write/discard notify the cache when finished
+     * @param readCache read cache of current file
+     * @param token returned by ReadCache::BeginRead, only used by read
+     */
+    void SetReadCache(ReadCache* readCache, uint64_t token) {
+        readCache_ = readCache;
+        readCacheToken_ = token;
+    }
+
     /**
      * @brief prepare space to store read data
      * @param subIoCount #space to store read data
@@ -357,6 +369,10 @@ class CURVE_CACHELINE_ALIGNMENT IOTracker {
 
     bool disableStripe_;
 
+    // read cache of current file, nullptr if read cache is disabled
+    ReadCache* readCache_;
+    uint64_t readCacheToken_;
+
     // read/write operations will hold segment's read lock,
     // so store corresponding segment lock and release after operations finished
     std::vector<FileSegment*> segmentLocks_;
@@ -21,14 +21,17 @@
  */
 
 #include <glog/logging.h>
+#include <unistd.h>
 
 #include <chrono>   // NOLINT
+#include <string>
 
 #include "src/client/metacache.h"
 #include "src/client/iomanager4file.h"
 #include "src/client/file_instance.h"
 #include "src/client/io_tracker.h"
 #include "src/client/splitor.h"
+#include "src/common/timeutility.h"
 
 namespace curve {
 namespace client {
@@ -87,6 +90,17 @@ bool IOManager4File::Initialize(const std::string& filename,
     discardTaskManager_.reset(
         new DiscardTaskManager(&(fileMetric_->discardMetric)));
 
+    segmentPreallocator_.reset(new SegmentPreallocator(
+        ioopt_.segmentPreallocOpt, &mc_, mdsclient,
+        &(fileMetric_->segmentPreallocMetric)));
+
+    if (ioopt_.readCacheOpt.enable) {
+        readCache_.reset(new ReadCache(ioopt_.readCacheOpt,
+                                       &(fileMetric_->readCacheMetric)));
+        readCache_->Init("curve_read_cache_" + std::to_string(getpid()) +
+                         "_" + std::to_string(id_));
+    }
+
     LOG(INFO) << "iomanager init success, conf info: "
               << "isolationTaskThreadPoolSize = "
               << ioopt_.taskThreadOpt.isolationTaskThreadPoolSize
@@ -126,6 +140,8 @@ void IOManager4File::UnInitialize() {
     }
 
     discardTaskManager_->Stop();
+    segmentPreallocator_->Stop();
+    readCache_.reset();
 
     {
         // 这个锁保证设置exit_和delete scheduler_是原子的
@@ -145,10 +161,17 @@ int IOManager4File::Read(char* buf, off_t offset,
     MetricHelper::IncremUserRPSCount(fileMetric_, OpType::READ);
     FlightIOGuard guard(this);
 
+    if (ReadFromCache(buf, offset, length, UserDataType::RawBuffer)) {
+        return static_cast<int>(length);
+    }
+
     butil::IOBuf data;
 
     IOTracker temp(this, &mc_, scheduler_, fileMetric_, disableStripe_);
     temp.SetUserDataType(UserDataType::IOBuffer);
+    if (readCache_) {
+        temp.SetReadCache(readCache_.get(), readCache_->BeginRead());
+    }
     temp.StartRead(&data, offset, length, mdsclient, this->GetFileInfo(),
                    throttle_.get());
 
@@ -169,11 +192,17 @@ int IOManager4File::Write(const char* buf,
     MetricHelper::IncremUserRPSCount(fileMetric_, OpType::WRITE);
     FlightIOGuard guard(this);
 
+    segmentPreallocator_->OnWrite(offset, length);
+
     butil::IOBuf data;
     data.append_user_data(const_cast<char*>(buf), length, TrivialDeleter);
 
     IOTracker temp(this, &mc_, scheduler_, fileMetric_, disableStripe_);
     temp.SetUserDataType(UserDataType::IOBuffer);
+    if (readCache_) {
+        readCache_->OnWriteStart(offset, length);
+        temp.SetReadCache(readCache_.get(), 0);
+    }
     temp.StartWrite(&data, offset, length, mdsclient, this->GetFileInfo(),
                     throttle_.get());
 
@@ -196,7 +225,17 @@ int IOManager4File::AioRead(CurveAioContext* ctx, MDSClient* mdsclient,
 
     temp->SetUserDataType(dataType);
     inflightCntl_.IncremInflightNum();
-    auto task = [this, ctx, mdsclient, temp]() {
+    auto task = [this, ctx, mdsclient, temp, dataType]() {
+        if (ReadFromCache(ctx->buf, ctx->offset, ctx->length, dataType)) {
+            ctx->ret = ctx->length;
+            ctx->cb(ctx);
+            HandleAsyncIOResponse(temp);
+            return;
+        }
+
+        if (readCache_) {
+            temp->SetReadCache(readCache_.get(), readCache_->BeginRead());
+        }
         temp->StartAioRead(ctx, mdsclient, this->GetFileInfo(),
                            throttle_.get());
     };
@@ -218,6 +257,12 @@ int IOManager4File::AioWrite(CurveAioContext* ctx, MDSClient* mdsclient,
         return LIBCURVE_ERROR::OK;
     }
 
+    segmentPreallocator_->OnWrite(ctx->offset, ctx->length);
+    if (readCache_) {
+        readCache_->OnWriteStart(ctx->offset, ctx->length);
+        temp->SetReadCache(readCache_.get(), 0);
+    }
+
     temp->SetUserDataType(dataType);
     inflightCntl_.IncremInflightNum();
     auto task = [this, ctx, mdsclient, temp]() {
@@ -239,6 +284,10 @@ int IOManager4File::Discard(off_t offset, size_t length, MDSClient* mdsclient) {
     FlightIOGuard guard(this);
 
     IOTracker tracker(this, &mc_, scheduler_, fileMetric_);
+    if (readCache_) {
+        readCache_->OnWriteStart(offset, length);
+        tracker.SetReadCache(readCache_.get(), 0);
+    }
     tracker.StartDiscard(offset, length, mdsclient, GetFileInfo(),
                          discardTaskManager_.get());
     return tracker.Wait();
@@ -263,6 +312,11 @@ int IOManager4File::AioDiscard(CurveAioContext* aioctx, MDSClient* mdsclient) {
         return LIBCURVE_ERROR::OK;
     }
 
+    if (readCache_) {
+        readCache_->OnWriteStart(aioctx->offset, aioctx->length);
+        ioTracker->SetReadCache(readCache_.get(), 0);
+    }
+
     inflightCntl_.IncremInflightNum();
     auto task = [this, aioctx, mdsclient, ioTracker]() {
         ioTracker->StartAioDiscard(aioctx, mdsclient, this->GetFileInfo(),
@@ -302,6 +356,33 @@ bool IOManager4File::IsNeedDiscard(size_t len) const {
     return false;
 }
 
+bool IOManager4File::ReadFromCache(void* buf, off_t offset, size_t length,
+                                   UserDataType dataType) {
+    if (!readCache_) {
+        return false;
+    }
+
+    uint64_t startUs = common::TimeUtility::GetTimeofDayUs();
+    bool hit = false;
+    switch (dataType) {
+        case UserDataType::RawBuffer:
+            hit = readCache_->Get(offset, length, static_cast<char*>(buf));
+            break;
+        case UserDataType::IOBuffer:
+            hit = readCache_->Get(offset, length,
+                                  static_cast<butil::IOBuf*>(buf));
+            break;
+    }
+
+    if (hit) {
+        MetricHelper::UserLatencyRecord(
+            fileMetric_, common::TimeUtility::GetTimeofDayUs() - startUs,
+            OpType::READ);
+        MetricHelper::IncremUserQPSCount(fileMetric_, length, OpType::READ);
+    }
+    return hit;
+}
+
 void IOManager4File::LeaseTimeoutBlockIO() {
     std::unique_lock<std::mutex> lk(exitMtx_);
     if (exit_ == false) {
@@ -43,6 +43,8 @@
 #include "src/common/concurrent/task_thread_pool.h"
 #include "src/common/throttle.h"
 #include "src/client/discard_task.h"
+#include "src/client/segment_preallocator.h"
+#include "src/client/read_cache.h"
 
 namespace curve {
 namespace client {
@@ -252,6 +254,13 @@ class IOManager4File : public IOManager {
 
     bool IsNeedDiscard(size_t len) const;
 
+    /**
+     * 从读缓存中读取数据
+     * @return: 读缓存开启且数据全部命中时返回true
+     */
+    bool ReadFromCache(void* buf, off_t offset, size_t length,
+                       UserDataType dataType);
+
  private:
     // 每个IOManager都有其IO配置，保存在iooption里
     IOOption ioopt_;
@@ -298,6 +307,12 @@ class IOManager4File : public IOManager {
     bool disableStripe_;
 
     std::unique_ptr<DiscardTaskManager> discardTaskManager_;
+
+    // 顺序写时提前分配后面的segment
+    std::unique_ptr<SegmentPreallocator> segmentPreallocator_;
+
+    // 读缓存，没有开启时为nullptr
+    std::unique_ptr<ReadCache> readCache_;
 };
 
 }  // namespace client
@@ -45,6 +45,26 @@ using curve::mds::StatusCode;
 using curve::mds::topology::ChunkServerLocation;
 using curve::mds::topology::CopySetServerInfo;
 
+namespace {
+
+void PageFileSegment2SegmentInfo(const PageFileSegment& pfs,
+                                 SegmentInfo* segInfo) {
+    segInfo->chunksize = pfs.chunksize();
+    segInfo->segmentsize = pfs.segmentsize();
+    segInfo->startoffset = pfs.startoffset();
+    LogicPoolID logicpoolid = pfs.logicalpoolid();
+    segInfo->lpcpIDInfo.lpid = logicpoolid;
+
+    for (int i = 0; i < pfs.chunks_size(); i++) {
+        ChunkID chunkid = pfs.chunks(i).chunkid();
+        CopysetID copysetid = pfs.chunks(i).copysetid();
+        segInfo->lpcpIDInfo.cpidVec.push_back(copysetid);
+        segInfo->chunkvec.emplace_back(chunkid, logicpoolid, copysetid);
+    }
+}
+
+}  // namespace
+
 MDSClient::MDSClient(const std::string& metricPrefix)
     : inited_(false),
       metaServerOpt_(),
@@ -923,31 +943,68 @@ LIBCURVE_ERROR MDSClient::GetOrAllocateSegment(bool allocate,
             default: break;
         }
 
-        PageFileSegment pfs = response.pagefilesegment();
-        segInfo->chunksize = pfs.chunksize();
-        segInfo->segmentsize = pfs.segmentsize();
-        segInfo->startoffset = pfs.startoffset();
-        LogicPoolID logicpoolid = pfs.logicalpoolid();
-        segInfo->lpcpIDInfo.lpid = pfs.logicalpoolid();
-
-        int chunksNum = pfs.chunks_size();
-        if (allocate && chunksNum <= 0) {
+        const PageFileSegment& pfs = response.pagefilesegment();
+        if (allocate && pfs.chunks_size() <= 0) {
             LOG(WARNING) << "MDS allocate segment, but no chunkinfo!";
             // Now, we will retry until allocate segment success
             return -LIBCURVE_ERROR::RETRY_UNTIL_SUCCESS;
         }
 
-        for (int i = 0; i < chunksNum; i++) {
-            ChunkID chunkid = pfs.chunks(i).chunkid();
-            CopysetID copysetid = pfs.chunks(i).copysetid();
-            segInfo->lpcpIDInfo.cpidVec.push_back(copysetid);
-            segInfo->chunkvec.emplace_back(chunkid, logicpoolid, copysetid);
-        }
+        PageFileSegment2SegmentInfo(pfs, segInfo);
         return LIBCURVE_ERROR::OK;
     };
     return rpcExcutor.DoRPCTask(task, metaServerOpt_.mdsMaxRetryMsInIOPath);
 }
 
+LIBCURVE_ERROR MDSClient::AllocateSegments(const FInfo_t* fi,
+                                           uint64_t offset,
+                                           uint32_t segmentNum,
+                                           std::vector<SegmentInfo>* segInfos) {
+    auto task = RPCTaskDefine {
+        AllocateSegmentsResponse response;
+        mdsClientMetric_.allocateSegments.qps.count << 1;
+        LatencyGuard lg(&mdsClientMetric_.allocateSegments.latency);
+        MDSClientBase::AllocateSegments(fi, offset, segmentNum,
+                                        &response, cntl, channel);
+        if (cntl->Failed()) {
+            mdsClientMetric_.allocateSegments.eps.count << 1;
+            LOG(WARNING) << "allocate segments failed, error code = "
+                         << cntl->ErrorCode()
+                         << ", error content:" << cntl->ErrorText()
+                         << ", offset:" << offset;
+            // 老版本的mds没有该接口
+            if (cntl->ErrorCode() == brpc::ENOMETHOD) {
+                return LIBCURVE_ERROR::NOT_SUPPORT;
+            }
+            return -cntl->ErrorCode();
+        }
+
+        auto statuscode = response.statuscode();
+        if (statuscode != StatusCode::kOK) {
+            LOG(WARNING) << "AllocateSegments return error, filename = "
+                         << fi->fullPathName << ", offset = " << offset
+                         << ", segment num = " << segmentNum
+                         << ", error msg = " << StatusCode_Name(statuscode);
+            LIBCURVE_ERROR errCode;
+            MDSStatusCode2LibcurveError(statuscode, &errCode);
+            return errCode;
+        }
+
+        segInfos->clear();
+        for (const auto& pfs : response.pagefilesegments()) {
+            if (pfs.chunks_size() <= 0) {
+                LOG(WARNING) << "MDS allocate segment, but no chunkinfo!"
+                             << ", offset = " << pfs.startoffset();
+                break;
+            }
+            segInfos->emplace_back();
+            PageFileSegment2SegmentInfo(pfs, &segInfos->back());
+        }
+        return LIBCURVE_ERROR::OK;
+    };
+    return rpcExcutor.DoRPCTask(task, metaServerOpt_.mdsMaxRetryMS);
+}
+
 LIBCURVE_ERROR MDSClient::DeAllocateSegment(const FInfo* fileInfo,
                                             uint64_t offset) {
     auto task = RPCTaskDefine {
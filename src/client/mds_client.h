@@ -99,9 +99,10 @@ class MDSClient : public MDSClientBase,
      * @param: cpinfoVec保存获取到的server信息
      * @return: 成功返回LIBCURVE_ERROR::OK,否则返回LIBCURVE_ERROR::FAILED
      */
-    LIBCURVE_ERROR GetServerList(const LogicPoolID& logicPoolId,
-                                 const std::vector<CopysetID>& csid,
-                                 std::vector<CopysetInfo>* cpinfoVec);
+    virtual LIBCURVE_ERROR GetServerList(
+        const LogicPoolID& logicPoolId,
+        const std::vector<CopysetID>& csid,
+        std::vector<CopysetInfo>* cpinfoVec);
 
     /**
      * 获取当前mds所属的集群信息
@@ -124,6 +125,21 @@ class MDSClient : public MDSClientBase,
                                         const FInfo_t* fi,
                                         SegmentInfo* segInfo);
 
+    /**
+     * 从offset所在的segment开始连续分配多个segment，已经分配的直接返回
+     * @param: fi是当前文件的基本信息
+     * @param: offset为文件整体偏移
+     * @param: segmentNum为分配的segment数量
+     * @param[out]: segInfos按偏移顺序返回各个segment的chunk信息，
+     *              超出文件长度或者mds分配失败的部分不返回
+     * @return: 成功返回LIBCURVE_ERROR::OK，mds不支持该接口时返回
+     *          LIBCURVE_ERROR::NOT_SUPPORT，否则返回LIBCURVE_ERROR::FAILED
+     */
+    virtual LIBCURVE_ERROR AllocateSegments(const FInfo_t* fi,
+                                            uint64_t offset,
+                                            uint32_t segmentNum,
+                                            std::vector<SegmentInfo>* segInfos);
+
     /**
      * @brief Send DeAllocateSegment request to current working MDS
      * @param fileInfo current file info
@@ -372,6 +372,30 @@ void MDSClientBase::GetOrAllocateSegment(bool allocate,
     stub.GetOrAllocateSegment(cntl, &request, response, NULL);
 }
 
+void MDSClientBase::AllocateSegments(const FInfo_t* fi,
+                                     uint64_t offset,
+                                     uint32_t segmentNum,
+                                     AllocateSegmentsResponse* response,
+                                     brpc::Controller* cntl,
+                                     brpc::Channel* channel) {
+    AllocateSegmentsRequest request;
+
+    uint64_t seg_offset = (offset / fi->segmentsize) * fi->segmentsize;
+    request.set_filename(fi->fullPathName);
+    request.set_offset(seg_offset);
+    request.set_segmentnum(segmentNum);
+    FillUserInfo(&request, fi->userinfo);
+
+    LOG(INFO) << "AllocateSegments: filename = " << fi->fullPathName
+              << ", owner = " << fi->owner << ", offset = " << offset
+              << ", segment offset = " << seg_offset
+              << ", segment num = " << segmentNum
+              << ", log id = " << cntl->log_id();
+
+    curve::mds::CurveFSService_Stub stub(channel);
+    stub.AllocateSegments(cntl, &request, response, NULL);
+}
+
 void MDSClientBase::DeAllocateSegment(const FInfo* fileInfo,
                                       uint64_t segmentOffset,
                                       DeAllocateSegmentResponse* response,
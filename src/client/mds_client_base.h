@@ -70,6 +70,8 @@ using curve::mds::SetCloneFileStatusRequest;
 using curve::mds::SetCloneFileStatusResponse;
 using curve::mds::GetOrAllocateSegmentRequest;
 using curve::mds::GetOrAllocateSegmentResponse;
+using curve::mds::AllocateSegmentsRequest;
+using curve::mds::AllocateSegmentsResponse;
 using curve::mds::DeAllocateSegmentRequest;
 using curve::mds::DeAllocateSegmentResponse;
 using curve::mds::CheckSnapShotStatusRequest;
@@ -327,6 +329,22 @@ class MDSClientBase {
                               brpc::Controller* cntl,
                               brpc::Channel* channel);
 
+    /**
+     * 从offset所在的segment开始连续分配多个segment
+     * @param: fi是当前文件的基本信息
+     * @param: offset为文件整体偏移
+     * @param: segmentNum为分配的segment数量
+     * @param[out]: response为该rpc的response，提供给外部处理
+     * @param[in|out]: cntl既是入参，也是出参，返回RPC状态
+     * @param[in]:channel是当前与mds建立的通道
+     */
+    void AllocateSegments(const FInfo_t* fi,
+                          uint64_t offset,
+                          uint32_t segmentNum,
+                          AllocateSegmentsResponse* response,
+                          brpc::Controller* cntl,
+                          brpc::Channel* channel);
+
     void DeAllocateSegment(const FInfo* fileInfo, uint64_t segmentOffset,
                            DeAllocateSegmentResponse* response,
                            brpc::Controller* cntl, brpc::Channel* channel);
@@ -55,36 +55,55 @@ void MetaCache::Init(const MetaCacheOption& metaCacheOpt,
     unstableHelper_.Init(metacacheopt_.chunkserverUnstableOption);
 }
 
+void MetaCache::CopysetCacheEntry::PublishLeader() {
+    CachedLeaderInfo cached;
+    ChunkServerID leaderId = 0;
+    EndPoint leaderAddr;
+    if (info.GetLeaderInfo(&leaderId, &leaderAddr) == 0) {
+        cached.valid = true;
+        cached.id = leaderId;
+        cached.ip = butil::ip2int(leaderAddr.ip);
+        cached.port = leaderAddr.port;
+    }
+    leader.Store(cached);
+}
+
 MetaCacheErrorType MetaCache::GetChunkInfoByIndex(ChunkIndex chunkidx,
                                                   ChunkIDInfo* chunxinfo) {
-    ReadLockGuard rdlk(rwlock4ChunkInfo_);
-    auto iter = chunkindex2idMap_.find(chunkidx);
-    if (iter != chunkindex2idMap_.end()) {
-        *chunxinfo = iter->second;
-        return MetaCacheErrorType::OK;
+    const ChunkIndexBlock* block =
+        chunkIndexBlocks_.Find(chunkidx >> kChunkIndexBlockShift);
+    if (block != nullptr) {
+        CachedChunkIDInfo cached =
+            block->chunks[chunkidx & (kChunkIndexBlockSize - 1)].Load();
+        if (cached.cached) {
+            *chunxinfo = cached.info;
+            return MetaCacheErrorType::OK;
+        }
     }
     return MetaCacheErrorType::CHUNKINFO_NOT_FOUND;
 }
 
 void MetaCache::UpdateChunkInfoByIndex(ChunkIndex cindex,
                                        const ChunkIDInfo& cinfo) {
+    CachedChunkIDInfo cached;
+    cached.info = cinfo;
+    cached.cached = true;
+
     WriteLockGuard wrlk(rwlock4ChunkInfo_);
-    chunkindex2idMap_[cindex] = cinfo;
+    ChunkIndexBlock* block =
+        chunkIndexBlocks_.FindOrInsert(cindex >> kChunkIndexBlockShift);
+    block->chunks[cindex & (kChunkIndexBlockSize - 1)].Store(cached);
 }
 
 bool MetaCache::IsLeaderMayChange(LogicPoolID logicPoolId,
                                   CopysetID copysetId) {
-    rwlock4ChunkInfo_.RDLock();
-    auto iter = lpcsid2CopsetInfoMap_.find(
-        CalcLogicPoolCopysetID(logicPoolId, copysetId));
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
-        rwlock4ChunkInfo_.Unlock();
+    const CopysetCacheEntry* entry =
+        copysets_.Find(CalcLogicPoolCopysetID(logicPoolId, copysetId));
+    if (entry == nullptr) {
         return false;
     }
 
-    bool flag = iter->second.LeaderMayChange();
-    rwlock4ChunkInfo_.Unlock();
-    return flag;
+    return entry->info.LeaderMayChange();
 }
 
 int MetaCache::GetLeader(LogicPoolID logicPoolId,
@@ -95,17 +114,29 @@ int MetaCache::GetLeader(LogicPoolID logicPoolId,
                          FileMetric* fm) {
     const auto key = CalcLogicPoolCopysetID(logicPoolId, copysetId);
 
-    CopysetInfo targetInfo;
-    rwlock4CopysetInfo_.RDLock();
-    auto iter = lpcsid2CopsetInfoMap_.find(key);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
-        rwlock4CopysetInfo_.Unlock();
+    CopysetCacheEntry* entry = copysets_.Find(key);
+    if (entry == nullptr) {
         LOG(ERROR) << "server list not exist, LogicPoolID = " << logicPoolId
                    << ", CopysetID = " << copysetId;
         return -1;
     }
-    targetInfo = iter->second;
-    rwlock4CopysetInfo_.Unlock();
+
+    // leader不需要刷新时直接读取leader快照，不加锁
+    if (!refresh && !entry->info.LeaderMayChange()) {
+        CachedLeaderInfo leader = entry->leader.Load();
+        if (!leader.valid) {
+            return -1;
+        }
+        *serverId = leader.id;
+        *serverAddr = EndPoint(butil::int2ip(leader.ip), leader.port);
+        return 0;
+    }
+
+    CopysetInfo targetInfo;
+    {
+        ReadLockGuard rdlk(rwlock4CopysetInfo_);
+        targetInfo = entry->info;
+    }
 
     int ret = 0;
     if (refresh || targetInfo.LeaderMayChange()) {
@@ -238,12 +269,12 @@ CopysetInfo MetaCache::GetServerList(LogicPoolID logicPoolId,
     CopysetInfo ret;
 
     ReadLockGuard rdlk(rwlock4CopysetInfo_);
-    auto iter = lpcsid2CopsetInfoMap_.find(key);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
+    const CopysetCacheEntry* entry = copysets_.Find(key);
+    if (entry == nullptr) {
         // it's impossible to get here
         return ret;
     }
-    return iter->second;
+    return entry->info;
 }
 
 /**
@@ -256,22 +287,26 @@ int MetaCache::UpdateLeader(LogicPoolID logicPoolId,
                             const EndPoint& leaderAddr) {
     const auto key = CalcLogicPoolCopysetID(logicPoolId, copysetId);
 
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
-    auto iter = lpcsid2CopsetInfoMap_.find(key);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
+    WriteLockGuard wrlk(rwlock4CopysetInfo_);
+    CopysetCacheEntry* entry = copysets_.Find(key);
+    if (entry == nullptr) {
         // it's impossible to get here
         return -1;
     }
 
     ChunkServerAddr csAddr(leaderAddr);
-    return iter->second.UpdateLeaderInfo(csAddr);
+    int ret = entry->info.UpdateLeaderInfo(csAddr);
+    entry->PublishLeader();
+    return ret;
 }
 
 void MetaCache::UpdateCopysetInfo(LogicPoolID logicPoolid, CopysetID copysetid,
                                   const CopysetInfo& csinfo) {
     const auto key = CalcLogicPoolCopysetID(logicPoolid, copysetid);
     WriteLockGuard wrlk(rwlock4CopysetInfo_);
-    lpcsid2CopsetInfoMap_[key] = csinfo;
+    CopysetCacheEntry* entry = copysets_.FindOrInsert(key);
+    entry->info = csinfo;
+    entry->PublishLeader();
 }
 
 void MetaCache::UpdateAppliedIndex(LogicPoolID logicPoolId,
@@ -279,26 +314,24 @@ void MetaCache::UpdateAppliedIndex(LogicPoolID logicPoolId,
                                    uint64_t appliedindex) {
     const auto key = CalcLogicPoolCopysetID(logicPoolId, copysetId);
 
-    ReadLockGuard wrlk(rwlock4CopysetInfo_);
-    auto iter = lpcsid2CopsetInfoMap_.find(key);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
+    CopysetCacheEntry* entry = copysets_.Find(key);
+    if (entry == nullptr) {
         return;
     }
 
-    iter->second.UpdateAppliedIndex(appliedindex);
+    entry->info.UpdateAppliedIndex(appliedindex);
 }
 
 uint64_t MetaCache::GetAppliedIndex(LogicPoolID logicPoolId,
                                     CopysetID copysetId) {
     const auto key = CalcLogicPoolCopysetID(logicPoolId, copysetId);
 
-    ReadLockGuard rdlk(rwlock4CopysetInfo_);
-    auto iter = lpcsid2CopsetInfoMap_.find(key);
-    if (iter == lpcsid2CopsetInfoMap_.end()) {
+    const CopysetCacheEntry* entry = copysets_.Find(key);
+    if (entry == nullptr) {
         return 0;
     }
 
-    return iter->second.GetAppliedIndex();
+    return entry->info.GetAppliedIndex();
 }
 
 void MetaCache::UpdateChunkInfoByID(ChunkID cid, const ChunkIDInfo& cidinfo) {
@@ -338,17 +371,17 @@ void MetaCache::SetChunkserverUnstable(ChunkServerID csid) {
     ReadLockGuard rdlk(rwlock4CopysetInfo_);
     for (auto it : copysetIDSet) {
         const auto key = CalcLogicPoolCopysetID(it.lpid, it.cpid);
-        auto cpinfo = lpcsid2CopsetInfoMap_.find(key);
-        if (cpinfo != lpcsid2CopsetInfoMap_.end()) {
+        CopysetCacheEntry* entry = copysets_.Find(key);
+        if (entry != nullptr) {
             ChunkServerID leaderid;
-            if (cpinfo->second.GetCurrentLeaderServerID(&leaderid)) {
+            if (entry->info.GetCurrentLeaderServerID(&leaderid)) {
                 if (leaderid == csid) {
                     // 只设置leaderid为当前serverid的Lcopyset
-                    cpinfo->second.SetLeaderUnstableFlag();
+                    entry->info.SetLeaderUnstableFlag();
                 }
             } else {
                 // 当前copyset集群信息未知，直接设置LeaderUnStable
-                cpinfo->second.SetLeaderUnstableFlag();
+                entry->info.SetLeaderUnstableFlag();
             }
         }
     }
@@ -365,13 +398,13 @@ void MetaCache::UpdateChunkserverCopysetInfo(LogicPoolID lpid,
     ReadLockGuard rdlk(rwlock4CopysetInfo_);
     const auto key = CalcLogicPoolCopysetID(lpid, cpinfo.cpid_);
     // 先获取原来的chunkserver到copyset映射
-    auto previouscpinfo = lpcsid2CopsetInfoMap_.find(key);
-    if (previouscpinfo != lpcsid2CopsetInfoMap_.end()) {
+    const CopysetCacheEntry* previous = copysets_.Find(key);
+    if (previous != nullptr) {
         std::vector<ChunkServerID> newID;
         std::vector<ChunkServerID> changedID;
 
         // 先判断当前copyset有没有变更chunkserverid
-        for (auto iter : previouscpinfo->second.csinfos_) {
+        for (auto iter : previous->info.csinfos_) {
             changedID.push_back(iter.chunkserverID);
         }
 
@@ -407,43 +440,42 @@ void MetaCache::UpdateChunkserverCopysetInfo(LogicPoolID lpid,
 CopysetInfo MetaCache::GetCopysetinfo(LogicPoolID lpid, CopysetID csid) {
     ReadLockGuard rdlk(rwlock4CopysetInfo_);
     const auto key = CalcLogicPoolCopysetID(lpid, csid);
-    auto cpinfo = lpcsid2CopsetInfoMap_.find(key);
-    if (cpinfo != lpcsid2CopsetInfoMap_.end()) {
-        return cpinfo->second;
+    const CopysetCacheEntry* entry = copysets_.Find(key);
+    if (entry != nullptr) {
+        return entry->info;
     }
     return CopysetInfo();
 }
 
 FileSegment* MetaCache::GetFileSegment(SegmentIndex segmentIndex) {
-    {
-        ReadLockGuard lk(rwlock4Segments_);
-        auto iter = segments_.find(segmentIndex);
-        if (iter != segments_.end()) {
-            return &iter->second;
-        }
+    FileSegment* segment = segments_.Find(segmentIndex);
+    if (segment != nullptr) {
+        return segment;
     }
 
     WriteLockGuard lk(rwlock4Segments_);
-    auto ret = segments_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(segmentIndex),
-        std::forward_as_tuple(segmentIndex,
-                              fileInfo_.segmentsize,
-                              metacacheopt_.discardGranularity));
-
-    return &(ret.first->second);
+    return segments_.FindOrInsert(segmentIndex,
+                                  segmentIndex,
+                                  fileInfo_.segmentsize,
+                                  metacacheopt_.discardGranularity);
 }
 
 void MetaCache::CleanChunksInSegment(SegmentIndex segmentIndex) {
-    WriteLockGuard lk(rwlock4chunkInfoMap_);
+    WriteLockGuard lk(rwlock4ChunkInfo_);
     ChunkIndex beginChunkIndex = static_cast<uint64_t>(segmentIndex) *
                                  fileInfo_.segmentsize / fileInfo_.chunksize;
     ChunkIndex endChunkIndex = static_cast<uint64_t>(segmentIndex + 1) *
                                fileInfo_.segmentsize / fileInfo_.chunksize;
 
+    CachedChunkIDInfo empty;
     auto currentIndex = beginChunkIndex;
     while (currentIndex < endChunkIndex) {
-        chunkindex2idMap_.erase(currentIndex);
+        ChunkIndexBlock* block =
+            chunkIndexBlocks_.Find(currentIndex >> kChunkIndexBlockShift);
+        if (block != nullptr) {
+            block->chunks[currentIndex & (kChunkIndexBlockSize - 1)].Store(
+                empty);
+        }
         ++currentIndex;
     }
 }
@@ -33,12 +33,16 @@
 #include "src/client/metacache_struct.h"
 #include "src/client/service_helper.h"
 #include "src/client/unstable_helper.h"
+#include "src/common/concurrent/insert_only_hash_map.h"
 #include "src/common/concurrent/rw_lock.h"
+#include "src/common/concurrent/seqlock.h"
 
 namespace curve {
 namespace client {
 
 using curve::common::RWLock;
+using curve::common::InsertOnlyHashMap;
+using curve::common::SeqLockValue;
 
 enum class MetaCacheErrorType {
     OK = 0,
@@ -52,8 +56,6 @@ class MetaCache {
  public:
     using LogicPoolCopysetID = uint64_t;
     using ChunkInfoMap = std::unordered_map<ChunkID, ChunkIDInfo>;
-    using CopysetInfoMap = std::unordered_map<LogicPoolCopysetID, CopysetInfo>;
-    using ChunkIndexInfoMap = std::unordered_map<ChunkIndex, ChunkIDInfo>;
 
     MetaCache() = default;
     virtual ~MetaCache() = default;
@@ -294,23 +296,59 @@ class MetaCache {
         CopysetID copysetId,
         const ChunkServerAddr& leaderAddr);
 
+ private:
+    // chunk index按块缓存，每块包含连续的256个chunk
+    static constexpr uint32_t kChunkIndexBlockShift = 8;
+    static constexpr uint32_t kChunkIndexBlockSize =
+        1u << kChunkIndexBlockShift;
+
+    struct CachedChunkIDInfo {
+        ChunkIDInfo info;
+        bool cached = false;
+    };
+
+    struct ChunkIndexBlock {
+        SeqLockValue<CachedChunkIDInfo> chunks[kChunkIndexBlockSize];
+    };
+
+    // copyset leader的快照，IO路径上不加锁读取
+    struct CachedLeaderInfo {
+        bool valid = false;
+        ChunkServerID id = 0;
+        uint32_t ip = 0;
+        int port = 0;
+    };
+
+    struct CopysetCacheEntry {
+        CopysetInfo info;
+        SeqLockValue<CachedLeaderInfo> leader;
+
+        // 根据info重新生成leader快照，调用方需要持有rwlock4CopysetInfo_写锁
+        void PublishLeader();
+    };
+
  private:
     MDSClient*          mdsclient_;
     MetaCacheOption   metacacheopt_;
 
-    // chunkindex到chunkidinfo的映射表
-    CURVE_CACHELINE_ALIGNMENT ChunkIndexInfoMap     chunkindex2idMap_;
+    // IO路径上的查找都不加锁：
+    // 下面三个表只插入不删除，chunk信息和leader信息通过顺序锁读取，
+    // appliedindex和leaderMayChange为原子变量。
+    // 读写锁只用于写之间的互斥，以及读取完整的copyset信息
+
+    // chunkindex到chunkidinfo的映射表，key为chunkindex所在的块
+    CURVE_CACHELINE_ALIGNMENT InsertOnlyHashMap<ChunkIndex, ChunkIndexBlock> chunkIndexBlocks_;  // NOLINT
 
     CURVE_CACHELINE_ALIGNMENT RWLock rwlock4Segments_;
-    CURVE_CACHELINE_ALIGNMENT std::unordered_map<SegmentIndex, FileSegment> segments_;  // NOLINT
+    CURVE_CACHELINE_ALIGNMENT InsertOnlyHashMap<SegmentIndex, FileSegment> segments_;  // NOLINT
 
     // logicalpoolid和copysetid到copysetinfo的映射表
-    CURVE_CACHELINE_ALIGNMENT CopysetInfoMap        lpcsid2CopsetInfoMap_;
+    CURVE_CACHELINE_ALIGNMENT InsertOnlyHashMap<LogicPoolCopysetID, CopysetCacheEntry> copysets_;  // NOLINT
 
     // chunkid到chunkidinfo的映射表
     CURVE_CACHELINE_ALIGNMENT ChunkInfoMap          chunkid2chunkInfoMap_;
 
-    // 三个读写锁分别保护上述三个映射表
+    // 读写锁分别保护上述映射表的更新
     CURVE_CACHELINE_ALIGNMENT RWLock    rwlock4chunkInfoMap_;
     CURVE_CACHELINE_ALIGNMENT RWLock    rwlock4ChunkInfo_;
     CURVE_CACHELINE_ALIGNMENT RWLock    rwlock4CopysetInfo_;
@@ -74,8 +74,8 @@ struct CURVE_CACHELINE_ALIGNMENT CopysetPeerInfo {
 
 // copyset的基本信息，包含peer信息、leader信息、appliedindex信息
 struct CURVE_CACHELINE_ALIGNMENT CopysetInfo {
-    // leader存在变更可能标志位
-    bool leaderMayChange_ = false;
+    // leader存在变更可能标志位，IO路径上会不加锁读取
+    std::atomic<bool> leaderMayChange_{false};
     // 当前copyset的节点信息
     std::vector<CopysetPeerInfo> csinfos_;
     // 当前节点的apply信息，在read的时候需要，用来避免读IO进入raft
@@ -95,12 +95,12 @@ struct CURVE_CACHELINE_ALIGNMENT CopysetInfo {
         this->csinfos_ = other.csinfos_;
         this->leaderindex_ = other.leaderindex_;
         this->lastappliedindex_.store(other.lastappliedindex_);
-        this->leaderMayChange_ = other.leaderMayChange_;
+        this->leaderMayChange_.store(other.leaderMayChange_.load());
         return *this;
     }
 
     CopysetInfo(const CopysetInfo& other)
-        : leaderMayChange_(other.leaderMayChange_),
+        : leaderMayChange_(other.leaderMayChange_.load()),
           csinfos_(other.csinfos_),
           lastappliedindex_(other.lastappliedindex_.load()),
           leaderindex_(other.leaderindex_),
@@ -111,15 +111,15 @@ struct CURVE_CACHELINE_ALIGNMENT CopysetInfo {
     }
 
     void SetLeaderUnstableFlag() {
-        leaderMayChange_ = true;
+        leaderMayChange_.store(true, std::memory_order_release);
     }
 
     void ResetSetLeaderUnstableFlag() {
-        leaderMayChange_ = false;
+        leaderMayChange_.store(false, std::memory_order_release);
     }
 
     bool LeaderMayChange() const {
-        return leaderMayChange_;
+        return leaderMayChange_.load(std::memory_order_acquire);
     }
 
     /**
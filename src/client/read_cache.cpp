@@ -0,0 +1,438 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include "src/client/read_cache.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+namespace curve {
+namespace client {
+
+using curve::common::LockGuard;
+using curve::common::UniqueLock;
+
+ReadCache::ReadCache(const ReadCacheOption& option, ReadCacheMetric* metric)
+    : option_(option),
+      metric_(metric),
+      memBlocksPerShard_(0),
+      diskSlotsPerShard_(0),
+      diskFd_(-1),
+      pendingDiskWrites_(0),
+      stopping_(false),
+      generation_(1),
+      inflightWrites_(0) {
+    memBlocksPerShard_ = std::max<uint64_t>(
+        1, option_.memCapacityMB * 1024 * 1024 / option_.blockSize / kShardNum);
+}
+
+ReadCache::~ReadCache() {
+    {
+        LockGuard lk(diskMtx_);
+        stopping_ = true;
+    }
+    diskCond_.notify_all();
+    if (diskWriter_.joinable()) {
+        diskWriter_.join();
+    }
+
+    if (diskFd_ >= 0) {
+        ::close(diskFd_);
+        diskFd_ = -1;
+    }
+}
+
+void ReadCache::Init(const std::string& name) {
+    if (option_.diskCacheDir.empty() || option_.diskCapacityMB == 0) {
+        return;
+    }
+
+    diskSlotsPerShard_ =
+        option_.diskCapacityMB * 1024 * 1024 / option_.blockSize / kShardNum;
+    if (diskSlotsPerShard_ == 0) {
+        return;
+    }
+
+    std::string path = option_.diskCacheDir + "/" + name;
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        LOG(ERROR) << "open read cache file failed, disk tier is disabled"
+                   << ", path = " << path << ", error = " << strerror(errno);
+        return;
+    }
+
+    // cache file is only accessed by fd, unlink it so it is removed
+    // when closed, even if the process crashes
+    if (::unlink(path.c_str()) != 0) {
+        LOG(WARNING) << "unlink read cache file failed, path = " << path
+                     << ", error = " << strerror(errno);
+    }
+
+    for (uint32_t i = 0; i < kShardNum; ++i) {
+        shards_[i].nextSlot = i * diskSlotsPerShard_;
+        shards_[i].slotEnd = (i + 1) * diskSlotsPerShard_;
+    }
+    diskFd_ = fd;
+    diskWriter_ = curve::common::Thread(&ReadCache::WriteDiskLoop, this);
+
+    LOG(INFO) << "read cache disk tier init success, path = " << path
+              << ", capacity = " << option_.diskCapacityMB << "MB";
+}
+
+bool ReadCache::Get(uint64_t offset, uint64_t length, char* buf) {
+    return Lookup(offset, length, [&buf](const char* data, size_t len) {
+        ::memcpy(buf, data, len);
+        buf += len;
+    });
+}
+
+bool ReadCache::Get(uint64_t offset, uint64_t length, butil::IOBuf* buf) {
+    buf->clear();
+    bool hit = Lookup(offset, length, [buf](const char* data, size_t len) {
+        buf->append(data, len);
+    });
+    if (!hit) {
+        buf->clear();
+    }
+    return hit;
+}
+
+uint64_t ReadCache::BeginRead() {
+    uint64_t token = generation_.load();
+    return inflightWrites_.load() == 0 ? token : 0;
+}
+
+void ReadCache::Put(uint64_t token, uint64_t offset,
+                    const butil::IOBuf& data) {
+    if (token == 0) {
+        return;
+    }
+
+    const uint64_t blockSize = option_.blockSize;
+    const uint64_t end = offset + data.size();
+    for (uint64_t blockIndex = (offset + blockSize - 1) / blockSize;
+         (blockIndex + 1) * blockSize <= end; ++blockIndex) {
+        std::string block(blockSize, '\0');
+        data.copy_to(&block[0], blockSize, blockIndex * blockSize - offset);
+
+        Shard* shard = GetShard(blockIndex);
+        LockGuard lk(shard->mtx);
+        // a write was issued after this read, the data may be stale
+        if (generation_.load() != token) {
+            return;
+        }
+        InsertMem(shard, blockIndex, std::move(block));
+    }
+}
+
+void ReadCache::OnWriteStart(uint64_t offset, uint64_t length) {
+    inflightWrites_.fetch_add(1);
+    generation_.fetch_add(1);
+    Invalidate(offset, length);
+}
+
+void ReadCache::OnWriteDone() {
+    inflightWrites_.fetch_sub(1);
+}
+
+template <typename Copier>
+bool ReadCache::Lookup(uint64_t offset, uint64_t length, Copier copier) {
+    if (length == 0) {
+        return false;
+    }
+
+    const uint64_t blockSize = option_.blockSize;
+    const uint64_t end = offset + length;
+    for (uint64_t blockIndex = offset / blockSize;
+         blockIndex * blockSize < end; ++blockIndex) {
+        uint64_t blockStart = blockIndex * blockSize;
+        uint64_t from = std::max(offset, blockStart) - blockStart;
+        uint64_t to = std::min(end, blockStart + blockSize) - blockStart;
+
+        Shard* shard = GetShard(blockIndex);
+        UniqueLock lk(shard->mtx);
+        const std::string* data = FindBlock(shard, blockIndex, &lk);
+        if (data == nullptr) {
+            metric_->miss << 1;
+            return false;
+        }
+        copier(data->data() + from, to - from);
+    }
+
+    metric_->hit << 1;
+    return true;
+}
+
+const std::string* ReadCache::FindBlock(Shard* shard, uint64_t blockIndex,
+                                        UniqueLock* lk) {
+    auto it = shard->memIndex.find(blockIndex);
+    if (it != shard->memIndex.end()) {
+        shard->memLru.splice(shard->memLru.begin(), shard->memLru,
+                             it->second);
+        return &it->second->second;
+    }
+
+    auto diskIt = shard->diskIndex.find(blockIndex);
+    if (diskIt == shard->diskIndex.end()) {
+        return nullptr;
+    }
+
+    // not written to disk yet, take the data in memory
+    const DiskBlock& block = diskIt->second->second;
+    if (block.pending != nullptr) {
+        std::string data(*block.pending);
+        metric_->diskHit << 1;
+        InsertMem(shard, blockIndex, std::move(data));
+        return &shard->memLru.front().second;
+    }
+
+    // read from disk without the shard lock, the slot may be reused if the
+    // block is erased meanwhile, so check it is still cached after reading
+    const uint64_t blockSize = option_.blockSize;
+    const uint64_t slot = block.slot;
+    const uint64_t seq = block.seq;
+    std::string data(blockSize, '\0');
+    lk->unlock();
+    ssize_t ret = ::pread(diskFd_, &data[0], blockSize, slot * blockSize);
+    int err = errno;
+    lk->lock();
+
+    // loaded or refilled by others meanwhile
+    it = shard->memIndex.find(blockIndex);
+    if (it != shard->memIndex.end()) {
+        shard->memLru.splice(shard->memLru.begin(), shard->memLru,
+                             it->second);
+        return &it->second->second;
+    }
+
+    diskIt = shard->diskIndex.find(blockIndex);
+    if (diskIt == shard->diskIndex.end() ||
+        diskIt->second->second.seq != seq) {
+        return nullptr;
+    }
+
+    if (ret != static_cast<ssize_t>(blockSize)) {
+        LOG(WARNING) << "read cache block from disk failed, ret = " << ret
+                     << ", error = " << strerror(err);
+        EraseDisk(shard, blockIndex);
+        return nullptr;
+    }
+
+    metric_->diskHit << 1;
+    InsertMem(shard, blockIndex, std::move(data));
+    return &shard->memLru.front().second;
+}
+
+void ReadCache::InsertMem(Shard* shard, uint64_t blockIndex,
+                          std::string&& data) {
+    EraseDisk(shard, blockIndex);
+
+    auto it = shard->memIndex.find(blockIndex);
+    if (it != shard->memIndex.end()) {
+        it->second->second = std::move(data);
+        shard->memLru.splice(shard->memLru.begin(), shard->memLru,
+                             it->second);
+        return;
+    }
+
+    shard->memLru.emplace_front(blockIndex, std::move(data));
+    shard->memIndex.emplace(blockIndex, shard->memLru.begin());
+    metric_->memUsedBytes << static_cast<int64_t>(option_.blockSize);
+
+    while (shard->memLru.size() > memBlocksPerShard_) {
+        auto& victim = shard->memLru.back();
+        InsertDisk(shard, victim.first, std::move(victim.second));
+        shard->memIndex.erase(victim.first);
+        shard->memLru.pop_back();
+        metric_->memUsedBytes << -static_cast<int64_t>(option_.blockSize);
+    }
+}
+
+void ReadCache::InsertDisk(Shard* shard, uint64_t blockIndex,
+                           std::string&& data) {
+    if (diskFd_ < 0) {
+        return;
+    }
+
+    // the writer can't keep up, drop the block rather than holding more
+    // memory than memory tier
+    {
+        LockGuard lk(diskMtx_);
+        if (pendingDiskWrites_ >= memBlocksPerShard_ * kShardNum) {
+            return;
+        }
+    }
+
+    uint64_t slot = 0;
+    if (!shard->freeSlots.empty()) {
+        slot = shard->freeSlots.back();
+        shard->freeSlots.pop_back();
+    } else if (shard->nextSlot < shard->slotEnd) {
+        slot = shard->nextSlot++;
+    } else if (!shard->diskLru.empty() &&
+               shard->diskLru.back().second.pending == nullptr) {
+        // reuse the slot of the least recently used block, if it is still
+        // being written, all blocks of this shard are, drop the new block
+        auto& victim = shard->diskLru.back();
+        slot = victim.second.slot;
+        shard->diskIndex.erase(victim.first);
+        shard->diskLru.pop_back();
+        metric_->diskUsedBytes << -static_cast<int64_t>(option_.blockSize);
+    } else {
+        return;
+    }
+
+    DiskBlock block;
+    block.slot = slot;
+    block.seq = ++shard->nextSeq;
+    block.pending = std::make_shared<const std::string>(std::move(data));
+    shard->diskLru.emplace_front(blockIndex, block);
+    shard->diskIndex.emplace(blockIndex, shard->diskLru.begin());
+    metric_->diskUsedBytes << static_cast<int64_t>(option_.blockSize);
+
+    {
+        LockGuard lk(diskMtx_);
+        diskWrites_.push_back({shard, blockIndex, slot, block.seq,
+                               block.pending});
+        ++pendingDiskWrites_;
+    }
+    metric_->diskPendingWrites << 1;
+    diskCond_.notify_one();
+}
+
+void ReadCache::WriteDiskLoop() {
+    UniqueLock lk(diskMtx_);
+    while (true) {
+        diskCond_.wait(lk, [this] {
+            return stopping_ || !diskWrites_.empty();
+        });
+        if (stopping_) {
+            return;
+        }
+        DiskWrite write = std::move(diskWrites_.front());
+        diskWrites_.pop_front();
+        lk.unlock();
+
+        WriteDisk(write);
+        metric_->diskPendingWrites << -1;
+
+        lk.lock();
+        --pendingDiskWrites_;
+    }
+}
+
+void ReadCache::WriteDisk(const DiskWrite& write) {
+    const uint64_t blockSize = option_.blockSize;
+    ssize_t ret = ::pwrite(diskFd_, write.data->data(), blockSize,
+                           write.slot * blockSize);
+    int err = errno;
+
+    Shard* shard = write.shard;
+    LockGuard lk(shard->mtx);
+    auto it = shard->diskIndex.find(write.blockIndex);
+    if (it == shard->diskIndex.end() ||
+        it->second->second.seq != write.seq) {
+        // erased while writing, the slot is freed here
+        shard->freeSlots.push_back(write.slot);
+        return;
+    }
+
+    it->second->second.pending.reset();
+    if (ret != static_cast<ssize_t>(blockSize)) {
+        LOG(WARNING) << "write cache block to disk failed, ret = " << ret
+                     << ", error = " << strerror(err);
+        EraseDisk(shard, write.blockIndex);
+    }
+}
+
+void ReadCache::EraseBlock(Shard* shard, uint64_t blockIndex) {
+    auto it = shard->memIndex.find(blockIndex);
+    if (it != shard->memIndex.end()) {
+        shard->memLru.erase(it->second);
+        shard->memIndex.erase(it);
+        metric_->memUsedBytes << -static_cast<int64_t>(option_.blockSize);
+    }
+
+    EraseDisk(shard, blockIndex);
+}
+
+void ReadCache::EraseDisk(Shard* shard, uint64_t blockIndex) {
+    auto it = shard->diskIndex.find(blockIndex);
+    if (it == shard->diskIndex.end()) {
+        return;
+    }
+
+    // the slot of a block being written is freed by the writer
+    if (it->second->second.pending == nullptr) {
+        shard->freeSlots.push_back(it->second->second.slot);
+    }
+    shard->diskLru.erase(it->second);
+    shard->diskIndex.erase(it);
+    metric_->diskUsedBytes << -static_cast<int64_t>(option_.blockSize);
+}
+
+void ReadCache::Invalidate(uint64_t offset, uint64_t length) {
+    if (length == 0) {
+        return;
+    }
+
+    const uint64_t first = offset / option_.blockSize;
+    const uint64_t last = (offset + length - 1) / option_.blockSize;
+
+    // erase blocks one by one if the range is small, otherwise scan all
+    // cached blocks, e.g. discard of a whole segment
+    if (last - first < (memBlocksPerShard_ + diskSlotsPerShard_) * kShardNum) {
+        for (uint64_t blockIndex = first; blockIndex <= last; ++blockIndex) {
+            Shard* shard = GetShard(blockIndex);
+            LockGuard lk(shard->mtx);
+            EraseBlock(shard, blockIndex);
+        }
+        return;
+    }
+
+    std::vector<uint64_t> blocks;
+    for (auto& shard : shards_) {
+        LockGuard lk(shard.mtx);
+        blocks.clear();
+        for (const auto& kv : shard.memIndex) {
+            if (kv.first >= first && kv.first <= last) {
+                blocks.push_back(kv.first);
+            }
+        }
+        for (const auto& kv : shard.diskIndex) {
+            if (kv.first >= first && kv.first <= last) {
+                blocks.push_back(kv.first);
+            }
+        }
+        for (auto blockIndex : blocks) {
+            EraseBlock(&shard, blockIndex);
+        }
+    }
+}
+
+}  // namespace client
+}  // namespace curve
@@ -0,0 +1,215 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_CLIENT_READ_CACHE_H_
+#define SRC_CLIENT_READ_CACHE_H_
+
+#include <butil/iobuf.h>
+
+#include <atomic>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "src/client/client_metric.h"
+#include "src/client/config_info.h"
+#include "src/common/concurrent/concurrent.h"
+#include "src/common/uncopyable.h"
+
+namespace curve {
+namespace client {
+
+/**
+ * Read cache of one opened file, data is cached in blocks of fixed size,
+ * keyed by block index (offset / blockSize). Each opened file has its own
+ * cache, so memCapacityMB and diskCapacityMB are budgets per opened file.
+ *
+ * Blocks are kept in a memory tier, blocks evicted from memory tier are
+ * moved to an optional disk tier (a local file), both tiers are LRU.
+ * Blocks are written to disk tier by a background thread, and read from it
+ * without holding the shard lock, so disk IO never blocks other lookups.
+ * Only blocks fully covered by a successful read are cached, and a read is
+ * served from cache only if all blocks it touches are cached.
+ *
+ * Writes and discards through the same file instance invalidate the blocks
+ * they touch when they are issued, and reads issued before a write returns
+ * won't fill the cache, so that cache never returns data older than a
+ * completed write. Writes from other clients are not visible to the cache.
+ *
+ * Nothing is shared between opened files: blocks are keyed by offset in
+ * this file rather than by clone source, and the disk tier file is
+ * unlinked once opened and lives only as long as this cache. Volumes
+ * cloned from the same image, in the same process or not, each read the
+ * image from chunkservers and cache their own copy of it.
+ */
+class ReadCache : public curve::common::Uncopyable {
+ public:
+    ReadCache(const ReadCacheOption& option, ReadCacheMetric* metric);
+
+    ~ReadCache();
+
+    /**
+     * @brief Init disk tier if enabled, memory tier is always available
+     * @param name name of the disk tier file under diskCacheDir
+     */
+    void Init(const std::string& name);
+
+    /**
+     * @brief Read data from cache
+     * @return true if all data is cached, otherwise return false and
+     *         content of buf is undefined
+     */
+    bool Get(uint64_t offset, uint64_t length, char* buf);
+    bool Get(uint64_t offset, uint64_t length, butil::IOBuf* buf);
+
+    /**
+     * @brief Called before sending a read to chunkserver
+     * @return token passed to Put when the read returns, 0 means the result
+     *         of this read can't be cached
+     */
+    uint64_t BeginRead();
+
+    /**
+     * @brief Cache data read from chunkserver
+     * @param token returned by BeginRead before the read is sent
+     * @param offset read offset
+     * @param data read data
+     */
+    void Put(uint64_t token, uint64_t offset, const butil::IOBuf& data);
+
+    /**
+     * @brief Called before sending a write or discard
+     */
+    void OnWriteStart(uint64_t offset, uint64_t length);
+
+    /**
+     * @brief Called after a write or discard returns
+     */
+    void OnWriteDone();
+
+ private:
+    using MemList = std::list<std::pair<uint64_t, std::string>>;
+
+    struct DiskBlock {
+        uint64_t slot;
+        // unique in the shard, used to check whether a block read from disk
+        // without the shard lock is still cached in the same slot
+        uint64_t seq;
+        // data waiting to be written by the background writer, the slot is
+        // freed by the writer if the block is erased before written
+        std::shared_ptr<const std::string> pending;
+    };
+    using DiskList = std::list<std::pair<uint64_t, DiskBlock>>;
+
+    struct Shard {
+        curve::common::Mutex mtx;
+
+        // memory tier, <block index, data>, front is the most recently used
+        MemList memLru;
+        std::unordered_map<uint64_t, MemList::iterator> memIndex;
+
+        // disk tier, <block index, block>, front is the most recently used
+        DiskList diskLru;
+        std::unordered_map<uint64_t, DiskList::iterator> diskIndex;
+        // slots in [nextSlot, slotEnd) have never been used
+        std::vector<uint64_t> freeSlots;
+        uint64_t nextSlot = 0;
+        uint64_t slotEnd = 0;
+        uint64_t nextSeq = 0;
+    };
+
+    struct DiskWrite {
+        Shard* shard;
+        uint64_t blockIndex;
+        uint64_t slot;
+        uint64_t seq;
+        std::shared_ptr<const std::string> data;
+    };
+
+    static const uint32_t kShardNum = 16;
+
+    Shard* GetShard(uint64_t blockIndex) {
+        return &shards_[blockIndex % kShardNum];
+    }
+
+    /**
+     * @brief Find all blocks of [offset, offset + length) and pass each
+     *        piece of cached data to copier in order
+     */
+    template <typename Copier>
+    bool Lookup(uint64_t offset, uint64_t length, Copier copier);
+
+    // find a block and move it to the front of memory tier,
+    // return nullptr if not cached, caller should hold the shard lock by lk,
+    // it is released while reading from disk tier
+    const std::string* FindBlock(Shard* shard, uint64_t blockIndex,
+                                 curve::common::UniqueLock* lk);
+
+    // caller should hold the shard lock
+    void InsertMem(Shard* shard, uint64_t blockIndex, std::string&& data);
+    void InsertDisk(Shard* shard, uint64_t blockIndex, std::string&& data);
+    void EraseBlock(Shard* shard, uint64_t blockIndex);
+    void EraseDisk(Shard* shard, uint64_t blockIndex);
+
+    // background writer of disk tier
+    void WriteDiskLoop();
+    void WriteDisk(const DiskWrite& write);
+
+    void Invalidate(uint64_t offset, uint64_t length);
+
+ private:
+    ReadCacheOption option_;
+    ReadCacheMetric* metric_;
+
+    // capacity of each shard in blocks
+    uint64_t memBlocksPerShard_;
+    uint64_t diskSlotsPerShard_;
+
+    // fd of disk tier file, -1 if disk tier is disabled
+    int diskFd_;
+
+    // blocks waiting to be written to disk tier, at most the number of
+    // blocks of memory tier, blocks evicted beyond that are dropped
+    curve::common::Mutex diskMtx_;
+    curve::common::ConditionVariable diskCond_;
+    std::deque<DiskWrite> diskWrites_;
+    // number of blocks in diskWrites_ or being written
+    uint64_t pendingDiskWrites_;
+    bool stopping_;
+    curve::common::Thread diskWriter_;
+
+    // increased when a write starts, reads started before it can't fill cache
+    std::atomic<uint64_t> generation_;
+    // number of inflight writes and discards
+    std::atomic<uint64_t> inflightWrites_;
+
+    Shard shards_[kShardNum];
+};
+
+}  // namespace client
+}  // namespace curve
+
+#endif  // SRC_CLIENT_READ_CACHE_H_
@@ -21,14 +21,20 @@
  */
 
 #include "src/client/request_sender.h"
+#include <bthread/unstable.h>
+#include <butil/time.h>
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <limits>
+#include <string>
+#include <unordered_map>
 
 #include "proto/chunk.pb.h"
 #include "src/common/timeutility.h"
 #include "src/client/request_closure.h"
 #include "src/common/location_operator.h"
+#include "src/common/concurrent/concurrent.h"
 
 namespace curve {
 namespace client {
@@ -39,8 +45,34 @@ using curve::chunkserver::ChunkService_Stub;
 using curve::chunkserver::GetChunkInfoRequest;
 using curve::chunkserver::GetChunkInfoResponse;
 using curve::common::TimeUtility;
+using curve::common::Mutex;
+using curve::common::LockGuard;
 using ::google::protobuf::Closure;
 
+namespace {
+
+// 同一进程内发往同一个chunkserver且connection_group相同的channel共享
+// 同一条连接，所以连接的metric按照地址和序号在进程内共享
+std::shared_ptr<ConnectionMetric> GetConnectionMetric(
+    const butil::EndPoint& endPoint, uint32_t index) {
+    static Mutex mtx;
+    static std::unordered_map<std::string,
+                              std::weak_ptr<ConnectionMetric>> metrics;
+
+    std::string name = std::string(butil::endpoint2str(endPoint).c_str()) +
+                       "_connection_" + std::to_string(index);
+
+    LockGuard lk(mtx);
+    std::shared_ptr<ConnectionMetric> metric = metrics[name].lock();
+    if (metric == nullptr) {
+        metric = std::make_shared<ConnectionMetric>(name);
+        metrics[name] = metric;
+    }
+    return metric;
+}
+
+}  // namespace
+
 inline void RequestSender::UpdateRpcRPS(ClientClosure* done,
                                         OpType type) const {
     RequestClosure* request = static_cast<RequestClosure*>(done->GetClosure());
@@ -61,12 +93,66 @@ inline void RequestSender::SetRpcStuff(
     done->SetChunkServerEndPoint(serverEndPoint_);
 }
 
+std::shared_ptr<ChunkServerConnection> RequestSender::SelectConnection() {
+    if (connections_.size() == 1) {
+        return connections_[0];
+    }
+
+    std::shared_ptr<ChunkServerConnection> conn;
+    if (iosenderopt_.chunkserverConnectionLeastInflight) {
+        // 从轮询位置开始找inflight最少的连接，避免总是偏向第一条连接
+        uint64_t start = nextConnection_.fetch_add(1,
+                                                   std::memory_order_relaxed);
+        int64_t minInflight = std::numeric_limits<int64_t>::max();
+        for (size_t i = 0; i < connections_.size(); ++i) {
+            const std::shared_ptr<ChunkServerConnection>& cur =
+                connections_[(start + i) % connections_.size()];
+            int64_t inflight =
+                cur->metric->inflight.load(std::memory_order_relaxed);
+            if (inflight < minInflight) {
+                minInflight = inflight;
+                conn = cur;
+            }
+        }
+    } else {
+        uint64_t index = nextConnection_.fetch_add(1,
+                                                   std::memory_order_relaxed);
+        conn = connections_[index % connections_.size()];
+    }
+
+    return conn;
+}
+
+brpc::Channel* RequestSender::SelectChannel(ClientClosure* done) {
+    std::shared_ptr<ChunkServerConnection> conn = SelectConnection();
+    conn->metric->OnRequest();
+    done->SetConnectionMetric(conn->metric);
+    return &conn->channel;
+}
+
 int RequestSender::Init(const IOSenderOption& ioSenderOpt) {
-    if (0 != channel_.Init(serverEndPoint_, NULL)) {
-        LOG(ERROR) << "failed to init channel to server, id: " << chunkServerId_
-                   << ", "<< serverEndPoint_.ip << ":" << serverEndPoint_.port;
-        return -1;
+    uint32_t connectionNum = std::max(1u, ioSenderOpt.chunkserverConnectionNum);
+
+    std::vector<std::shared_ptr<ChunkServerConnection>> connections;
+    for (uint32_t i = 0; i < connectionNum; ++i) {
+        auto conn = std::make_shared<ChunkServerConnection>();
+        brpc::ChannelOptions options;
+        // 第一条连接沿用默认的连接分组，其余连接各自使用独立的分组，
+        // 否则发往同一地址的channel会共享同一条连接
+        if (i > 0) {
+            options.connection_group = "curve_connection_" + std::to_string(i);
+        }
+        if (0 != conn->channel.Init(serverEndPoint_, &options)) {
+            LOG(ERROR) << "failed to init channel to server, id: "
+                       << chunkServerId_ << ", " << serverEndPoint_.ip << ":"
+                       << serverEndPoint_.port << ", connection index: " << i;
+            return -1;
+        }
+        conn->metric = GetConnectionMetric(serverEndPoint_, i);
+        connections.emplace_back(std::move(conn));
     }
+
+    connections_.swap(connections);
     iosenderopt_ = ioSenderOpt;
     ClientClosure::SetFailureRequestOption(iosenderopt_.failRequestOpt);
 
@@ -94,6 +180,7 @@ int RequestSender::ReadChunk(const ChunkIDInfo& idinfo,
     request.set_chunkid(idinfo.cid_);
     request.set_offset(offset);
     request.set_size(length);
+    done->PrepareQosParas(request.mutable_deltarho());
 
     if (sourceInfo.IsValid()) {
         request.set_clonefilesource(sourceInfo.cloneFileSource);
@@ -104,7 +191,13 @@ int RequestSender::ReadChunk(const ChunkIDInfo& idinfo,
         request.set_appliedindex(appliedindex);
     }
 
-    ChunkService_Stub stub(&channel_);
+    if (NeedBatch(length)) {
+        AddToBatch(&request, butil::IOBuf(), cntl, response,
+                   doneGuard.release());
+        return 0;
+    }
+
+    ChunkService_Stub stub(SelectChannel(done));
     stub.ReadChunk(cntl, &request, response, doneGuard.release());
 
     return 0;
@@ -135,14 +228,21 @@ int RequestSender::WriteChunk(const ChunkIDInfo& idinfo,
     request.set_sn(sn);
     request.set_offset(offset);
     request.set_size(length);
+    done->PrepareQosParas(request.mutable_deltarho());
 
     if (sourceInfo.IsValid()) {
         request.set_clonefilesource(sourceInfo.cloneFileSource);
         request.set_clonefileoffset(sourceInfo.cloneFileOffset);
     }
 
+    // BatchChunk按照size切分数据，数据长度和size不一致的请求不能攒批
+    if (NeedBatch(length) && data.size() == length) {
+        AddToBatch(&request, data, cntl, response, doneGuard.release());
+        return 0;
+    }
+
     cntl->request_attachment().append(data);
-    ChunkService_Stub stub(&channel_);
+    ChunkService_Stub stub(SelectChannel(done));
     stub.WriteChunk(cntl, &request, response, doneGuard.release());
 
     return 0;
@@ -168,7 +268,7 @@ int RequestSender::ReadChunkSnapshot(const ChunkIDInfo& idinfo,
     request.set_sn(sn);
     request.set_offset(offset);
     request.set_size(length);
-    ChunkService_Stub stub(&channel_);
+    ChunkService_Stub stub(SelectChannel(done));
     stub.ReadChunkSnapshot(cntl, &request, response, doneGuard.release());
 
     return 0;
@@ -190,7 +290,7 @@ int RequestSender::DeleteChunkSnapshotOrCorrectSn(const ChunkIDInfo& idinfo,
     request.set_copysetid(idinfo.cpid_);
     request.set_chunkid(idinfo.cid_);
     request.set_correctedsn(correctedSn);
-    ChunkService_Stub stub(&channel_);
+    ChunkService_Stub stub(SelectChannel(done));
     stub.DeleteChunkSnapshotOrCorrectSn(cntl,
                                         &request,
                                         response,
@@ -211,7 +311,7 @@ int RequestSender::GetChunkInfo(const ChunkIDInfo& idinfo,
     request.set_logicpoolid(idinfo.lpid_);
     request.set_copysetid(idinfo.cpid_);
     request.set_chunkid(idinfo.cid_);
-    ChunkService_Stub stub(&channel_);
+    ChunkService_Stub stub(SelectChannel(done));
     stub.GetChunkInfo(cntl, &request, response, doneGuard.release());
     return 0;
 }
@@ -240,7 +340,7 @@ int RequestSender::CreateCloneChunk(const ChunkIDInfo& idinfo,
     request.set_correctedsn(correntSn);
     request.set_size(chunkSize);
 
-    ChunkService_Stub stub(&channel_);
+    ChunkService_Stub stub(SelectChannel(done));
     stub.CreateCloneChunk(cntl, &request, response, doneGuard.release());
 }
 
@@ -263,10 +363,50 @@ int RequestSender::RecoverChunk(const ChunkIDInfo& idinfo,
     request.set_offset(offset);
     request.set_size(len);
 
-    ChunkService_Stub stub(&channel_);
+    ChunkService_Stub stub(SelectChannel(done));
     stub.RecoverChunk(cntl, &request, response, doneGuard.release());
 }
 
+void RequestSender::AddToBatch(ChunkRequest* request,
+                               const butil::IOBuf& data,
+                               brpc::Controller* cntl,
+                               ChunkResponse* response,
+                               ClientClosure* done) {
+    std::shared_ptr<ChunkRequestBatch> fullBatch;
+    {
+        LockGuard lk(batchMtx_);
+        bool full = false;
+        // 没有正在攒的batch，或者batch已经因为时间窗口到期被发送了，
+        // 则新建一个batch并启动它的时间窗口
+        if (pendingBatch_ == nullptr ||
+            !pendingBatch_->Add(request, data, cntl, response, done, &full)) {
+            pendingBatch_ = std::make_shared<ChunkRequestBatch>(
+                SelectConnection(),
+                iosenderopt_.chunkserverBatchMaxRequestNum);
+            pendingBatch_->Add(request, data, cntl, response, done, &full);
+
+            bthread_timer_t timer;
+            auto arg = new std::shared_ptr<ChunkRequestBatch>(pendingBatch_);
+            if (0 != bthread_timer_add(&timer,
+                    butil::microseconds_from_now(
+                        iosenderopt_.chunkserverBatchWindowUS),
+                    ChunkRequestBatch::OnTimer, arg)) {
+                LOG(WARNING) << "failed to add batch timer, send directly";
+                delete arg;
+                full = true;
+            }
+        }
+
+        if (full) {
+            fullBatch.swap(pendingBatch_);
+        }
+    }
+
+    if (fullBatch != nullptr) {
+        fullBatch->Send();
+    }
+}
+
 int RequestSender::ResetSender(ChunkServerID chunkServerId,
                                butil::EndPoint serverEndPoint) {
     chunkServerId_ = chunkServerId;
@@ -27,20 +27,33 @@
 #include <butil/endpoint.h>
 #include <butil/iobuf.h>
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "src/client/client_config.h"
 #include "src/client/client_common.h"
 #include "src/client/chunk_closure.h"
 #include "include/curve_compiler_specific.h"
 #include "src/client/request_context.h"
+#include "src/client/client_metric.h"
+#include "src/client/chunk_request_batch.h"
+#include "src/common/concurrent/concurrent.h"
 
 namespace curve {
 namespace client {
 
+// 与ChunkServer之间的一条connection
+struct ChunkServerConnection {
+    brpc::Channel channel;
+    std::shared_ptr<ConnectionMetric> metric;
+};
+
 /**
- * 一个RequestSender负责管理一个ChunkServer的所有
- * connection，目前一个ChunkServer仅有一个connection
+ * 一个RequestSender负责管理一个ChunkServer的所有connection，
+ * connection数量由IOSenderOption::chunkserverConnectionNum决定，
+ * 每个rpc发送前从中选择一条connection
  */
 class RequestSender {
  public:
@@ -48,7 +61,7 @@ class RequestSender {
                   butil::EndPoint serverEndPoint)
         : chunkServerId_(chunkServerId),
           serverEndPoint_(serverEndPoint),
-          channel_() {}
+          nextConnection_(0) {}
     virtual ~RequestSender() {}
 
     int Init(const IOSenderOption& ioSenderOpt);
@@ -169,7 +182,16 @@ class RequestSender {
                     butil::EndPoint serverEndPoint);
 
     bool IsSocketHealth() {
-       return channel_.CheckHealth() == 0;
+        for (auto& conn : connections_) {
+            if (conn->channel.CheckHealth() != 0) {
+                return false;
+            }
+        }
+        return !connections_.empty();
+    }
+
+    size_t GetConnectionNum() const {
+        return connections_.size();
     }
 
  private:
@@ -178,6 +200,40 @@ class RequestSender {
     void SetRpcStuff(ClientClosure* done, brpc::Controller* cntl,
                      google::protobuf::Message* rpcResponse) const;
 
+    /**
+     * 选择一条connection，轮询或者选择inflight rpc最少的connection
+     */
+    std::shared_ptr<ChunkServerConnection> SelectConnection();
+
+    /**
+     * 为当前rpc选择一条connection，并将该connection的metric设置到closure中
+     * @param done:当前rpc的closure
+     * @return 选中connection的channel
+     */
+    brpc::Channel* SelectChannel(ClientClosure* done);
+
+    /**
+     * 小的读写请求是否需要攒批发送
+     * @param length:请求的长度
+     */
+    bool NeedBatch(size_t length) const {
+        return iosenderopt_.chunkserverBatchWindowUS > 0 &&
+               length <= iosenderopt_.chunkserverBatchMaxRequestBytes;
+    }
+
+    /**
+     * 把请求加入当前正在攒的batch，batch攒满或者时间窗口到期后发送
+     * @param request:子请求
+     * @param data:写请求的数据，读请求为空
+     * @param cntl:子请求的controller
+     * @param response:子请求的response
+     * @param done:子请求的closure
+     */
+    void AddToBatch(curve::chunkserver::ChunkRequest* request,
+                    const butil::IOBuf& data,
+                    brpc::Controller* cntl, ChunkResponse* response,
+                    ClientClosure* done);
+
  private:
     // Rpc stub配置
     IOSenderOption iosenderopt_;
@@ -185,7 +241,15 @@ class RequestSender {
     ChunkServerID chunkServerId_;
     // ChunkServer 的地址
     butil::EndPoint serverEndPoint_;
-    brpc::Channel channel_; /* TODO(wudemiao): 后期会维护多个 channel */
+    // 与ChunkServer之间的connection，不同connection使用不同的connection_group
+    std::vector<std::shared_ptr<ChunkServerConnection>> connections_;
+    // 轮询选择connection时的计数
+    std::atomic<uint64_t> nextConnection_;
+
+    // 保护pendingBatch_
+    curve::common::Mutex batchMtx_;
+    // 当前正在攒的batch
+    std::shared_ptr<ChunkRequestBatch> pendingBatch_;
 };
 
 }   // namespace client
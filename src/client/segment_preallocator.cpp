@@ -0,0 +1,261 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include "src/client/segment_preallocator.h"
+
+#include <bthread/bthread.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "src/client/splitor.h"
+
+namespace curve {
+namespace client {
+
+SegmentPreallocator::SegmentPreallocator(const SegmentPreallocOption& option,
+                                         MetaCache* metaCache,
+                                         MDSClient* mdsClient,
+                                         SegmentPreallocMetric* metric)
+    : option_(option),
+      metaCache_(metaCache),
+      mdsClient_(mdsClient),
+      metric_(metric),
+      batchSupported_(true),
+      maxSegmentsPerRequest_(kMaxSegmentsPerRequest),
+      mtx_(),
+      cond_(),
+      nextOffset_(0),
+      sequentialCount_(0),
+      preallocEnd_(0),
+      running_(false),
+      stopped_(false) {}
+
+void SegmentPreallocator::OnWrite(uint64_t offset, uint64_t length) {
+    if (option_.preallocSegmentNum == 0 || length == 0) {
+        return;
+    }
+
+    // only a hint, skip this write rather than wait for the lock
+    std::unique_lock<bthread::Mutex> lk(mtx_, std::try_to_lock);
+    if (!lk.owns_lock() || stopped_) {
+        return;
+    }
+
+    if (offset == nextOffset_) {
+        ++sequentialCount_;
+    } else {
+        sequentialCount_ = 0;
+        preallocEnd_ = 0;
+    }
+    nextOffset_ = offset + length;
+
+    if (sequentialCount_ < option_.sequentialWriteThreshold || running_) {
+        return;
+    }
+
+    const FInfo* fileInfo = metaCache_->GetFileInfo();
+    if (fileInfo->segmentsize == 0) {
+        return;
+    }
+
+    SegmentIndex current = (nextOffset_ - 1) / fileInfo->segmentsize;
+    uint64_t totalSegments = fileInfo->length / fileInfo->segmentsize;
+    uint64_t begin =
+        std::max(static_cast<uint64_t>(current) + 1,
+                 static_cast<uint64_t>(preallocEnd_));
+    uint64_t end = std::min(
+        static_cast<uint64_t>(current) + 1 + option_.preallocSegmentNum,
+        totalSegments);
+    if (begin >= end) {
+        return;
+    }
+
+    // wait until half of the pre-allocated segments are consumed,
+    // so that segments are allocated in batch
+    if (end < totalSegments &&
+        end - begin < (option_.preallocSegmentNum + 1) / 2) {
+        return;
+    }
+
+    Task* task = new Task{this, static_cast<SegmentIndex>(begin),
+                          static_cast<SegmentIndex>(end)};
+    bthread_t tid;
+    if (0 != bthread_start_background(&tid, nullptr, RunTask, task)) {
+        LOG(WARNING) << "start segment prealloc task failed";
+        delete task;
+        return;
+    }
+
+    running_ = true;
+    // if this task fails, next task is triggered after writes go further
+    preallocEnd_ = end;
+}
+
+void SegmentPreallocator::Stop() {
+    std::unique_lock<bthread::Mutex> lk(mtx_);
+    stopped_ = true;
+    while (running_) {
+        cond_.wait(lk);
+    }
+}
+
+void* SegmentPreallocator::RunTask(void* arg) {
+    std::unique_ptr<Task> task(static_cast<Task*>(arg));
+    SegmentPreallocator* preallocator = task->preallocator;
+
+    int64_t count = preallocator->Prealloc(task->begin, task->end);
+    if (count >= 0) {
+        preallocator->metric_->totalSuccess << count;
+    } else {
+        preallocator->metric_->totalError << 1;
+    }
+
+    std::lock_guard<bthread::Mutex> lk(preallocator->mtx_);
+    preallocator->running_ = false;
+    preallocator->cond_.notify_all();
+    return nullptr;
+}
+
+int64_t SegmentPreallocator::Prealloc(SegmentIndex begin, SegmentIndex end) {
+    const FInfo* fileInfo = metaCache_->GetFileInfo();
+
+    while (begin < end && IsSegmentCached(begin, fileInfo)) {
+        ++begin;
+    }
+    if (begin >= end) {
+        return 0;
+    }
+
+    // hold read lock of segments, so discard tasks can't deallocate them
+    // before new chunk infos are updated to metacache
+    std::vector<FileSegment*> segments;
+    for (SegmentIndex idx = begin; idx < end; ++idx) {
+        FileSegment* segment = metaCache_->GetFileSegment(idx);
+        segment->AcquireReadLock();
+        segments.push_back(segment);
+    }
+
+    struct Unlocker {
+        std::vector<FileSegment*>* segments;
+        ~Unlocker() {
+            for (auto* segment : *segments) {
+                segment->ReleaseLock();
+            }
+        }
+    } unlocker{&segments};
+
+    uint64_t offset = static_cast<uint64_t>(begin) * fileInfo->segmentsize;
+    std::vector<SegmentInfo> segInfos;
+    LIBCURVE_ERROR errCode = LIBCURVE_ERROR::NOT_SUPPORT;
+    if (batchSupported_.load(std::memory_order_relaxed)) {
+        errCode = AllocateInBatches(fileInfo, begin, end, &segInfos);
+        if (errCode == LIBCURVE_ERROR::NOT_SUPPORT && segInfos.empty()) {
+            LOG(INFO) << "mds doesn't support AllocateSegments, "
+                         "fallback to allocate segment one by one";
+            batchSupported_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    if (errCode == LIBCURVE_ERROR::NOT_SUPPORT && segInfos.empty()) {
+        for (SegmentIndex idx = begin; idx < end; ++idx) {
+            SegmentInfo segInfo;
+            errCode = mdsClient_->GetOrAllocateSegment(
+                true, static_cast<uint64_t>(idx) * fileInfo->segmentsize,
+                fileInfo, &segInfo);
+            if (errCode != LIBCURVE_ERROR::OK) {
+                break;
+            }
+            segInfos.push_back(segInfo);
+        }
+    }
+
+    if (segInfos.empty()) {
+        LOG(WARNING) << "prealloc segment failed, filename = "
+                     << fileInfo->fullPathName << ", offset = " << offset
+                     << ", segment num = " << end - begin
+                     << ", error = " << errCode;
+        return -1;
+    }
+
+    for (const auto& segInfo : segInfos) {
+        if (!Splitor::UpdateSegmentInfo(segInfo, mdsClient_, metaCache_,
+                                        fileInfo)) {
+            return -1;
+        }
+    }
+
+    VLOG(3) << "prealloc segment success, filename = "
+            << fileInfo->fullPathName << ", offset = " << offset
+            << ", segment num = " << segInfos.size();
+    return segInfos.size();
+}
+
+LIBCURVE_ERROR SegmentPreallocator::AllocateInBatches(
+    const FInfo* fileInfo, SegmentIndex begin, SegmentIndex end,
+    std::vector<SegmentInfo>* segInfos) {
+    SegmentIndex idx = begin;
+    while (idx < end) {
+        uint32_t num = std::min(
+            static_cast<uint32_t>(end - idx),
+            maxSegmentsPerRequest_.load(std::memory_order_relaxed));
+        std::vector<SegmentInfo> batch;
+        LIBCURVE_ERROR errCode = mdsClient_->AllocateSegments(
+            fileInfo, static_cast<uint64_t>(idx) * fileInfo->segmentsize,
+            num, &batch);
+        if (errCode == LIBCURVE_ERROR::PARAM_ERROR && num > 1) {
+            // mds rejects requests with more segments than
+            // mds.curvefs.maxAllocateSegmentNum, retry with smaller batches
+            LOG(INFO) << "mds rejects allocating " << num
+                      << " segments in one request, retry with " << num / 2;
+            maxSegmentsPerRequest_.store(num / 2, std::memory_order_relaxed);
+            continue;
+        }
+        if (errCode != LIBCURVE_ERROR::OK) {
+            return errCode;
+        }
+
+        segInfos->insert(segInfos->end(), batch.begin(), batch.end());
+        if (batch.size() < num) {
+            break;
+        }
+        idx += num;
+    }
+
+    return LIBCURVE_ERROR::OK;
+}
+
+bool SegmentPreallocator::IsSegmentCached(SegmentIndex segmentIndex,
+                                          const FInfo* fileInfo) {
+    ChunkIndex chunkIdx = static_cast<uint64_t>(segmentIndex) *
+                          fileInfo->segmentsize / fileInfo->chunksize;
+    ChunkIDInfo chunkIdInfo;
+    MetaCacheErrorType errCode =
+        metaCache_->GetChunkInfoByIndex(chunkIdx, &chunkIdInfo);
+    return errCode == MetaCacheErrorType::OK && chunkIdInfo.chunkExist;
+}
+
+}  // namespace client
+}  // namespace curve
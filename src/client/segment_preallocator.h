@@ -0,0 +1,123 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_CLIENT_SEGMENT_PREALLOCATOR_H_
+#define SRC_CLIENT_SEGMENT_PREALLOCATOR_H_
+
+#include <bthread/condition_variable.h>
+#include <bthread/mutex.h>
+
+#include <atomic>
+#include <vector>
+
+#include "src/client/client_common.h"
+#include "src/client/client_metric.h"
+#include "src/client/config_info.h"
+#include "src/client/mds_client.h"
+#include "src/client/metacache.h"
+
+namespace curve {
+namespace client {
+
+/**
+ * SegmentPreallocator watches the write stream of one file, and when the
+ * writes are sequential, allocates the next few segments in background,
+ * so that writes crossing a segment boundary don't have to wait for
+ * the segment to be allocated by MDS.
+ */
+class SegmentPreallocator {
+ public:
+    // default value of mds.curvefs.maxAllocateSegmentNum
+    static constexpr uint32_t kMaxSegmentsPerRequest = 64;
+
+    SegmentPreallocator(const SegmentPreallocOption& option,
+                        MetaCache* metaCache, MDSClient* mdsClient,
+                        SegmentPreallocMetric* metric);
+
+    /**
+     * @brief Called on every user write, never blocks the write path
+     * @param offset write offset
+     * @param length write length
+     */
+    void OnWrite(uint64_t offset, uint64_t length);
+
+    /**
+     * @brief Stop accepting new tasks and wait the running task to finish
+     */
+    void Stop();
+
+ private:
+    struct Task {
+        SegmentPreallocator* preallocator;
+        SegmentIndex begin;
+        SegmentIndex end;
+    };
+
+    static void* RunTask(void* arg);
+
+    /**
+     * @brief Allocate segments in [begin, end) and update them to metacache
+     * @return number of segments pre-allocated, -1 on failure
+     */
+    int64_t Prealloc(SegmentIndex begin, SegmentIndex end);
+
+    /**
+     * @brief Allocate segments in [begin, end) by AllocateSegments, split
+     *        into requests no larger than what mds accepts
+     * @param[out] segInfos segments allocated, may be fewer than requested
+     * @return error code of the last request
+     */
+    LIBCURVE_ERROR AllocateInBatches(const FInfo* fileInfo,
+                                     SegmentIndex begin, SegmentIndex end,
+                                     std::vector<SegmentInfo>* segInfos);
+
+    bool IsSegmentCached(SegmentIndex segmentIndex, const FInfo* fileInfo);
+
+ private:
+    SegmentPreallocOption option_;
+    MetaCache* metaCache_;
+    MDSClient* mdsClient_;
+    SegmentPreallocMetric* metric_;
+
+    // false if mds doesn't support AllocateSegments
+    std::atomic<bool> batchSupported_;
+    // max segments in one AllocateSegments request, starts with the default
+    // of mds.curvefs.maxAllocateSegmentNum and is halved if mds rejects it
+    std::atomic<uint32_t> maxSegmentsPerRequest_;
+
+    // protect members below
+    bthread::Mutex mtx_;
+    bthread::ConditionVariable cond_;
+    // end offset of last write
+    uint64_t nextOffset_;
+    // number of consecutive sequential writes
+    uint32_t sequentialCount_;
+    // segments before it have been pre-allocated
+    SegmentIndex preallocEnd_;
+    bool running_;
+    bool stopped_;
+};
+
+}  // namespace client
+}  // namespace curve
+
+#endif  // SRC_CLIENT_SEGMENT_PREALLOCATOR_H_
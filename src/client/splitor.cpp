@@ -244,19 +244,18 @@ bool Splitor::GetOrAllocateSegment(bool allocateIfNotExist,
         return true;
     }
 
-    const auto chunksize = fileInfo->chunksize;
-    uint32_t count = 0;
-    for (const auto& chunkIdInfo : segmentInfo.chunkvec) {
-        uint64_t chunkIdx =
-            (segmentInfo.startoffset + count * chunksize) / chunksize;
-        metaCache->UpdateChunkInfoByIndex(chunkIdx, chunkIdInfo);
-        ++count;
-    }
+    return UpdateSegmentInfo(segmentInfo, mdsClient, metaCache, fileInfo);
+}
 
+bool Splitor::UpdateSegmentInfo(const SegmentInfo& segmentInfo,
+                                MDSClient* mdsClient,
+                                MetaCache* metaCache,
+                                const FInfo* fileInfo) {
     std::vector<CopysetInfo> copysetInfos;
-    errCode = mdsClient->GetServerList(segmentInfo.lpcpIDInfo.lpid,
-                                       segmentInfo.lpcpIDInfo.cpidVec,
-                                       &copysetInfos);
+    LIBCURVE_ERROR errCode =
+        mdsClient->GetServerList(segmentInfo.lpcpIDInfo.lpid,
+                                 segmentInfo.lpcpIDInfo.cpidVec,
+                                 &copysetInfos);
 
     if (errCode == LIBCURVE_ERROR::FAILED) {
         std::string failedCopysets;
@@ -284,6 +283,16 @@ bool Splitor::GetOrAllocateSegment(bool allocateIfNotExist,
                                      copysetInfo.cpid_, copysetInfo);
     }
 
+    // chunk信息最后更新，其他请求查到chunk信息时copyset信息已经在缓存中
+    const auto chunksize = fileInfo->chunksize;
+    uint32_t count = 0;
+    for (const auto& chunkIdInfo : segmentInfo.chunkvec) {
+        uint64_t chunkIdx =
+            (segmentInfo.startoffset + count * chunksize) / chunksize;
+        metaCache->UpdateChunkInfoByIndex(chunkIdx, chunkIdInfo);
+        ++count;
+    }
+
     return true;
 }
 
@@ -94,6 +94,19 @@ class Splitor {
                                                    MetaCache* metaCache,
                                                    ChunkIndex chunkIdx);
 
+    /**
+     * @brief 把mds返回的segment信息更新到metacache，包括chunk和copyset信息
+     * @param segmentInfo segment信息
+     * @param mdsClient 用于向mds查询copyset信息
+     * @param metaCache 文件缓存信息
+     * @param fileInfo 文件信息
+     * @return 成功返回true，否则返回false
+     */
+    static bool UpdateSegmentInfo(const SegmentInfo& segmentInfo,
+                                  MDSClient* mdsClient,
+                                  MetaCache* metaCache,
+                                  const FInfo* fileInfo);
+
  private:
     /**
      * IO2ChunkRequests内部会调用这个函数，进行真正的拆分操作
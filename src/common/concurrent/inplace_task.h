@@ -0,0 +1,193 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_COMMON_CONCURRENT_INPLACE_TASK_H_
+#define SRC_COMMON_CONCURRENT_INPLACE_TASK_H_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace curve {
+namespace common {
+
+/**
+ * 只能移动的void()可调用对象，与std::function相比，大小不超过InlineSize
+ * 的可调用对象直接存放在对象内部，不会在堆上分配内存；超过的退化为
+ * 堆上分配
+ */
+template <size_t InlineSize>
+class InplaceTask {
+ public:
+    InplaceTask() : ops_(nullptr) {}
+
+    template <class F, class = typename std::enable_if<!std::is_same<
+        typename std::decay<F>::type, InplaceTask>::value>::type>
+    InplaceTask(F&& f) : ops_(nullptr) {  // NOLINT
+        using Func = typename std::decay<F>::type;
+        Construct<Func>(std::forward<F>(f),
+                        std::integral_constant<bool, Fits<Func>()>());
+    }
+
+    InplaceTask(InplaceTask&& other) : ops_(nullptr) {
+        MoveFrom(&other);
+    }
+
+    InplaceTask& operator=(InplaceTask&& other) {
+        if (this != &other) {
+            Reset();
+            MoveFrom(&other);
+        }
+        return *this;
+    }
+
+    InplaceTask(const InplaceTask&) = delete;
+    InplaceTask& operator=(const InplaceTask&) = delete;
+
+    ~InplaceTask() {
+        Reset();
+    }
+
+    void operator()() {
+        ops_->invoke(&storage_);
+    }
+
+    explicit operator bool() const {
+        return ops_ != nullptr;
+    }
+
+    /**
+     * 可调用对象是否存放在对象内部
+     */
+    bool IsInline() const {
+        return ops_ != nullptr && ops_->isInline;
+    }
+
+    void Reset() {
+        if (ops_ != nullptr) {
+            ops_->destroy(&storage_);
+            ops_ = nullptr;
+        }
+    }
+
+ private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        // 把src中的对象移动到dst，并销毁src中的对象
+        void (*move)(void* dst, void* src);
+        void (*destroy)(void* storage);
+        bool isInline;
+    };
+
+    using Storage = typename std::aligned_storage<
+        InlineSize, alignof(std::max_align_t)>::type;
+
+    template <class Func>
+    static constexpr bool Fits() {
+        return sizeof(Func) <= sizeof(Storage) &&
+               alignof(Func) <= alignof(Storage);
+    }
+
+    template <class Func>
+    struct InlineOps {
+        static void Invoke(void* storage) {
+            (*static_cast<Func*>(storage))();
+        }
+        static void Move(void* dst, void* src) {
+            Func* f = static_cast<Func*>(src);
+            new (dst) Func(std::move(*f));
+            f->~Func();
+        }
+        static void Destroy(void* storage) {
+            static_cast<Func*>(storage)->~Func();
+        }
+        static const Ops ops;
+    };
+
+    template <class Func>
+    struct HeapOps {
+        static Func*& Get(void* storage) {
+            return *static_cast<Func**>(storage);
+        }
+        static void Invoke(void* storage) {
+            (*Get(storage))();
+        }
+        static void Move(void* dst, void* src) {
+            Get(dst) = Get(src);
+            Get(src) = nullptr;
+        }
+        static void Destroy(void* storage) {
+            delete Get(storage);
+        }
+        static const Ops ops;
+    };
+
+    template <class Func, class F>
+    void Construct(F&& f, std::true_type /* fits */) {
+        new (&storage_) Func(std::forward<F>(f));
+        ops_ = &InlineOps<Func>::ops;
+    }
+
+    template <class Func, class F>
+    void Construct(F&& f, std::false_type /* fits */) {
+        new (&storage_) Func*(new Func(std::forward<F>(f)));
+        ops_ = &HeapOps<Func>::ops;
+    }
+
+    void MoveFrom(InplaceTask* other) {
+        if (other->ops_ != nullptr) {
+            other->ops_->move(&storage_, &other->storage_);
+            ops_ = other->ops_;
+            other->ops_ = nullptr;
+        }
+    }
+
+ private:
+    Storage storage_;
+    const Ops* ops_;
+};
+
+template <size_t InlineSize>
+template <class Func>
+const typename InplaceTask<InlineSize>::Ops
+InplaceTask<InlineSize>::InlineOps<Func>::ops = {
+    &InplaceTask<InlineSize>::InlineOps<Func>::Invoke,
+    &InplaceTask<InlineSize>::InlineOps<Func>::Move,
+    &InplaceTask<InlineSize>::InlineOps<Func>::Destroy,
+    true
+};
+
+template <size_t InlineSize>
+template <class Func>
+const typename InplaceTask<InlineSize>::Ops
+InplaceTask<InlineSize>::HeapOps<Func>::ops = {
+    &InplaceTask<InlineSize>::HeapOps<Func>::Invoke,
+    &InplaceTask<InlineSize>::HeapOps<Func>::Move,
+    &InplaceTask<InlineSize>::HeapOps<Func>::Destroy,
+    false
+};
+
+}  // namespace common
+}  // namespace curve
+
+#endif  // SRC_COMMON_CONCURRENT_INPLACE_TASK_H_
@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_COMMON_CONCURRENT_INSERT_ONLY_HASH_MAP_H_
+#define SRC_COMMON_CONCURRENT_INSERT_ONLY_HASH_MAP_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "src/common/uncopyable.h"
+
+namespace curve {
+namespace common {
+
+/**
+ * 只插入不删除的哈希表，查找不加锁。
+ * 桶的数量固定，每个桶是一个单向链表，新节点插入到链表头部并以release语义发布，
+ * 节点插入后直到哈希表析构才会释放，所以查找得到的value指针一直有效。
+ * 插入之间需要由调用方保证互斥，value内容的并发访问也由调用方负责。
+ * 适用于key集合有限、读远多于写的场景。
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class InsertOnlyHashMap : public Uncopyable {
+ public:
+    /**
+     * @param bucketNum: 桶的数量，会向上取整为2的幂
+     */
+    explicit InsertOnlyHashMap(size_t bucketNum = 4096) : size_(0) {
+        size_t num = 1;
+        while (num < bucketNum) {
+            num <<= 1;
+        }
+        mask_ = num - 1;
+        buckets_.reset(new std::atomic<Node*>[num]);
+        for (size_t i = 0; i < num; ++i) {
+            buckets_[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~InsertOnlyHashMap() {
+        for (size_t i = 0; i <= mask_; ++i) {
+            Node* node = buckets_[i].load(std::memory_order_relaxed);
+            while (node != nullptr) {
+                Node* next = node->next;
+                delete node;
+                node = next;
+            }
+        }
+    }
+
+    /**
+     * 查找key对应的value，不加锁
+     * @return 不存在时返回nullptr
+     */
+    Value* Find(const Key& key) const {
+        Node* node = Bucket(key).load(std::memory_order_acquire);
+        while (node != nullptr) {
+            if (node->key == key) {
+                return &node->value;
+            }
+            node = node->next;
+        }
+        return nullptr;
+    }
+
+    /**
+     * 查找key对应的value，不存在时用args构造一个插入，需要和其他插入互斥
+     * @return key对应的value
+     */
+    template <typename... Args>
+    Value* FindOrInsert(const Key& key, Args&&... args) {
+        Value* value = Find(key);
+        if (value != nullptr) {
+            return value;
+        }
+
+        std::atomic<Node*>& bucket = Bucket(key);
+        Node* node = new Node(key, std::forward<Args>(args)...);
+        node->next = bucket.load(std::memory_order_relaxed);
+        bucket.store(node, std::memory_order_release);
+        size_.fetch_add(1, std::memory_order_relaxed);
+        return &node->value;
+    }
+
+    /**
+     * 遍历所有节点，遍历过程中插入的节点可能遍历不到
+     */
+    template <typename Func>
+    void ForEach(Func func) const {
+        for (size_t i = 0; i <= mask_; ++i) {
+            Node* node = buckets_[i].load(std::memory_order_acquire);
+            while (node != nullptr) {
+                func(node->key, &node->value);
+                node = node->next;
+            }
+        }
+    }
+
+    size_t Size() const {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+ private:
+    struct Node {
+        template <typename... Args>
+        explicit Node(const Key& k, Args&&... args)
+            : key(k), value(std::forward<Args>(args)...), next(nullptr) {}
+
+        const Key key;
+        Value value;
+        Node* next;
+    };
+
+    std::atomic<Node*>& Bucket(const Key& key) const {
+        return buckets_[Hash()(key) & mask_];
+    }
+
+ private:
+    size_t mask_;
+    std::unique_ptr<std::atomic<Node*>[]> buckets_;
+    std::atomic<size_t> size_;
+};
+
+}  // namespace common
+}  // namespace curve
+
+#endif  // SRC_COMMON_CONCURRENT_INSERT_ONLY_HASH_MAP_H_
@@ -0,0 +1,268 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_COMMON_CONCURRENT_MPSC_RING_QUEUE_H_
+#define SRC_COMMON_CONCURRENT_MPSC_RING_QUEUE_H_
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <mutex>  // NOLINT
+#include <new>
+#include <thread>  // NOLINT
+#include <type_traits>
+#include <utility>
+
+#include "include/curve_compiler_specific.h"
+#include "src/common/uncopyable.h"
+
+namespace curve {
+namespace common {
+
+/**
+ * 有界的多生产者单消费者无锁环形队列
+ * 每个槽位带有序号并按cache line对齐，生产者通过CAS抢占槽位，
+ * 元素直接构造在槽位中，入队出队不需要加锁也不需要分配内存。
+ * 队列空时消费者先自旋，自旋次数根据最近是否自旋成功自适应调整，
+ * 仍然取不到再挂起等待；队列满时生产者同样先自旋再挂起。
+ * 只有在有线程挂起时，另一方才会加锁唤醒。
+ */
+template <typename T>
+class MPSCRingQueue : public Uncopyable {
+ public:
+    /**
+     * @param capacity: 队列容量，会向上取整为2的幂，最小为2
+     */
+    explicit MPSCRingQueue(size_t capacity)
+        : tail_(0), head_(0), spinLimit_(MinSpin()),
+          consumerParked_(false), producersParked_(0) {
+        size_t cap = 2;
+        while (cap < capacity) {
+            cap <<= 1;
+        }
+        mask_ = cap - 1;
+        void* mem = nullptr;
+        if (posix_memalign(&mem, CURVE_CACHELINE_SIZE,
+                           sizeof(Slot) * cap) != 0) {
+            throw std::bad_alloc();
+        }
+        slots_ = static_cast<Slot*>(mem);
+        for (size_t i = 0; i < cap; ++i) {
+            new (&slots_[i]) Slot();
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MPSCRingQueue() {
+        T item;
+        while (TryPop(&item)) {}
+        for (size_t i = 0; i <= mask_; ++i) {
+            slots_[i].~Slot();
+        }
+        free(slots_);
+    }
+
+    size_t Capacity() const {
+        return mask_ + 1;
+    }
+
+    /**
+     * 入队，队列满时阻塞
+     */
+    void Push(T&& item) {
+        uint32_t spins = 0;
+        while (!TryPush(&item)) {
+            if (++spins < MaxSpin()) {
+                Backoff(spins);
+                continue;
+            }
+            std::unique_lock<std::mutex> lk(producerMutex_);
+            producersParked_.fetch_add(1, std::memory_order_seq_cst);
+            while (Full()) {
+                notFull_.wait(lk);
+            }
+            producersParked_.fetch_sub(1, std::memory_order_relaxed);
+            spins = 0;
+        }
+    }
+
+    /**
+     * 尝试入队，队列满时返回false，此时item不会被移动
+     */
+    bool TryPush(T* item) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot* slot = &slots_[pos & mask_];
+            size_t seq = slot->seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) -
+                            static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1,
+                                                std::memory_order_relaxed)) {
+                    new (&slot->storage) T(std::move(*item));
+                    slot->seq.store(pos + 1, std::memory_order_release);
+                    WakeConsumer();
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * 出队，只能由唯一的消费者线程调用，队列空时阻塞
+     */
+    void Pop(T* item) {
+        uint32_t spins = 0;
+        bool parked = false;
+        while (!TryPop(item)) {
+            if (spins < spinLimit_) {
+                Backoff(spins++);
+                continue;
+            }
+            // 自旋没有等到元素，减少下一次的自旋次数并挂起
+            spinLimit_ = std::max(spinLimit_ / 2, MinSpin());
+            std::unique_lock<std::mutex> lk(consumerMutex_);
+            consumerParked_.store(true, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            while (!Readable()) {
+                notEmpty_.wait(lk);
+            }
+            consumerParked_.store(false, std::memory_order_relaxed);
+            parked = true;
+        }
+        if (!parked) {
+            // 自旋等到了元素，增加下一次的自旋次数
+            spinLimit_ = std::min(std::max(spinLimit_ * 2, MinSpin()),
+                                  MaxSpin());
+        }
+    }
+
+    /**
+     * 尝试出队，只能由唯一的消费者线程调用，队列空时返回false
+     */
+    bool TryPop(T* item) {
+        Slot* slot = &slots_[head_ & mask_];
+        if (slot->seq.load(std::memory_order_acquire) != head_ + 1) {
+            return false;
+        }
+        T* elem = reinterpret_cast<T*>(&slot->storage);
+        *item = std::move(*elem);
+        elem->~T();
+        slot->seq.store(head_ + mask_ + 1, std::memory_order_release);
+        ++head_;
+        WakeProducers();
+        return true;
+    }
+
+ private:
+    struct CURVE_CACHELINE_ALIGNMENT Slot {
+        std::atomic<size_t> seq;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    // 单核上自旋等不到对方执行，直接挂起
+    static uint32_t MinSpin() {
+        static const uint32_t spin =
+            std::thread::hardware_concurrency() > 1 ? kMinSpin : 0;
+        return spin;
+    }
+
+    static uint32_t MaxSpin() {
+        static const uint32_t spin =
+            std::thread::hardware_concurrency() > 1 ? kMaxSpin : 0;
+        return spin;
+    }
+
+    // 短时间内忙等，之后让出cpu，避免cpu不足时自旋的一方占住对方
+    static inline void Backoff(uint32_t spins) {
+#if defined(__x86_64__) || defined(__i386__)
+        if (spins < kMinSpin) {
+            __builtin_ia32_pause();
+            return;
+        }
+#endif
+        std::this_thread::yield();
+    }
+
+    bool Readable() const {
+        return slots_[head_ & mask_].seq.load(std::memory_order_acquire) ==
+               head_ + 1;
+    }
+
+    bool Full() const {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        size_t seq = slots_[pos & mask_].seq.load(std::memory_order_acquire);
+        return static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos) < 0;
+    }
+
+    void WakeConsumer() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumerParked_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lk(consumerMutex_);
+            notEmpty_.notify_one();
+        }
+    }
+
+    void WakeProducers() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (producersParked_.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lk(producerMutex_);
+            notFull_.notify_all();
+        }
+    }
+
+ private:
+    static const uint32_t kMinSpin = 16;
+    static const uint32_t kMaxSpin = 1024;
+
+    Slot* slots_;
+    size_t mask_;
+    // 生产者共享的入队位置
+    CURVE_CACHELINE_ALIGNMENT std::atomic<size_t> tail_;
+    // 以下只有消费者访问
+    CURVE_CACHELINE_ALIGNMENT size_t head_;
+    uint32_t spinLimit_;
+    // 挂起相关
+    CURVE_CACHELINE_ALIGNMENT std::atomic<bool> consumerParked_;
+    std::atomic<int> producersParked_;
+    std::mutex consumerMutex_;
+    std::condition_variable notEmpty_;
+    std::mutex producerMutex_;
+    std::condition_variable notFull_;
+};
+
+template <typename T>
+const uint32_t MPSCRingQueue<T>::kMinSpin;
+template <typename T>
+const uint32_t MPSCRingQueue<T>::kMaxSpin;
+
+}  // namespace common
+}  // namespace curve
+
+#endif  // SRC_COMMON_CONCURRENT_MPSC_RING_QUEUE_H_
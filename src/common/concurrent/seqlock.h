@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_COMMON_CONCURRENT_SEQLOCK_H_
+#define SRC_COMMON_CONCURRENT_SEQLOCK_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <atomic>
+
+namespace curve {
+namespace common {
+
+/**
+ * 顺序锁保护的值，适用于读多写少、值较小且可以按字节拷贝的类型。
+ * 读不加锁，读的过程中如果有写入则重试；写之间需要由调用方保证互斥。
+ * 数据按8字节拆分存放在原子变量中，避免读写之间的数据竞争。
+ */
+template <typename T>
+class SeqLockValue {
+ public:
+    SeqLockValue() : seq_(0) {
+        Store(T());
+    }
+
+    explicit SeqLockValue(const T& value) : seq_(0) {
+        Store(value);
+    }
+
+    SeqLockValue(const SeqLockValue&) = delete;
+    SeqLockValue& operator=(const SeqLockValue&) = delete;
+
+    T Load() const {
+        uint64_t buf[kWords];
+        while (true) {
+            uint32_t begin = seq_.load(std::memory_order_acquire);
+            if (begin & 1) {
+                // 正在写入
+                continue;
+            }
+            for (size_t i = 0; i < kWords; ++i) {
+                buf[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == begin) {
+                break;
+            }
+        }
+
+        T value;
+        ::memcpy(static_cast<void*>(&value), buf, sizeof(T));
+        return value;
+    }
+
+    void Store(const T& value) {
+        uint64_t buf[kWords] = {0};
+        ::memcpy(buf, static_cast<const void*>(&value), sizeof(T));
+
+        uint32_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(buf[i], std::memory_order_relaxed);
+        }
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+ private:
+    static constexpr size_t kWords = (sizeof(T) + 7) / 8;
+
+    std::atomic<uint32_t> seq_;
+    std::atomic<uint64_t> words_[kWords];
+};
+
+}  // namespace common
+}  // namespace curve
+
+#endif  // SRC_COMMON_CONCURRENT_SEQLOCK_H_
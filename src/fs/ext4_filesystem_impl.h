@@ -61,8 +61,10 @@ class Ext4FileSystemImpl : public LocalFileSystem {
     int Fstat(int fd, struct stat* info) override;
     int Fsync(int fd) override;
 
- private:
+ protected:
     explicit Ext4FileSystemImpl(std::shared_ptr<PosixWrapper>);
+
+ private:
     int DoRename(const string& oldPath,
                  const string& newPath,
                  unsigned int flags) override;
@@ -0,0 +1,194 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2026-10-17
+ * Author: curve
+ */
+
+#include <glog/logging.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <algorithm>
+#include <vector>
+
+#include "src/fs/ext4_uring_filesystem_impl.h"
+
+namespace curve {
+namespace fs {
+
+std::shared_ptr<Ext4UringFileSystemImpl>
+    Ext4UringFileSystemImpl::self_ = nullptr;
+std::mutex Ext4UringFileSystemImpl::mutex_;
+
+Ext4UringFileSystemImpl::Ext4UringFileSystemImpl(
+    std::shared_ptr<PosixWrapper> posixWrapper)
+    : Ext4FileSystemImpl(posixWrapper) {}
+
+Ext4UringFileSystemImpl::~Ext4UringFileSystemImpl() {
+    ring_.Fini();
+}
+
+std::shared_ptr<Ext4UringFileSystemImpl>
+Ext4UringFileSystemImpl::getInstance() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (self_ == nullptr) {
+        std::shared_ptr<PosixWrapper> wrapper =
+            std::make_shared<PosixWrapper>();
+        self_ = std::shared_ptr<Ext4UringFileSystemImpl>(
+                new(std::nothrow) Ext4UringFileSystemImpl(wrapper));
+        CHECK(self_ != nullptr) << "Failed to new ext4 uring local fs.";
+    }
+    return self_;
+}
+
+int Ext4UringFileSystemImpl::Init(const LocalFileSystemOption& option) {
+    int rc = Ext4FileSystemImpl::Init(option);
+    if (rc != 0) {
+        return rc;
+    }
+    rc = ring_.Init(option.uringQueueDepth);
+    if (rc < 0) {
+        LOG(WARNING) << "io_uring is unavailable: " << strerror(-rc)
+                     << ", fall back to pread/pwrite.";
+    }
+    return 0;
+}
+
+int Ext4UringFileSystemImpl::Read(int fd,
+                                  char *buf,
+                                  uint64_t offset,
+                                  int length) {
+    if (!ring_.IsRunning()) {
+        return Ext4FileSystemImpl::Read(fd, buf, offset, length);
+    }
+    int remainLength = length;
+    int relativeOffset = 0;
+    int retryTimes = 0;
+    while (remainLength > 0) {
+        struct iovec iov;
+        iov.iov_base = buf + relativeOffset;
+        iov.iov_len = remainLength;
+        int ret = ring_.Readv(fd, &iov, 1, offset);
+        // 如果offset大于文件长度，会返回0
+        if (ret == 0) {
+            LOG(WARNING) << "io_uring read returns zero."
+                         << "offset: " << offset
+                         << ", length: " << remainLength;
+            break;
+        }
+        if (ret < 0) {
+            if ((ret == -EINTR || ret == -EAGAIN)
+                && retryTimes < MAX_RETYR_TIME) {
+                ++retryTimes;
+                continue;
+            }
+            LOG(ERROR) << "io_uring read failed: " << strerror(-ret);
+            return ret;
+        }
+        remainLength -= ret;
+        offset += ret;
+        relativeOffset += ret;
+    }
+    return length - remainLength;
+}
+
+int Ext4UringFileSystemImpl::Write(int fd,
+                                   const char *buf,
+                                   uint64_t offset,
+                                   int length) {
+    if (!ring_.IsRunning()) {
+        return Ext4FileSystemImpl::Write(fd, buf, offset, length);
+    }
+    int remainLength = length;
+    int relativeOffset = 0;
+    int retryTimes = 0;
+    while (remainLength > 0) {
+        struct iovec iov;
+        iov.iov_base = const_cast<char*>(buf) + relativeOffset;
+        iov.iov_len = remainLength;
+        int ret = ring_.Writev(fd, &iov, 1, offset);
+        if (ret < 0) {
+            if ((ret == -EINTR || ret == -EAGAIN)
+                && retryTimes < MAX_RETYR_TIME) {
+                ++retryTimes;
+                continue;
+            }
+            LOG(ERROR) << "io_uring write failed: " << strerror(-ret);
+            return ret;
+        }
+        remainLength -= ret;
+        offset += ret;
+        relativeOffset += ret;
+    }
+    return length;
+}
+
+int Ext4UringFileSystemImpl::Write(int fd,
+                                   butil::IOBuf buf,
+                                   uint64_t offset,
+                                   int length) {
+    if (!ring_.IsRunning()) {
+        return Ext4FileSystemImpl::Write(fd, buf, offset, length);
+    }
+    int remainLength = length;
+    int retryTimes = 0;
+    std::vector<struct iovec> iovs;
+    while (remainLength > 0) {
+        // IOBuf的各个block直接作为iovec提交，不需要拷贝成连续内存
+        iovs.clear();
+        size_t bytes = 0;
+        size_t blockNum = buf.backing_block_num();
+        for (size_t i = 0; i < blockNum && iovs.size() < IOV_MAX; ++i) {
+            butil::StringPiece block = buf.backing_block(i);
+            size_t len = std::min(block.size(),
+                                  static_cast<size_t>(remainLength) - bytes);
+            struct iovec iov;
+            iov.iov_base = const_cast<char*>(block.data());
+            iov.iov_len = len;
+            iovs.push_back(iov);
+            bytes += len;
+            if (bytes == static_cast<size_t>(remainLength)) {
+                break;
+            }
+        }
+        if (iovs.empty()) {
+            LOG(ERROR) << "io_uring write failed, buffer is shorter than "
+                       << "length, remain length: " << remainLength;
+            return -EINVAL;
+        }
+
+        int ret = ring_.Writev(fd, iovs.data(), iovs.size(), offset);
+        if (ret < 0) {
+            if ((ret == -EINTR || ret == -EAGAIN)
+                && retryTimes < MAX_RETYR_TIME) {
+                ++retryTimes;
+                continue;
+            }
+            LOG(ERROR) << "io_uring writev failed: " << strerror(-ret);
+            return ret;
+        }
+        buf.pop_front(ret);
+        remainLength -= ret;
+        offset += ret;
+    }
+    return length;
+}
+
+}  // namespace fs
+}  // namespace curve
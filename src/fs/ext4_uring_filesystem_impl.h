@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_FS_EXT4_URING_FILESYSTEM_IMPL_H_
+#define SRC_FS_EXT4_URING_FILESYSTEM_IMPL_H_
+
+#include <butil/iobuf.h>
+
+#include <memory>
+#include <mutex>  // NOLINT
+
+#include "src/fs/ext4_filesystem_impl.h"
+#include "src/fs/io_uring.h"
+
+namespace curve {
+namespace fs {
+
+/**
+ * 数据读写通过io_uring提交的ext4文件系统实现
+ * 目录、打开关闭、fsync等元数据操作沿用Ext4FileSystemImpl，
+ * Read/Write对调用者仍然是同步语义，因此CSChunkFile等上层无需改动；
+ * 多个apply线程的IO会被批量提交到同一个ring，磁盘队列深度不再受
+ * 单线程串行pread/pwrite的限制。
+ * 内核不支持io_uring时自动退化为pread/pwrite。
+ */
+class Ext4UringFileSystemImpl : public Ext4FileSystemImpl {
+ public:
+    virtual ~Ext4UringFileSystemImpl();
+    static std::shared_ptr<Ext4UringFileSystemImpl> getInstance();
+
+    int Init(const LocalFileSystemOption& option) override;
+    int Read(int fd, char* buf, uint64_t offset, int length) override;
+    int Write(int fd, const char* buf, uint64_t offset, int length) override;
+    int Write(int fd, butil::IOBuf buf, uint64_t offset, int length) override;
+
+    /**
+     * 当前是否通过io_uring读写，Init失败退化时返回false
+     */
+    bool IsUringEnabled() const {
+        return ring_.IsRunning();
+    }
+
+ private:
+    explicit Ext4UringFileSystemImpl(std::shared_ptr<PosixWrapper>);
+
+ private:
+    static std::shared_ptr<Ext4UringFileSystemImpl> self_;
+    static std::mutex mutex_;
+    IoUring ring_;
+};
+
+}  // namespace fs
+}  // namespace curve
+
+#endif  // SRC_FS_EXT4_URING_FILESYSTEM_IMPL_H_
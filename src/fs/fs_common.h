@@ -23,12 +23,23 @@
 #ifndef SRC_FS_FS_COMMON_H_
 #define SRC_FS_FS_COMMON_H_
 
+#include <fcntl.h>
+
+#include <cstdint>
+
+// 由设备卸载写零，分配之后的区间为written状态，linux 6.17开始支持
+#ifndef FALLOC_FL_WRITE_ZEROES
+#define FALLOC_FL_WRITE_ZEROES 0x80
+#endif
+
 namespace curve {
 namespace fs {
 
 enum class FileSystemType {
     // SFS,
     EXT4,
+    // ext4上的文件，数据读写通过io_uring提交
+    EXT4_URING,
 };
 
 struct FileSystemInfo {
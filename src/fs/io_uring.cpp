@@ -0,0 +1,310 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2026-10-17
+ * Author: curve
+ */
+
+#include <glog/logging.h>
+#include <bthread/countdown_event.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <algorithm>
+
+#include "src/fs/io_uring.h"
+
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+
+namespace curve {
+namespace fs {
+
+namespace {
+
+int SysIoUringSetup(uint32_t entries, uapi::io_uring_params* p) {
+    return ::syscall(__NR_io_uring_setup, entries, p);
+}
+
+int SysIoUringEnter(int fd, uint32_t toSubmit, uint32_t minComplete,
+                    uint32_t flags) {
+    return ::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete,
+                     flags, nullptr, 0);
+}
+
+}  // namespace
+
+struct IoUring::Completion {
+    int res;
+    bthread::CountdownEvent event;
+
+    Completion() : res(0), event(1) {}
+};
+
+IoUring::IoUring()
+    : ringFd_(-1)
+    , running_(false)
+    , sqRing_(MAP_FAILED)
+    , sqRingSize_(0)
+    , sqHead_(nullptr)
+    , sqTail_(nullptr)
+    , sqMask_(nullptr)
+    , sqArray_(nullptr)
+    , sqEntries_(0)
+    , sqes_(nullptr)
+    , sqesSize_(0)
+    , cqRing_(MAP_FAILED)
+    , cqRingSize_(0)
+    , cqHead_(nullptr)
+    , cqTail_(nullptr)
+    , cqMask_(nullptr)
+    , cqes_(nullptr)
+    , inflight_(0)
+    , pending_(0)
+    , submitting_(false) {}
+
+IoUring::~IoUring() {
+    Fini();
+}
+
+int IoUring::Init(uint32_t entries) {
+    if (running_.load(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    uapi::io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ringFd_ = SysIoUringSetup(entries, &params);
+    if (ringFd_ < 0) {
+        int err = errno;
+        LOG(WARNING) << "io_uring_setup failed: " << strerror(err)
+                     << ", entries: " << entries;
+        ringFd_ = -1;
+        return -err;
+    }
+
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ = params.cq_off.cqes +
+                  params.cq_entries * sizeof(uapi::io_uring_cqe);
+    bool singleMmap = params.features & uapi::kFeatSingleMmap;
+    if (singleMmap) {
+        sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+    }
+
+    sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, ringFd_, uapi::kOffSqRing);
+    if (sqRing_ == MAP_FAILED) {
+        int err = errno;
+        LOG(ERROR) << "mmap io_uring sq ring failed: " << strerror(err);
+        UnmapRing();
+        return -err;
+    }
+    if (singleMmap) {
+        cqRing_ = sqRing_;
+    } else {
+        cqRing_ = mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, ringFd_, uapi::kOffCqRing);
+        if (cqRing_ == MAP_FAILED) {
+            int err = errno;
+            LOG(ERROR) << "mmap io_uring cq ring failed: " << strerror(err);
+            UnmapRing();
+            return -err;
+        }
+    }
+    sqesSize_ = params.sq_entries * sizeof(uapi::io_uring_sqe);
+    void* sqes = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ringFd_, uapi::kOffSqes);
+    if (sqes == MAP_FAILED) {
+        int err = errno;
+        LOG(ERROR) << "mmap io_uring sqes failed: " << strerror(err);
+        UnmapRing();
+        return -err;
+    }
+    sqes_ = static_cast<uapi::io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(sqRing_);
+    sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqMask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sqEntries_ = params.sq_entries;
+
+    char* cq = static_cast<char*>(cqRing_);
+    cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<uapi::io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    inflight_ = 0;
+    pending_ = 0;
+    submitting_ = false;
+    running_.store(true, std::memory_order_release);
+    reaper_ = std::thread(&IoUring::ReapLoop, this);
+    LOG(INFO) << "io_uring initialized, sq entries: " << params.sq_entries
+              << ", cq entries: " << params.cq_entries;
+    return 0;
+}
+
+void IoUring::Fini() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    // 提交一个user_data为空的NOP，reaper收割到它后退出
+    Submit(uapi::kOpNop, -1, nullptr, 0, 0, nullptr);
+    reaper_.join();
+    UnmapRing();
+    LOG(INFO) << "io_uring stopped.";
+}
+
+void IoUring::UnmapRing() {
+    if (sqes_ != nullptr) {
+        munmap(sqes_, sqesSize_);
+        sqes_ = nullptr;
+    }
+    if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_) {
+        munmap(cqRing_, cqRingSize_);
+    }
+    cqRing_ = MAP_FAILED;
+    if (sqRing_ != MAP_FAILED) {
+        munmap(sqRing_, sqRingSize_);
+        sqRing_ = MAP_FAILED;
+    }
+    if (ringFd_ >= 0) {
+        ::close(ringFd_);
+        ringFd_ = -1;
+    }
+}
+
+int IoUring::Readv(int fd, const struct iovec* iov,
+                   int iovcnt, uint64_t offset) {
+    Completion completion;
+    int rc = Submit(uapi::kOpReadv, fd, iov, iovcnt, offset, &completion);
+    if (rc < 0) {
+        return rc;
+    }
+    completion.event.wait();
+    return completion.res;
+}
+
+int IoUring::Writev(int fd, const struct iovec* iov,
+                    int iovcnt, uint64_t offset) {
+    Completion completion;
+    int rc = Submit(uapi::kOpWritev, fd, iov, iovcnt, offset, &completion);
+    if (rc < 0) {
+        return rc;
+    }
+    completion.event.wait();
+    return completion.res;
+}
+
+int IoUring::Submit(uint8_t opcode, int fd, const struct iovec* iov,
+                    int iovcnt, uint64_t offset, Completion* completion) {
+    std::unique_lock<std::mutex> lock(sqMutex_);
+    // 停止过程中只允许提交用于唤醒reaper的NOP
+    if (completion != nullptr && !running_.load(std::memory_order_acquire)) {
+        return -ESHUTDOWN;
+    }
+    slotCond_.wait(lock, [this] { return inflight_ < sqEntries_; });
+
+    unsigned tail = *sqTail_;
+    unsigned index = tail & *sqMask_;
+    uapi::io_uring_sqe* sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->off = offset;
+    sqe->addr = reinterpret_cast<uint64_t>(iov);
+    sqe->len = iovcnt;
+    sqe->user_data = reinterpret_cast<uint64_t>(completion);
+    sqArray_[index] = index;
+    __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+    ++inflight_;
+    ++pending_;
+
+    // 已有线程在提交时，由它顺带把本请求一起提交
+    if (!submitting_) {
+        FlushLocked(&lock);
+    }
+    return 0;
+}
+
+void IoUring::FlushLocked(std::unique_lock<std::mutex>* lock) {
+    submitting_ = true;
+    while (pending_ > 0) {
+        uint32_t toSubmit = pending_;
+        lock->unlock();
+        int ret = SysIoUringEnter(ringFd_, toSubmit, 0, 0);
+        int err = errno;
+        lock->lock();
+        if (ret < 0) {
+            if (err == EINTR || err == EAGAIN || err == EBUSY) {
+                continue;
+            }
+            // SQE已经在ring中无法撤回，无法恢复
+            LOG(FATAL) << "io_uring_enter failed: " << strerror(err);
+        }
+        pending_ -= ret;
+    }
+    submitting_ = false;
+}
+
+void IoUring::ReapLoop() {
+    bool stop = false;
+    while (!stop) {
+        unsigned head = *cqHead_;
+        unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            int ret = SysIoUringEnter(ringFd_, 0, 1, uapi::kEnterGetEvents);
+            if (ret < 0 && errno != EINTR) {
+                LOG(ERROR) << "io_uring_enter wait failed: "
+                           << strerror(errno);
+            }
+            continue;
+        }
+
+        uint32_t reaped = 0;
+        for (; head != tail; ++head) {
+            uapi::io_uring_cqe* cqe = &cqes_[head & *cqMask_];
+            Completion* completion =
+                reinterpret_cast<Completion*>(cqe->user_data);
+            if (completion == nullptr) {
+                stop = true;
+            } else {
+                completion->res = cqe->res;
+                completion->event.signal();
+            }
+            ++reaped;
+        }
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+
+        {
+            std::lock_guard<std::mutex> lock(sqMutex_);
+            inflight_ -= reaped;
+        }
+        slotCond_.notify_all();
+    }
+}
+
+}  // namespace fs
+}  // namespace curve
@@ -0,0 +1,201 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2026-10-17
+ * Author: curve
+ */
+
+#ifndef SRC_FS_IO_URING_H_
+#define SRC_FS_IO_URING_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+
+namespace curve {
+namespace fs {
+
+/**
+ * io_uring用到的内核uapi定义，与<linux/io_uring.h>二进制兼容。
+ * 不直接包含内核头文件，低于5.1的内核头文件(以及缺少features字段的
+ * 5.1~5.3头文件)也能编译，运行时内核不支持io_uring则Init返回失败。
+ * 常量不沿用内核的宏名，避免与其他地方包含的内核头文件冲突。
+ */
+namespace uapi {
+
+struct io_uring_sqe {
+    uint8_t opcode;
+    uint8_t flags;
+    uint16_t ioprio;
+    int32_t fd;
+    uint64_t off;
+    uint64_t addr;
+    uint32_t len;
+    uint32_t rw_flags;
+    uint64_t user_data;
+    uint64_t pad[3];
+};
+
+struct io_uring_cqe {
+    uint64_t user_data;
+    int32_t res;
+    uint32_t flags;
+};
+
+struct io_sqring_offsets {
+    uint32_t head;
+    uint32_t tail;
+    uint32_t ring_mask;
+    uint32_t ring_entries;
+    uint32_t flags;
+    uint32_t dropped;
+    uint32_t array;
+    uint32_t resv1;
+    uint64_t resv2;
+};
+
+struct io_cqring_offsets {
+    uint32_t head;
+    uint32_t tail;
+    uint32_t ring_mask;
+    uint32_t ring_entries;
+    uint32_t overflow;
+    uint32_t cqes;
+    uint64_t resv[2];
+};
+
+struct io_uring_params {
+    uint32_t sq_entries;
+    uint32_t cq_entries;
+    uint32_t flags;
+    uint32_t sq_thread_cpu;
+    uint32_t sq_thread_idle;
+    uint32_t features;
+    uint32_t resv[4];
+    struct io_sqring_offsets sq_off;
+    struct io_cqring_offsets cq_off;
+};
+
+static_assert(sizeof(io_uring_sqe) == 64, "io_uring_sqe size mismatch");
+static_assert(sizeof(io_uring_cqe) == 16, "io_uring_cqe size mismatch");
+static_assert(sizeof(io_uring_params) == 120,
+              "io_uring_params size mismatch");
+
+const uint8_t kOpNop = 0;
+const uint8_t kOpReadv = 1;
+const uint8_t kOpWritev = 2;
+
+const uint32_t kEnterGetEvents = 1U << 0;
+const uint32_t kFeatSingleMmap = 1U << 0;
+
+const off_t kOffSqRing = 0;
+const off_t kOffCqRing = 0x8000000;
+const off_t kOffSqes = 0x10000000;
+
+}  // namespace uapi
+
+/**
+ * 对io_uring的简单封装，直接使用系统调用，不依赖liburing
+ * 对调用者来说IO是同步的：调用线程把请求放入提交队列后等待完成；
+ * 多个线程并发提交时，由其中一个线程一次io_uring_enter批量提交
+ * 所有已入队的请求，完成事件由后台reaper线程统一收割并唤醒调用者。
+ * 这样磁盘上的在途IO数由并发调用者数决定，不再受单个线程串行IO的限制。
+ */
+class IoUring {
+ public:
+    IoUring();
+    ~IoUring();
+
+    /**
+     * 创建ring并启动reaper线程
+     * @param entries: 提交队列深度，同时也是最大在途IO数
+     * @return 成功返回0，失败返回-errno（如内核不支持io_uring）
+     */
+    int Init(uint32_t entries);
+
+    /**
+     * 停止reaper线程并释放ring，调用前需保证没有正在进行的IO
+     */
+    void Fini();
+
+    bool IsRunning() const {
+        return running_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * 向量读写，语义同preadv/pwritev，但一次只提交一个SQE，
+     * 可能发生短读写，由调用者负责重试剩余部分
+     * @return 成功返回读写的字节数，失败返回-errno
+     */
+    int Readv(int fd, const struct iovec* iov, int iovcnt, uint64_t offset);
+    int Writev(int fd, const struct iovec* iov, int iovcnt, uint64_t offset);
+
+ private:
+    struct Completion;
+
+    int Submit(uint8_t opcode, int fd, const struct iovec* iov,
+               int iovcnt, uint64_t offset, Completion* completion);
+    // 将已入队但未提交的SQE批量提交给内核，需要持有sqMutex_
+    void FlushLocked(std::unique_lock<std::mutex>* lock);
+    void ReapLoop();
+    void UnmapRing();
+
+ private:
+    int ringFd_;
+    std::atomic<bool> running_;
+
+    // 提交队列
+    void* sqRing_;
+    size_t sqRingSize_;
+    unsigned* sqHead_;
+    unsigned* sqTail_;
+    unsigned* sqMask_;
+    unsigned* sqArray_;
+    uint32_t sqEntries_;
+    uapi::io_uring_sqe* sqes_;
+    size_t sqesSize_;
+
+    // 完成队列，内核支持kFeatSingleMmap时与提交队列共用映射
+    void* cqRing_;
+    size_t cqRingSize_;
+    unsigned* cqHead_;
+    unsigned* cqTail_;
+    unsigned* cqMask_;
+    uapi::io_uring_cqe* cqes_;
+
+    std::mutex sqMutex_;
+    std::condition_variable slotCond_;
+    // 已入队还未完成的请求数，不超过sqEntries_，保证SQ与CQ都不会溢出
+    uint32_t inflight_;
+    // 已入队但还没有提交给内核的请求数
+    uint32_t pending_;
+    // 是否已有线程在执行io_uring_enter提交
+    bool submitting_;
+
+    std::thread reaper_;
+};
+
+}  // namespace fs
+}  // namespace curve
+
+#endif  // SRC_FS_IO_URING_H_
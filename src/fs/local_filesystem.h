@@ -45,7 +45,10 @@ namespace fs {
 
 struct LocalFileSystemOption {
     bool enableRenameat2;
-    LocalFileSystemOption() : enableRenameat2(false) {}
+    // io_uring提交队列深度，仅对EXT4_URING类型的文件系统有效
+    uint32_t uringQueueDepth;
+    LocalFileSystemOption() : enableRenameat2(false)
+                            , uringQueueDepth(128) {}
 };
 
 class LocalFileSystem {
@@ -28,6 +28,7 @@
 #include <set>
 #include <utility>
 #include <map>
+#include <algorithm>
 #include "src/common/string_util.h"
 #include "src/common/encode.h"
 #include "src/common/timeutility.h"
@@ -125,6 +126,7 @@ bool CurveFS::Init(std::shared_ptr<NameServerStorage> storage,
     defaultSegmentSize_ = curveFSOptions.defaultSegmentSize;
     minFileLength_ = curveFSOptions.minFileLength;
     maxFileLength_ = curveFSOptions.maxFileLength;
+    maxAllocateSegmentNum_ = curveFSOptions.maxAllocateSegmentNum;
     topology_ = topology;
     snapshotCloneClient_ = snapshotCloneClient;
 
@@ -1162,37 +1164,106 @@ StatusCode CurveFS::GetOrAllocateSegment(const std::string & filename,
                       << ", not allocated";
             return  StatusCode::kSegmentNotAllocated;
         } else {
-            // TODO(hzsunjianliang): check the user and define the logical pool
-            auto ifok = chunkSegAllocator_->AllocateChunkSegment(
-                            fileInfo.filetype(), fileInfo.segmentsize(),
-                            fileInfo.chunksize(), offset, segment);
-            if (ifok == false) {
-                LOG(ERROR) << "AllocateChunkSegment error";
-                return StatusCode::kSegmentAllocateError;
-            }
-            int64_t revision;
-            if (storage_->PutSegment(fileInfo.id(), offset, segment, &revision)
-                != StoreStatus::OK) {
-                LOG(ERROR) << "PutSegment fail, fileInfo.id() = "
-                           << fileInfo.id()
-                           << ", offset = "
-                           << offset;
-                return StatusCode::kStorageError;
-            }
-            allocStatistic_->AllocSpace(segment->logicalpoolid(),
-                    segment->segmentsize(),
-                    revision);
-
-            LOG(INFO) << "alloc segment success, fileInfo.id() = "
-                      << fileInfo.id()
-                      << ", offset = " << offset;
-            return StatusCode::kOK;
+            return AllocateSegment(fileInfo, offset, segment);
         }
     }  else {
         return StatusCode::KInternalError;
     }
 }
 
+StatusCode CurveFS::AllocateSegments(const std::string &filename,
+        offset_t offset, uint32_t segmentNum,
+        std::vector<PageFileSegment> *segments) {
+    assert(segments != nullptr);
+
+    if (segmentNum == 0 || segmentNum > maxAllocateSegmentNum_) {
+        LOG(INFO) << "segment num " << segmentNum << " out of range (0, "
+                  << maxAllocateSegmentNum_ << "]";
+        return StatusCode::kParaError;
+    }
+
+    FileInfo  fileInfo;
+    auto ret = GetFileInfo(filename, &fileInfo);
+    if (ret != StatusCode::kOK) {
+        LOG(INFO) << "get source file error, errCode = " << ret;
+        return  ret;
+    }
+
+    if (fileInfo.filetype() != FileType::INODE_PAGEFILE) {
+        LOG(INFO) << "not pageFile, can't do this";
+        return StatusCode::kParaError;
+    }
+
+    if (offset % fileInfo.segmentsize() != 0) {
+        LOG(INFO) << "offset not align with segment";
+        return StatusCode::kParaError;
+    }
+
+    if (offset + fileInfo.segmentsize() > fileInfo.length()) {
+        LOG(INFO) << "bigger than file length, first extentFile";
+        return StatusCode::kParaError;
+    }
+
+    // segments beyond the file length are ignored
+    uint64_t endOffset = std::min(
+        offset + static_cast<uint64_t>(segmentNum) * fileInfo.segmentsize(),
+        fileInfo.length());
+    for (uint64_t segOffset = offset;
+         segOffset + fileInfo.segmentsize() <= endOffset;
+         segOffset += fileInfo.segmentsize()) {
+        PageFileSegment segment;
+        auto storeRet = storage_->GetSegment(fileInfo.id(), segOffset,
+                                             &segment);
+        if (storeRet == StoreStatus::KeyNotExist) {
+            ret = AllocateSegment(fileInfo, segOffset, &segment);
+        } else if (storeRet != StoreStatus::OK) {
+            ret = StatusCode::KInternalError;
+        }
+
+        if (ret != StatusCode::kOK) {
+            // return the segments allocated before, the caller will
+            // allocate the rest later
+            LOG(WARNING) << "allocate segments stop at offset " << segOffset
+                         << ", filename = " << filename
+                         << ", allocated num = " << segments->size()
+                         << ", errCode = " << ret;
+            return segments->empty() ? ret : StatusCode::kOK;
+        }
+        segments->push_back(segment);
+    }
+
+    return StatusCode::kOK;
+}
+
+StatusCode CurveFS::AllocateSegment(const FileInfo &fileInfo, offset_t offset,
+                                    PageFileSegment *segment) {
+    // TODO(hzsunjianliang): check the user and define the logical pool
+    auto ifok = chunkSegAllocator_->AllocateChunkSegment(
+                    fileInfo.filetype(), fileInfo.segmentsize(),
+                    fileInfo.chunksize(), offset, segment);
+    if (ifok == false) {
+        LOG(ERROR) << "AllocateChunkSegment error";
+        return StatusCode::kSegmentAllocateError;
+    }
+    int64_t revision;
+    if (storage_->PutSegment(fileInfo.id(), offset, segment, &revision)
+        != StoreStatus::OK) {
+        LOG(ERROR) << "PutSegment fail, fileInfo.id() = "
+                   << fileInfo.id()
+                   << ", offset = "
+                   << offset;
+        return StatusCode::kStorageError;
+    }
+    allocStatistic_->AllocSpace(segment->logicalpoolid(),
+            segment->segmentsize(),
+            revision);
+
+    LOG(INFO) << "alloc segment success, fileInfo.id() = "
+              << fileInfo.id()
+              << ", offset = " << offset;
+    return StatusCode::kOK;
+}
+
 StatusCode CurveFS::DeAllocateSegment(const std::string& fileName,
                                       uint64_t offset) {
     FileInfo fileInfo;
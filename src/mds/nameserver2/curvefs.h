@@ -67,6 +67,8 @@ struct CurveFSOption {
     uint64_t defaultSegmentSize;
     uint64_t minFileLength;
     uint64_t maxFileLength;
+    // max number of segments allocated by one AllocateSegments request
+    uint32_t maxAllocateSegmentNum = 64;
     RootAuthOption authOptions;
     FileRecordOptions fileRecordOptions;
     ThrottleOption throttleOption;
@@ -273,6 +275,22 @@ class CurveFS {
         offset_t offset,
         bool allocateIfNoExist, PageFileSegment *segment);
 
+    /**
+     *  @brief allocate segmentNum consecutive segments starting at offset,
+     *         segments which already exist are returned directly
+     *
+     *  @param filename
+     *  @param offset: offset of the first segment, aligned with segment size
+     *  @param segmentNum: number of segments, segments beyond the file
+     *                     length are not allocated
+     *  @param segments: Return the segments in order of offset
+     *  @return StatusCode::kOK if at least one segment is returned
+     */
+    StatusCode AllocateSegments(const std::string &filename,
+                                offset_t offset,
+                                uint32_t segmentNum,
+                                std::vector<PageFileSegment> *segments);
+
     /**
      * @brief deallocate file segment start at offset
      * @param filename
@@ -598,6 +616,16 @@ class CurveFS {
 
     StatusCode PutFile(const FileInfo & fileInfo);
 
+    /**
+     *  @brief allocate a new segment of the file and persist it
+     *  @param fileInfo
+     *  @param offset: segment offset
+     *  @param segment: Return the allocated segment
+     *  @return StatusCode::kOK if succeeded
+     */
+    StatusCode AllocateSegment(const FileInfo &fileInfo, offset_t offset,
+                               PageFileSegment *segment);
+
     /**
      * @brief Execute a snapshot transaction of a fileinfo
      * @param originalFileInfo: fileInfo of the original file
@@ -781,6 +809,7 @@ class CurveFS {
     uint64_t defaultSegmentSize_;
     uint64_t minFileLength_;
     uint64_t maxFileLength_;
+    uint32_t maxAllocateSegmentNum_;
     std::chrono::steady_clock::time_point startTime_;
 };
 extern CurveFS &kCurveFS;
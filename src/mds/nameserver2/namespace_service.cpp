@@ -486,6 +486,96 @@ void NameSpaceService::GetOrAllocateSegment(
     return;
 }
 
+void NameSpaceService::AllocateSegments(
+                    ::google::protobuf::RpcController* controller,
+                    const ::curve::mds::AllocateSegmentsRequest* request,
+                    ::curve::mds::AllocateSegmentsResponse* response,
+                    ::google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+    ExpiredTime expiredTime;
+
+    if (!isPathValid(request->filename())) {
+        response->set_statuscode(StatusCode::kParaError);
+        LOG(ERROR) << "logid = " << cntl->log_id()
+            << ", AllocateSegments request path is invalid, filename = "
+            << request->filename()
+            << ", offset = " << request->offset()
+            << ", segmentNum = " << request->segmentnum();
+        return;
+    }
+
+    LOG(INFO) << "logid = " << cntl->log_id()
+        << ", AllocateSegments request, filename = " << request->filename()
+        << ", offset = " << request->offset()
+        << ", segmentNum = " << request->segmentnum();
+
+    FileWriteLockGuard guard(fileLockManager_, request->filename());
+
+    std::string signature;
+    if (request->has_signature()) {
+        signature = request->signature();
+    }
+
+    StatusCode retCode;
+    retCode = kCurveFS.CheckFileOwner(request->filename(), request->owner(),
+                                      signature, request->date());
+    if (retCode != StatusCode::kOK) {
+        response->set_statuscode(retCode);
+        if (google::ERROR != GetMdsLogLevel(retCode)) {
+            LOG(WARNING) << "logid = " << cntl->log_id()
+                << ", CheckFileOwner fail, filename = " <<  request->filename()
+                << ", owner = " << request->owner()
+                << ", statusCode = " << retCode;
+        } else {
+            LOG(ERROR) << "logid = " << cntl->log_id()
+                << ", CheckFileOwner fail, filename = " <<  request->filename()
+                << ", owner = " << request->owner()
+                << ", statusCode = " << retCode;
+        }
+        return;
+    }
+
+    std::vector<PageFileSegment> segments;
+    retCode = kCurveFS.AllocateSegments(request->filename(),
+                request->offset(), request->segmentnum(), &segments);
+
+    if (retCode != StatusCode::kOK)  {
+        response->set_statuscode(retCode);
+        if (google::ERROR != GetMdsLogLevel(retCode)) {
+            LOG(WARNING) << "logid = " << cntl->log_id()
+                << ", AllocateSegments fail, filename = "
+                <<  request->filename()
+                << ", offset = " << request->offset()
+                << ", segmentNum = " << request->segmentnum()
+                << ", statusCode = " << retCode
+                << ", StatusCode_Name = " << StatusCode_Name(retCode)
+                << ", cost " << expiredTime.ExpiredMs() << " ms";
+        } else {
+            LOG(ERROR) << "logid = " << cntl->log_id()
+                << ", AllocateSegments fail, filename = "
+                <<  request->filename()
+                << ", offset = " << request->offset()
+                << ", segmentNum = " << request->segmentnum()
+                << ", statusCode = " << retCode
+                << ", StatusCode_Name = " << StatusCode_Name(retCode)
+                << ", cost " << expiredTime.ExpiredMs() << " ms";
+        }
+    } else {
+        response->set_statuscode(StatusCode::kOK);
+        for (auto& segment : segments) {
+            response->add_pagefilesegments()->Swap(&segment);
+        }
+        LOG(INFO) << "logid = " << cntl->log_id()
+                  << ", AllocateSegments ok, filename = "
+                  << request->filename() << ", offset = " << request->offset()
+                  << ", segmentNum = " << request->segmentnum()
+                  << ", allocated num = " << segments.size()
+                  << ", cost " << expiredTime.ExpiredMs() << " ms";
+    }
+    return;
+}
+
 void NameSpaceService::DeAllocateSegment(
     ::google::protobuf::RpcController* controller,
     const ::curve::mds::DeAllocateSegmentRequest* request,
@@ -96,6 +96,11 @@ class NameSpaceService: public CurveFSService {
                        ::curve::mds::GetOrAllocateSegmentResponse* response,
                        ::google::protobuf::Closure* done) override;
 
+    void AllocateSegments(::google::protobuf::RpcController* controller,
+                       const ::curve::mds::AllocateSegmentsRequest* request,
+                       ::curve::mds::AllocateSegmentsResponse* response,
+                       ::google::protobuf::Closure* done) override;
+
     void DeAllocateSegment(
         ::google::protobuf::RpcController* controller,
         const ::curve::mds::DeAllocateSegmentRequest* request,
@@ -24,13 +24,18 @@
 #include <gflags/gflags.h>
 #include <json/json.h>
 
+#include <errno.h>
 #include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
 
 #include <set>
 #include <mutex>    // NOLINT
 #include <thread>   // NOLINT
 #include <atomic>
 #include <vector>
+#include <fstream>
+#include <algorithm>
 
 #include "src/fs/fs_common.h"
 #include "src/fs/local_filesystem.h"
@@ -77,6 +82,8 @@ DEFINE_uint32(preAllocateNum,
 
 // 在系统初始化的时候，管理员需要预先格式化磁盘，并进行预分配
 // 这时候只需要指定allocatepercent，allocatepercent是占整个盘的空间的百分比
+// 配合chunkserver的chunkfilepool.allocate_in_background使用时，可以只格式化
+// 一小部分，chunkserver启动之后在后台继续分配剩余的chunk
 DEFINE_uint32(allocatePercent,
               80,
               "preallocate storage percent of total disk");
@@ -86,6 +93,20 @@ DEFINE_bool(needWriteZero,
         true,
         "not write zero for test.");
 
+// 设备支持时由设备卸载写零(FALLOC_FL_WRITE_ZEROES)，不支持时退回写零
+DEFINE_bool(zeroingOffload,
+        true,
+        "zero chunk by the device's write zeroes offload if supported");
+
+// 格式化并发数，为0时根据设备类型决定，机械盘并发过高反而会降低带宽
+DEFINE_uint32(formatThreads,
+              0,
+              "concurrent threads for formatting, 0 means decided by device");
+
+// 未指定formatThreads时，机械盘和固态盘的格式化并发数
+const uint32_t kHddFormatThreads = 2;
+const uint32_t kSsdFormatThreads = 16;
+
 using curve::fs::FileSystemType;
 using curve::fs::LocalFsFactory;
 using curve::fs::FileSystemInfo;
@@ -104,18 +125,63 @@ class CompareInternal {
 struct AllocateStruct {
     std::shared_ptr<LocalFileSystem> fsptr;
     std::atomic<uint64_t>* allocateChunknum;
-    bool* checkwrong;
+    std::atomic<bool>* checkwrong;
+    std::atomic<bool>* zeroingOffload;
     std::mutex* mtx;
     uint64_t chunknum;
     std::string cleanChunkSuffix;
 };
 
+/**
+ * 判断path所在的设备是否为机械盘，无法判断时按机械盘处理
+ */
+bool IsRotational(const std::string& path) {
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0) {
+        return true;
+    }
+
+    // 分区没有queue目录，需要查看所属的整盘
+    const char* patterns[] = {"/sys/dev/block/%u:%u/queue/rotational",
+                              "/sys/dev/block/%u:%u/../queue/rotational"};
+    for (const char* pattern : patterns) {
+        char sysPath[128];
+        snprintf(sysPath, sizeof(sysPath), pattern,
+                 major(info.st_dev), minor(info.st_dev));
+        std::ifstream in(sysPath);
+        int rotational = 1;
+        if (in >> rotational) {
+            return rotational != 0;
+        }
+    }
+    return true;
+}
+
+/**
+ * 将chunk文件置零，优先由设备卸载写零，设备不支持时退回写零
+ */
+int ZeroFile(AllocateStruct* allocatestruct, int fd, const char* data) {
+    uint64_t chunklen = FLAGS_fileSize + FLAGS_metaPagSize;
+    if (allocatestruct->zeroingOffload->load()) {
+        int ret = allocatestruct->fsptr->Fallocate(fd,
+            FALLOC_FL_WRITE_ZEROES, 0, chunklen);
+        if (ret != -EOPNOTSUPP && ret != -EINVAL) {
+            return ret;
+        }
+        LOG(WARNING) << "device does not support write zeroes offload, "
+                     << "fall back to write zero.";
+        allocatestruct->zeroingOffload->store(false);
+    }
+    return allocatestruct->fsptr->Write(fd, data, 0, chunklen);
+}
+
 int AllocateFiles(AllocateStruct* allocatestruct) {
     char* data = new(std::nothrow)char[FLAGS_fileSize + FLAGS_metaPagSize];
     memset(data, 0, FLAGS_fileSize + FLAGS_metaPagSize);
 
     uint64_t count = 0;
-    while (count < allocatestruct->chunknum) {
+    while (count < allocatestruct->chunknum
+           && !allocatestruct->checkwrong->load()) {
         std::string filename;
         {
             std::unique_lock<std::mutex> lk(*allocatestruct->mtx);
@@ -129,7 +195,7 @@ int AllocateFiles(AllocateStruct* allocatestruct) {
         int ret = allocatestruct->fsptr->Open(tmpchunkfilepath.c_str(),
                                              O_RDWR | O_CREAT);
         if (ret < 0) {
-            *allocatestruct->checkwrong = true;
+            allocatestruct->checkwrong->store(true);
             LOG(ERROR) << "file open failed, " << tmpchunkfilepath.c_str();
             break;
         }
@@ -139,17 +205,16 @@ int AllocateFiles(AllocateStruct* allocatestruct) {
                                         FLAGS_fileSize + FLAGS_metaPagSize);
         if (ret < 0) {
             allocatestruct->fsptr->Close(fd);
-            *allocatestruct->checkwrong = true;
+            allocatestruct->checkwrong->store(true);
             LOG(ERROR) << "Fallocate failed, " << tmpchunkfilepath.c_str();
             break;
         }
 
         if (FLAGS_needWriteZero) {
-            ret = allocatestruct->fsptr->Write(fd, data, 0,
-                FLAGS_fileSize + FLAGS_metaPagSize);
+            ret = ZeroFile(allocatestruct, fd, data);
             if (ret < 0) {
                 allocatestruct->fsptr->Close(fd);
-                *allocatestruct->checkwrong = true;
+                allocatestruct->checkwrong->store(true);
                 LOG(ERROR) << "write failed, " << tmpchunkfilepath.c_str();
                 break;
             }
@@ -158,21 +223,21 @@ int AllocateFiles(AllocateStruct* allocatestruct) {
         ret = allocatestruct->fsptr->Fsync(fd);
         if (ret < 0) {
             allocatestruct->fsptr->Close(fd);
-            *allocatestruct->checkwrong = true;
+            allocatestruct->checkwrong->store(true);
             LOG(ERROR) << "fsync failed, " << tmpchunkfilepath.c_str();
             break;
         }
 
-        allocatestruct->fsptr->Close(fd);
+        ret = allocatestruct->fsptr->Close(fd);
         if (ret < 0) {
-            *allocatestruct->checkwrong = true;
+            allocatestruct->checkwrong->store(true);
             LOG(ERROR) << "close failed, " << tmpchunkfilepath.c_str();
             break;
         }
         count++;
     }
     delete[] data;
-    return *allocatestruct->checkwrong == true ? 0 : -1;
+    return allocatestruct->checkwrong->load() ? -1 : 0;
 }
 
 // TODO(tongguangxun) :添加单元测试
@@ -227,27 +292,41 @@ int main(int argc, char** argv) {
         preAllocateChunkNum = FLAGS_preAllocateNum;
     }
 
-    bool checkwrong = false;
-    // two threads concurrent, can reach the bandwidth of disk.
-    uint64_t threadAllocateNum = preAllocateChunkNum/2;
+    uint32_t threadNum = FLAGS_formatThreads;
+    if (threadNum == 0) {
+        threadNum = IsRotational(FLAGS_fileSystemPath) ? kHddFormatThreads
+                                                      : kSsdFormatThreads;
+    }
+    threadNum = std::max<uint64_t>(1,
+        std::min<uint64_t>(threadNum, preAllocateChunkNum));
+    LOG(INFO) << "preallocate " << preAllocateChunkNum << " chunks with "
+              << threadNum << " threads.";
+
+    std::atomic<bool> checkwrong(false);
+    std::atomic<bool> zeroingOffload(FLAGS_zeroingOffload);
+    std::vector<AllocateStruct> allocateStructs(threadNum);
     std::vector<std::thread> thvec;
-    AllocateStruct allocateStruct;
-    allocateStruct.fsptr = fsptr;
-    allocateStruct.allocateChunknum = &allocateChunknum_;
-    allocateStruct.checkwrong = &checkwrong;
-    allocateStruct.mtx = &mtx;
-    allocateStruct.chunknum = threadAllocateNum;
-    allocateStruct.cleanChunkSuffix =
-        curve::chunkserver::FilePool::GetCleanChunkSuffix();
-
-    thvec.push_back(std::move(std::thread(AllocateFiles, &allocateStruct)));
-    thvec.push_back(std::move(std::thread(AllocateFiles, &allocateStruct)));
+    for (uint32_t i = 0; i < threadNum; ++i) {
+        AllocateStruct& allocateStruct = allocateStructs[i];
+        allocateStruct.fsptr = fsptr;
+        allocateStruct.allocateChunknum = &allocateChunknum_;
+        allocateStruct.checkwrong = &checkwrong;
+        allocateStruct.zeroingOffload = &zeroingOffload;
+        allocateStruct.mtx = &mtx;
+        allocateStruct.chunknum = preAllocateChunkNum / threadNum
+            + (i < preAllocateChunkNum % threadNum ? 1 : 0);
+        allocateStruct.cleanChunkSuffix =
+            curve::chunkserver::FilePool::GetCleanChunkSuffix();
+    }
+    for (uint32_t i = 0; i < threadNum; ++i) {
+        thvec.push_back(std::thread(AllocateFiles, &allocateStructs[i]));
+    }
 
     for (auto& iter : thvec) {
         iter.join();
     }
 
-    if (checkwrong) {
+    if (checkwrong.load()) {
         LOG(ERROR) << "allocate got something wrong, please check.";
         return -1;
     }
@@ -457,6 +457,111 @@ TEST_F(ChunkService2Test, illegial_parameters_test) {
         ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST,
                   response.status());
     }
+    /* batch chunk：写请求和读请求合并在一个 rpc 中 */
+    {
+        brpc::Controller cntl;
+        cntl.set_timeout_ms(rpcTimeoutMs);
+        BatchChunkRequest request;
+        BatchChunkResponse response;
+        for (int i = 0; i < 2; ++i) {
+            ChunkRequest *subRequest = request.add_requests();
+            subRequest->set_optype(CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+            subRequest->set_logicpoolid(logicPoolId);
+            subRequest->set_copysetid(copysetId);
+            subRequest->set_chunkid(chunkId + 100 + i);
+            subRequest->set_sn(sn);
+            subRequest->set_offset(0);
+            subRequest->set_size(kOpRequestAlignSize);
+            cntl.request_attachment().append(
+                std::string(kOpRequestAlignSize, 'b' + i));
+        }
+        /* copyset 不存在的子请求不影响其他子请求 */
+        ChunkRequest *subRequest = request.add_requests();
+        subRequest->set_optype(CHUNK_OP_TYPE::CHUNK_OP_READ);
+        subRequest->set_logicpoolid(logicPoolId + 1);
+        subRequest->set_copysetid(copysetId + 1);
+        subRequest->set_chunkid(chunkId);
+        subRequest->set_sn(sn);
+        subRequest->set_offset(0);
+        subRequest->set_size(kOpRequestAlignSize);
+        stub.BatchChunk(&cntl, &request, &response, nullptr);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(3, response.responses_size());
+        ASSERT_EQ(3, response.datasize_size());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                  response.responses(0).status());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                  response.responses(1).status());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_COPYSET_NOTEXIST,
+                  response.responses(2).status());
+        ASSERT_EQ(0, cntl.response_attachment().size());
+    }
+    {
+        brpc::Controller cntl;
+        cntl.set_timeout_ms(rpcTimeoutMs);
+        BatchChunkRequest request;
+        BatchChunkResponse response;
+        for (int i = 0; i < 2; ++i) {
+            ChunkRequest *subRequest = request.add_requests();
+            subRequest->set_optype(CHUNK_OP_TYPE::CHUNK_OP_READ);
+            subRequest->set_logicpoolid(logicPoolId);
+            subRequest->set_copysetid(copysetId);
+            subRequest->set_chunkid(chunkId + 100 + i);
+            subRequest->set_sn(sn);
+            subRequest->set_offset(0);
+            subRequest->set_size(kOpRequestAlignSize);
+        }
+        stub.BatchChunk(&cntl, &request, &response, nullptr);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(2, response.responses_size());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                  response.responses(0).status());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                  response.responses(1).status());
+        ASSERT_EQ(kOpRequestAlignSize, response.datasize(0));
+        ASSERT_EQ(kOpRequestAlignSize, response.datasize(1));
+        ASSERT_EQ(std::string(kOpRequestAlignSize, 'b') +
+                  std::string(kOpRequestAlignSize, 'c'),
+                  cntl.response_attachment().to_string());
+    }
+    /* batch chunk：写数据长度和 attachment 不一致，不支持的子请求类型 */
+    {
+        brpc::Controller cntl;
+        cntl.set_timeout_ms(rpcTimeoutMs);
+        BatchChunkRequest request;
+        BatchChunkResponse response;
+        ChunkRequest *subRequest = request.add_requests();
+        subRequest->set_optype(CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+        subRequest->set_logicpoolid(logicPoolId);
+        subRequest->set_copysetid(copysetId);
+        subRequest->set_chunkid(chunkId);
+        subRequest->set_sn(sn);
+        subRequest->set_offset(0);
+        subRequest->set_size(kOpRequestAlignSize);
+        cntl.request_attachment().resize(kOpRequestAlignSize - 1, 'a');
+        stub.BatchChunk(&cntl, &request, &response, nullptr);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(1, response.responses_size());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST,
+                  response.responses(0).status());
+    }
+    {
+        brpc::Controller cntl;
+        cntl.set_timeout_ms(rpcTimeoutMs);
+        BatchChunkRequest request;
+        BatchChunkResponse response;
+        ChunkRequest *subRequest = request.add_requests();
+        subRequest->set_optype(CHUNK_OP_TYPE::CHUNK_OP_DELETE);
+        subRequest->set_logicpoolid(logicPoolId);
+        subRequest->set_copysetid(copysetId);
+        subRequest->set_chunkid(chunkId);
+        subRequest->set_sn(sn);
+        stub.BatchChunk(&cntl, &request, &response, nullptr);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_EQ(1, response.responses_size());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_INVALID_REQUEST,
+                  response.responses(0).status());
+    }
     /* 不是 leader */
     {
         PeerId peer1;
@@ -665,6 +665,37 @@ TEST_F(OpRequestTest, ReadChunkTest) {
         closure->Run();
         ASSERT_TRUE(closure->isDone_);
     }
+    /**
+     * 测试Process
+     * 用例： node_->IsLeaderTerm() == true,
+     *       请求的 apply index 大于 node的 apply index，但leader lease有效
+     * 预期： 不会走一致性协议，请求提交给concurrentApplyModule_处理
+     */
+    {
+        // 重置closure
+        closure->Reset();
+
+        request->set_appliedindex(LAST_INDEX + 1);
+
+        // 设置预期
+        EXPECT_CALL(*node_, IsLeaderTerm())
+            .WillRepeatedly(Return(true));
+        EXPECT_CALL(*node_, IsLeaseLeader())
+            .WillOnce(Return(true));
+        EXPECT_CALL(*node_, Propose(_))
+            .Times(0);
+
+        opReq->Process();
+
+        // 验证结果
+        ASSERT_FALSE(closure->isDone_);
+        ASSERT_FALSE(response->has_appliedindex());
+        ASSERT_FALSE(closure->response_->has_status());
+
+        closure->Run();
+        ASSERT_TRUE(closure->isDone_);
+        request->set_appliedindex(3);
+    }
     CSChunkInfo info;
     info.isClone = true;
     info.pageSize = PAGE_SIZE;
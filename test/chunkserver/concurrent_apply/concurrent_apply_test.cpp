@@ -24,6 +24,7 @@
 
 #include <atomic>
 #include <functional>
+#include <vector>
 
 #include "proto/chunk.pb.h"
 #include "src/common/timeutility.h"
@@ -166,3 +167,101 @@ TEST(ConcurrentApplyModule, ConcurrentTest) {
     concurrentapply.Stop();
 }
 
+
+TEST(ConcurrentApplyModule, AsyncInitTest) {
+    ConcurrentApplyModule concurrentapply;
+    {
+        // init with invalid async io threads
+        ConcurrentApplyOption opt{1, 1, 1, 1, true, 0};
+        ASSERT_FALSE(concurrentapply.Init(opt));
+    }
+    {
+        ConcurrentApplyOption opt{1, 1, 1, 1, true, 4};
+        ASSERT_TRUE(concurrentapply.Init(opt));
+    }
+    concurrentapply.Stop();
+}
+
+TEST(ConcurrentApplyModule, AsyncWriteTest) {
+    // 只有一个写线程，不同chunk的写请求也能并发执行
+    ConcurrentApplyModule concurrentapply;
+    ConcurrentApplyOption opt{1, 10, 1, 1, true, 4};
+    ASSERT_TRUE(concurrentapply.Init(opt));
+
+    std::atomic<uint32_t> testnum(0);
+    auto task = [&testnum]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        testnum.fetch_add(1);
+    };
+    uint64_t start = curve::common::TimeUtility::GetTimeofDayMs();
+    for (int i = 0; i < 4; i++) {
+        concurrentapply.Push(i, CHUNK_OP_TYPE::CHUNK_OP_WRITE, task);
+    }
+    concurrentapply.Flush();
+    ASSERT_EQ(4, testnum);
+    ASSERT_LT(curve::common::TimeUtility::GetTimeofDayMs() - start, 1200);
+
+    concurrentapply.Stop();
+}
+
+TEST(ConcurrentApplyModule, AsyncOrderTest) {
+    // 同一chunk上的请求按提交顺序执行
+    ConcurrentApplyModule concurrentapply;
+    ConcurrentApplyOption opt{2, 100, 1, 1, true, 8};
+    ASSERT_TRUE(concurrentapply.Init(opt));
+
+    const int chunkNum = 8;
+    const int taskNum = 1000;
+    std::vector<int> lastSeq(chunkNum, -1);
+    std::atomic<uint32_t> disorder(0);
+    std::atomic<uint32_t> testnum(0);
+    for (int j = 0; j < taskNum; j++) {
+        for (int i = 0; i < chunkNum; i++) {
+            auto task = [&lastSeq, &disorder, &testnum, i, j]() {
+                if (lastSeq[i] != j - 1) {
+                    disorder.fetch_add(1);
+                }
+                lastSeq[i] = j;
+                testnum.fetch_add(1);
+            };
+            concurrentapply.Push(i, CHUNK_OP_TYPE::CHUNK_OP_WRITE, task);
+        }
+    }
+    concurrentapply.Flush();
+    ASSERT_EQ(chunkNum * taskNum, testnum);
+    ASSERT_EQ(0, disorder);
+
+    concurrentapply.Stop();
+}
+
+TEST(ConcurrentApplyModule, PushAfterWritesTest) {
+    // 同步和异步写模式下，PushAfterWrites的任务都排在同一chunk的写之后
+    for (bool wasync : {false, true}) {
+        ConcurrentApplyModule concurrentapply;
+        ConcurrentApplyOption opt{2, 100, 2, 100, wasync, 2};
+        ASSERT_TRUE(concurrentapply.Init(opt));
+
+        const int taskNum = 1000;
+        std::atomic<int> written(0);
+        std::atomic<uint32_t> disorder(0);
+        std::atomic<uint32_t> testnum(0);
+        for (int j = 0; j < taskNum; j++) {
+            auto write = [&written, j]() {
+                written.store(j + 1);
+            };
+            concurrentapply.Push(1, CHUNK_OP_TYPE::CHUNK_OP_WRITE, write);
+            auto read = [&written, &disorder, &testnum, j]() {
+                if (written.load() < j + 1) {
+                    disorder.fetch_add(1);
+                }
+                testnum.fetch_add(1);
+            };
+            concurrentapply.PushAfterWrites(1, read);
+        }
+        concurrentapply.Flush();
+        ASSERT_EQ(taskNum, testnum);
+        ASSERT_EQ(0, disorder);
+
+        concurrentapply.Stop();
+    }
+}
@@ -97,17 +97,22 @@ class FakeSnapshotWriter : public braft::SnapshotWriter {
     }
 
     virtual int add_file(const std::string &filename) {
+        addedFiles.push_back(filename);
         return 0;
     }
 
     virtual int add_file(const std::string &filename,
                          const ::google::protobuf::Message *file_meta) {
+        addedFiles.push_back(filename);
         return 0;
     }
 
     virtual int remove_file(const std::string &filename) {
         return 0;
     }
+
+    // 记录加入到快照元数据中的文件
+    std::vector<std::string> addedFiles;
 };
 
 class FakeClosure : public braft::Closure {
@@ -522,6 +527,51 @@ TEST_F(CopysetNodeTest, error_test) {
     }
 }
 
+TEST_F(CopysetNodeTest, snapshot_save_skip_local_files) {
+    LogicPoolID logicPoolID = 123;
+    CopysetID copysetID = 1345;
+    Configuration conf;
+    std::vector<std::string> files;
+    files.push_back("chunk_1");
+    files.push_back("chunk_1_snap_2");
+    files.push_back("chunk_1_crc");
+    files.push_back("chunk_2");
+    files.push_back("chunk_2_crc");
+
+    char *json = "{\"logicPoolId\":123,\"copysetId\":1345,\"epoch\":0,\"checksum\":774340440}";  // NOLINT
+    std::string jsonStr(json);
+
+    CopysetNode copysetNode(logicPoolID, copysetID, conf);
+    ASSERT_EQ(0, copysetNode.Init(defaultOptions_));
+    FakeClosure closure;
+    FakeSnapshotWriter writer;
+    std::shared_ptr<MockLocalFileSystem>
+        mockfs = std::make_shared<MockLocalFileSystem>();
+    std::unique_ptr<ConfEpochFile>
+        epochFile(new ConfEpochFile(mockfs));
+
+    copysetNode.SetLocalFileSystem(mockfs);
+    copysetNode.SetConfEpochFile(std::move(epochFile));
+    EXPECT_CALL(*mockfs, Open(_, _)).Times(1).WillOnce(Return(10));
+    EXPECT_CALL(*mockfs, Write(_, Matcher<const char*>(_), _, _)).Times(1)
+        .WillOnce(Return(jsonStr.size()));
+    EXPECT_CALL(*mockfs, Fsync(_)).Times(1).WillOnce(Return(0));
+    EXPECT_CALL(*mockfs, Close(_)).Times(1).WillOnce(Return(0));
+    EXPECT_CALL(*mockfs, List(_, _)).Times(1)
+        .WillOnce(DoAll(SetArgPointee<1>(files), Return(0)));
+
+    copysetNode.on_snapshot_save(&writer, &closure);
+    ASSERT_TRUE(closure.status().ok());
+
+    // 快照文件和校验和文件不加入快照元数据
+    ASSERT_EQ(3, writer.addedFiles.size());
+    for (const auto& file : writer.addedFiles) {
+        ASSERT_EQ(std::string::npos, file.find("_snap_")) << file;
+        ASSERT_EQ(std::string::npos, file.find("_crc")) << file;
+    }
+    ASSERT_EQ(std::string(kCurveConfEpochFilename), writer.addedFiles.back());
+}
+
 TEST_F(CopysetNodeTest, get_conf_change) {
     std::shared_ptr<LocalFileSystem>
         fs(LocalFsFactory::CreateFs(FileSystemType::EXT4, ""));    //NOLINT
@@ -1018,5 +1068,68 @@ TEST_F(CopysetNodeTest, get_leader_status) {
     }
 }
 
+TEST_F(CopysetNodeTest, is_lease_leader) {
+    LogicPoolID logicPoolID = 1;
+    CopysetID copysetID = 1;
+    Configuration conf;
+    std::shared_ptr<MockNode> mockNode
+            = std::make_shared<MockNode>(logicPoolID,
+                                         copysetID);
+
+    // 未开启lease read
+    {
+        CopysetNode copysetNode(logicPoolID, copysetID, conf);
+        ASSERT_EQ(0, copysetNode.Init(defaultOptions_));
+        copysetNode.SetCopysetNode(mockNode);
+        copysetNode.on_leader_start(8);
+        EXPECT_CALL(*mockNode, get_leader_lease_status(_))
+            .Times(0);
+        ASSERT_FALSE(copysetNode.IsLeaseLeader());
+    }
+
+    defaultOptions_.enableLeaseRead = true;
+    CopysetNode copysetNode(logicPoolID, copysetID, conf);
+    ASSERT_EQ(0, copysetNode.Init(defaultOptions_));
+    copysetNode.SetCopysetNode(mockNode);
+
+    // 不是leader
+    {
+        EXPECT_CALL(*mockNode, get_leader_lease_status(_))
+            .Times(0);
+        ASSERT_FALSE(copysetNode.IsLeaseLeader());
+    }
+
+    copysetNode.on_leader_start(8);
+    // lease有效
+    {
+        braft::LeaderLeaseStatus status;
+        status.state = braft::LEASE_VALID;
+        status.term = 8;
+        EXPECT_CALL(*mockNode, get_leader_lease_status(_))
+            .WillOnce(SetArgPointee<0>(status));
+        ASSERT_TRUE(copysetNode.IsLeaseLeader());
+    }
+    // lease过期
+    {
+        braft::LeaderLeaseStatus status;
+        status.state = braft::LEASE_EXPIRED;
+        EXPECT_CALL(*mockNode, get_leader_lease_status(_))
+            .WillOnce(SetArgPointee<0>(status));
+        ASSERT_FALSE(copysetNode.IsLeaseLeader());
+    }
+    // lease的任期和当前任期不一致
+    {
+        braft::LeaderLeaseStatus status;
+        status.state = braft::LEASE_VALID;
+        status.term = 9;
+        EXPECT_CALL(*mockNode, get_leader_lease_status(_))
+            .WillOnce(SetArgPointee<0>(status));
+        ASSERT_FALSE(copysetNode.IsLeaseLeader());
+    }
+
+    copysetNode.on_leader_stop(butil::Status::OK());
+    defaultOptions_.enableLeaseRead = false;
+}
+
 }  // namespace chunkserver
 }  // namespace curve
@@ -24,6 +24,7 @@
 #include <gmock/gmock.h>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "include/chunkserver/chunkserver_common.h"
 #include "src/common/bitmap.h"
@@ -53,6 +54,7 @@ using ::testing::ElementsAre;
 using ::testing::SetArgPointee;
 using ::testing::SetArrayArgument;
 using ::testing::AtLeast;
+using ::testing::Invoke;
 
 using std::shared_ptr;
 using std::make_shared;
@@ -4536,5 +4538,515 @@ TEST_F(CSDataStore_test, NormalChunkAlignmentTest) {
         .Times(1);
 }
 
+/**
+ * 测试clone chunk的bitmap延迟持久化
+ * 写入的page数达到阈值或者调用SyncChunkMetaPages时才更新metapage
+ */
+TEST_F(CSDataStore_test, CloneChunkLazyMetaPageTest) {
+    DataStoreOptions options;
+    options.baseDir = baseDir;
+    options.chunkSize = CHUNK_SIZE;
+    options.pageSize = PAGE_SIZE;
+    options.locationLimit = kLocationLimit;
+    options.metaFlushPages = 2;
+    dataStore = std::make_shared<CSDataStore>(lfs_, fpool_, options);
+    // initialize
+    FakeEnv();
+    EXPECT_TRUE(dataStore->Initialize());
+
+    ChunkID id = 3;
+    SequenceNum sn = 2;
+    SequenceNum correctedSn = 0;
+    size_t length = PAGE_SIZE;
+    char buf[length];  // NOLINT
+    memset(buf, 0, sizeof(buf));
+    CSChunkInfo info;
+    // 创建 clone chunk
+    {
+        char chunk3MetaPage[PAGE_SIZE];
+        memset(chunk3MetaPage, 0, sizeof(chunk3MetaPage));
+        shared_ptr<Bitmap> bitmap =
+            make_shared<Bitmap>(CHUNK_SIZE / PAGE_SIZE);
+        FakeEncodeChunk(chunk3MetaPage, correctedSn, sn, bitmap, location);
+        string chunk3Path = string(baseDir) + "/" +
+                            FileNameOperator::GenerateChunkFileName(id);
+        EXPECT_CALL(*lfs_, FileExists(chunk3Path))
+            .WillOnce(Return(false));
+        EXPECT_CALL(*fpool_, GetFileImpl(chunk3Path, NotNull()))
+            .WillOnce(Return(0));
+        EXPECT_CALL(*lfs_, Open(chunk3Path, _))
+            .Times(1)
+            .WillOnce(Return(4));
+        EXPECT_CALL(*lfs_, Read(4, NotNull(), 0, PAGE_SIZE))
+            .WillOnce(DoAll(SetArrayArgument<1>(chunk3MetaPage,
+                            chunk3MetaPage + PAGE_SIZE),
+                            Return(PAGE_SIZE)));
+        EXPECT_EQ(CSErrorCode::Success,
+                  dataStore->CreateCloneChunk(id,
+                                              sn,
+                                              correctedSn,
+                                              CHUNK_SIZE,
+                                              location));
+    }
+
+    // 第一个page只更新内存中的bitmap
+    {
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const char*>(_), 0, PAGE_SIZE))
+            .Times(0);
+        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_),
+                    PAGE_SIZE, length))
+            .Times(1);
+        EXPECT_EQ(CSErrorCode::Success,
+                  dataStore->WriteChunk(id, sn, buf, 0, length, nullptr));
+        ASSERT_EQ(CSErrorCode::Success, dataStore->GetChunkInfo(id, &info));
+        ASSERT_TRUE(info.bitmap->Test(0));
+        // 重复写同一个page不会计入新写入的page
+        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_),
+                    PAGE_SIZE, length))
+            .Times(1);
+        EXPECT_EQ(CSErrorCode::Success,
+                  dataStore->WriteChunk(id, sn, buf, 0, length, nullptr));
+        // paste不会覆盖已经写过的page
+        EXPECT_EQ(CSErrorCode::Success,
+                  dataStore->PasteChunk(id, buf, 0, length));
+    }
+
+    // 达到阈值后持久化metapage
+    {
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const char*>(_), 0, PAGE_SIZE))
+            .Times(1);
+        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_),
+                    PAGE_SIZE * 2, length))
+            .Times(1);
+        EXPECT_EQ(CSErrorCode::Success,
+                  dataStore->WriteChunk(id, sn, buf, PAGE_SIZE, length,
+                                        nullptr));
+    }
+
+    // 打快照前持久化，没有新的写入时不更新metapage
+    {
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const char*>(_), 0, PAGE_SIZE))
+            .Times(0);
+        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_),
+                    PAGE_SIZE * 3, length))
+            .Times(1);
+        EXPECT_EQ(CSErrorCode::Success,
+                  dataStore->WriteChunk(id, sn, buf, PAGE_SIZE * 2, length,
+                                        nullptr));
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const char*>(_), 0, PAGE_SIZE))
+            .Times(1);
+        EXPECT_EQ(CSErrorCode::Success, dataStore->SyncChunkMetaPages());
+        EXPECT_EQ(CSErrorCode::Success, dataStore->SyncChunkMetaPages());
+    }
+
+    // 持久化失败
+    {
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const char*>(_), 0, PAGE_SIZE))
+            .Times(0);
+        EXPECT_CALL(*lfs_, Write(4, Matcher<butil::IOBuf>(_),
+                    PAGE_SIZE * 4, length))
+            .Times(1);
+        EXPECT_EQ(CSErrorCode::Success,
+                  dataStore->WriteChunk(id, sn, buf, PAGE_SIZE * 3, length,
+                                        nullptr));
+        EXPECT_CALL(*lfs_, Write(4, Matcher<const char*>(_), 0, PAGE_SIZE))
+            .WillOnce(Return(-UT_ERRNO));
+        EXPECT_EQ(CSErrorCode::InternalError,
+                  dataStore->SyncChunkMetaPages());
+    }
+
+    EXPECT_CALL(*lfs_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(2))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(3))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(4))
+        .Times(1);
+}
+
+/**
+ * PageCacheTest
+ * case:开启页缓存后读写chunk
+ * 预期:第二次读命中缓存不再读文件，写入后读到新数据，删除后缓存失效
+ */
+TEST_F(CSDataStore_test, PageCacheTest) {
+    PageCacheOptions cacheOptions;
+    cacheOptions.capacity = 16 * PAGE_SIZE;
+    cacheOptions.pageSize = PAGE_SIZE;
+    std::shared_ptr<CSPageCache> pageCache =
+        std::make_shared<CSPageCache>(cacheOptions);
+    DataStoreOptions options;
+    options.baseDir = baseDir;
+    options.chunkSize = CHUNK_SIZE;
+    options.pageSize = PAGE_SIZE;
+    options.locationLimit = kLocationLimit;
+    options.pageCache = pageCache;
+    dataStore = std::make_shared<CSDataStore>(lfs_, fpool_, options);
+    // initialize
+    FakeEnv();
+    EXPECT_TRUE(dataStore->Initialize());
+
+    ChunkID id = 2;
+    SequenceNum sn = 2;
+    off_t offset = 0;
+    size_t length = 2 * PAGE_SIZE;
+    char buf[length];  // NOLINT
+    char readBuf[length];  // NOLINT
+    memset(buf, 'a', length);
+    memset(readBuf, 0, length);
+
+    // 第一次读未命中，从文件读取
+    EXPECT_CALL(*lfs_, Read(3, NotNull(), offset + PAGE_SIZE, length))
+        .WillOnce(DoAll(SetArrayArgument<1>(buf, buf + length),
+                        Return(length)));
+    EXPECT_EQ(CSErrorCode::Success,
+              dataStore->ReadChunk(id, sn, readBuf, offset, length));
+    ASSERT_EQ(0, memcmp(buf, readBuf, length));
+    ASSERT_EQ(1, pageCache->GetMissCount());
+
+    // 第二次读命中缓存
+    memset(readBuf, 0, length);
+    EXPECT_EQ(CSErrorCode::Success,
+              dataStore->ReadChunk(id, sn, readBuf, offset, length));
+    ASSERT_EQ(0, memcmp(buf, readBuf, length));
+    ASSERT_EQ(1, pageCache->GetHitCount());
+
+    // 写入后缓存中的数据同时更新
+    memset(buf + PAGE_SIZE, 'b', PAGE_SIZE);
+    EXPECT_CALL(*lfs_, Write(3, Matcher<butil::IOBuf>(_),
+                             2 * PAGE_SIZE, PAGE_SIZE))
+        .Times(1);
+    EXPECT_EQ(CSErrorCode::Success,
+              dataStore->WriteChunk(id, sn, buf + PAGE_SIZE, PAGE_SIZE,
+                                    PAGE_SIZE, nullptr));
+    memset(readBuf, 0, length);
+    EXPECT_EQ(CSErrorCode::Success,
+              dataStore->ReadChunk(id, sn, readBuf, offset, length));
+    ASSERT_EQ(0, memcmp(buf, readBuf, length));
+    ASSERT_EQ(2, pageCache->GetHitCount());
+
+    // 删除chunk后缓存失效
+    EXPECT_EQ(CSErrorCode::Success, dataStore->DeleteChunk(id, sn));
+    ASSERT_EQ(0, pageCache->GetUsedBytes());
+
+    EXPECT_CALL(*lfs_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(2))
+        .Times(1);
+}
+
+/**
+ * ChunkIndexTest
+ * case:开启chunk索引，打快照时保存索引，重启后根据索引加载chunk
+ * 预期:重启时不打开chunk文件，首次访问时打开，metapage变化前删除索引
+ */
+TEST_F(CSDataStore_test, ChunkIndexTest) {
+    DataStoreOptions options;
+    options.baseDir = baseDir;
+    options.chunkSize = CHUNK_SIZE;
+    options.pageSize = PAGE_SIZE;
+    options.locationLimit = kLocationLimit;
+    options.enableChunkIndex = true;
+    dataStore = std::make_shared<CSDataStore>(lfs_, fpool_, options);
+    string indexPath = string(baseDir) + "/chunk.index";
+    string tmpPath = indexPath + ".tmp";
+    // 没有索引时打开所有chunk文件
+    FakeEnv();
+    EXPECT_CALL(*lfs_, Open(chunk2Path, _))
+        .WillOnce(Return(3));
+    EXPECT_TRUE(dataStore->Initialize());
+
+    // 保存索引
+    string index;
+    EXPECT_CALL(*lfs_, Open(tmpPath, _))
+        .WillOnce(Return(10));
+    EXPECT_CALL(*lfs_, Write(10, Matcher<const char*>(NotNull()), 0, _))
+        .WillOnce(Invoke([&index](int, const char* buf, uint64_t, int len) {
+            index.assign(buf, len);
+            return len;
+        }));
+    EXPECT_CALL(*lfs_, Rename(tmpPath, indexPath, 0))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*lfs_, Open(baseDir, _))
+        .WillOnce(Return(11));
+    EXPECT_EQ(CSErrorCode::Success, dataStore->SaveChunkIndex());
+
+    // 根据索引重新加载，不打开chunk文件
+    dataStore = std::make_shared<CSDataStore>(lfs_, fpool_, options);
+    vector<string> fileNames;
+    fileNames.push_back(chunk1);
+    fileNames.push_back(chunk1snap1);
+    fileNames.push_back(chunk2);
+    fileNames.push_back("chunk.index");
+    EXPECT_CALL(*lfs_, List(baseDir, NotNull()))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(fileNames),
+                        Return(0)));
+    EXPECT_CALL(*lfs_, Open(indexPath, _))
+        .WillOnce(Return(12));
+    struct stat indexInfo;
+    indexInfo.st_size = index.size();
+    EXPECT_CALL(*lfs_, Fstat(12, _))
+        .WillOnce(DoAll(SetArgPointee<1>(indexInfo), Return(0)));
+    EXPECT_CALL(*lfs_, Read(12, NotNull(), 0, static_cast<int>(index.size())))
+        .WillOnce(DoAll(SetArrayArgument<1>(index.begin(), index.end()),
+                        Return(index.size())));
+    EXPECT_CALL(*lfs_, Open(chunk1Path, _))
+        .Times(0);
+    EXPECT_CALL(*lfs_, Open(chunk2Path, _))
+        .Times(0);
+    EXPECT_TRUE(dataStore->Initialize());
+    CSChunkInfo info;
+    EXPECT_EQ(CSErrorCode::Success, dataStore->GetChunkInfo(1, &info));
+    ASSERT_EQ(2, info.curSn);
+    ASSERT_EQ(1, info.snapSn);
+    EXPECT_EQ(CSErrorCode::Success, dataStore->GetChunkInfo(2, &info));
+    ASSERT_EQ(2, info.curSn);
+    ASSERT_EQ(0, info.correctedSn);
+
+    // 首次读chunk2时打开chunk文件
+    char buf[PAGE_SIZE];
+    EXPECT_CALL(*lfs_, Open(chunk2Path, _))
+        .WillOnce(Return(3));
+    EXPECT_CALL(*lfs_, Read(3, NotNull(), PAGE_SIZE, PAGE_SIZE))
+        .Times(2);
+    EXPECT_EQ(CSErrorCode::Success,
+              dataStore->ReadChunk(2, 2, buf, 0, PAGE_SIZE));
+    EXPECT_EQ(CSErrorCode::Success,
+              dataStore->ReadChunk(2, 2, buf, 0, PAGE_SIZE));
+
+    // 第一次更新metapage前删除索引
+    EXPECT_CALL(*lfs_, Delete(indexPath))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*lfs_, Open(baseDir, _))
+        .WillOnce(Return(11));
+    EXPECT_CALL(*lfs_, Write(3, Matcher<const char*>(NotNull()), 0, PAGE_SIZE))
+        .Times(2);
+    EXPECT_EQ(CSErrorCode::Success,
+              dataStore->DeleteSnapshotChunkOrCorrectSn(2, 3));
+    EXPECT_EQ(CSErrorCode::Success,
+              dataStore->DeleteSnapshotChunkOrCorrectSn(2, 4));
+
+    EXPECT_CALL(*lfs_, Close(2))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(3))
+        .Times(1);
+}
+
+/**
+ * ChunkIndexErrorTest
+ * case:chunk索引损坏
+ * 预期:删除索引，打开所有chunk文件
+ */
+TEST_F(CSDataStore_test, ChunkIndexErrorTest) {
+    DataStoreOptions options;
+    options.baseDir = baseDir;
+    options.chunkSize = CHUNK_SIZE;
+    options.pageSize = PAGE_SIZE;
+    options.locationLimit = kLocationLimit;
+    options.enableChunkIndex = true;
+    dataStore = std::make_shared<CSDataStore>(lfs_, fpool_, options);
+    string indexPath = string(baseDir) + "/chunk.index";
+    FakeEnv();
+    vector<string> fileNames;
+    fileNames.push_back(chunk1);
+    fileNames.push_back(chunk1snap1);
+    fileNames.push_back(chunk2);
+    fileNames.push_back("chunk.index");
+    EXPECT_CALL(*lfs_, List(baseDir, NotNull()))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(fileNames),
+                        Return(0)));
+    char index[64];
+    memset(index, 'a', sizeof(index));
+    EXPECT_CALL(*lfs_, Open(indexPath, _))
+        .WillOnce(Return(12));
+    struct stat indexInfo;
+    indexInfo.st_size = sizeof(index);
+    EXPECT_CALL(*lfs_, Fstat(12, _))
+        .WillOnce(DoAll(SetArgPointee<1>(indexInfo), Return(0)));
+    EXPECT_CALL(*lfs_, Read(12, NotNull(), 0, sizeof(index)))
+        .WillOnce(DoAll(SetArrayArgument<1>(index, index + sizeof(index)),
+                        Return(sizeof(index))));
+    EXPECT_CALL(*lfs_, Delete(indexPath))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*lfs_, Open(baseDir, _))
+        .WillOnce(Return(11));
+    EXPECT_CALL(*lfs_, Open(chunk2Path, _))
+        .WillOnce(Return(3));
+    EXPECT_TRUE(dataStore->Initialize());
+
+    EXPECT_CALL(*lfs_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(2))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(3))
+        .Times(1);
+}
+
+/**
+ * PageChecksumTest
+ * case:开启page校验，写入时更新page的crc，读取时校验
+ * 预期:数据损坏时返回CrcCheckError，scan根据记录的crc计算校验值
+ */
+TEST_F(CSDataStore_test, PageChecksumTest) {
+    DataStoreOptions options;
+    options.baseDir = baseDir;
+    options.chunkSize = CHUNK_SIZE;
+    options.pageSize = PAGE_SIZE;
+    options.locationLimit = kLocationLimit;
+    options.enablePageChecksum = true;
+    dataStore = std::make_shared<CSDataStore>(lfs_, fpool_, options);
+    string chunk1CrcPath = string(chunk1Path) + "_crc";
+    string chunk2CrcPath = string(chunk2Path) + "_crc";
+    int crcFileSize = CHUNK_SIZE / PAGE_SIZE * sizeof(PageChecksum);
+    FakeEnv();
+    EXPECT_CALL(*lfs_, Open(chunk1CrcPath, _))
+        .WillOnce(Return(21));
+    EXPECT_CALL(*lfs_, Open(chunk2CrcPath, _))
+        .WillOnce(Return(22));
+    // chunk1还没有记录过crc，chunk2的page 2记录的crc为0
+    std::vector<char> crcFile(crcFileSize, 0);
+    PageChecksum zeroCrc{0, kPageChecksumValid};
+    memcpy(crcFile.data() + 2 * sizeof(PageChecksum), &zeroCrc,
+           sizeof(zeroCrc));
+    EXPECT_CALL(*lfs_, Read(21, NotNull(), 0, crcFileSize))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*lfs_, Read(22, NotNull(), 0, crcFileSize))
+        .WillOnce(DoAll(SetArrayArgument<1>(crcFile.begin(), crcFile.end()),
+                        Return(crcFileSize)));
+    EXPECT_TRUE(dataStore->Initialize());
+
+    // 写满page 0，根据写入的数据计算crc
+    char data[PAGE_SIZE];
+    memset(data, 'a', PAGE_SIZE);
+    uint32_t crc = ::curve::common::CRC32(data, PAGE_SIZE);
+    PageChecksum recordCrc{0, 0};
+    EXPECT_CALL(*lfs_, Write(22, Matcher<const char*>(NotNull()), 0, 8))
+        .WillOnce(Invoke([&recordCrc](int, const char* buf, uint64_t, int) {
+            memcpy(&recordCrc, buf, sizeof(recordCrc));
+            return 8;
+        }));
+    EXPECT_EQ(CSErrorCode::Success,
+              dataStore->WriteChunk(2, 2, data, 0, PAGE_SIZE, nullptr));
+    ASSERT_EQ(crc, recordCrc.crc);
+    ASSERT_EQ(kPageChecksumValid, recordCrc.flags);
+
+    // 读到的数据与crc一致
+    char buf[PAGE_SIZE];
+    EXPECT_CALL(*lfs_, Read(3, NotNull(), PAGE_SIZE, PAGE_SIZE))
+        .WillOnce(DoAll(SetArrayArgument<1>(data, data + PAGE_SIZE),
+                        Return(PAGE_SIZE)));
+    EXPECT_EQ(CSErrorCode::Success,
+              dataStore->ReadChunk(2, 2, buf, 0, PAGE_SIZE));
+
+    // 数据损坏
+    char badData[PAGE_SIZE];
+    memcpy(badData, data, PAGE_SIZE);
+    badData[100] = 'b';
+    EXPECT_CALL(*lfs_, Read(3, NotNull(), PAGE_SIZE, PAGE_SIZE))
+        .WillOnce(DoAll(SetArrayArgument<1>(badData, badData + PAGE_SIZE),
+                        Return(PAGE_SIZE)));
+    EXPECT_EQ(CSErrorCode::CrcCheckError,
+              dataStore->ReadChunk(2, 2, buf, 0, PAGE_SIZE));
+    ASSERT_EQ(1, dataStore->GetStatus().crcErrorCount);
+
+    // 部分读page 0，需要读取整个page校验
+    EXPECT_CALL(*lfs_, Read(3, NotNull(), PAGE_SIZE + 512, 512))
+        .WillOnce(Return(512));
+    EXPECT_CALL(*lfs_, Read(3, NotNull(), PAGE_SIZE, PAGE_SIZE))
+        .WillOnce(DoAll(SetArrayArgument<1>(data, data + PAGE_SIZE),
+                        Return(PAGE_SIZE)));
+    EXPECT_EQ(CSErrorCode::Success,
+              dataStore->ReadChunk(2, 2, buf, 512, 512));
+
+    // 没有记录crc的page不校验
+    EXPECT_CALL(*lfs_, Read(3, NotNull(), 2 * PAGE_SIZE, PAGE_SIZE))
+        .WillOnce(DoAll(SetArrayArgument<1>(badData, badData + PAGE_SIZE),
+                        Return(PAGE_SIZE)));
+    EXPECT_EQ(CSErrorCode::Success,
+              dataStore->ReadChunk(2, 2, buf, PAGE_SIZE, PAGE_SIZE));
+
+    // 记录的crc为0的page同样需要校验
+    EXPECT_CALL(*lfs_, Read(3, NotNull(), 3 * PAGE_SIZE, PAGE_SIZE))
+        .WillOnce(DoAll(SetArrayArgument<1>(data, data + PAGE_SIZE),
+                        Return(PAGE_SIZE)));
+    EXPECT_EQ(CSErrorCode::CrcCheckError,
+              dataStore->ReadChunk(2, 2, buf, 2 * PAGE_SIZE, PAGE_SIZE));
+    ASSERT_EQ(2, dataStore->GetStatus().crcErrorCount);
+
+    // 部分写page 1，从chunk文件读回整个page计算crc
+    EXPECT_CALL(*lfs_, Read(3, NotNull(), 2 * PAGE_SIZE, PAGE_SIZE))
+        .WillOnce(DoAll(SetArrayArgument<1>(data, data + PAGE_SIZE),
+                        Return(PAGE_SIZE)));
+    EXPECT_CALL(*lfs_, Write(22, Matcher<const char*>(NotNull()), 8, 8))
+        .WillOnce(Return(8));
+    EXPECT_EQ(CSErrorCode::Success,
+              dataStore->WriteChunk(2, 2, data, PAGE_SIZE + 512, 512, nullptr));
+
+    // scan根据记录的crc计算，不读取chunk数据
+    uint32_t expectCrc = 0;
+    expectCrc = ::curve::common::CRC32(
+        expectCrc, reinterpret_cast<const char*>(&crc), sizeof(crc));
+    expectCrc = ::curve::common::CRC32(
+        expectCrc, reinterpret_cast<const char*>(&crc), sizeof(crc));
+    uint32_t scanCrc = 0;
+    EXPECT_EQ(CSErrorCode::Success,
+              dataStore->GetChunkChecksum(2, 0, 2 * PAGE_SIZE, &scanCrc));
+    ASSERT_EQ(expectCrc, scanCrc);
+    EXPECT_EQ(CSErrorCode::InvalidArgError,
+              dataStore->GetChunkChecksum(2, 512, PAGE_SIZE, &scanCrc));
+
+    // 打快照时只sync写过的crc文件
+    EXPECT_CALL(*lfs_, Fsync(22))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*lfs_, Fsync(21))
+        .Times(0);
+    EXPECT_EQ(CSErrorCode::Success, dataStore->SyncChunkMetaPages());
+
+    // 删除chunk时删除crc文件
+    EXPECT_CALL(*lfs_, Delete(chunk2CrcPath))
+        .WillOnce(Return(0));
+    EXPECT_CALL(*lfs_, Close(22))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(3))
+        .Times(1);
+    EXPECT_EQ(CSErrorCode::Success, dataStore->DeleteChunk(2, 2));
+
+    EXPECT_CALL(*lfs_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(2))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(21))
+        .Times(1);
+}
+
+/**
+ * PageChecksumDisabledTest
+ * case:关闭page校验时存在crc文件
+ * 预期:crc文件可能已经过期，初始化时删除
+ */
+TEST_F(CSDataStore_test, PageChecksumDisabledTest) {
+    string chunk2CrcPath = string(chunk2Path) + "_crc";
+    FakeEnv();
+    vector<string> fileNames;
+    fileNames.push_back(chunk1);
+    fileNames.push_back(chunk1snap1);
+    fileNames.push_back(chunk2);
+    fileNames.push_back("chunk_2_crc");
+    EXPECT_CALL(*lfs_, List(baseDir, NotNull()))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(fileNames),
+                        Return(0)));
+    EXPECT_CALL(*lfs_, Delete(chunk2CrcPath))
+        .WillOnce(Return(0));
+    EXPECT_TRUE(dataStore->Initialize());
+
+    EXPECT_CALL(*lfs_, Close(1))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(2))
+        .Times(1);
+    EXPECT_CALL(*lfs_, Close(3))
+        .Times(1);
+}
+
 }  // namespace chunkserver
 }  // namespace curve
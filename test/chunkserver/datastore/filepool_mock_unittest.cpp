@@ -25,7 +25,10 @@
 #include <json/json.h>
 #include <fcntl.h>
 #include <climits>
+#include <chrono>  // NOLINT
 #include <memory>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "include/chunkserver/chunkserver_common.h"
 #include "src/common/crc32.h"
@@ -48,6 +51,7 @@ using ::testing::SetArgPointee;
 using ::testing::SetArrayArgument;
 
 using curve::fs::MockLocalFileSystem;
+using curve::fs::FileSystemInfo;
 using curve::common::kFilePoolMaigic;
 
 namespace curve {
@@ -984,5 +988,158 @@ TEST_F(CSChunkfilePoolMockTest, RecycleFileTest) {
     }
 }
 
+TEST_F(CSChunkfilePoolMockTest, RecycleFilesTest) {
+    // 初始化options
+    FilePoolOptions options;
+    options.getFileFromPool = true;
+    memcpy(options.filePoolDir, poolDir.c_str(), poolDir.size());
+    options.fileSize = CHUNK_SIZE;
+    options.metaPageSize = PAGE_SIZE;
+    memcpy(options.metaPath, poolMetaPath.c_str(), poolMetaPath.size());
+    options.metaFileSize = metaFileSize;
+    const std::string filePath2 = "./data/chunk_2";  // NOLINT
+    const std::string filePath3 = "./data/chunk_3";  // NOLINT
+    std::vector<std::string> paths{filePath2, filePath3, targetPath};
+    uint64_t recycledNum = 0;
+
+    /****************getFileFromPool为false**************/
+    options.getFileFromPool = false;
+    {
+        FilePool pool(lfs_);
+        FakePool(&pool, options, 0);
+        EXPECT_CALL(*lfs_, Delete(filePath2))
+            .WillOnce(Return(0));
+        EXPECT_CALL(*lfs_, Delete(filePath3))
+            .WillOnce(Return(-1));
+        EXPECT_CALL(*lfs_, Delete(targetPath))
+            .WillOnce(Return(0));
+        ASSERT_EQ(-1, pool.RecycleFiles(paths, &recycledNum));
+        ASSERT_EQ(2, recycledNum);
+    }
+
+    /****************getFileFromPool为true**************/
+    options.getFileFromPool = true;
+    // filePath2大小不匹配被删除，filePath3 rename失败，targetPath回收成功
+    {
+        FilePool pool(lfs_);
+        FakePool(&pool, options, 0);
+        struct stat badInfo;
+        badInfo.st_size = CHUNK_SIZE;
+        struct stat goodInfo;
+        goodInfo.st_size = CHUNK_SIZE + PAGE_SIZE;
+
+        EXPECT_CALL(*lfs_, Open(filePath2, _))
+            .WillOnce(Return(1));
+        EXPECT_CALL(*lfs_, Fstat(1, _))
+            .WillOnce(DoAll(SetArgPointee<1>(badInfo),
+                            Return(0)));
+        EXPECT_CALL(*lfs_, Close(1))
+            .Times(1);
+        EXPECT_CALL(*lfs_, Delete(filePath2))
+            .WillOnce(Return(0));
+        EXPECT_CALL(*lfs_, Open(filePath3, _))
+            .WillOnce(Return(2));
+        EXPECT_CALL(*lfs_, Open(targetPath, _))
+            .WillOnce(Return(2));
+        EXPECT_CALL(*lfs_, Fstat(2, _))
+            .Times(2)
+            .WillRepeatedly(DoAll(SetArgPointee<1>(goodInfo),
+                                  Return(0)));
+        EXPECT_CALL(*lfs_, Close(2))
+            .Times(2);
+        EXPECT_CALL(*lfs_, Rename(filePath3, _, _))
+            .WillOnce(Return(-1));
+        EXPECT_CALL(*lfs_, Rename(targetPath, _, _))
+            .WillOnce(Return(0));
+        ASSERT_EQ(-1, pool.RecycleFiles(paths, &recycledNum));
+        ASSERT_EQ(2, recycledNum);
+        ASSERT_EQ(1, pool.Size());
+    }
+
+    // 全部回收成功
+    {
+        FilePool pool(lfs_);
+        FakePool(&pool, options, 0);
+        struct stat fileInfo;
+        fileInfo.st_size = CHUNK_SIZE + PAGE_SIZE;
+
+        EXPECT_CALL(*lfs_, Open(_, _))
+            .Times(3)
+            .WillRepeatedly(Return(1));
+        EXPECT_CALL(*lfs_, Fstat(1, _))
+            .Times(3)
+            .WillRepeatedly(DoAll(SetArgPointee<1>(fileInfo),
+                                  Return(0)));
+        EXPECT_CALL(*lfs_, Close(1))
+            .Times(3);
+        EXPECT_CALL(*lfs_, Rename(_, _, _))
+            .Times(3)
+            .WillRepeatedly(Return(0));
+        ASSERT_EQ(0, pool.RecycleFiles(paths, &recycledNum));
+        ASSERT_EQ(3, recycledNum);
+        ASSERT_EQ(3, pool.Size());
+    }
+}
+
+TEST_F(CSChunkfilePoolMockTest, CalcCleanIntervalTest) {
+    using std::chrono::milliseconds;
+    // 前台延时超过阈值时加倍，直到上限
+    ASSERT_EQ(milliseconds(20),
+              FilePool::CalcCleanInterval(milliseconds(10), 2000, 1000));
+    ASSERT_EQ(milliseconds(2000),
+              FilePool::CalcCleanInterval(milliseconds(1500), 2000, 1000));
+    // 前台延时恢复后减半，直到下限
+    ASSERT_EQ(milliseconds(750),
+              FilePool::CalcCleanInterval(milliseconds(1500), 500, 1000));
+    ASSERT_EQ(milliseconds(10),
+              FilePool::CalcCleanInterval(milliseconds(10), 500, 1000));
+}
+
+TEST_F(CSChunkfilePoolMockTest, AllocateInBackgroundTest) {
+    // 初始化options
+    FilePoolOptions options;
+    options.getFileFromPool = true;
+    memcpy(options.filePoolDir, poolDir.c_str(), poolDir.size());
+    options.fileSize = CHUNK_SIZE;
+    options.metaPageSize = PAGE_SIZE;
+    memcpy(options.metaPath, poolMetaPath.c_str(), poolMetaPath.size());
+    options.metaFileSize = metaFileSize;
+    options.allocateInBackground = true;
+    options.allocatePercent = 50;
+
+    FilePool pool(lfs_);
+    FakePool(&pool, options, 0);
+
+    // 磁盘使用40%时继续分配，达到50%时停止分配
+    uint64_t chunklen = CHUNK_SIZE + PAGE_SIZE;
+    FileSystemInfo notFull;
+    notFull.total = 100 * chunklen;
+    notFull.available = 60 * chunklen;
+    FileSystemInfo full;
+    full.total = 100 * chunklen;
+    full.available = 50 * chunklen;
+    EXPECT_CALL(*lfs_, Statfs(_, _))
+        .WillOnce(DoAll(SetArgPointee<1>(notFull), Return(0)))
+        .WillOnce(DoAll(SetArgPointee<1>(notFull), Return(0)))
+        .WillOnce(DoAll(SetArgPointee<1>(full), Return(0)));
+    EXPECT_CALL(*lfs_, Open(_, _))
+        .Times(2)
+        .WillRepeatedly(Return(1));
+    EXPECT_CALL(*lfs_, Fallocate(1, 0, 0, chunklen))
+        .Times(2)
+        .WillRepeatedly(Return(0));
+    EXPECT_CALL(*lfs_, Fsync(1))
+        .Times(2)
+        .WillRepeatedly(Return(0));
+    EXPECT_CALL(*lfs_, Close(1))
+        .Times(2);
+
+    ASSERT_TRUE(pool.StartAllocating());
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    ASSERT_TRUE(pool.StopAllocating());
+    ASSERT_EQ(2, pool.Size());
+    ASSERT_EQ(2, pool.GetState().dirtyChunksLeft);
+}
+
 }  // namespace chunkserver
 }  // namespace curve
@@ -0,0 +1,137 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2026-10-17
+ * Author: curve
+ */
+
+/**
+ * CSMetaCache的并发查询压测工具，模拟多个apply线程并发查询chunk
+ * --shards=1时与原来单个读写锁保护整个map的实现等价
+ * 示例：
+ *   ./meta_cache_bench --chunks=50000 --threads=32 --shards=64 --runtime=10
+ */
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/chunkserver/datastore/chunkserver_datastore.h"
+
+DEFINE_uint64(chunks, 50000, "number of chunks in the cache");
+DEFINE_uint32(threads, 32, "number of threads looking up the cache");
+DEFINE_uint32(shards, 64, "number of shards of the cache");
+DEFINE_uint32(runtime, 10, "seconds to run");
+DEFINE_uint32(write_percent, 0, "percent of operations which remove and "
+              "set the chunk again, like deleting and creating chunks");
+
+using curve::chunkserver::ChunkID;
+using curve::chunkserver::ChunkOptions;
+using curve::chunkserver::CSChunkFile;
+using curve::chunkserver::CSChunkFilePtr;
+using curve::chunkserver::CSMetaCache;
+using curve::fs::FileSystemType;
+using curve::fs::LocalFileSystem;
+using curve::fs::LocalFsFactory;
+
+namespace {
+
+void RunJob(CSMetaCache* cache, const std::vector<CSChunkFilePtr>* chunks,
+            uint32_t jobIndex, const std::atomic<bool>* stop,
+            uint64_t* ops, uint64_t* misses) {
+    std::mt19937_64 rand(jobIndex);
+    uint64_t count = 0;
+    uint64_t missCount = 0;
+    while (!stop->load(std::memory_order_relaxed)) {
+        ChunkID id = rand() % FLAGS_chunks;
+        if (FLAGS_write_percent > 0 && rand() % 100 < FLAGS_write_percent) {
+            cache->Remove(id);
+            cache->Set(id, (*chunks)[id]);
+        } else if (cache->Get(id) == nullptr) {
+            ++missCount;
+        }
+        ++count;
+    }
+    *ops = count;
+    *misses = missCount;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    google::ParseCommandLineFlags(&argc, &argv, false);
+    google::InitGoogleLogging(argv[0]);
+    if (FLAGS_chunks == 0 || FLAGS_threads == 0) {
+        LOG(ERROR) << "Invalid chunks or threads";
+        return -1;
+    }
+
+    std::shared_ptr<LocalFileSystem> lfs =
+        LocalFsFactory::CreateFs(FileSystemType::EXT4, "");
+    CSMetaCache cache(FLAGS_shards);
+    std::vector<CSChunkFilePtr> chunks;
+    chunks.reserve(FLAGS_chunks);
+    for (ChunkID id = 0; id < FLAGS_chunks; ++id) {
+        ChunkOptions options;
+        options.id = id;
+        options.baseDir = "/meta_cache_bench";
+        options.chunkSize = 16 * 1024 * 1024;
+        options.pageSize = 4096;
+        chunks.push_back(std::make_shared<CSChunkFile>(lfs, nullptr, options));
+        cache.Set(id, chunks.back());
+    }
+
+    std::atomic<bool> stop(false);
+    std::vector<uint64_t> ops(FLAGS_threads, 0);
+    std::vector<uint64_t> misses(FLAGS_threads, 0);
+    std::vector<std::thread> jobs;
+    auto begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < FLAGS_threads; ++i) {
+        jobs.emplace_back(RunJob, &cache, &chunks, i, &stop,
+                          &ops[i], &misses[i]);
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(FLAGS_runtime));
+    stop.store(true);
+    for (auto& job : jobs) {
+        job.join();
+    }
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - begin).count();
+
+    uint64_t totalOps = 0;
+    uint64_t totalMisses = 0;
+    for (uint32_t i = 0; i < FLAGS_threads; ++i) {
+        totalOps += ops[i];
+        totalMisses += misses[i];
+    }
+    std::cout << "chunks=" << FLAGS_chunks
+              << ", threads=" << FLAGS_threads
+              << ", shards=" << FLAGS_shards
+              << ", write_percent=" << FLAGS_write_percent << std::endl
+              << "  ops=" << static_cast<uint64_t>(totalOps / seconds)
+              << "/s, per thread="
+              << static_cast<uint64_t>(totalOps / seconds / FLAGS_threads)
+              << "/s, misses=" << totalMisses << std::endl;
+    return 0;
+}
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/chunkserver/datastore/chunkserver_datastore.h"
+#include "test/fs/mock_local_filesystem.h"
+
+using curve::fs::MockLocalFileSystem;
+
+namespace curve {
+namespace chunkserver {
+
+class CSMetaCacheTest : public testing::Test {
+ public:
+    void SetUp() {
+        lfs_ = std::make_shared<MockLocalFileSystem>();
+    }
+
+    CSChunkFilePtr NewChunkFile(ChunkID id) {
+        ChunkOptions options;
+        options.id = id;
+        options.baseDir = "/meta_cache_test";
+        options.chunkSize = 16 * 1024 * 1024;
+        options.pageSize = 4096;
+        return std::make_shared<CSChunkFile>(lfs_, nullptr, options);
+    }
+
+ protected:
+    std::shared_ptr<MockLocalFileSystem> lfs_;
+};
+
+TEST_F(CSMetaCacheTest, BasicTest) {
+    CSMetaCache cache(4);
+    ASSERT_EQ(nullptr, cache.Get(1));
+
+    CSChunkFilePtr chunk1 = NewChunkFile(1);
+    ASSERT_EQ(chunk1, cache.Set(1, chunk1));
+    ASSERT_EQ(chunk1, cache.Get(1));
+    // the first set chunk file is kept
+    ASSERT_EQ(chunk1, cache.Set(1, NewChunkFile(1)));
+    ASSERT_EQ(chunk1, cache.Get(1));
+
+    for (ChunkID id = 2; id <= 10; ++id) {
+        cache.Set(id, NewChunkFile(id));
+    }
+    ASSERT_EQ(10, cache.Size());
+    ChunkMap chunkMap = cache.GetMap();
+    ASSERT_EQ(10, chunkMap.size());
+    ASSERT_EQ(chunk1, chunkMap[1]);
+
+    ChunkID sum = 0;
+    cache.ForEach([&](ChunkID id, const CSChunkFilePtr& chunkFile) {
+        ASSERT_EQ(cache.Get(id), chunkFile);
+        sum += id;
+    });
+    ASSERT_EQ(55, sum);
+
+    cache.Remove(1);
+    ASSERT_EQ(nullptr, cache.Get(1));
+    ASSERT_EQ(9, cache.Size());
+    // remove a chunk not exists
+    cache.Remove(1);
+
+    cache.Clear();
+    ASSERT_EQ(0, cache.Size());
+    ASSERT_EQ(nullptr, cache.Get(2));
+}
+
+TEST_F(CSMetaCacheTest, ConcurrentTest) {
+    CSMetaCache cache;
+    const int kThreadNum = 8;
+    const ChunkID kChunkNum = 1000;
+    std::vector<CSChunkFilePtr> chunks;
+    for (ChunkID id = 0; id < kChunkNum; ++id) {
+        chunks.push_back(NewChunkFile(id));
+    }
+
+    // every thread sets all the chunks, only one of them wins
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreadNum; ++i) {
+        threads.emplace_back([&]() {
+            for (ChunkID id = 0; id < kChunkNum; ++id) {
+                ASSERT_EQ(chunks[id], cache.Set(id, chunks[id]));
+                ASSERT_EQ(chunks[id], cache.Get(id));
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    ASSERT_EQ(kChunkNum, cache.Size());
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -27,6 +27,7 @@
 #include <gmock/gmock.h>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "src/chunkserver/datastore/file_pool.h"
 
@@ -50,6 +51,20 @@ class MockFilePool : public FilePool {
                 bool needClean = false) override {
         return GetFileImpl(chunkpath, metapage);
     };
+
+    int RecycleFiles(const std::vector<std::string>& chunkpaths,
+                     uint64_t* recycledNum) override {
+        int ret = 0;
+        *recycledNum = 0;
+        for (auto& chunkpath : chunkpaths) {
+            if (RecycleFile(chunkpath) != 0) {
+                ret = -1;
+            } else {
+                ++(*recycledNum);
+            }
+        }
+        return ret;
+    }
 };
 
 }  // namespace chunkserver
@@ -0,0 +1,143 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <memory>
+
+#include "src/chunkserver/datastore/page_cache.h"
+
+namespace curve {
+namespace chunkserver {
+
+const uint32_t kPageSize = 4096;
+
+class PageCacheTest : public testing::Test {
+ public:
+    void SetUp() {
+        PageCacheOptions options;
+        options.capacity = 16 * kPageSize;
+        options.pageSize = kPageSize;
+        options.shardNum = 1;
+        cache_ = std::make_shared<CSPageCache>(options);
+        owner_ = CSPageCache::NewOwner();
+    }
+    void TearDown() {}
+
+ protected:
+    std::shared_ptr<CSPageCache> cache_;
+    uint64_t owner_;
+};
+
+TEST_F(PageCacheTest, ReadAfterFill) {
+    char buf[4 * kPageSize];
+    char readBuf[4 * kPageSize];
+    memset(buf, 'a', sizeof(buf));
+
+    // nothing cached
+    ASSERT_FALSE(cache_->Read(owner_, 1, readBuf, 0, kPageSize));
+    ASSERT_EQ(1, cache_->GetMissCount());
+
+    cache_->Fill(owner_, 1, buf, 0, sizeof(buf));
+    ASSERT_EQ(4 * kPageSize, cache_->GetUsedBytes());
+    ASSERT_TRUE(cache_->Read(owner_, 1, readBuf, 0, sizeof(readBuf)));
+    ASSERT_EQ(0, memcmp(buf, readBuf, sizeof(buf)));
+    // unaligned read inside the cached pages
+    memset(readBuf, 0, sizeof(readBuf));
+    ASSERT_TRUE(cache_->Read(owner_, 1, readBuf, 512, 2 * kPageSize));
+    ASSERT_EQ(0, memcmp(buf, readBuf, 2 * kPageSize));
+    ASSERT_EQ(2, cache_->GetHitCount());
+
+    // partially cached range is a miss
+    ASSERT_FALSE(cache_->Read(owner_, 1, readBuf, 3 * kPageSize,
+                              2 * kPageSize));
+    // other chunk or other owner is a miss
+    ASSERT_FALSE(cache_->Read(owner_, 2, readBuf, 0, kPageSize));
+    ASSERT_FALSE(cache_->Read(CSPageCache::NewOwner(), 1, readBuf, 0,
+                              kPageSize));
+    ASSERT_EQ(4, cache_->GetMissCount());
+}
+
+TEST_F(PageCacheTest, FillPartialPage) {
+    char buf[2 * kPageSize];
+    char readBuf[kPageSize];
+    memset(buf, 'a', sizeof(buf));
+
+    // only page 1 is fully covered by [512, 512 + 2 * kPageSize)
+    cache_->Fill(owner_, 1, buf, 512, 2 * kPageSize - 512);
+    ASSERT_EQ(kPageSize, cache_->GetUsedBytes());
+    ASSERT_FALSE(cache_->Read(owner_, 1, readBuf, 0, kPageSize));
+    ASSERT_TRUE(cache_->Read(owner_, 1, readBuf, kPageSize, kPageSize));
+}
+
+TEST_F(PageCacheTest, UpdateAndInvalidate) {
+    char buf[2 * kPageSize];
+    char readBuf[2 * kPageSize];
+    memset(buf, 'a', sizeof(buf));
+    cache_->Fill(owner_, 1, buf, 0, kPageSize);
+
+    // update the cached page 0 and the uncached page 1
+    butil::IOBuf data;
+    data.resize(2 * kPageSize - 1024, 'b');
+    cache_->Update(owner_, 1, data, 1024, data.size());
+    ASSERT_EQ(kPageSize, cache_->GetUsedBytes());
+    ASSERT_TRUE(cache_->Read(owner_, 1, readBuf, 0, kPageSize));
+    memset(buf + 1024, 'b', kPageSize - 1024);
+    ASSERT_EQ(0, memcmp(buf, readBuf, kPageSize));
+    ASSERT_FALSE(cache_->Read(owner_, 1, readBuf, kPageSize, kPageSize));
+
+    cache_->Invalidate(owner_, 1, 0, 2 * kPageSize);
+    ASSERT_EQ(0, cache_->GetUsedBytes());
+    ASSERT_FALSE(cache_->Read(owner_, 1, readBuf, 0, kPageSize));
+}
+
+TEST_F(PageCacheTest, LruEvict) {
+    char buf[kPageSize];
+    char readBuf[kPageSize];
+    for (ChunkID id = 0; id < 16; ++id) {
+        memset(buf, 'a' + id, kPageSize);
+        cache_->Fill(owner_, id, buf, 0, kPageSize);
+    }
+    ASSERT_EQ(16 * kPageSize, cache_->GetUsedBytes());
+    // touch chunk 0, so chunk 1 is the least recently used
+    ASSERT_TRUE(cache_->Read(owner_, 0, readBuf, 0, kPageSize));
+
+    cache_->Fill(owner_, 16, buf, 0, kPageSize);
+    ASSERT_EQ(16 * kPageSize, cache_->GetUsedBytes());
+    ASSERT_TRUE(cache_->Read(owner_, 0, readBuf, 0, kPageSize));
+    ASSERT_FALSE(cache_->Read(owner_, 1, readBuf, 0, kPageSize));
+    ASSERT_TRUE(cache_->Read(owner_, 16, readBuf, 0, kPageSize));
+}
+
+TEST_F(PageCacheTest, ZeroCapacity) {
+    PageCacheOptions options;
+    options.capacity = 0;
+    CSPageCache cache(options);
+    char buf[kPageSize];
+    memset(buf, 'a', kPageSize);
+    cache.Fill(owner_, 1, buf, 0, kPageSize);
+    ASSERT_EQ(0, cache.GetUsedBytes());
+    ASSERT_FALSE(cache.Read(owner_, 1, buf, 0, kPageSize));
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,359 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+#include <bthread/bthread.h>
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <map>
+#include <thread>  // NOLINT
+
+#include "src/chunkserver/dmclock_scheduler.h"
+
+namespace curve {
+namespace chunkserver {
+
+namespace {
+
+const uint64_t kSecondUs = 1000000;
+
+// 从队列中取出一个请求并执行，返回是否取到，不限制copyset
+bool PopAndRun(DmClockQueue* queue, uint64_t nowUs,
+               QosPhase* phase, uint64_t* waitUs) {
+    QosTask task;
+    uint64_t copysetId;
+    uint32_t cost;
+    if (!queue->Pop(nowUs, [](uint64_t) { return true; }, &task,
+                    &copysetId, phase, &cost, waitUs)) {
+        return false;
+    }
+    task(*phase, cost);
+    return true;
+}
+
+}  // namespace
+
+TEST(DmClockSchedulerTest, CalcCostTest) {
+    ASSERT_EQ(1, DmClockScheduler::CalcCost(0));
+    ASSERT_EQ(1, DmClockScheduler::CalcCost(4096));
+    ASSERT_EQ(1, DmClockScheduler::CalcCost(64 * 1024));
+    ASSERT_EQ(2, DmClockScheduler::CalcCost(64 * 1024 + 1));
+    ASSERT_EQ(16, DmClockScheduler::CalcCost(1024 * 1024));
+}
+
+TEST(DmClockSchedulerTest, WeightTest) {
+    // 两个卷都有积压时，按权重分配
+    DmClockOptions options;
+    options.weight = 100;
+    DmClockQueue queue(options);
+    uint64_t now = 100 * kSecondUs;
+    std::map<uint32_t, int> served;
+    for (int i = 0; i < 100; ++i) {
+        for (uint32_t client : {1, 2}) {
+            queue.Push(QosClientKey{client, false}, 1, 1, 1, 1, now,
+                [&served, client](QosPhase, uint32_t) {
+                    ++served[client];
+                });
+        }
+    }
+    ASSERT_EQ(200, queue.Size());
+    ASSERT_EQ(2, queue.ClientCount());
+
+    QosPhase phase;
+    uint64_t waitUs = 0;
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(PopAndRun(&queue, now, &phase, &waitUs));
+        ASSERT_EQ(QosPhase::PRIORITY, phase);
+    }
+    ASSERT_EQ(50, served[1]);
+    ASSERT_EQ(50, served[2]);
+    ASSERT_EQ(100, queue.Size());
+}
+
+TEST(DmClockSchedulerTest, DeltaTest) {
+    // 卷1在其它chunkserver上完成了很多请求，delta大，在这里得到的份额少
+    DmClockOptions options;
+    DmClockQueue queue(options);
+    uint64_t now = 100 * kSecondUs;
+    std::map<uint32_t, int> served;
+    for (int i = 0; i < 40; ++i) {
+        queue.Push(QosClientKey{1, false}, 1, 3, 1, 1, now,
+            [&served](QosPhase, uint32_t) { ++served[1]; });
+        queue.Push(QosClientKey{2, false}, 1, 1, 1, 1, now,
+            [&served](QosPhase, uint32_t) { ++served[2]; });
+    }
+    QosPhase phase;
+    uint64_t waitUs = 0;
+    for (int i = 0; i < 40; ++i) {
+        ASSERT_TRUE(PopAndRun(&queue, now, &phase, &waitUs));
+    }
+    ASSERT_EQ(10, served[1]);
+    ASSERT_EQ(30, served[2]);
+}
+
+TEST(DmClockSchedulerTest, ReservationTest) {
+    // 卷1在其它chunkserver上很忙(delta大)，按权重只能得到很少的份额，
+    // 开启保底之后，每秒至少能处理reservation个请求
+    auto simulate = [](uint32_t reservation, std::map<uint32_t, int>* served,
+                       std::map<QosPhase, int>* phases) {
+        DmClockOptions options;
+        options.reservation = reservation;
+        DmClockQueue queue(options);
+        uint64_t now = 100 * kSecondUs;
+        for (int i = 0; i < 200; ++i) {
+            queue.Push(QosClientKey{1, false}, 1, 100, 1, 1, now,
+                [served](QosPhase, uint32_t) { ++(*served)[1]; });
+            queue.Push(QosClientKey{2, false}, 1, 1, 1, 1, now,
+                [served](QosPhase, uint32_t) { ++(*served)[2]; });
+        }
+        // 1秒内每10ms处理一个请求
+        QosPhase phase;
+        uint64_t waitUs = 0;
+        for (int i = 0; i < 100; ++i) {
+            ASSERT_TRUE(PopAndRun(&queue, now + i * kSecondUs / 100,
+                                  &phase, &waitUs));
+            ++(*phases)[phase];
+        }
+    };
+
+    std::map<uint32_t, int> served;
+    std::map<QosPhase, int> phases;
+    simulate(0, &served, &phases);
+    ASSERT_LE(served[1], 2);
+    ASSERT_EQ(0, phases[QosPhase::RESERVATION]);
+
+    served.clear();
+    phases.clear();
+    simulate(10, &served, &phases);
+    ASSERT_GE(served[1], 10);
+    ASSERT_GE(phases[QosPhase::RESERVATION], 10);
+    ASSERT_EQ(100, served[1] + served[2]);
+}
+
+TEST(DmClockSchedulerTest, LimitTest) {
+    // 卷1上限每秒2个请求
+    DmClockOptions options;
+    options.limit = 2;
+    DmClockQueue queue(options);
+    uint64_t now = 100 * kSecondUs;
+    int served = 0;
+    for (int i = 0; i < 3; ++i) {
+        queue.Push(QosClientKey{1, false}, 1, 1, 1, 1, now,
+            [&served](QosPhase, uint32_t) { ++served; });
+    }
+
+    QosPhase phase;
+    uint64_t waitUs = 0;
+    ASSERT_TRUE(PopAndRun(&queue, now, &phase, &waitUs));
+    ASSERT_FALSE(PopAndRun(&queue, now, &phase, &waitUs));
+    ASSERT_EQ(kSecondUs / 2 + 1, waitUs);
+    ASSERT_TRUE(PopAndRun(&queue, now + kSecondUs / 2, &phase, &waitUs));
+    ASSERT_FALSE(PopAndRun(&queue, now + kSecondUs / 2, &phase, &waitUs));
+    ASSERT_TRUE(PopAndRun(&queue, now + kSecondUs, &phase, &waitUs));
+    ASSERT_EQ(3, served);
+    ASSERT_EQ(0, queue.Size());
+
+    // 空闲的卷会被清理
+    options.idleTimeoutS = 10;
+    DmClockQueue queue2(options);
+    queue2.Push(QosClientKey{1, false}, 1, 1, 1, 1, now,
+                [](QosPhase, uint32_t) {});
+    ASSERT_TRUE(PopAndRun(&queue2, now, &phase, &waitUs));
+    queue2.RemoveIdleClients(now + kSecondUs);
+    ASSERT_EQ(1, queue2.ClientCount());
+    queue2.RemoveIdleClients(now + 10 * kSecondUs);
+    ASSERT_EQ(0, queue2.ClientCount());
+}
+
+TEST(DmClockSchedulerTest, CopysetDispatchableTest) {
+    // 所属copyset已经下发满的请求不参与选择，也不影响其它copyset的请求
+    DmClockOptions options;
+    DmClockQueue queue(options);
+    uint64_t now = 100 * kSecondUs;
+    std::map<uint32_t, int> served;
+    queue.Push(QosClientKey{1, false}, 1, 1, 1, 1, now,
+        [&served](QosPhase, uint32_t) { ++served[1]; });
+    queue.Push(QosClientKey{2, false}, 2, 100, 1, 1, now,
+        [&served](QosPhase, uint32_t) { ++served[2]; });
+
+    auto notCopyset1 = [](uint64_t copysetId) { return copysetId != 1; };
+    QosTask task;
+    uint64_t copysetId;
+    QosPhase phase;
+    uint32_t cost;
+    uint64_t waitUs = 0;
+    ASSERT_TRUE(queue.Pop(now, notCopyset1, &task, &copysetId, &phase,
+                          &cost, &waitUs));
+    ASSERT_EQ(2, copysetId);
+    task(phase, cost);
+    ASSERT_EQ(1, served[2]);
+    ASSERT_FALSE(queue.Pop(now, notCopyset1, &task, &copysetId, &phase,
+                           &cost, &waitUs));
+    ASSERT_EQ(0, waitUs);
+    ASSERT_EQ(1, queue.Size());
+    ASSERT_TRUE(PopAndRun(&queue, now, &phase, &waitUs));
+    ASSERT_EQ(1, served[1]);
+}
+
+TEST(DmClockSchedulerTest, SchedulerTest) {
+    DmClockOptions options;
+    options.maxInflight = 2;
+    DmClockScheduler scheduler(options);
+    ASSERT_EQ(0, scheduler.Start());
+
+    std::atomic<int> dispatched(0);
+    auto task = [&dispatched](QosPhase phase, uint32_t cost) {
+        ASSERT_EQ(1, cost);
+        dispatched.fetch_add(1);
+    };
+    for (int i = 0; i < 4; ++i) {
+        scheduler.Submit(QosClientKey{1, false}, 1, 1, 1, 4096, task);
+    }
+    // task返回之后请求还没有完成，仍然占用名额，最多同时下发2个请求
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ASSERT_EQ(2, dispatched.load());
+    // 请求完成之后才释放名额
+    scheduler.OnComplete(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ASSERT_EQ(3, dispatched.load());
+
+    // 停止时剩余的请求会被立即下发
+    scheduler.Stop();
+    ASSERT_EQ(4, dispatched.load());
+    scheduler.Submit(QosClientKey{1, false}, 1, 1, 1, 4096, task);
+    ASSERT_EQ(5, dispatched.load());
+}
+
+TEST(DmClockSchedulerTest, InflightPerCopysetTest) {
+    // 每个copyset同时只处理1个请求，copyset1处理不过来不影响copyset2
+    DmClockOptions options;
+    options.maxInflight = 4;
+    options.maxInflightPerCopyset = 1;
+    DmClockScheduler scheduler(options);
+    ASSERT_EQ(0, scheduler.Start());
+
+    std::atomic<int> served1(0);
+    std::atomic<int> served2(0);
+    for (int i = 0; i < 3; ++i) {
+        scheduler.Submit(QosClientKey{1, false}, 1, 1, 1, 4096,
+            [&served1](QosPhase, uint32_t) { served1.fetch_add(1); });
+    }
+    scheduler.Submit(QosClientKey{2, false}, 2, 1, 1, 4096,
+        [&served2](QosPhase, uint32_t) { served2.fetch_add(1); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ASSERT_EQ(1, served1.load());
+    ASSERT_EQ(1, served2.load());
+
+    scheduler.OnComplete(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ASSERT_EQ(2, served1.load());
+    // copyset2的名额不能给copyset1用
+    scheduler.OnComplete(2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ASSERT_EQ(2, served1.load());
+    scheduler.OnComplete(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ASSERT_EQ(3, served1.load());
+    scheduler.OnComplete(1);
+    scheduler.Stop();
+}
+
+TEST(DmClockSchedulerTest, SaturationReservationTest) {
+    // chunkserver处理能力饱和(同时只能处理1个请求，每个请求2ms)时，
+    // 卷1在其它chunkserver上很忙(delta大)，按权重几乎分不到处理能力，
+    // 开启保底之后每秒至少能处理reservation个请求
+    auto simulate = [](uint32_t reservation) {
+        DmClockOptions options;
+        options.reservation = reservation;
+        options.maxInflight = 1;
+        DmClockScheduler scheduler(options);
+        EXPECT_EQ(0, scheduler.Start());
+
+        std::atomic<bool> stopping(false);
+        std::atomic<int> served1(0);
+        std::atomic<int> served2(0);
+        auto makeTask = [&](std::atomic<int>* served) {
+            return [&, served](QosPhase, uint32_t) {
+                served->fetch_add(1);
+                if (!stopping.load()) {
+                    bthread_usleep(2000);
+                }
+                scheduler.OnComplete(1);
+            };
+        };
+        for (int i = 0; i < 500; ++i) {
+            scheduler.Submit(QosClientKey{1, false}, 1, 100, 1, 4096,
+                             makeTask(&served1));
+            scheduler.Submit(QosClientKey{2, false}, 1, 1, 1, 4096,
+                             makeTask(&served2));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        int result = served1.load();
+        // 饱和时请求在qos队列中排队，而不是全部被下发
+        EXPECT_LT(served1.load() + served2.load(), 1000);
+        stopping = true;
+        scheduler.Stop();
+        return result;
+    };
+
+    ASSERT_LE(simulate(0), 10);
+    // 500ms内保底100iops至少应处理50个请求，留出余量
+    ASSERT_GE(simulate(100), 30);
+}
+
+TEST(DmClockSchedulerTest, ClientKeyTest) {
+    butil::EndPoint peer1;
+    butil::EndPoint peer2;
+    butil::EndPoint peer3;
+    ASSERT_EQ(0, butil::str2endpoint("127.0.0.1:9000", &peer1));
+    ASSERT_EQ(0, butil::str2endpoint("127.0.0.1:9001", &peer2));
+    ASSERT_EQ(0, butil::str2endpoint("127.0.0.2:9000", &peer3));
+
+    // 带clientId的请求按clientId分卷，和地址无关，64位的inode id不截断
+    QosClientKey expect{100, false};
+    ASSERT_EQ(expect, DmClockScheduler::ClientKey(100, peer1));
+    ASSERT_EQ(expect, DmClockScheduler::ClientKey(100, peer2));
+    uint64_t bigId = (1ull << 32) | 100;
+    QosClientKey bigKey = DmClockScheduler::ClientKey(bigId, peer1);
+    ASSERT_FALSE(bigKey.legacy);
+    ASSERT_EQ(bigId, bigKey.id);
+    ASSERT_FALSE(bigKey == expect);
+    // 低32位为0的inode id也不会被当成老版本client
+    QosClientKey highKey = DmClockScheduler::ClientKey(1ull << 32, peer1);
+    ASSERT_FALSE(highKey.legacy);
+    ASSERT_EQ(1ull << 32, highKey.id);
+
+    // 老版本client按地址分卷，不和带clientId的卷冲突
+    QosClientKey key1 = DmClockScheduler::ClientKey(0, peer1);
+    QosClientKey key2 = DmClockScheduler::ClientKey(0, peer2);
+    QosClientKey key3 = DmClockScheduler::ClientKey(0, peer3);
+    ASSERT_TRUE(key1.legacy);
+    ASSERT_EQ(key1, DmClockScheduler::ClientKey(0, peer1));
+    ASSERT_FALSE(key1 == key2);
+    ASSERT_FALSE(key1 == key3);
+    ASSERT_FALSE(key2 == key3);
+    ASSERT_FALSE(key1 == DmClockScheduler::ClientKey(key1.id, peer1));
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -116,5 +116,69 @@ TEST(InflightThrottleTest, basic) {
     }
 }
 
+TEST(InflightThrottleTest, adaptive) {
+    InflightThrottleOptions options;
+    options.maxInflight = 1000;
+    options.minInflight = 10;
+    options.latencyTolerance = 2.0;
+    options.sampleWindowMs = 0;
+
+    // 每个窗口至少10个请求
+    auto feed = [](InflightThrottle* throttle, uint64_t latencyUs,
+                   int windows) {
+        for (int i = 0; i < windows * 10; ++i) {
+            throttle->OnResponse(latencyUs);
+        }
+    };
+
+    // 不开启自适应时上限不变
+    {
+        InflightThrottle inflightThrottle(options);
+        for (int i = 0; i < 600; ++i) {
+            inflightThrottle.Increment();
+        }
+        feed(&inflightThrottle, 1000, 10);
+        feed(&inflightThrottle, 100000, 10);
+        ASSERT_EQ(1000, inflightThrottle.GetLimit());
+        ASSERT_FALSE(inflightThrottle.IsOverLoad());
+        ASSERT_EQ(0, inflightThrottle.GetShedCount());
+    }
+
+    // 开启自适应
+    {
+        options.enableAdaptive = true;
+        InflightThrottle inflightThrottle(options);
+        for (int i = 0; i < 600; ++i) {
+            inflightThrottle.Increment();
+        }
+        ASSERT_EQ(600, inflightThrottle.GetInflightCount());
+
+        // 延时平稳时上限保持在最大值
+        feed(&inflightThrottle, 1000, 10);
+        ASSERT_EQ(1000, inflightThrottle.GetLimit());
+
+        // 延时上升，上限降低，超过上限的请求被拒绝
+        feed(&inflightThrottle, 10000, 10);
+        uint64_t limit = inflightThrottle.GetLimit();
+        ASSERT_LT(limit, 600);
+        ASSERT_GE(limit, 10);
+        ASSERT_TRUE(inflightThrottle.IsOverLoad());
+        ASSERT_TRUE(inflightThrottle.IsOverLoad());
+        ASSERT_EQ(2, inflightThrottle.GetShedCount());
+
+        // 上限不会低于最小值
+        feed(&inflightThrottle, 1000000, 50);
+        ASSERT_GE(inflightThrottle.GetLimit(), 10);
+
+        // 延时恢复后上限逐渐升高
+        limit = inflightThrottle.GetLimit();
+        feed(&inflightThrottle, 1000, 10);
+        ASSERT_GT(inflightThrottle.GetLimit(), limit);
+        feed(&inflightThrottle, 1000, 500);
+        ASSERT_EQ(1000, inflightThrottle.GetLimit());
+        ASSERT_FALSE(inflightThrottle.IsOverLoad());
+    }
+}
+
 }  // namespace chunkserver
 }  // namespace curve
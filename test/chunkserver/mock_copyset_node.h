@@ -43,6 +43,7 @@ class MockCopysetNode : public CopysetNode {
     MOCK_METHOD0(Run, int());
     MOCK_METHOD0(Fini, void());
     MOCK_CONST_METHOD0(IsLeaderTerm, bool());
+    MOCK_CONST_METHOD0(IsLeaseLeader, bool());
     MOCK_CONST_METHOD0(GetLeaderId, PeerId());
     MOCK_METHOD1(ListPeers, void(std::vector<Peer>*));
     MOCK_CONST_METHOD0(GetConfEpoch, uint64_t());
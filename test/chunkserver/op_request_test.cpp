@@ -835,5 +835,111 @@ TEST(ChunkOpRequestTest, OnApplyFromLogTest) {
     }
 }
 
+TEST(ChunkOpRequestTest, WriteChunkMergerTest) {
+    LogicPoolID logicPoolId = 1;
+    CopysetID copysetId = 10001;
+    uint64_t chunkId = 12345;
+    uint64_t sn = 1;
+    uint64_t appliedIndex = 12;
+    uint32_t pageSize = 4 * 1024;
+
+    Configuration conf;
+    std::shared_ptr<CopysetNode> nodePtr =
+        std::make_shared<CopysetNode>(logicPoolId, copysetId, conf);
+    std::shared_ptr<LocalFileSystem> fs(LocalFsFactory::CreateFs(FileSystemType::EXT4, ""));    //NOLINT
+    DataStoreOptions options;
+    options.baseDir = "./test-temp";
+    options.chunkSize = 16 * 1024 * 1024;
+    options.pageSize = pageSize;
+    std::shared_ptr<FakeCSDataStore> dataStore =
+        std::make_shared<FakeCSDataStore>(options, fs);
+    nodePtr->SetCSDateStore(dataStore);
+
+    auto makeRequest = [&](ChunkRequest *request, uint64_t offset,
+                           uint32_t size, butil::IOBuf *data, char c) {
+        request->set_optype(CHUNK_OP_TYPE::CHUNK_OP_WRITE);
+        request->set_logicpoolid(logicPoolId);
+        request->set_copysetid(copysetId);
+        request->set_chunkid(chunkId);
+        request->set_offset(offset);
+        request->set_size(size);
+        request->set_sn(sn);
+        data->clear();
+        data->append(std::string(size, c));
+    };
+
+    // from log: 相邻和重叠的请求合并成一次写，重叠部分以后面的请求为准
+    {
+        WriteChunkMerger merger(dataStore, 4 * pageSize);
+        ChunkRequest request;
+        butil::IOBuf data;
+        makeRequest(&request, pageSize, pageSize, &data, 'a');
+        ASSERT_TRUE(merger.Add(request, data));
+        makeRequest(&request, 2 * pageSize, pageSize, &data, 'b');
+        ASSERT_TRUE(merger.Add(request, data));
+        makeRequest(&request, 0, 2 * pageSize, &data, 'c');
+        ASSERT_TRUE(merger.Add(request, data));
+        // 不相邻
+        makeRequest(&request, 4 * pageSize, pageSize, &data, 'd');
+        ASSERT_FALSE(merger.Add(request, data));
+        // 超过最大长度
+        makeRequest(&request, 3 * pageSize, 2 * pageSize, &data, 'd');
+        ASSERT_FALSE(merger.Add(request, data));
+        // 版本号不同
+        makeRequest(&request, 3 * pageSize, pageSize, &data, 'd');
+        request.set_sn(sn + 1);
+        ASSERT_FALSE(merger.Add(request, data));
+        // 其他chunk
+        makeRequest(&request, 3 * pageSize, pageSize, &data, 'd');
+        request.set_chunkid(chunkId + 1);
+        ASSERT_FALSE(merger.Add(request, data));
+        ASSERT_EQ(3, merger.Size());
+        ASSERT_EQ(0, merger.Offset());
+        ASSERT_EQ(3 * pageSize, merger.Length());
+
+        merger.Apply();
+        ASSERT_FALSE(dataStore->HasInjectError());
+        std::string expect = std::string(2 * pageSize, 'c') +
+                             std::string(pageSize, 'b');
+        char buf[3 * 4 * 1024];
+        ASSERT_EQ(CSErrorCode::Success,
+                  dataStore->ReadChunk(chunkId, sn, buf, 0, 3 * pageSize));
+        ASSERT_EQ(expect, std::string(buf, 3 * pageSize));
+    }
+    // leader: 每个请求单独返回结果
+    {
+        WriteChunkMerger merger(dataStore, 4 * pageSize);
+        ChunkRequest request[2];
+        ChunkResponse response[2];
+        brpc::Controller cntl[2];
+        butil::IOBuf data;
+        makeRequest(&request[0], 0, pageSize, &data, 'e');
+        cntl[0].request_attachment().append(data);
+        makeRequest(&request[1], pageSize, pageSize, &data, 'f');
+        cntl[1].request_attachment().append(data);
+        OpFakeClosure done[2];
+        for (int i = 0; i < 2; ++i) {
+            std::shared_ptr<ChunkOpRequest> opReq =
+                std::make_shared<WriteChunkRequest>(nodePtr,
+                                                    &cntl[i],
+                                                    &request[i],
+                                                    &response[i],
+                                                    nullptr);
+            ASSERT_TRUE(merger.Add(opReq, appliedIndex + i, &done[i]));
+        }
+        // from log的请求不能与leader上的请求合并
+        ChunkRequest logRequest;
+        makeRequest(&logRequest, 0, pageSize, &data, 'g');
+        ASSERT_FALSE(merger.Add(logRequest, data));
+
+        dataStore->InjectError(CSErrorCode::BackwardRequestError);
+        merger.Apply();
+        for (int i = 0; i < 2; ++i) {
+            ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_BACKWARD,
+                      response[i].status());
+        }
+    }
+}
+
 }  // namespace chunkserver
 }  // namespace curve
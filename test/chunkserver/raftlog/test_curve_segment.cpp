@@ -141,7 +141,10 @@ TEST_F(CurveSegmentTest, open_segment) {
     ASSERT_TRUE(seg1->is_open());
 
     // append entry
+    uint64_t copyBytes = GetWalCopyBytes();
     append_entries_curve_segment(seg1);
+    // direct write需要把数据拷贝到对齐的内存中
+    ASSERT_GT(GetWalCopyBytes(), copyBytes);
 
     // read entry
     read_entries_curve_segment(seg1);
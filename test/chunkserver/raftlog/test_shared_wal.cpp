@@ -0,0 +1,280 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+#include <braft/configuration_manager.h>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/chunkserver/raftlog/shared_wal.h"
+#include "src/chunkserver/raftlog/shared_wal_log_storage.h"
+
+namespace curve {
+namespace chunkserver {
+
+const char kSharedWalDataDir[] = "./shared-wal-data";
+const char kSharedWalDir[] = "./shared-wal-data/wal";
+
+class SharedWalTest : public testing::Test {
+ protected:
+    void SetUp() {
+        std::string cmd = std::string("mkdir -p ") + kSharedWalDataDir;
+        ::system(cmd.c_str());
+        options_.dir = kSharedWalDir;
+        options_.segmentSize = 64 * 1024;
+        // 测试中手动触发回收
+        options_.reclaimIntervalS = 3600;
+        ASSERT_EQ(0, wal_.Init(options_));
+    }
+
+    void TearDown() {
+        wal_.Fini();
+        std::string cmd = std::string("rm -rf ") + kSharedWalDataDir;
+        ::system(cmd.c_str());
+    }
+
+    std::string CopysetPath(int id) {
+        return std::string(kSharedWalDataDir) + "/copysets/" +
+               std::to_string(id) + "/log";
+    }
+
+    std::shared_ptr<braft::LogStorage> NewStorage(int id) {
+        std::shared_ptr<braft::LogStorage> storage =
+            std::make_shared<SharedWalLogStorage>(CopysetPath(id), &wal_);
+        braft::ConfigurationManager configManager;
+        if (storage->init(&configManager) != 0) {
+            return nullptr;
+        }
+        return storage;
+    }
+
+    void AppendEntries(std::shared_ptr<braft::LogStorage> storage,
+                       int64_t first, int64_t last, int64_t term = 1) {
+        std::vector<braft::LogEntry*> entries;
+        for (int64_t i = first; i <= last; ++i) {
+            braft::LogEntry* entry = new braft::LogEntry();
+            entry->AddRef();
+            entry->type = braft::ENTRY_TYPE_DATA;
+            entry->id.term = term;
+            entry->id.index = i;
+            entry->data.append(std::string(100, 'a' + i % 26));
+            entries.push_back(entry);
+        }
+        ASSERT_EQ(entries.size(), storage->append_entries(entries));
+        for (auto entry : entries) {
+            entry->Release();
+        }
+    }
+
+    void CheckEntries(std::shared_ptr<braft::LogStorage> storage,
+                      int64_t first, int64_t last, int64_t term = 1) {
+        ASSERT_EQ(first, storage->first_log_index());
+        ASSERT_EQ(last, storage->last_log_index());
+        for (int64_t i = first; i <= last; ++i) {
+            braft::LogEntry* entry = storage->get_entry(i);
+            ASSERT_NE(nullptr, entry);
+            ASSERT_EQ(braft::ENTRY_TYPE_DATA, entry->type);
+            ASSERT_EQ(term, entry->id.term);
+            ASSERT_EQ(term, storage->get_term(i));
+            ASSERT_EQ(std::string(100, 'a' + i % 26),
+                      entry->data.to_string());
+            entry->Release();
+        }
+        ASSERT_EQ(nullptr, storage->get_entry(last + 1));
+        ASSERT_EQ(0, storage->get_term(last + 1));
+    }
+
+    void Restart() {
+        wal_.Fini();
+        ASSERT_EQ(0, wal_.Init(options_));
+    }
+
+    SharedWalOptions options_;
+    SharedWal wal_;
+};
+
+TEST_F(SharedWalTest, AppendAndTruncate) {
+    auto storage = NewStorage(1);
+    ASSERT_NE(nullptr, storage);
+    ASSERT_EQ(1, storage->first_log_index());
+    ASSERT_EQ(0, storage->last_log_index());
+
+    AppendEntries(storage, 1, 100);
+    CheckEntries(storage, 1, 100);
+
+    // 同一个目录不能被打开两次
+    ASSERT_EQ(nullptr, NewStorage(1));
+
+    ASSERT_EQ(0, storage->truncate_prefix(21));
+    CheckEntries(storage, 21, 100);
+    ASSERT_EQ(nullptr, storage->get_entry(20));
+
+    ASSERT_EQ(0, storage->truncate_suffix(80));
+    CheckEntries(storage, 21, 80);
+    AppendEntries(storage, 81, 90, 2);
+    ASSERT_EQ(2, storage->get_term(90));
+    ASSERT_EQ(1, storage->get_term(80));
+
+    ASSERT_EQ(0, storage->reset(1000));
+    ASSERT_EQ(1000, storage->first_log_index());
+    ASSERT_EQ(999, storage->last_log_index());
+    AppendEntries(storage, 1000, 1010);
+    CheckEntries(storage, 1000, 1010);
+}
+
+TEST_F(SharedWalTest, RecoverAfterRestart) {
+    {
+        auto storage1 = NewStorage(1);
+        auto storage2 = NewStorage(2);
+        ASSERT_NE(nullptr, storage1);
+        ASSERT_NE(nullptr, storage2);
+        // 交替写入，两个copyset的entry交织在同一组日志文件中
+        for (int i = 0; i < 20; ++i) {
+            AppendEntries(storage1, i * 50 + 1, (i + 1) * 50);
+            AppendEntries(storage2, i * 30 + 1, (i + 1) * 30);
+        }
+        ASSERT_EQ(0, storage1->truncate_prefix(101));
+        ASSERT_EQ(0, storage1->truncate_suffix(900));
+        ASSERT_EQ(0, storage2->reset(500));
+        ASSERT_GT(wal_.GetSegmentCount(), 1);
+    }
+
+    Restart();
+    auto storage1 = NewStorage(1);
+    auto storage2 = NewStorage(2);
+    CheckEntries(storage1, 101, 900);
+    CheckEntries(storage2, 500, 499);
+    AppendEntries(storage2, 500, 510);
+    CheckEntries(storage2, 500, 510);
+}
+
+TEST_F(SharedWalTest, ReclaimSegments) {
+    auto storage1 = NewStorage(1);
+    auto storage2 = NewStorage(2);
+    ASSERT_NE(nullptr, storage1);
+    ASSERT_NE(nullptr, storage2);
+    for (int i = 0; i < 20; ++i) {
+        AppendEntries(storage1, i * 50 + 1, (i + 1) * 50);
+        AppendEntries(storage2, i * 50 + 1, (i + 1) * 50);
+    }
+    uint32_t before = wal_.GetSegmentCount();
+    ASSERT_GT(before, 2);
+
+    // copyset2仍然引用第一个文件，不能回收
+    ASSERT_EQ(0, storage1->truncate_prefix(1001));
+    ASSERT_EQ(0, wal_.Reclaim());
+
+    // 两个copyset都截断后，除了当前文件都可以回收
+    ASSERT_EQ(0, storage2->truncate_prefix(1001));
+    ASSERT_EQ(before - 1, wal_.Reclaim());
+    ASSERT_EQ(1, wal_.GetSegmentCount());
+
+    // 回收之后重启，空日志的起始index不变
+    storage1.reset();
+    storage2.reset();
+    Restart();
+    storage1 = NewStorage(1);
+    storage2 = NewStorage(2);
+    CheckEntries(storage1, 1001, 1000);
+    AppendEntries(storage1, 1001, 1100);
+    CheckEntries(storage1, 1001, 1100);
+
+    // copyset目录被删除后，索引和引用的文件一起回收
+    storage1.reset();
+    std::string cmd = "rm -rf " + CopysetPath(1);
+    ::system(cmd.c_str());
+    for (int i = 0; i < 20; ++i) {
+        AppendEntries(storage2, 1001 + i * 50, 1000 + (i + 1) * 50);
+    }
+    ASSERT_EQ(0, storage2->truncate_prefix(2001));
+    ASSERT_GT(wal_.Reclaim(), 0);
+    ASSERT_EQ(1, wal_.GetSegmentCount());
+}
+
+TEST_F(SharedWalTest, RecreateCopyset) {
+    auto storage1 = NewStorage(1);
+    auto storage2 = NewStorage(2);
+    ASSERT_NE(nullptr, storage1);
+    ASSERT_NE(nullptr, storage2);
+    AppendEntries(storage1, 1, 100);
+    AppendEntries(storage2, 1, 100);
+
+    // copyset被删除后在同一路径重建，回收之前不能看到旧的日志
+    storage1.reset();
+    std::string cmd = "rm -rf " + CopysetPath(1);
+    ::system(cmd.c_str());
+    storage1 = NewStorage(1);
+    ASSERT_NE(nullptr, storage1);
+    CheckEntries(storage1, 1, 0);
+    AppendEntries(storage1, 1, 10, 2);
+    CheckEntries(storage1, 1, 10, 2);
+
+    // 重启回放旧copyset的记录后，仍然只有重建之后的日志
+    storage1.reset();
+    storage2.reset();
+    Restart();
+    storage1 = NewStorage(1);
+    storage2 = NewStorage(2);
+    CheckEntries(storage1, 1, 10, 2);
+    CheckEntries(storage2, 1, 100);
+
+    // 重建后还没有写入就重启
+    storage1.reset();
+    cmd = "rm -rf " + CopysetPath(1);
+    ::system(cmd.c_str());
+    storage1 = NewStorage(1);
+    ASSERT_NE(nullptr, storage1);
+    storage1.reset();
+    Restart();
+    storage1 = NewStorage(1);
+    CheckEntries(storage1, 1, 0);
+}
+
+TEST_F(SharedWalTest, ConcurrentAppend) {
+    const int kCopysetNum = 8;
+    const int kLoop = 50;
+    std::vector<std::shared_ptr<braft::LogStorage>> storages;
+    for (int i = 0; i < kCopysetNum; ++i) {
+        storages.push_back(NewStorage(i));
+        ASSERT_NE(nullptr, storages.back());
+    }
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kCopysetNum; ++i) {
+        auto storage = storages[i];
+        threads.emplace_back([this, storage, kLoop]() {
+            for (int j = 0; j < kLoop; ++j) {
+                AppendEntries(storage, j * 4 + 1, (j + 1) * 4);
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    for (auto storage : storages) {
+        CheckEntries(storage, 1, kLoop * 4);
+    }
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -0,0 +1,159 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/chunkserver/raftlog/wal_group_commit.h"
+
+namespace curve {
+namespace chunkserver {
+
+const char kGroupCommitDir[] = "./wal-group-commit-data";
+
+class WalGroupCommitTest : public testing::Test {
+ protected:
+    void SetUp() {
+        std::string cmd = std::string("mkdir -p ") + kGroupCommitDir;
+        ::system(cmd.c_str());
+        for (int i = 0; i < kFileNum; ++i) {
+            std::string path = std::string(kGroupCommitDir) + "/" +
+                               std::to_string(i);
+            int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+            ASSERT_GE(fd, 0);
+            fds_.push_back(fd);
+        }
+    }
+
+    void TearDown() {
+        for (int fd : fds_) {
+            ::close(fd);
+        }
+        std::string cmd = std::string("rm -rf ") + kGroupCommitDir;
+        ::system(cmd.c_str());
+        FLAGS_walGroupCommitMaxDelayUs = 200;
+        FLAGS_walGroupCommitMaxBatch = 256;
+        FLAGS_walGroupCommitUseSyncfs = false;
+    }
+
+    static const int kFileNum = 8;
+    std::vector<int> fds_;
+};
+
+TEST_F(WalGroupCommitTest, SyncOneFile) {
+    WalGroupCommitter committer;
+    ASSERT_EQ(4, ::pwrite(fds_[0], "test", 4, 0));
+    ASSERT_EQ(0, committer.Sync(fds_[0]));
+    ASSERT_EQ(1, committer.GetFlushCount());
+    ASSERT_EQ(1, committer.GetRequestCount());
+
+    // 无效的fd返回错误
+    ASSERT_EQ(-1, committer.Sync(-1));
+    ASSERT_EQ(EBADF, errno);
+
+    // 停止之后直接fsync
+    committer.Stop();
+    ASSERT_EQ(0, committer.Sync(fds_[0]));
+    ASSERT_EQ(2, committer.GetFlushCount());
+}
+
+TEST_F(WalGroupCommitTest, CoalesceManyFiles) {
+    // 窗口足够长，所有请求合并到少数几个窗口中
+    FLAGS_walGroupCommitMaxDelayUs = 50000;
+    FLAGS_walGroupCommitMaxBatch = kFileNum;
+    for (bool useSyncfs : {true, false}) {
+        FLAGS_walGroupCommitUseSyncfs = useSyncfs;
+        WalGroupCommitter committer;
+        const int kLoop = 10;
+        std::vector<std::thread> threads;
+        std::atomic<int> failed(0);
+        for (int i = 0; i < kFileNum; ++i) {
+            int fd = fds_[i];
+            threads.emplace_back([&committer, &failed, fd, kLoop]() {
+                for (int j = 0; j < kLoop; ++j) {
+                    if (::pwrite(fd, "test", 4, j * 4) != 4 ||
+                        committer.Sync(fd) != 0) {
+                        failed.fetch_add(1);
+                    }
+                }
+            });
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+        ASSERT_EQ(0, failed.load());
+        ASSERT_EQ(kFileNum * kLoop, committer.GetRequestCount());
+        if (useSyncfs) {
+            ASSERT_LT(committer.GetFlushCount(), kFileNum * kLoop);
+        } else {
+            ASSERT_LE(committer.GetFlushCount(), kFileNum * kLoop);
+        }
+    }
+}
+
+TEST_F(WalGroupCommitTest, NoWindowWithoutSyncfs) {
+    // 不使用syncfs时不等待窗口，请求立即落盘
+    FLAGS_walGroupCommitMaxDelayUs = 10 * 1000 * 1000;
+    FLAGS_walGroupCommitUseSyncfs = false;
+    WalGroupCommitter committer;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    std::atomic<int> failed(0);
+    for (int i = 0; i < kFileNum; ++i) {
+        int fd = fds_[i];
+        threads.emplace_back([&committer, &failed, fd]() {
+            if (::pwrite(fd, "test", 4, 0) != 4 || committer.Sync(fd) != 0) {
+                failed.fetch_add(1);
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    ASSERT_EQ(0, failed.load());
+    ASSERT_EQ(static_cast<uint64_t>(kFileNum), committer.GetRequestCount());
+    ASSERT_LT(std::chrono::steady_clock::now() - start,
+              std::chrono::seconds(5));
+}
+
+TEST_F(WalGroupCommitTest, StopWithPendingRequest) {
+    FLAGS_walGroupCommitMaxDelayUs = 10 * 1000 * 1000;
+    FLAGS_walGroupCommitUseSyncfs = true;
+    WalGroupCommitter committer;
+    std::thread th([&committer, this]() {
+        ASSERT_EQ(0, committer.Sync(fds_[0]));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // 停止时不再等待窗口结束，已提交的请求立即落盘
+    committer.Stop();
+    th.join();
+    ASSERT_EQ(1, committer.GetRequestCount());
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -25,6 +25,7 @@
 #include <brpc/controller.h>
 #include <brpc/server.h>
 #include "src/chunkserver/raftsnapshot/curve_file_service.h"
+#include "src/chunkserver/raftsnapshot/curve_snapshot_digest.h"
 #include "src/chunkserver/raftsnapshot/curve_filesystem_adaptor.h"
 #include "test/chunkserver/raftsnapshot/mock_file_reader.h"
 #include "test/chunkserver/raftsnapshot/mock_snapshot_attachment.h"
@@ -90,6 +91,114 @@ TEST_F(CurveFileServiceTest, success_normal_file) {
     kCurveFileService.remove_reader(reader_id);
 }
 
+TEST_F(CurveFileServiceTest, file_digest) {
+    int64_t reader_id;
+    ASSERT_EQ(0, kCurveFileService.add_reader(reader_, &reader_id));
+    std::string path = "/test";
+    EXPECT_CALL(*reader_, path())
+        .WillRepeatedly(ReturnRef(path));
+    brpc::Channel channel;
+    ASSERT_EQ(channel.Init(serverAddr, nullptr), 0);
+    braft::FileService_Stub stub(&channel);
+    braft::GetFileRequest request;
+    request.set_reader_id(reader_id);
+    request.set_filename(GetDigestFilename("../../data/chunk_1"));
+    request.set_count(1024);
+    request.set_offset(0);
+
+    // 获取摘要成功，不会走read_file
+    butil::IOBuf buf;
+    buf.append("digest");
+    EXPECT_CALL(*reader_, read_file(_, _, _, _, _, _, _))
+        .Times(0);
+    EXPECT_CALL(*reader_, read_file_digest(_, "../../data/chunk_1",
+                                           0, 1024, _, _))
+        .WillOnce(DoAll(SetArgPointee<0>(buf),
+                        SetArgPointee<4>(buf.size()),
+                        SetArgPointee<5>(true),
+                        Return(0)));
+    {
+        brpc::Controller cntl;
+        braft::GetFileResponse response;
+        stub.get_file(&cntl, &request, &response, nullptr);
+        ASSERT_FALSE(cntl.Failed());
+        ASSERT_TRUE(response.eof());
+        ASSERT_EQ(buf.size(), response.read_size());
+    }
+
+    // 文件不在快照中
+    EXPECT_CALL(*reader_, read_file_digest(_, _, _, _, _, _))
+        .WillOnce(Return(ENOENT));
+    {
+        brpc::Controller cntl;
+        braft::GetFileResponse response;
+        stub.get_file(&cntl, &request, &response, nullptr);
+        ASSERT_TRUE(cntl.Failed());
+        ASSERT_EQ(ENOENT, cntl.ErrorCode());
+    }
+    kCurveFileService.remove_reader(reader_id);
+}
+
+TEST_F(CurveFileServiceTest, skip_hole) {
+    int64_t reader_id;
+    ASSERT_EQ(0, kCurveFileService.add_reader(reader_, &reader_id));
+    std::string path = "/test";
+    EXPECT_CALL(*reader_, path())
+        .WillRepeatedly(ReturnRef(path));
+    const uint32_t pageSize = 4096;
+    // metapage + 3个数据页，第1个数据页为全零，第3个数据页在clone源上
+    butil::IOBuf buf;
+    buf.append(std::string(pageSize, 'a'));
+    buf.append(std::string(pageSize, '\0'));
+    buf.append(std::string(pageSize, 'b'));
+    buf.append(std::string(pageSize, 'c'));
+    std::shared_ptr<curve::common::Bitmap> bitmap =
+        std::make_shared<curve::common::Bitmap>(3);
+    bitmap->Set(0);
+    bitmap->Set(1);
+
+    brpc::Channel channel;
+    ASSERT_EQ(channel.Init(serverAddr, nullptr), 0);
+    braft::FileService_Stub stub(&channel);
+    braft::GetFileRequest request;
+    request.set_reader_id(reader_id);
+    request.set_filename("../../data/chunk_1");
+    request.set_count(buf.size());
+    request.set_offset(0);
+
+    FLAGS_raftSnapshotSkipHole = true;
+    EXPECT_CALL(*reader_, read_file(_, _, _, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<0>(buf),
+                        SetArgPointee<5>(buf.size()),
+                        SetArgPointee<6>(true),
+                        Return(0)));
+    EXPECT_CALL(*reader_, read_chunk_bitmap("../../data/chunk_1", _, _))
+        .WillOnce(DoAll(SetArgPointee<1>(bitmap),
+                        SetArgPointee<2>(pageSize),
+                        Return(0)));
+    brpc::Controller cntl;
+    braft::GetFileResponse response;
+    stub.get_file(&cntl, &request, &response, nullptr);
+    FLAGS_raftSnapshotSkipHole = false;
+    ASSERT_FALSE(cntl.Failed());
+    ASSERT_EQ(buf.size(), response.read_size());
+
+    // 只传输了metapage和第2个数据页
+    braft::FileSegData segData(cntl.response_attachment());
+    uint64_t segOffset = 0;
+    butil::IOBuf seg;
+    ASSERT_EQ(pageSize, segData.next(&segOffset, &seg));
+    ASSERT_EQ(0, segOffset);
+    ASSERT_EQ(std::string(pageSize, 'a'), seg.to_string());
+    seg.clear();
+    ASSERT_EQ(pageSize, segData.next(&segOffset, &seg));
+    ASSERT_EQ(2 * pageSize, segOffset);
+    ASSERT_EQ(std::string(pageSize, 'b'), seg.to_string());
+    seg.clear();
+    ASSERT_EQ(0, segData.next(&segOffset, &seg));
+    kCurveFileService.remove_reader(reader_id);
+}
+
 TEST_F(CurveFileServiceTest, success_attach_file) {
     int64_t reader_id;
     ASSERT_EQ(0, kCurveFileService.add_reader(reader_, &reader_id));
@@ -0,0 +1,135 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+#include <glog/logging.h>
+#include <brpc/server.h>
+#include <braft/snapshot.h>
+#include <bthread/bthread.h>
+#include <atomic>
+#include <string>
+
+#include "src/chunkserver/raftsnapshot/curve_file_service.h"
+#include "src/chunkserver/raftsnapshot/curve_filesystem_adaptor.h"
+#include "src/chunkserver/raftsnapshot/curve_snapshot_copier.h"
+#include "src/chunkserver/raftsnapshot/curve_snapshot_storage.h"
+#include "src/common/timeutility.h"
+#include "test/chunkserver/raftsnapshot/mock_file_reader.h"
+
+namespace curve {
+namespace chunkserver {
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::ReturnRef;
+
+const char kCopierServerAddr[] = "127.0.0.1:9503";
+const char kCopierDataDir[] = "./copier_data";
+const char kFailedFile[] = "file_0";
+// 下载慢的文件每次只读一个字节，不被取消的话要下载很久
+const off_t kSlowFileSize = 1000;
+const int kFileNum = 4;
+
+TEST(CurveSnapshotCopierTest, ParallelCopyWithOneFailedFile) {
+    FLAGS_raftSnapshotCopyConcurrency = kFileNum;
+    ::system((std::string("rm -rf ") + kCopierDataDir).c_str());
+
+    brpc::Server server;
+    ASSERT_EQ(0, server.AddService(&kCurveFileService,
+                                   brpc::SERVER_DOESNT_OWN_SERVICE));
+    ASSERT_EQ(0, server.Start(kCopierServerAddr, nullptr));
+
+    // leader上的快照包含kFileNum个文件，其中一个读失败
+    braft::LocalSnapshotMetaTable metaTable;
+    braft::SnapshotMeta meta;
+    meta.set_last_included_index(1000);
+    meta.set_last_included_term(2);
+    metaTable.set_meta(meta);
+    for (int i = 0; i < kFileNum; ++i) {
+        braft::LocalFileMeta fileMeta;
+        ASSERT_EQ(0, metaTable.add_file("file_" + std::to_string(i),
+                                        fileMeta));
+    }
+    butil::IOBuf metaBuf;
+    ASSERT_EQ(0, metaTable.save_to_iobuf_as_remote(&metaBuf));
+
+    std::atomic<int> slowReads(0);
+    scoped_refptr<MockFileReader> reader(
+        new MockFileReader(new CurveFilesystemAdaptor(), nullptr));
+    std::string path = "/test";
+    EXPECT_CALL(*reader, path())
+        .WillRepeatedly(ReturnRef(path));
+    EXPECT_CALL(*reader, read_file(_, _, _, _, _, _, _))
+        .WillRepeatedly(Invoke([&](butil::IOBuf* out,
+                                   const std::string& filename,
+                                   off_t offset, size_t, bool,
+                                   size_t* readCount, bool* isEof) {
+            if (filename == BRAFT_SNAPSHOT_META_FILE) {
+                out->append(metaBuf);
+                *readCount = metaBuf.size();
+                *isEof = true;
+                return 0;
+            }
+            if (filename == kFailedFile) {
+                return EIO;
+            }
+            slowReads.fetch_add(1);
+            bthread_usleep(100 * 1000);
+            out->append("a");
+            *readCount = 1;
+            *isEof = offset + 1 >= kSlowFileSize;
+            return 0;
+        }));
+    int64_t readerId = 0;
+    ASSERT_EQ(0, kCurveFileService.add_reader(reader, &readerId));
+
+    scoped_refptr<braft::PosixFileSystemAdaptor> fs(
+                new braft::PosixFileSystemAdaptor());
+    CurveSnapshotStorage* storage = new CurveSnapshotStorage(kCopierDataDir);
+    ASSERT_EQ(0, storage->set_file_system_adaptor(fs));
+    ASSERT_EQ(0, storage->init());
+
+    std::string uri = std::string("remote://") + kCopierServerAddr + "/" +
+                      std::to_string(readerId);
+    uint64_t startMs = curve::common::TimeUtility::GetTimeofDayMs();
+    braft::SnapshotCopier* copier = storage->start_to_copy_from(uri);
+    ASSERT_TRUE(copier != nullptr);
+    copier->join();
+    uint64_t costMs = curve::common::TimeUtility::GetTimeofDayMs() - startMs;
+
+    // 失败文件的错误传递给了copier，而不是其他下载被取消的错误
+    ASSERT_FALSE(copier->ok());
+    ASSERT_EQ(EIO, copier->error_code());
+    // 其他文件的下载被取消，没有等到下载完成
+    ASSERT_LT(slowReads.load(), (kFileNum - 1) * kSlowFileSize);
+    ASSERT_LT(costMs, 30 * 1000);
+    ASSERT_EQ(0, storage->close(copier));
+
+    kCurveFileService.remove_reader(readerId);
+    server.Stop(0);
+    server.Join();
+    delete storage;
+    ::system((std::string("rm -rf ") + kCopierDataDir).c_str());
+}
+
+}  // namespace chunkserver
+}  // namespace curve
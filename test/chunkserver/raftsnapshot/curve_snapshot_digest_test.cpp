@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+#include <openssl/sha.h>
+#include <algorithm>
+#include <string>
+
+#include "src/chunkserver/raftsnapshot/curve_snapshot_digest.h"
+#include "src/chunkserver/raftsnapshot/define.h"
+
+namespace curve {
+namespace chunkserver {
+
+std::string Sha256(const char* data, size_t length) {
+    unsigned char hash[SHA256_DIGEST_LENGTH];
+    SHA256(reinterpret_cast<const unsigned char*>(data), length, hash);
+    return std::string(reinterpret_cast<char*>(hash), sizeof(hash));
+}
+
+// 内存中的文件，用于计算摘要
+class MemFileAdaptor : public braft::FileAdaptor {
+ public:
+    explicit MemFileAdaptor(const std::string& content) : content_(content) {}
+    ssize_t write(const butil::IOBuf& data, off_t offset) override {
+        return -1;
+    }
+    ssize_t read(butil::IOPortal* portal, off_t offset, size_t size) override {
+        if (offset >= static_cast<off_t>(content_.size())) {
+            return 0;
+        }
+        size_t length = std::min(size, content_.size() - offset);
+        portal->append(content_.data() + offset, length);
+        return length;
+    }
+    ssize_t size() override { return content_.size(); }
+    bool sync() override { return true; }
+    bool close() override { return true; }
+
+ private:
+    std::string content_;
+};
+
+TEST(CurveSnapshotDigestTest, ComputeTest) {
+    std::string content(10 * 1024, 'a');
+    content.replace(4096, 1024, 1024, 'b');
+    MemFileAdaptor file(content);
+    FileDigest digest;
+    ASSERT_EQ(0, ComputeFileDigest(&file, 4096, &digest));
+    ASSERT_EQ(4096, digest.rangeSize);
+    ASSERT_EQ(content.size(), digest.fileSize);
+    ASSERT_EQ(3, digest.ranges.size());
+    ASSERT_EQ(4096, digest.RangeLength(0));
+    ASSERT_EQ(2048, digest.RangeLength(2));
+    ASSERT_EQ(0, digest.RangeLength(3));
+    for (size_t i = 0; i < digest.ranges.size(); ++i) {
+        ASSERT_EQ(Sha256(content.data() + i * 4096, digest.RangeLength(i)),
+                  digest.ranges[i]);
+    }
+    ASSERT_NE(digest.ranges[0], digest.ranges[1]);
+    ASSERT_EQ(Sha256(content.data(), content.size()), digest.fileHash);
+
+    butil::IOBuf data;
+    data.append(content.data(), 4096);
+    ASSERT_EQ(digest.ranges[0], CalcRangeDigest(data));
+
+    // 空文件没有range
+    MemFileAdaptor empty("");
+    ASSERT_EQ(0, ComputeFileDigest(&empty, 4096, &digest));
+    ASSERT_EQ(0, digest.fileSize);
+    ASSERT_TRUE(digest.ranges.empty());
+    ASSERT_EQ(Sha256("", 0), digest.fileHash);
+}
+
+TEST(CurveSnapshotDigestTest, EncodeDecodeTest) {
+    FileDigest digest;
+    digest.rangeSize = 4096;
+    digest.fileSize = 3 * 4096 - 100;
+    digest.fileHash = Sha256("file", 4);
+    digest.ranges = {Sha256("a", 1), Sha256("b", 1), Sha256("c", 1)};
+    butil::IOBuf buf;
+    digest.Encode(&buf);
+
+    FileDigest decoded;
+    ASSERT_EQ(0, decoded.Decode(buf));
+    ASSERT_EQ(digest.rangeSize, decoded.rangeSize);
+    ASSERT_EQ(digest.fileSize, decoded.fileSize);
+    ASSERT_EQ(digest.fileHash, decoded.fileHash);
+    ASSERT_EQ(digest.ranges, decoded.ranges);
+
+    // 数据不完整
+    butil::IOBuf truncated;
+    buf.append_to(&truncated, buf.size() - 1);
+    ASSERT_EQ(-1, decoded.Decode(truncated));
+    butil::IOBuf empty;
+    ASSERT_EQ(-1, decoded.Decode(empty));
+
+    // range个数与文件大小不匹配
+    digest.fileSize = 4 * 4096;
+    butil::IOBuf mismatch;
+    digest.Encode(&mismatch);
+    ASSERT_EQ(-1, decoded.Decode(mismatch));
+}
+
+TEST(CurveSnapshotDigestTest, FilenameTest) {
+    std::string source;
+    std::string digestName = GetDigestFilename("../../data/chunk_1");
+    ASSERT_TRUE(IsDigestFilename(digestName, &source));
+    ASSERT_EQ("../../data/chunk_1", source);
+    ASSERT_FALSE(IsDigestFilename("../../data/chunk_1", &source));
+    ASSERT_FALSE(IsDigestFilename(SNAPSHOT_DIGEST_SUFFIX, &source));
+}
+
+}  // namespace chunkserver
+}  // namespace curve
@@ -26,6 +26,7 @@
 #include <gmock/gmock.h>
 #include <gmock/gmock-generated-function-mockers.h>
 #include <gmock/internal/gmock-generated-internal-utils.h>
+#include <memory>
 #include <string>
 #include <vector>
 #include "src/chunkserver/raftsnapshot/curve_snapshot_file_reader.h"
@@ -42,6 +43,12 @@ class MockFileReader : public CurveSnapshotFileReader {
     virtual ~MockFileReader() {}
     MOCK_CONST_METHOD7(read_file, int(butil::IOBuf*, const std::string&,
                           off_t, size_t, bool, size_t*, bool*));
+    MOCK_CONST_METHOD6(read_file_digest, int(butil::IOBuf*,
+                          const std::string&, off_t, size_t,
+                          size_t*, bool*));
+    MOCK_CONST_METHOD3(read_chunk_bitmap, int(const std::string&,
+                          std::shared_ptr<curve::common::Bitmap>*,
+                          uint32_t*));
     MOCK_CONST_METHOD0(path, const std::string&());
 };
 
@@ -0,0 +1,71 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/client/dmclock_tracker.h"
+
+namespace curve {
+namespace client {
+
+TEST(DmClockTrackerTest, DeltaRhoTest) {
+    DmClockTracker tracker;
+    QosRequestParas paras;
+    QosResponseParas reservation;
+    reservation.set_phase(0);
+    QosResponseParas priority;
+    priority.set_phase(1);
+
+    // 第一次发往chunkserver的请求delta/rho都为1
+    tracker.PrepareRequest(1, &paras);
+    ASSERT_EQ(1, paras.dmclockdelta());
+    ASSERT_EQ(1, paras.dmclockrho());
+    tracker.PrepareRequest(2, &paras);
+    ASSERT_EQ(1, paras.dmclockdelta());
+    ASSERT_EQ(1, paras.dmclockrho());
+
+    // chunkserver 2上完成了3个请求，其中1个在reservation阶段
+    tracker.OnResponse(2, reservation);
+    tracker.OnResponse(2, priority);
+    tracker.OnResponse(2, priority);
+    tracker.PrepareRequest(1, &paras);
+    ASSERT_EQ(4, paras.dmclockdelta());
+    ASSERT_EQ(2, paras.dmclockrho());
+
+    // chunkserver 2自己完成的请求不计入
+    tracker.PrepareRequest(2, &paras);
+    ASSERT_EQ(1, paras.dmclockdelta());
+    ASSERT_EQ(1, paras.dmclockrho());
+
+    // chunkserver 1上完成的请求计入发往chunkserver 2的请求
+    tracker.OnResponse(1, reservation);
+    tracker.OnResponse(1, reservation);
+    tracker.PrepareRequest(2, &paras);
+    ASSERT_EQ(3, paras.dmclockdelta());
+    ASSERT_EQ(3, paras.dmclockrho());
+    tracker.PrepareRequest(1, &paras);
+    ASSERT_EQ(1, paras.dmclockdelta());
+    ASSERT_EQ(1, paras.dmclockrho());
+}
+
+}  // namespace client
+}  // namespace curve
@@ -0,0 +1,183 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+/**
+ * client MetaCache的并发查询压测工具，模拟IO路径上多个bthread并发查询
+ * chunk信息、leader和appliedindex
+ * 示例：
+ *   ./metacache_bench --chunks=100000 --copysets=1000 --bthreads=64
+ */
+
+#include <bthread/bthread.h>
+#include <butil/time.h>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <atomic>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "src/client/metacache.h"
+
+DEFINE_uint32(chunks, 100000, "number of chunks in the cache");
+DEFINE_uint32(copysets, 1000, "number of copysets in the cache");
+DEFINE_uint32(bthreads, 64, "number of bthreads looking up the cache");
+DEFINE_uint32(runtime, 10, "seconds to run");
+DEFINE_uint32(update_percent, 0, "percent of operations which update the "
+              "leader of copyset, like leader redirect");
+
+using curve::client::ChunkIDInfo;
+using curve::client::ChunkServerAddr;
+using curve::client::ChunkServerID;
+using curve::client::CopysetInfo;
+using curve::client::CopysetPeerInfo;
+using curve::client::FInfo;
+using curve::client::MetaCache;
+using curve::client::MetaCacheErrorType;
+
+namespace {
+
+const curve::client::LogicPoolID kLogicPoolId = 1;
+const uint32_t kPeerNum = 3;
+
+struct JobContext {
+    MetaCache* cache;
+    uint32_t jobIndex;
+    const std::atomic<bool>* stop;
+    uint64_t ops;
+    uint64_t misses;
+};
+
+butil::EndPoint PeerAddr(uint32_t copysetId, uint32_t peerIndex) {
+    butil::EndPoint ep;
+    butil::str2endpoint("127.0.0.1", 8200 + (copysetId + peerIndex) % 100,
+                        &ep);
+    return ep;
+}
+
+void* RunJob(void* arg) {
+    JobContext* ctx = static_cast<JobContext*>(arg);
+    std::mt19937 rand(ctx->jobIndex);
+    uint64_t count = 0;
+    uint64_t missCount = 0;
+    while (!ctx->stop->load(std::memory_order_relaxed)) {
+        ChunkIDInfo chunkInfo;
+        if (ctx->cache->GetChunkInfoByIndex(rand() % FLAGS_chunks,
+                                            &chunkInfo) !=
+            MetaCacheErrorType::OK) {
+            ++missCount;
+            continue;
+        }
+
+        if (FLAGS_update_percent > 0 && rand() % 100 < FLAGS_update_percent) {
+            ctx->cache->UpdateLeader(
+                chunkInfo.lpid_, chunkInfo.cpid_,
+                PeerAddr(chunkInfo.cpid_, rand() % kPeerNum));
+        }
+
+        ChunkServerID leaderId;
+        butil::EndPoint leaderAddr;
+        if (ctx->cache->GetLeader(chunkInfo.lpid_, chunkInfo.cpid_, &leaderId,
+                                  &leaderAddr) != 0) {
+            ++missCount;
+        }
+        uint64_t appliedIndex =
+            ctx->cache->GetAppliedIndex(chunkInfo.lpid_, chunkInfo.cpid_);
+        ctx->cache->UpdateAppliedIndex(chunkInfo.lpid_, chunkInfo.cpid_,
+                                       appliedIndex + 1);
+        ++count;
+    }
+    ctx->ops = count;
+    ctx->misses = missCount;
+    return nullptr;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    google::ParseCommandLineFlags(&argc, &argv, false);
+    google::InitGoogleLogging(argv[0]);
+    if (FLAGS_chunks == 0 || FLAGS_copysets == 0 || FLAGS_bthreads == 0) {
+        LOG(ERROR) << "Invalid chunks, copysets or bthreads";
+        return -1;
+    }
+
+    FInfo fileInfo;
+    fileInfo.chunksize = 16 * 1024 * 1024;
+    fileInfo.segmentsize = 1024 * 1024 * 1024;
+    MetaCache cache;
+    cache.UpdateFileInfo(fileInfo);
+
+    for (uint32_t cpid = 1; cpid <= FLAGS_copysets; ++cpid) {
+        CopysetInfo info;
+        info.cpid_ = cpid;
+        for (uint32_t i = 0; i < kPeerNum; ++i) {
+            ChunkServerAddr addr(PeerAddr(cpid, i));
+            info.AddCopysetPeerInfo(CopysetPeerInfo(cpid * kPeerNum + i,
+                                                    addr, addr));
+        }
+        info.UpdateLeaderIndex(0);
+        cache.UpdateCopysetInfo(kLogicPoolId, cpid, info);
+    }
+    for (uint32_t i = 0; i < FLAGS_chunks; ++i) {
+        cache.UpdateChunkInfoByIndex(
+            i, ChunkIDInfo(i + 1, kLogicPoolId, i % FLAGS_copysets + 1));
+    }
+
+    std::atomic<bool> stop(false);
+    std::vector<JobContext> ctxs(FLAGS_bthreads);
+    std::vector<bthread_t> tids(FLAGS_bthreads);
+    butil::Timer timer;
+    timer.start();
+    for (uint32_t i = 0; i < FLAGS_bthreads; ++i) {
+        ctxs[i] = {&cache, i, &stop, 0, 0};
+        if (0 != bthread_start_background(&tids[i], nullptr, RunJob,
+                                          &ctxs[i])) {
+            LOG(ERROR) << "Start bthread failed";
+            return -1;
+        }
+    }
+    bthread_usleep(FLAGS_runtime * 1000000ull);
+    stop.store(true);
+    for (uint32_t i = 0; i < FLAGS_bthreads; ++i) {
+        bthread_join(tids[i], nullptr);
+    }
+    timer.stop();
+    double seconds = timer.u_elapsed() / 1000000.0;
+
+    uint64_t totalOps = 0;
+    uint64_t totalMisses = 0;
+    for (const auto& ctx : ctxs) {
+        totalOps += ctx.ops;
+        totalMisses += ctx.misses;
+    }
+    std::cout << "chunks=" << FLAGS_chunks
+              << ", copysets=" << FLAGS_copysets
+              << ", bthreads=" << FLAGS_bthreads
+              << ", update_percent=" << FLAGS_update_percent << std::endl
+              << "  ops=" << static_cast<uint64_t>(totalOps / seconds)
+              << "/s, per bthread="
+              << static_cast<uint64_t>(totalOps / seconds / FLAGS_bthreads)
+              << "/s, misses=" << totalMisses << std::endl;
+    return 0;
+}
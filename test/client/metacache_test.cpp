@@ -110,5 +110,54 @@ TEST_F(MetaCacheTest, TestCleanChunksInSegment) {
     }
 }
 
+TEST_F(MetaCacheTest, TestLeaderSnapshot) {
+    const LogicPoolID lpid = 1;
+    const CopysetID cpid = 1;
+    ChunkServerID leaderId = 0;
+    butil::EndPoint leaderAddr;
+
+    // copyset不存在
+    ASSERT_EQ(-1, metaCache_.GetLeader(lpid, cpid, &leaderId, &leaderAddr));
+
+    CopysetInfo info;
+    info.cpid_ = cpid;
+    std::vector<butil::EndPoint> addrs;
+    for (int i = 0; i < 3; ++i) {
+        butil::EndPoint ep;
+        butil::str2endpoint("127.0.0.1", 9000 + i, &ep);
+        addrs.push_back(ep);
+        ChunkServerAddr addr(ep);
+        info.AddCopysetPeerInfo(CopysetPeerInfo(i + 1, addr, addr));
+    }
+
+    // leader未知
+    metaCache_.UpdateCopysetInfo(lpid, cpid, info);
+    ASSERT_EQ(-1, metaCache_.GetLeader(lpid, cpid, &leaderId, &leaderAddr));
+
+    info.UpdateLeaderIndex(1);
+    metaCache_.UpdateCopysetInfo(lpid, cpid, info);
+    ASSERT_EQ(0, metaCache_.GetLeader(lpid, cpid, &leaderId, &leaderAddr));
+    ASSERT_EQ(2, leaderId);
+    ASSERT_EQ(addrs[1], leaderAddr);
+
+    // leader重定向后快照随之更新
+    ASSERT_EQ(0, metaCache_.UpdateLeader(lpid, cpid, addrs[2]));
+    ASSERT_EQ(0, metaCache_.GetLeader(lpid, cpid, &leaderId, &leaderAddr));
+    ASSERT_EQ(3, leaderId);
+    ASSERT_EQ(addrs[2], leaderAddr);
+    ASSERT_EQ(2, metaCache_.GetCopysetinfo(lpid, cpid).GetCurrentLeaderIndex());
+
+    // 不在复制组中的地址
+    butil::EndPoint other;
+    butil::str2endpoint("127.0.0.1", 9100, &other);
+    ASSERT_EQ(-1, metaCache_.UpdateLeader(lpid, cpid, other));
+    ASSERT_EQ(0, metaCache_.GetLeader(lpid, cpid, &leaderId, &leaderAddr));
+    ASSERT_EQ(3, leaderId);
+
+    metaCache_.UpdateAppliedIndex(lpid, cpid, 100);
+    ASSERT_EQ(100, metaCache_.GetAppliedIndex(lpid, cpid));
+    ASSERT_FALSE(metaCache_.IsLeaderMayChange(lpid, cpid));
+}
+
 }  // namespace client
 }  // namespace curve
@@ -175,6 +175,11 @@ class MockChunkServiceImpl : public ChunkService {
         const ::curve::chunkserver::ChunkRequest *request,
         ::curve::chunkserver::ChunkResponse *response,
         google::protobuf::Closure *done));
+    MOCK_METHOD4(BatchChunk, void(::google::protobuf::RpcController
+        *controller,
+        const ::curve::chunkserver::BatchChunkRequest *request,
+        ::curve::chunkserver::BatchChunkResponse *response,
+        google::protobuf::Closure *done));
 
     void DelegateToFake() {
         ON_CALL(*this, WriteChunk(_, _, _, _))
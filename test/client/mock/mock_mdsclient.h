@@ -24,6 +24,8 @@
 
 #include <gmock/gmock.h>
 
+#include <vector>
+
 #include "src/client/mds_client.h"
 
 namespace curve {
@@ -32,6 +34,13 @@ namespace client {
 class MockMDSClient : public MDSClient {
  public:
     MOCK_METHOD2(DeAllocateSegment, LIBCURVE_ERROR(const FInfo*, uint64_t));
+    MOCK_METHOD4(AllocateSegments,
+                 LIBCURVE_ERROR(const FInfo*, uint64_t, uint32_t,
+                                std::vector<SegmentInfo>*));
+    MOCK_METHOD3(GetServerList,
+                 LIBCURVE_ERROR(const LogicPoolID&,
+                                const std::vector<CopysetID>&,
+                                std::vector<CopysetInfo>*));
 };
 
 }  // namespace client
@@ -0,0 +1,259 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include "src/client/read_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace curve {
+namespace client {
+
+const uint32_t kBlockSize = 4096;
+// blocks of the same shard
+const uint64_t kShardStride = 16;
+
+class ReadCacheTest : public ::testing::Test {
+ public:
+    void SetUp() override {
+        metric_.reset(new ReadCacheMetric("ReadCacheTest"));
+        option_.enable = true;
+        option_.blockSize = kBlockSize;
+        // 16 blocks for each shard
+        option_.memCapacityMB = 1;
+    }
+
+    void InitCache() {
+        cache_.reset(new ReadCache(option_, metric_.get()));
+        cache_->Init("ReadCacheTest.cache");
+    }
+
+    // data of each block is filled with its block index
+    static butil::IOBuf MakeData(uint64_t offset, uint64_t length) {
+        std::string data(length, '\0');
+        for (uint64_t i = 0; i < length; ++i) {
+            data[i] = static_cast<char>((offset + i) / kBlockSize);
+        }
+        butil::IOBuf buf;
+        buf.append(data.data(), data.size());
+        return buf;
+    }
+
+    void PutBlocks(uint64_t offset, uint64_t length) {
+        cache_->Put(cache_->BeginRead(), offset, MakeData(offset, length));
+    }
+
+    // blocks are written to disk tier in background
+    void WaitDiskWrites() {
+        while (metric_->diskPendingWrites.get_value() > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    bool Check(uint64_t offset, uint64_t length) {
+        std::string buf(length, '\0');
+        if (!cache_->Get(offset, length, &buf[0])) {
+            return false;
+        }
+        return buf == MakeData(offset, length).to_string();
+    }
+
+ protected:
+    ReadCacheOption option_;
+    std::unique_ptr<ReadCacheMetric> metric_;
+    std::unique_ptr<ReadCache> cache_;
+};
+
+TEST_F(ReadCacheTest, TestGetAndPut) {
+    InitCache();
+
+    ASSERT_FALSE(Check(0, kBlockSize));
+    ASSERT_EQ(1, metric_->miss.get_value());
+
+    PutBlocks(0, 4 * kBlockSize);
+    ASSERT_TRUE(Check(0, 4 * kBlockSize));
+    ASSERT_TRUE(Check(kBlockSize, kBlockSize));
+    ASSERT_TRUE(Check(512, 3 * kBlockSize));
+    ASSERT_FALSE(Check(3 * kBlockSize, 2 * kBlockSize));
+    ASSERT_EQ(3, metric_->hit.get_value());
+    ASSERT_EQ(2, metric_->miss.get_value());
+    ASSERT_EQ(4 * kBlockSize, metric_->memUsedBytes.get_value());
+
+    butil::IOBuf buf;
+    ASSERT_TRUE(cache_->Get(1024, kBlockSize, &buf));
+    ASSERT_EQ(MakeData(1024, kBlockSize).to_string(), buf.to_string());
+    ASSERT_FALSE(cache_->Get(4 * kBlockSize, kBlockSize, &buf));
+    ASSERT_EQ(0, buf.size());
+}
+
+TEST_F(ReadCacheTest, TestOnlyFullBlocksCached) {
+    InitCache();
+
+    // block 0 and block 3 are not fully covered
+    PutBlocks(512, 3 * kBlockSize);
+    ASSERT_FALSE(Check(0, kBlockSize));
+    ASSERT_TRUE(Check(kBlockSize, 2 * kBlockSize));
+    ASSERT_FALSE(Check(3 * kBlockSize, kBlockSize));
+}
+
+TEST_F(ReadCacheTest, TestWriteInvalidate) {
+    InitCache();
+
+    PutBlocks(0, 4 * kBlockSize);
+
+    // write invalidates blocks it touches
+    cache_->OnWriteStart(kBlockSize + 512, 512);
+    ASSERT_TRUE(Check(0, kBlockSize));
+    ASSERT_FALSE(Check(kBlockSize, kBlockSize));
+    ASSERT_TRUE(Check(2 * kBlockSize, 2 * kBlockSize));
+
+    // reads issued during a write can't fill cache
+    ASSERT_EQ(0, cache_->BeginRead());
+    cache_->OnWriteDone();
+
+    // reads issued before a write can't fill cache
+    uint64_t token = cache_->BeginRead();
+    ASSERT_NE(0, token);
+    cache_->OnWriteStart(0, kBlockSize);
+    cache_->OnWriteDone();
+    cache_->Put(token, kBlockSize, MakeData(kBlockSize, kBlockSize));
+    ASSERT_FALSE(Check(kBlockSize, kBlockSize));
+
+    PutBlocks(kBlockSize, kBlockSize);
+    ASSERT_TRUE(Check(kBlockSize, kBlockSize));
+
+    // invalidate a range larger than cache capacity
+    cache_->OnWriteStart(0, 1ull << 30);
+    cache_->OnWriteDone();
+    ASSERT_FALSE(Check(2 * kBlockSize, kBlockSize));
+    ASSERT_EQ(0, metric_->memUsedBytes.get_value());
+}
+
+TEST_F(ReadCacheTest, TestLRU) {
+    InitCache();
+
+    for (uint64_t i = 0; i < 16; ++i) {
+        PutBlocks(i * kShardStride * kBlockSize, kBlockSize);
+    }
+
+    // block 0 is the most recently used now, block 16 will be evicted
+    ASSERT_TRUE(Check(0, kBlockSize));
+    PutBlocks(16 * kShardStride * kBlockSize, kBlockSize);
+
+    ASSERT_TRUE(Check(0, kBlockSize));
+    ASSERT_FALSE(Check(kShardStride * kBlockSize, kBlockSize));
+    ASSERT_TRUE(Check(16 * kShardStride * kBlockSize, kBlockSize));
+    ASSERT_EQ(16 * kBlockSize, metric_->memUsedBytes.get_value());
+}
+
+TEST_F(ReadCacheTest, TestDiskTier) {
+    option_.diskCacheDir = ".";
+    // 16 blocks for each shard
+    option_.diskCapacityMB = 1;
+    InitCache();
+
+    for (uint64_t i = 0; i < 32; ++i) {
+        PutBlocks(i * kShardStride * kBlockSize, kBlockSize);
+    }
+    ASSERT_EQ(16 * kBlockSize, metric_->memUsedBytes.get_value());
+    ASSERT_EQ(16 * kBlockSize, metric_->diskUsedBytes.get_value());
+    WaitDiskWrites();
+
+    // oldest blocks are moved to disk tier, and back to memory on hit
+    ASSERT_TRUE(Check(0, kBlockSize));
+    ASSERT_EQ(1, metric_->diskHit.get_value());
+    ASSERT_TRUE(Check(31 * kShardStride * kBlockSize, kBlockSize));
+    ASSERT_EQ(1, metric_->diskHit.get_value());
+
+    // blocks evicted from disk tier are dropped
+    WaitDiskWrites();
+    PutBlocks(32 * kShardStride * kBlockSize, kBlockSize);
+    PutBlocks(33 * kShardStride * kBlockSize, kBlockSize);
+    ASSERT_FALSE(Check(kShardStride * kBlockSize, kBlockSize));
+    ASSERT_FALSE(Check(2 * kShardStride * kBlockSize, kBlockSize));
+    ASSERT_TRUE(Check(3 * kShardStride * kBlockSize, kBlockSize));
+    ASSERT_EQ(2, metric_->diskHit.get_value());
+
+    // invalidate blocks in disk tier
+    cache_->OnWriteStart(0, 64 * kShardStride * kBlockSize);
+    cache_->OnWriteDone();
+    ASSERT_EQ(0, metric_->memUsedBytes.get_value());
+    ASSERT_EQ(0, metric_->diskUsedBytes.get_value());
+}
+
+TEST_F(ReadCacheTest, TestConcurrentDiskTier) {
+    option_.diskCacheDir = ".";
+    option_.diskCapacityMB = 1;
+    InitCache();
+
+    // blocks move between memory tier and disk tier while being read and
+    // invalidated, cache hits must always return the right data
+    const uint64_t kBlockNum = 1024;
+    std::atomic<bool> stop(false);
+    std::atomic<int> wrongData(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t]() {
+            uint64_t seed = t;
+            while (!stop.load()) {
+                seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+                uint64_t offset = (seed >> 33) % kBlockNum * kBlockSize;
+                if (t == 0 && (seed >> 20) % 16 == 0) {
+                    cache_->OnWriteStart(offset, kBlockSize);
+                    cache_->OnWriteDone();
+                    continue;
+                }
+                std::string buf(kBlockSize, '\0');
+                if (!cache_->Get(offset, kBlockSize, &buf[0])) {
+                    PutBlocks(offset, kBlockSize);
+                } else if (buf != MakeData(offset, kBlockSize).to_string()) {
+                    ++wrongData;
+                }
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    stop = true;
+    for (auto& th : threads) {
+        th.join();
+    }
+    ASSERT_EQ(0, wrongData.load());
+    ASSERT_GT(metric_->diskHit.get_value(), 0);
+
+    // every cached block has the right data
+    WaitDiskWrites();
+    for (uint64_t i = 0; i < kBlockNum; ++i) {
+        std::string buf(kBlockSize, '\0');
+        if (cache_->Get(i * kBlockSize, kBlockSize, &buf[0])) {
+            ASSERT_EQ(MakeData(i * kBlockSize, kBlockSize).to_string(), buf);
+        }
+    }
+}
+
+}  // namespace client
+}  // namespace curve
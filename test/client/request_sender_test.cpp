@@ -21,8 +21,11 @@
  */
 
 #include <brpc/server.h>
+#include <bthread/bthread.h>
 #include <gtest/gtest.h>
 
+#include <map>
+
 #include "src/client/client_common.h"
 #include "src/client/request_sender.h"
 #include "src/common/concurrent/count_down_event.h"
@@ -60,6 +63,30 @@ class FakeChunkClosure : public ClientClosure {
 
     void SendRetryRequest() override {}
 
+    ConnectionMetric* GetConnectionMetric() const {
+        return connMetric_.get();
+    }
+
+    brpc::Controller* GetCntl() const {
+        return cntl_;
+    }
+
+    ChunkResponse* GetChunkResponse() const {
+        return response_.get();
+    }
+
+    int64_t GetLatencyUs() const {
+        return RpcLatencyUs();
+    }
+
+    butil::EndPoint GetRemoteSide() const {
+        return RpcRemoteSide();
+    }
+
+    bool CountTimeout() const {
+        return countTimeout_;
+    }
+
  private:
     RequestClosure reqeustClosure;
     CountDownEvent* event;
@@ -72,6 +99,26 @@ void MockChunkRequestService(::google::protobuf::RpcController* controller,
     brpc::ClosureGuard doneGuard(done);
 }
 
+// 每个子请求都返回成功，读请求返回size长度的'r'
+void MockBatchChunkService(
+    ::google::protobuf::RpcController* controller,
+    const ::curve::chunkserver::BatchChunkRequest* request,
+    ::curve::chunkserver::BatchChunkResponse* response,
+    google::protobuf::Closure* done) {
+    brpc::ClosureGuard doneGuard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(controller);
+    for (const auto& sub : request->requests()) {
+        response->add_responses()->set_status(
+            CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS);
+        if (sub.optype() == curve::chunkserver::CHUNK_OP_TYPE::CHUNK_OP_READ) {
+            cntl->response_attachment().append(std::string(sub.size(), 'r'));
+            response->add_datasize(sub.size());
+        } else {
+            response->add_datasize(0);
+        }
+    }
+}
+
 class RequestSenderTest : public ::testing::Test {
  public:
     void SetUp() override {
@@ -259,5 +306,188 @@ TEST_F(RequestSenderTest, TestReadChunkSourceInfo) {
     }
 }
 
+TEST_F(RequestSenderTest, TestMultiConnection) {
+    ioSenderOption_.chunkserverEnableAppliedIndexRead = true;
+    ioSenderOption_.chunkserverConnectionNum = 4;
+
+    butil::EndPoint serverEndpoint;
+    butil::str2endpoint(serverAddr_.c_str(), &serverEndpoint);
+
+    EXPECT_CALL(mockChunkService_, ReadChunk(_, _, _, _))
+        .WillRepeatedly(Invoke(MockChunkRequestService));
+
+    // 轮询，每条连接被选中的次数相同
+    {
+        ioSenderOption_.chunkserverConnectionLeastInflight = false;
+        RequestSender requestSender(0, serverEndpoint);
+        ASSERT_EQ(0, requestSender.Init(ioSenderOption_));
+        ASSERT_EQ(4, requestSender.GetConnectionNum());
+
+        std::map<ConnectionMetric*, int> selected;
+        for (int i = 0; i < 8; ++i) {
+            CountDownEvent event(1);
+            FakeChunkClosure closure(&event);
+            requestSender.ReadChunk(ChunkIDInfo(), 0, 0, 0, 0, {}, &closure);
+            event.Wait();
+            ASSERT_NE(nullptr, closure.GetConnectionMetric());
+            selected[closure.GetConnectionMetric()]++;
+        }
+
+        ASSERT_EQ(4, selected.size());
+        for (auto& item : selected) {
+            ASSERT_EQ(2, item.second);
+        }
+        ASSERT_TRUE(requestSender.IsSocketHealth());
+    }
+
+    // 选择inflight最少的连接，FakeChunkClosure不会减少inflight计数，
+    // 所以每次都会选到不同的连接
+    {
+        ioSenderOption_.chunkserverConnectionLeastInflight = true;
+        RequestSender requestSender(0, serverEndpoint);
+        ASSERT_EQ(0, requestSender.Init(ioSenderOption_));
+
+        std::map<ConnectionMetric*, int> selected;
+        for (int i = 0; i < 4; ++i) {
+            CountDownEvent event(1);
+            FakeChunkClosure closure(&event);
+            requestSender.ReadChunk(ChunkIDInfo(), 0, 0, 0, 0, {}, &closure);
+            event.Wait();
+            selected[closure.GetConnectionMetric()]++;
+        }
+
+        ASSERT_EQ(4, selected.size());
+    }
+}
+
+TEST_F(RequestSenderTest, TestBatchChunk) {
+    ioSenderOption_.chunkserverEnableAppliedIndexRead = true;
+    ioSenderOption_.chunkserverBatchMaxRequestNum = 3;
+    ioSenderOption_.chunkserverBatchMaxRequestBytes = 8192;
+
+    butil::EndPoint serverEndpoint;
+    butil::str2endpoint(serverAddr_.c_str(), &serverEndpoint);
+
+    // 攒够子请求数量之后立即发送，结果拆分回每个子请求
+    {
+        ioSenderOption_.chunkserverBatchWindowUS = 10 * 1000 * 1000;
+        RequestSender requestSender(0, serverEndpoint);
+        ASSERT_EQ(0, requestSender.Init(ioSenderOption_));
+
+        curve::chunkserver::BatchChunkRequest batchRequest;
+        std::string attachment;
+        EXPECT_CALL(mockChunkService_, BatchChunk(_, _, _, _))
+            .Times(1)
+            .WillOnce(DoAll(SaveArgPointee<1>(&batchRequest),
+                Invoke([&](::google::protobuf::RpcController* controller,
+                           const curve::chunkserver::BatchChunkRequest* req,
+                           curve::chunkserver::BatchChunkResponse* resp,
+                           google::protobuf::Closure* done) {
+                    attachment = static_cast<brpc::Controller*>(controller)
+                                     ->request_attachment().to_string();
+                    bthread_usleep(10 * 1000);
+                    MockBatchChunkService(controller, req, resp, done);
+                })));
+        EXPECT_CALL(mockChunkService_, WriteChunk(_, _, _, _)).Times(0);
+        EXPECT_CALL(mockChunkService_, ReadChunk(_, _, _, _)).Times(0);
+
+        CountDownEvent event(3);
+        FakeChunkClosure write1(&event);
+        FakeChunkClosure write2(&event);
+        FakeChunkClosure read(&event);
+
+        butil::IOBuf data1;
+        data1.append(std::string(4096, 'a'));
+        butil::IOBuf data2;
+        data2.append(std::string(4096, 'b'));
+        requestSender.WriteChunk(ChunkIDInfo(1, 1, 1), 0, data1, 0, 4096, {},
+                                 &write1);
+        requestSender.WriteChunk(ChunkIDInfo(2, 1, 1), 0, data2, 0, 4096, {},
+                                 &write2);
+        requestSender.ReadChunk(ChunkIDInfo(3, 1, 1), 0, 4096, 4096, 0, {},
+                                &read);
+        event.Wait();
+
+        ASSERT_EQ(3, batchRequest.requests_size());
+        ASSERT_EQ(1, batchRequest.requests(0).chunkid());
+        ASSERT_EQ(2, batchRequest.requests(1).chunkid());
+        ASSERT_EQ(3, batchRequest.requests(2).chunkid());
+        ASSERT_EQ(std::string(4096, 'a') + std::string(4096, 'b'),
+                  attachment);
+
+        ASSERT_FALSE(write1.GetCntl()->Failed());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                  write1.GetChunkResponse()->status());
+        ASSERT_EQ(0, write1.GetCntl()->response_attachment().size());
+        ASSERT_EQ(CHUNK_OP_STATUS::CHUNK_OP_STATUS_SUCCESS,
+                  read.GetChunkResponse()->status());
+        ASSERT_EQ(std::string(4096, 'r'),
+                  read.GetCntl()->response_attachment().to_string());
+
+        // 子请求的延时和对端地址取自batch rpc
+        for (auto closure : {&write1, &write2, &read}) {
+            ASSERT_GE(closure->GetLatencyUs(), 10 * 1000);
+            ASSERT_EQ(serverEndpoint, closure->GetRemoteSide());
+        }
+    }
+
+    // 子请求数量不够时，时间窗口到期后发送；大请求不攒批
+    {
+        ioSenderOption_.chunkserverBatchWindowUS = 10 * 1000;
+        RequestSender requestSender(0, serverEndpoint);
+        ASSERT_EQ(0, requestSender.Init(ioSenderOption_));
+
+        curve::chunkserver::BatchChunkRequest batchRequest;
+        EXPECT_CALL(mockChunkService_, BatchChunk(_, _, _, _))
+            .Times(1)
+            .WillOnce(DoAll(SaveArgPointee<1>(&batchRequest),
+                            Invoke(MockBatchChunkService)));
+        EXPECT_CALL(mockChunkService_, ReadChunk(_, _, _, _))
+            .Times(1)
+            .WillOnce(Invoke(MockChunkRequestService));
+
+        CountDownEvent event(2);
+        FakeChunkClosure small(&event);
+        FakeChunkClosure large(&event);
+        requestSender.ReadChunk(ChunkIDInfo(), 0, 0, 4096, 0, {}, &small);
+        requestSender.ReadChunk(ChunkIDInfo(), 0, 0, 16384, 0, {}, &large);
+        event.Wait();
+
+        ASSERT_EQ(1, batchRequest.requests_size());
+        ASSERT_EQ(std::string(4096, 'r'),
+                  small.GetCntl()->response_attachment().to_string());
+    }
+
+    // batch rpc失败时，每个子请求都带上相同的错误码
+    {
+        ioSenderOption_.chunkserverBatchWindowUS = 10 * 1000;
+        RequestSender requestSender(0, serverEndpoint);
+        ASSERT_EQ(0, requestSender.Init(ioSenderOption_));
+
+        EXPECT_CALL(mockChunkService_, BatchChunk(_, _, _, _))
+            .Times(1)
+            .WillOnce(Invoke([](::google::protobuf::RpcController* controller,
+                                const curve::chunkserver::BatchChunkRequest*,
+                                curve::chunkserver::BatchChunkResponse*,
+                                google::protobuf::Closure* done) {
+                brpc::ClosureGuard doneGuard(done);
+                controller->SetFailed("batch failed");
+            }));
+
+        CountDownEvent event(2);
+        FakeChunkClosure read1(&event);
+        FakeChunkClosure read2(&event);
+        requestSender.ReadChunk(ChunkIDInfo(), 0, 0, 4096, 0, {}, &read1);
+        requestSender.ReadChunk(ChunkIDInfo(), 0, 0, 4096, 0, {}, &read2);
+        event.Wait();
+
+        ASSERT_TRUE(read1.GetCntl()->Failed());
+        ASSERT_TRUE(read2.GetCntl()->Failed());
+        // 一个batch失败只计一次chunkserver超时
+        ASSERT_TRUE(read1.CountTimeout());
+        ASSERT_FALSE(read2.CountTimeout());
+    }
+}
+
 }  // namespace client
 }  // namespace curve
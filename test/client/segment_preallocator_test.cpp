@@ -0,0 +1,238 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include "src/client/segment_preallocator.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "src/client/splitor.h"
+#include "test/client/mock/mock_mdsclient.h"
+
+namespace curve {
+namespace client {
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+
+const uint64_t kChunkSize = 16ull * 1024 * 1024;
+const uint64_t kSegmentSize = 1ull * 1024 * 1024 * 1024;
+const uint64_t kSegmentNum = 10;
+const uint64_t kWriteSize = 4ull * 1024 * 1024;
+
+class SegmentPreallocatorTest : public ::testing::Test {
+ public:
+    void SetUp() override {
+        metric_.reset(new SegmentPreallocMetric("SegmentPreallocatorTest"));
+        mockMDSClient_.reset(new MockMDSClient());
+        metaCache_.reset(new MetaCache());
+
+        fileInfo_.fullPathName = "/TestSegmentPreallocator";
+        fileInfo_.chunksize = kChunkSize;
+        fileInfo_.segmentsize = kSegmentSize;
+        fileInfo_.length = kSegmentNum * kSegmentSize;
+        metaCache_->UpdateFileInfo(fileInfo_);
+
+        option_.preallocSegmentNum = 4;
+        option_.sequentialWriteThreshold = 2;
+
+        ON_CALL(*mockMDSClient_, GetServerList(_, _, _))
+            .WillByDefault(Return(LIBCURVE_ERROR::OK));
+    }
+
+    std::vector<SegmentInfo> MakeSegmentInfos(SegmentIndex begin,
+                                              SegmentIndex end) {
+        std::vector<SegmentInfo> segInfos;
+        ChunkID chunkId = begin * (kSegmentSize / kChunkSize) + 1;
+        for (SegmentIndex idx = begin; idx < end; ++idx) {
+            SegmentInfo segInfo;
+            segInfo.segmentsize = kSegmentSize;
+            segInfo.chunksize = kChunkSize;
+            segInfo.startoffset = idx * kSegmentSize;
+            segInfo.lpcpIDInfo.lpid = 1;
+            segInfo.lpcpIDInfo.cpidVec.push_back(1);
+            for (uint64_t i = 0; i < kSegmentSize / kChunkSize; ++i) {
+                segInfo.chunkvec.emplace_back(chunkId++, 1, 1);
+            }
+            segInfos.push_back(segInfo);
+        }
+        return segInfos;
+    }
+
+    bool IsSegmentCached(SegmentIndex idx) {
+        ChunkIDInfo chunkIdInfo;
+        return metaCache_->GetChunkInfoByIndex(idx * kSegmentSize / kChunkSize,
+                                               &chunkIdInfo) ==
+               MetaCacheErrorType::OK;
+    }
+
+ protected:
+    FInfo fileInfo_;
+    SegmentPreallocOption option_;
+    std::unique_ptr<SegmentPreallocMetric> metric_;
+    std::unique_ptr<MockMDSClient> mockMDSClient_;
+    std::unique_ptr<MetaCache> metaCache_;
+};
+
+TEST_F(SegmentPreallocatorTest, TestDisabled) {
+    option_.preallocSegmentNum = 0;
+    SegmentPreallocator preallocator(option_, metaCache_.get(),
+                                     mockMDSClient_.get(), metric_.get());
+
+    EXPECT_CALL(*mockMDSClient_, AllocateSegments(_, _, _, _)).Times(0);
+
+    for (uint64_t offset = 0; offset < 10 * kWriteSize;
+         offset += kWriteSize) {
+        preallocator.OnWrite(offset, kWriteSize);
+    }
+    preallocator.Stop();
+}
+
+TEST_F(SegmentPreallocatorTest, TestRandomWrite) {
+    SegmentPreallocator preallocator(option_, metaCache_.get(),
+                                     mockMDSClient_.get(), metric_.get());
+
+    EXPECT_CALL(*mockMDSClient_, AllocateSegments(_, _, _, _)).Times(0);
+
+    for (uint64_t i = 0; i < 10; ++i) {
+        preallocator.OnWrite((i % 2 + 1) * kSegmentSize + i * kWriteSize,
+                             kWriteSize);
+    }
+    preallocator.Stop();
+}
+
+TEST_F(SegmentPreallocatorTest, TestSequentialWrite) {
+    SegmentPreallocator preallocator(option_, metaCache_.get(),
+                                     mockMDSClient_.get(), metric_.get());
+
+    EXPECT_CALL(*mockMDSClient_, AllocateSegments(_, kSegmentSize, 4, _))
+        .WillOnce(DoAll(SetArgPointee<3>(MakeSegmentInfos(1, 5)),
+                        Return(LIBCURVE_ERROR::OK)));
+    EXPECT_CALL(*mockMDSClient_, GetServerList(_, _, _)).Times(4);
+
+    preallocator.OnWrite(0, kWriteSize);
+    preallocator.OnWrite(kWriteSize, kWriteSize);
+    preallocator.Stop();
+
+    ASSERT_FALSE(IsSegmentCached(0));
+    for (SegmentIndex idx = 1; idx < 5; ++idx) {
+        ASSERT_TRUE(IsSegmentCached(idx));
+    }
+    ASSERT_FALSE(IsSegmentCached(5));
+    ASSERT_EQ(4, metric_->totalSuccess.get_value());
+}
+
+TEST_F(SegmentPreallocatorTest, TestSplitLargeAllocation) {
+    fileInfo_.length = 200 * kSegmentSize;
+    metaCache_->UpdateFileInfo(fileInfo_);
+    option_.preallocSegmentNum = 100;
+    SegmentPreallocator preallocator(option_, metaCache_.get(),
+                                     mockMDSClient_.get(), metric_.get());
+
+    const uint32_t maxNum = SegmentPreallocator::kMaxSegmentsPerRequest;
+    EXPECT_CALL(*mockMDSClient_, AllocateSegments(_, kSegmentSize, maxNum, _))
+        .WillOnce(DoAll(SetArgPointee<3>(MakeSegmentInfos(1, 1 + maxNum)),
+                        Return(LIBCURVE_ERROR::OK)));
+    EXPECT_CALL(*mockMDSClient_,
+                AllocateSegments(_, (1 + maxNum) * kSegmentSize,
+                                 100 - maxNum, _))
+        .WillOnce(DoAll(SetArgPointee<3>(MakeSegmentInfos(1 + maxNum, 101)),
+                        Return(LIBCURVE_ERROR::OK)));
+
+    preallocator.OnWrite(0, kWriteSize);
+    preallocator.OnWrite(kWriteSize, kWriteSize);
+    preallocator.Stop();
+
+    ASSERT_TRUE(IsSegmentCached(1));
+    ASSERT_TRUE(IsSegmentCached(100));
+    ASSERT_FALSE(IsSegmentCached(101));
+    ASSERT_EQ(100, metric_->totalSuccess.get_value());
+}
+
+TEST_F(SegmentPreallocatorTest, TestRetrySmallerBatchOnParamError) {
+    SegmentPreallocator preallocator(option_, metaCache_.get(),
+                                     mockMDSClient_.get(), metric_.get());
+
+    // mds is configured with a smaller maxAllocateSegmentNum
+    EXPECT_CALL(*mockMDSClient_, AllocateSegments(_, kSegmentSize, 4, _))
+        .WillOnce(Return(LIBCURVE_ERROR::PARAM_ERROR));
+    EXPECT_CALL(*mockMDSClient_, AllocateSegments(_, kSegmentSize, 2, _))
+        .WillOnce(DoAll(SetArgPointee<3>(MakeSegmentInfos(1, 3)),
+                        Return(LIBCURVE_ERROR::OK)));
+    EXPECT_CALL(*mockMDSClient_, AllocateSegments(_, 3 * kSegmentSize, 2, _))
+        .WillOnce(DoAll(SetArgPointee<3>(MakeSegmentInfos(3, 5)),
+                        Return(LIBCURVE_ERROR::OK)));
+
+    preallocator.OnWrite(0, kWriteSize);
+    preallocator.OnWrite(kWriteSize, kWriteSize);
+    preallocator.Stop();
+
+    for (SegmentIndex idx = 1; idx < 5; ++idx) {
+        ASSERT_TRUE(IsSegmentCached(idx));
+    }
+    ASSERT_EQ(4, metric_->totalSuccess.get_value());
+}
+
+TEST_F(SegmentPreallocatorTest, TestSkipCachedSegmentNearFileEnd) {
+    SegmentPreallocator preallocator(option_, metaCache_.get(),
+                                     mockMDSClient_.get(), metric_.get());
+
+    for (const auto& segInfo : MakeSegmentInfos(7, 8)) {
+        ASSERT_TRUE(Splitor::UpdateSegmentInfo(segInfo, mockMDSClient_.get(),
+                                               metaCache_.get(), &fileInfo_));
+    }
+
+    // write in segment 6, segment 7 is cached and segment 10 is out of file
+    uint64_t offset = 6 * kSegmentSize;
+    EXPECT_CALL(*mockMDSClient_, AllocateSegments(_, 8 * kSegmentSize, 2, _))
+        .WillOnce(Return(LIBCURVE_ERROR::FAILED));
+
+    preallocator.OnWrite(offset, kWriteSize);
+    preallocator.OnWrite(offset + kWriteSize, kWriteSize);
+    preallocator.OnWrite(offset + 2 * kWriteSize, kWriteSize);
+    preallocator.Stop();
+    ASSERT_EQ(1, metric_->totalError.get_value());
+}
+
+TEST_F(SegmentPreallocatorTest, TestAllSegmentsCached) {
+    SegmentPreallocator preallocator(option_, metaCache_.get(),
+                                     mockMDSClient_.get(), metric_.get());
+
+    for (const auto& segInfo : MakeSegmentInfos(1, 5)) {
+        ASSERT_TRUE(Splitor::UpdateSegmentInfo(segInfo, mockMDSClient_.get(),
+                                               metaCache_.get(), &fileInfo_));
+    }
+
+    EXPECT_CALL(*mockMDSClient_, AllocateSegments(_, _, _, _)).Times(0);
+
+    preallocator.OnWrite(0, kWriteSize);
+    preallocator.OnWrite(kWriteSize, kWriteSize);
+    preallocator.Stop();
+    ASSERT_EQ(0, metric_->totalSuccess.get_value());
+}
+
+}  // namespace client
+}  // namespace curve
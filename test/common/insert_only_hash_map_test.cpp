@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>   // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/common/concurrent/insert_only_hash_map.h"
+
+namespace curve {
+namespace common {
+
+TEST(InsertOnlyHashMapTest, basic) {
+    InsertOnlyHashMap<uint64_t, std::string> map(3);
+    ASSERT_EQ(nullptr, map.Find(1));
+    ASSERT_EQ(0, map.Size());
+
+    std::string* value = map.FindOrInsert(1, "one");
+    ASSERT_EQ("one", *value);
+    ASSERT_EQ(value, map.Find(1));
+
+    // 已经存在时不会重新构造
+    ASSERT_EQ(value, map.FindOrInsert(1, "another"));
+    ASSERT_EQ("one", *map.Find(1));
+
+    // 桶数量少于key数量，同一个桶中存在多个节点
+    for (uint64_t i = 2; i <= 100; ++i) {
+        map.FindOrInsert(i, std::to_string(i));
+    }
+    ASSERT_EQ(100, map.Size());
+    for (uint64_t i = 2; i <= 100; ++i) {
+        ASSERT_EQ(std::to_string(i), *map.Find(i));
+    }
+    ASSERT_EQ(nullptr, map.Find(101));
+
+    uint64_t count = 0;
+    map.ForEach([&count](uint64_t key, std::string* value) {
+        ++count;
+    });
+    ASSERT_EQ(100, count);
+}
+
+TEST(InsertOnlyHashMapTest, ConcurrentFindAndInsert) {
+    const uint64_t kKeys = 100000;
+    InsertOnlyHashMap<uint64_t, uint64_t> map(1024);
+    std::mutex insertMtx;
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> wrong(0);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&]() {
+            uint64_t key = 0;
+            while (!stop.load()) {
+                const uint64_t* value = map.Find(key);
+                if (value != nullptr && *value != key * 2) {
+                    wrong.fetch_add(1);
+                }
+                key = (key + 1) % kKeys;
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 2; ++i) {
+        writers.emplace_back([&]() {
+            for (uint64_t key = 0; key < kKeys; ++key) {
+                std::lock_guard<std::mutex> lk(insertMtx);
+                map.FindOrInsert(key, key * 2);
+            }
+        });
+    }
+    for (auto& t : writers) {
+        t.join();
+    }
+    stop.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+
+    ASSERT_EQ(0, wrong.load());
+    ASSERT_EQ(kKeys, map.Size());
+}
+
+}  // namespace common
+}  // namespace curve
@@ -0,0 +1,164 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>   //NOLINT
+#include <vector>
+
+#include "src/common/concurrent/inplace_task.h"
+#include "src/common/concurrent/mpsc_ring_queue.h"
+
+namespace curve {
+namespace common {
+
+TEST(InplaceTaskTest, basic) {
+    // 1. 小的可调用对象存放在对象内部
+    int count = 0;
+    InplaceTask<64> task([&count]() { ++count; });
+    ASSERT_TRUE(static_cast<bool>(task));
+    ASSERT_TRUE(task.IsInline());
+    task();
+    ASSERT_EQ(1, count);
+
+    // 2. 移动后原对象为空
+    InplaceTask<64> moved(std::move(task));
+    ASSERT_FALSE(static_cast<bool>(task));
+    moved();
+    ASSERT_EQ(2, count);
+
+    // 3. 超过大小的可调用对象在堆上分配
+    char big[128] = {1};
+    InplaceTask<64> heapTask([&count, big]() { count += big[0]; });
+    ASSERT_FALSE(heapTask.IsInline());
+    InplaceTask<64> heapMoved;
+    heapMoved = std::move(heapTask);
+    heapMoved();
+    ASSERT_EQ(3, count);
+
+    // 4. 析构和Reset时释放捕获的对象
+    std::shared_ptr<int> ref = std::make_shared<int>(0);
+    {
+        InplaceTask<64> t1([ref]() {});
+        InplaceTask<64> t2([ref, big]() {});
+        ASSERT_EQ(3, ref.use_count());
+        t1.Reset();
+        ASSERT_EQ(2, ref.use_count());
+    }
+    ASSERT_EQ(1, ref.use_count());
+}
+
+TEST(MPSCRingQueueTest, basic) {
+    // 1. 容量向上取整为2的幂
+    {
+        MPSCRingQueue<int> q1(1);
+        ASSERT_EQ(2, q1.Capacity());
+        MPSCRingQueue<int> q2(100);
+        ASSERT_EQ(128, q2.Capacity());
+    }
+
+    // 2. 先进先出，满时TryPush失败，空时TryPop失败
+    {
+        MPSCRingQueue<int> q(4);
+        int item = 0;
+        ASSERT_FALSE(q.TryPop(&item));
+        for (int i = 0; i < 4; ++i) {
+            item = i;
+            ASSERT_TRUE(q.TryPush(&item));
+        }
+        item = 4;
+        ASSERT_FALSE(q.TryPush(&item));
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_TRUE(q.TryPop(&item));
+            ASSERT_EQ(i, item);
+        }
+        ASSERT_FALSE(q.TryPop(&item));
+    }
+
+    // 3. 队列析构时释放未出队的元素
+    {
+        std::shared_ptr<int> ref = std::make_shared<int>(0);
+        {
+            MPSCRingQueue<std::shared_ptr<int>> q(4);
+            q.Push(std::shared_ptr<int>(ref));
+            q.Push(std::shared_ptr<int>(ref));
+            ASSERT_EQ(3, ref.use_count());
+        }
+        ASSERT_EQ(1, ref.use_count());
+    }
+}
+
+TEST(MPSCRingQueueTest, MultiProducer) {
+    const int kProducers = 4;
+    const uint64_t kItems = 100000;
+    // 队列很小，生产者和消费者都会频繁挂起
+    MPSCRingQueue<uint64_t> q(8);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&q, p, kItems]() {
+            for (uint64_t i = 0; i < kItems; ++i) {
+                q.Push(p * kItems + i);
+            }
+        });
+    }
+
+    // 同一生产者的元素按入队顺序出队
+    std::vector<uint64_t> next(kProducers, 0);
+    for (uint64_t i = 0; i < kProducers * kItems; ++i) {
+        uint64_t item;
+        q.Pop(&item);
+        int p = item / kItems;
+        ASSERT_EQ(next[p], item % kItems);
+        ++next[p];
+    }
+    for (auto& th : producers) {
+        th.join();
+    }
+    uint64_t item;
+    ASSERT_FALSE(q.TryPop(&item));
+}
+
+TEST(MPSCRingQueueTest, ParkAndWakeup) {
+    MPSCRingQueue<InplaceTask<64>> q(2);
+    std::atomic<int> count(0);
+    std::thread consumer([&q, &count]() {
+        InplaceTask<64> task;
+        for (int i = 0; i < 3; ++i) {
+            q.Pop(&task);
+            task();
+        }
+    });
+    // 等待消费者自旋结束挂起
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    for (int i = 0; i < 3; ++i) {
+        q.Push(InplaceTask<64>([&count]() { ++count; }));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    consumer.join();
+    ASSERT_EQ(3, count.load());
+}
+
+}  // namespace common
+}  // namespace curve
@@ -0,0 +1,105 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * Created Date: 2026-10-17
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/common/concurrent/seqlock.h"
+
+namespace curve {
+namespace common {
+
+namespace {
+
+// 各字段始终相同，读到不同的值说明读到了写了一半的数据
+struct Item {
+    uint64_t a = 0;
+    uint64_t b = 0;
+    uint32_t c = 0;
+    bool valid = false;
+};
+
+}  // namespace
+
+TEST(SeqLockValueTest, basic) {
+    SeqLockValue<Item> value;
+    Item item = value.Load();
+    ASSERT_EQ(0, item.a);
+    ASSERT_FALSE(item.valid);
+
+    item.a = 1;
+    item.b = 2;
+    item.c = 3;
+    item.valid = true;
+    value.Store(item);
+
+    Item loaded = value.Load();
+    ASSERT_EQ(1, loaded.a);
+    ASSERT_EQ(2, loaded.b);
+    ASSERT_EQ(3, loaded.c);
+    ASSERT_TRUE(loaded.valid);
+
+    SeqLockValue<uint32_t> small(10);
+    ASSERT_EQ(10, small.Load());
+    small.Store(20);
+    ASSERT_EQ(20, small.Load());
+}
+
+TEST(SeqLockValueTest, ConcurrentReadWrite) {
+    SeqLockValue<Item> value;
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> torn(0);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&]() {
+            while (!stop.load()) {
+                Item item = value.Load();
+                if (item.a != item.b || item.a != item.c) {
+                    torn.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    for (uint32_t i = 1; i <= 100000; ++i) {
+        Item item;
+        item.a = i;
+        item.b = i;
+        item.c = i;
+        item.valid = true;
+        value.Store(item);
+    }
+    stop.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+
+    ASSERT_EQ(0, torn.load());
+    ASSERT_EQ(100000, value.Load().a);
+}
+
+}  // namespace common
+}  // namespace curve
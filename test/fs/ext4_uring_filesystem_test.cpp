@@ -0,0 +1,136 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2026-10-17
+ * Author: curve
+ */
+
+#include <gtest/gtest.h>
+#include <glog/logging.h>
+#include <fcntl.h>
+#include <string.h>
+#include <butil/iobuf.h>
+
+#include <atomic>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/fs/local_filesystem.h"
+#include "src/fs/ext4_uring_filesystem_impl.h"
+
+namespace curve {
+namespace fs {
+
+const char kUringTestDir[] = "./ext4_uring_test";
+
+class Ext4UringFileSystemTest : public testing::Test {
+ public:
+    void SetUp() {
+        lfs = Ext4UringFileSystemImpl::getInstance();
+        LocalFileSystemOption option;
+        option.uringQueueDepth = 32;
+        ASSERT_EQ(0, lfs->Init(option));
+        ASSERT_EQ(0, lfs->Mkdir(kUringTestDir));
+        path = std::string(kUringTestDir) + "/file";
+        fd = lfs->Open(path, O_RDWR | O_CREAT);
+        ASSERT_GE(fd, 0);
+    }
+
+    void TearDown() {
+        ASSERT_EQ(0, lfs->Close(fd));
+        ASSERT_EQ(0, lfs->Delete(kUringTestDir));
+    }
+
+ protected:
+    std::shared_ptr<Ext4UringFileSystemImpl> lfs;
+    std::string path;
+    int fd;
+};
+
+TEST_F(Ext4UringFileSystemTest, FactoryTest) {
+    std::shared_ptr<LocalFileSystem> lfs1 =
+        LocalFsFactory::CreateFs(FileSystemType::EXT4_URING, "");
+    ASSERT_EQ(lfs1.get(), lfs.get());
+    std::shared_ptr<LocalFileSystem> lfs2 =
+        LocalFsFactory::CreateFs(FileSystemType::EXT4, "");
+    ASSERT_NE(lfs1.get(), lfs2.get());
+}
+
+TEST_F(Ext4UringFileSystemTest, ReadWriteTest) {
+    // 内核不支持io_uring时会退化为pread/pwrite，读写语义不变
+    LOG(INFO) << "io_uring enabled: " << lfs->IsUringEnabled();
+
+    const int length = 8192;
+    char writeBuf[length];
+    char readBuf[length];
+    memset(writeBuf, 'a', length);
+    ASSERT_EQ(length, lfs->Write(fd, writeBuf, 4096, length));
+    memset(readBuf, 0, length);
+    ASSERT_EQ(length, lfs->Read(fd, readBuf, 4096, length));
+    ASSERT_EQ(0, memcmp(writeBuf, readBuf, length));
+
+    // IOBuf中的数据通过writev直接写入
+    butil::IOBuf buf;
+    std::string part1(4096, 'b');
+    std::string part2(4096, 'c');
+    buf.append(part1);
+    butil::IOBuf other;
+    other.append(part2);
+    buf.append(other);
+    ASSERT_EQ(length, lfs->Write(fd, buf, 0, length));
+    ASSERT_EQ(length, lfs->Read(fd, readBuf, 0, length));
+    ASSERT_EQ(0, memcmp(part1.data(), readBuf, 4096));
+    ASSERT_EQ(0, memcmp(part2.data(), readBuf + 4096, 4096));
+
+    // 读超过文件末尾时返回实际读到的长度
+    ASSERT_EQ(4096, lfs->Read(fd, readBuf, 8192, length));
+}
+
+TEST_F(Ext4UringFileSystemTest, ConcurrentTest) {
+    const int threadNum = 8;
+    const int ioNum = 64;
+    const int ioSize = 4096;
+    std::vector<std::thread> threads;
+    std::atomic<int> errorCount(0);
+    for (int i = 0; i < threadNum; ++i) {
+        threads.emplace_back([&, i] {
+            char writeBuf[ioSize];
+            char readBuf[ioSize];
+            for (int j = 0; j < ioNum; ++j) {
+                uint64_t offset = (i * ioNum + j) * ioSize;
+                memset(writeBuf, 'a' + i, ioSize);
+                if (lfs->Write(fd, writeBuf, offset, ioSize) != ioSize) {
+                    ++errorCount;
+                    continue;
+                }
+                if (lfs->Read(fd, readBuf, offset, ioSize) != ioSize
+                    || memcmp(writeBuf, readBuf, ioSize) != 0) {
+                    ++errorCount;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    ASSERT_EQ(0, errorCount.load());
+}
+
+}  // namespace fs
+}  // namespace curve
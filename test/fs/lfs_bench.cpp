@@ -0,0 +1,204 @@
+/*
+ *  Copyright (c) 2020 NetEase Inc.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*
+ * Project: curve
+ * File Created: 2026-10-17
+ * Author: curve
+ */
+
+/**
+ * fio风格的本地文件系统压测工具，用于对比pread/pwrite与io_uring两种实现
+ * 每个job线程同步地发起IO，iodepth即为job数，与chunkserver中
+ * 多个apply线程同步读写chunk文件的模型一致
+ * 示例：
+ *   ./lfs_bench --engine=io_uring --filename=/data/test --size=1073741824
+ *               --rw=randwrite --bs=4096 --numjobs=32 --runtime=30 --direct
+ */
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "src/fs/local_filesystem.h"
+
+DEFINE_string(engine, "psync", "io engine: psync | io_uring");
+DEFINE_string(filename, "./lfs_bench.dat", "file to test against");
+DEFINE_uint64(size, 1024 * 1024 * 1024, "file size in bytes");
+DEFINE_string(rw, "randwrite", "io pattern: read | write | randread | randwrite");  // NOLINT
+DEFINE_uint32(bs, 4096, "block size of each io");
+DEFINE_uint32(numjobs, 16, "number of threads issuing io, i.e. iodepth");
+DEFINE_uint32(runtime, 10, "seconds to run");
+DEFINE_bool(direct, true, "open file with O_DIRECT");
+DEFINE_bool(dsync, false, "open file with O_DSYNC, same as chunk files");
+DEFINE_uint32(queue_depth, 128, "io_uring submission queue depth");
+
+using curve::fs::LocalFileSystem;
+using curve::fs::LocalFsFactory;
+using curve::fs::LocalFileSystemOption;
+using curve::fs::FileSystemType;
+
+namespace {
+
+struct JobStat {
+    uint64_t ios = 0;
+    uint64_t bytes = 0;
+    uint64_t latencyUs = 0;
+    uint64_t maxLatencyUs = 0;
+    uint64_t errors = 0;
+};
+
+void RunJob(std::shared_ptr<LocalFileSystem> lfs, int fd, uint32_t jobIndex,
+            const std::atomic<bool>* stop, JobStat* stat) {
+    bool isRead = FLAGS_rw == "read" || FLAGS_rw == "randread";
+    bool isRand = FLAGS_rw == "randread" || FLAGS_rw == "randwrite";
+    uint64_t blocks = FLAGS_size / FLAGS_bs;
+    // 顺序模式下各个job负责文件中不相交的一段
+    uint64_t blocksPerJob = std::max<uint64_t>(blocks / FLAGS_numjobs, 1);
+    uint64_t seqBegin = (jobIndex * blocksPerJob) % blocks;
+    uint64_t seqIndex = 0;
+
+    char* buf = nullptr;
+    CHECK(0 == posix_memalign(reinterpret_cast<void**>(&buf), 4096, FLAGS_bs))
+        << "alloc buffer failed";
+    memset(buf, 'a' + jobIndex % 26, FLAGS_bs);
+
+    std::mt19937_64 rand(jobIndex);
+    while (!stop->load(std::memory_order_relaxed)) {
+        uint64_t block = isRand ? rand() % blocks
+                                : seqBegin + seqIndex++ % blocksPerJob;
+        uint64_t offset = block * FLAGS_bs;
+        auto start = std::chrono::steady_clock::now();
+        int ret = isRead ? lfs->Read(fd, buf, offset, FLAGS_bs)
+                         : lfs->Write(fd, buf, offset, FLAGS_bs);
+        auto end = std::chrono::steady_clock::now();
+        if (ret != static_cast<int>(FLAGS_bs)) {
+            ++stat->errors;
+            continue;
+        }
+        uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+            end - start).count();
+        ++stat->ios;
+        stat->bytes += FLAGS_bs;
+        stat->latencyUs += us;
+        stat->maxLatencyUs = std::max(stat->maxLatencyUs, us);
+    }
+    free(buf);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    google::ParseCommandLineFlags(&argc, &argv, false);
+    google::InitGoogleLogging(argv[0]);
+
+    FileSystemType type;
+    if (FLAGS_engine == "psync") {
+        type = FileSystemType::EXT4;
+    } else if (FLAGS_engine == "io_uring") {
+        type = FileSystemType::EXT4_URING;
+    } else {
+        LOG(ERROR) << "Unknown engine: " << FLAGS_engine;
+        return -1;
+    }
+    if (FLAGS_bs == 0 || FLAGS_size < FLAGS_bs || FLAGS_numjobs == 0) {
+        LOG(ERROR) << "Invalid bs, size or numjobs";
+        return -1;
+    }
+
+    std::shared_ptr<LocalFileSystem> lfs = LocalFsFactory::CreateFs(type, "");
+    LocalFileSystemOption option;
+    option.uringQueueDepth = FLAGS_queue_depth;
+    if (lfs == nullptr || lfs->Init(option) != 0) {
+        LOG(ERROR) << "Init local filesystem failed";
+        return -1;
+    }
+
+    int flags = O_RDWR | O_CREAT | O_NOATIME;
+    if (FLAGS_direct) {
+        flags |= O_DIRECT;
+    }
+    if (FLAGS_dsync) {
+        flags |= O_DSYNC;
+    }
+    int fd = lfs->Open(FLAGS_filename, flags);
+    if (fd < 0) {
+        LOG(ERROR) << "Open " << FLAGS_filename << " failed";
+        return -1;
+    }
+    struct stat info;
+    if (lfs->Fstat(fd, &info) != 0) {
+        LOG(ERROR) << "Stat " << FLAGS_filename << " failed";
+        lfs->Close(fd);
+        return -1;
+    }
+    if (static_cast<uint64_t>(info.st_size) < FLAGS_size) {
+        LOG(INFO) << "Preallocating " << FLAGS_filename
+                  << ", size: " << FLAGS_size;
+        if (lfs->Fallocate(fd, 0, 0, FLAGS_size) != 0) {
+            LOG(ERROR) << "Fallocate " << FLAGS_filename << " failed";
+            lfs->Close(fd);
+            return -1;
+        }
+    }
+
+    std::atomic<bool> stop(false);
+    std::vector<JobStat> stats(FLAGS_numjobs);
+    std::vector<std::thread> jobs;
+    auto begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < FLAGS_numjobs; ++i) {
+        jobs.emplace_back(RunJob, lfs, fd, i, &stop, &stats[i]);
+    }
+    std::this_thread::sleep_for(std::chrono::seconds(FLAGS_runtime));
+    stop.store(true);
+    for (auto& job : jobs) {
+        job.join();
+    }
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - begin).count();
+    lfs->Close(fd);
+
+    JobStat total;
+    for (auto& stat : stats) {
+        total.ios += stat.ios;
+        total.bytes += stat.bytes;
+        total.latencyUs += stat.latencyUs;
+        total.errors += stat.errors;
+        total.maxLatencyUs = std::max(total.maxLatencyUs, stat.maxLatencyUs);
+    }
+    std::cout << FLAGS_engine << ": rw=" << FLAGS_rw
+              << ", bs=" << FLAGS_bs
+              << ", numjobs=" << FLAGS_numjobs << std::endl
+              << "  iops=" << static_cast<uint64_t>(total.ios / seconds)
+              << ", bw=" << total.bytes / seconds / 1024 / 1024 << "MiB/s"
+              << ", avg lat="
+              << (total.ios == 0 ? 0 : total.latencyUs / total.ios) << "us"
+              << ", max lat=" << total.maxLatencyUs << "us"
+              << ", errors=" << total.errors << std::endl;
+    return 0;
+}
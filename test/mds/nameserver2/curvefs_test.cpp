@@ -2356,6 +2356,118 @@ TEST_F(CurveFSTest, testGetOrAllocateSegment) {
     }
 }
 
+TEST_F(CurveFSTest, testAllocateSegments) {
+    FileInfo fileInfo1;
+    fileInfo1.set_filetype(FileType::INODE_DIRECTORY);
+
+    FileInfo fileInfo2;
+    fileInfo2.set_filetype(FileType::INODE_PAGEFILE);
+    fileInfo2.set_length(kMiniFileLength);
+    fileInfo2.set_segmentsize(DefaultSegmentSize);
+
+    const uint64_t lastSegmentOffset = kMiniFileLength - DefaultSegmentSize;
+
+    // segment num is 0
+    {
+        std::vector<PageFileSegment> segments;
+        ASSERT_EQ(StatusCode::kParaError,
+                  curvefs_->AllocateSegments("/user1/file2", 0, 0,
+                                             &segments));
+    }
+
+    // segment offset not align file segment size
+    {
+        std::vector<PageFileSegment> segments;
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+            .Times(2)
+            .WillOnce(DoAll(SetArgPointee<2>(fileInfo1),
+                            Return(StoreStatus::OK)))
+            .WillOnce(DoAll(SetArgPointee<2>(fileInfo2),
+                            Return(StoreStatus::OK)));
+
+        ASSERT_EQ(StatusCode::kParaError,
+                  curvefs_->AllocateSegments("/user1/file2", 1, 2,
+                                             &segments));
+    }
+
+    // segments beyond file length are ignored,
+    // exist segment is returned and not exist segment is allocated
+    {
+        std::vector<PageFileSegment> segments;
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+            .Times(2)
+            .WillOnce(DoAll(SetArgPointee<2>(fileInfo1),
+                            Return(StoreStatus::OK)))
+            .WillOnce(DoAll(SetArgPointee<2>(fileInfo2),
+                            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, GetSegment(_, _, _))
+            .Times(2)
+            .WillOnce(Return(StoreStatus::OK))
+            .WillOnce(Return(StoreStatus::KeyNotExist));
+        EXPECT_CALL(*mockChunkAllocator_,
+                    AllocateChunkSegment(_, _, _, lastSegmentOffset, _))
+            .Times(1)
+            .WillOnce(Return(true));
+        EXPECT_CALL(*storage_, PutSegment(_, lastSegmentOffset, _, _))
+            .Times(1)
+            .WillOnce(Return(StoreStatus::OK));
+
+        ASSERT_EQ(StatusCode::kOK,
+                  curvefs_->AllocateSegments(
+                      "/user1/file2", lastSegmentOffset - DefaultSegmentSize,
+                      4, &segments));
+        ASSERT_EQ(2, segments.size());
+    }
+
+    // allocate failed at the first segment
+    {
+        std::vector<PageFileSegment> segments;
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+            .Times(2)
+            .WillOnce(DoAll(SetArgPointee<2>(fileInfo1),
+                            Return(StoreStatus::OK)))
+            .WillOnce(DoAll(SetArgPointee<2>(fileInfo2),
+                            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, GetSegment(_, _, _))
+            .Times(1)
+            .WillOnce(Return(StoreStatus::KeyNotExist));
+        EXPECT_CALL(*mockChunkAllocator_, AllocateChunkSegment(_, _, _, _, _))
+            .Times(1)
+            .WillOnce(Return(false));
+
+        ASSERT_EQ(StatusCode::kSegmentAllocateError,
+                  curvefs_->AllocateSegments("/user1/file2", 0, 4,
+                                             &segments));
+        ASSERT_TRUE(segments.empty());
+    }
+
+    // allocate failed at the second segment, return the first one
+    {
+        std::vector<PageFileSegment> segments;
+        EXPECT_CALL(*storage_, GetFile(_, _, _))
+            .Times(2)
+            .WillOnce(DoAll(SetArgPointee<2>(fileInfo1),
+                            Return(StoreStatus::OK)))
+            .WillOnce(DoAll(SetArgPointee<2>(fileInfo2),
+                            Return(StoreStatus::OK)));
+        EXPECT_CALL(*storage_, GetSegment(_, _, _))
+            .Times(2)
+            .WillOnce(Return(StoreStatus::OK))
+            .WillOnce(Return(StoreStatus::KeyNotExist));
+        EXPECT_CALL(*mockChunkAllocator_, AllocateChunkSegment(_, _, _, _, _))
+            .Times(1)
+            .WillOnce(Return(true));
+        EXPECT_CALL(*storage_, PutSegment(_, _, _, _))
+            .Times(1)
+            .WillOnce(Return(StoreStatus::InternalError));
+
+        ASSERT_EQ(StatusCode::kOK,
+                  curvefs_->AllocateSegments("/user1/file2", 0, 4,
+                                             &segments));
+        ASSERT_EQ(1, segments.size());
+    }
+}
+
 TEST_F(CurveFSTest, TestDeAllocateSegment) {
     const std::string filename = "/TestDeAllocateSegment";
     const uint64_t offset = 1ull * 1024 * 1024 * 1024;